@@ -0,0 +1,340 @@
+# -*- coding: utf-8 -*-
+"""
+Check M4 eyes config files and compile them to the binary form that
+mdo_m4_eyes reads at startup instead of the JSON.
+
+    python eye_config_compile.py ../mdo_m4_eyes/eyes/hazel/config.eye
+    python eye_config_compile.py --check ../mdo_m4_eyes/eyes/*/config.eye
+
+For each NAME.eye this reports unknown keys and values out of range
+(warnings; the sketch ignores or clamps those) and syntax errors or
+values of the wrong type (errors), and unless --check writes NAME.bin
+next to it.
+Copy the .bin to the board along with the .eye; the sketch uses the .bin
+when it's intact and made from the .eye as it is now (the .bin holds a
+hash of the .eye's contents), else falls back to the .eye. Exit status is 1 if any file had errors (no .bin written for it).
+
+The .bin layout and the value conversions must match file.cpp in
+mdo_m4_eyes (configKeys[], configResolved, dwim() ...).
+
+@author: https://github.com/Mark-MDO47
+"""
+import sys
+import os
+import re
+import json
+import struct
+import argparse
+
+BLOB_MAGIC   = 0x47464345 # "ECFG"
+BLOB_VERSION = 6
+BLOB_MAX     = 1024       # CONFIG_BLOB_MAX in file.cpp
+EYE_NAMES    = ["right", "left"]
+
+# Key, conversion, (low, high) or None. SAME ORDER AS configKeys[] in
+# file.cpp. The first EYE_KEYS can also be set per-eye.
+KEYS = [
+    ["pupilColor",       "dwim",     None],
+    ["backColor",        "dwim",     None],
+    ["irisColor",        "dwim",     None],
+    ["scleraColor",      "dwim",     None],
+    ["irisAngle",        "angle",    None],
+    ["scleraAngle",      "angle",    None],
+    ["irisSpin",         "spin",     None],
+    ["scleraSpin",       "spin",     None],
+    ["irisiSpin",        "int",      None],
+    ["scleraiSpin",      "int",      None],
+    ["irisMirror",       "mirror",   None],
+    ["scleraMirror",     "mirror",   None],
+    ["irisTexture",      "string",   None],
+    ["scleraTexture",    "string",   None],
+    ["rotate",           "int",      (0, 3)],
+    ["irisRadius",       "dwim",     (0, 240)],
+    ["slitPupilRadius",  "dwim",     (0, 240)],
+    # Global only...
+    ["stackReserve",     "dwim",     (0, 65535)],
+    ["eyeRadius",        "dwim",     (0, 240)],
+    ["eyelidIndex",      "dwim",     (0, 255)],
+    ["gazeMax",          "dwim",     (0, 60000000)], # uS, default 3000000
+    ["coverage",         "float",    (0.0, 1.0)],
+    ["upperEyelid",      "string",   None],
+    ["lowerEyelid",      "string",   None],
+    ["lightSensorMin",   "int",      (0, 1023)],
+    ["lightSensorMax",   "int",      (0, 1023)],
+    ["lightSensorCurve", "float",    (0.01, 10.0)],
+    ["pupilMax",         "float",    (0.0, 1.0)],
+    ["pupilMin",         "float",    (0.0, 1.0)],
+    ["lightSensor",      "int",      (-1, 127)],
+    ["boopSensor",       "int",      (-1, 127)],
+    ["tracking",         "bool",     None],
+    ["squint",           "float",    (0.0, 1.0)],
+    ["voice",            "bool",     None],
+    ["pitch",            "float",    (0.1, 10.0)],
+    ["gain",             "float",    (0.0, 10.0)],
+    ["modulate",         "int",      (0, 10000)],
+    ["waveform",         "waveform", None],
+    ["eyelidPoses",      "dir",      None],
+    ["expressions",      "string",   None],
+    ["recordLog",        "output",   None],
+    ["replayLog",        "string",   None],
+    ["voiceMode",        "voicemode", None],
+]
+EYE_KEYS  = 17
+KEY_INDEX = {k[0]: i for i, k in enumerate(KEYS)}
+SET_WORDS = (len(KEYS) + 31) // 32
+
+# JSON reading: config files allow // and /* */ comments and trailing
+# commas (the sketch's own parser does), Python's json doesn't.
+TOKENS = re.compile(r'"(?:\\.|[^"\\])*"|//[^\n]*|/\*.*?\*/|,(?=\s*[}\]])', re.S)
+
+def read_json(path):
+    with open(path, "rb") as f:
+        raw = f.read()
+    text = raw.decode("ascii", "replace")
+    def keep(m):
+        t = m.group(0)
+        if t.startswith('"'):
+            return t
+        return re.sub(r"[^\n]", " ", t) # Keep line numbers for errors
+    pairs = []
+    def hook(items):
+        pairs.append(items)
+        return dict(items)
+    doc = json.loads(TOKENS.sub(keep, text), object_pairs_hook=hook)
+    dups = []
+    for items in pairs:
+        names = [k for k, v in items]
+        dups += sorted(set(k for k in names if names.count(k) > 1))
+    return doc, len(raw), dups
+
+def fnv1a(data):
+    h = 2166136261
+    for b in data:
+        h = ((h ^ b) * 16777619) & 0xFFFFFFFF
+    return h
+
+def strtol(s):
+    # C strtol(s, NULL, 0): leading part only, 0 if none
+    m = re.match(r"\s*([+-]?)(0[xX][0-9a-fA-F]+|0[0-7]*|[1-9][0-9]*)", s)
+    if not m:
+        return 0
+    n = m.group(2)
+    if n[:2].lower() == "0x":
+        v = int(n, 16)
+    elif n.startswith("0"):
+        v = int(n, 8)
+    else:
+        v = int(n)
+    return -v if m.group(1) == "-" else v
+
+def c_int(f):
+    # C (int) cast of a float, truncates toward zero
+    return int(f)
+
+def bswap16(v):
+    v &= 0xFFFF
+    return ((v & 0xFF) << 8) | (v >> 8)
+
+def is_int(v):
+    return isinstance(v, int) and not isinstance(v, bool)
+
+def is_number(v):
+    return is_int(v) or isinstance(v, float)
+
+def dwim(v):
+    # Same guesses as dwim() in file.cpp
+    if is_int(v):
+        return v
+    if isinstance(v, float):
+        return c_int(v + 0.5)
+    if isinstance(v, str):
+        if len(v) == 6 and v[:2].lower() == "0x":
+            return bswap16(strtol(v))
+        return strtol(v)
+    if len(v) >= 3:
+        cc = []
+        for c in v[:3]:
+            if is_int(c):
+                n = c
+            elif isinstance(c, float):
+                n = c_int(c * 255.999)
+            elif isinstance(c, str):
+                n = strtol(c)
+            else:
+                n = 0
+            cc.append(min(max(n, 0), 255))
+        return bswap16(((cc[0] & 0xF8) << 8) | ((cc[1] & 0xFC) << 3) | (cc[2] >> 3))
+    c = v[0]
+    if isinstance(c, str):
+        return strtol(c)
+    if isinstance(c, float):
+        return c_int(c)
+    if is_int(c):
+        return c
+    return 0
+
+WAVEFORMS = [("sq", 1), ("si", 2), ("t", 3), ("sa", 4)]
+
+def resolve(kind, v):
+    # Returns ("i" or "f" or "s", value), or None if wrong type
+    if kind == "dwim":
+        if is_number(v) or isinstance(v, str) or (isinstance(v, list) and v):
+            return ("i", dwim(v))
+    elif kind == "int":
+        if is_int(v):
+            return ("i", v)
+    elif kind == "float":
+        if is_number(v):
+            return ("f", float(v))
+    elif kind == "angle":
+        if is_int(v):
+            return ("i", 1023 - (v & 1023))
+        if isinstance(v, float):
+            return ("i", 1023 - (c_int(v * 1024.0) & 1023))
+    elif kind == "spin":
+        if is_number(v):
+            return ("f", v * -1024.0)
+    elif kind == "mirror":
+        if isinstance(v, bool) or is_int(v):
+            return ("i", 1023 if v else 0)
+    elif kind == "bool":
+        if isinstance(v, bool):
+            return ("i", int(v))
+    elif kind in ("string", "dir", "output"):
+        if isinstance(v, str):
+            return ("s", v)
+    elif kind == "waveform":
+        if isinstance(v, str):
+            for prefix, n in WAVEFORMS:
+                if v.lower().startswith(prefix):
+                    return ("i", n)
+            return ("i", 0)
+    elif kind == "voicemode":
+        if isinstance(v, str):
+            return ("i", 1 if v.lower().startswith("ps") else 0)
+    return None
+
+class Report:
+    def __init__(self, path):
+        self.path   = path
+        self.errors = 0
+    def error(self, msg):
+        self.errors += 1
+        sys.stdout.write("%s: error: %s\n" % (self.path, msg))
+    def warn(self, msg):
+        sys.stdout.write("%s: warning: %s\n" % (self.path, msg))
+
+def check_range(rep, name, kind, limits, v):
+    if limits is None:
+        if kind == "angle":
+            if (is_int(v) and not 0 <= v <= 1023) or (isinstance(v, float) and not 0.0 <= v <= 1.0):
+                rep.warn("%s = %s wraps around (0-1023 or 0.0-1.0)" % (name, v))
+        elif kind == "waveform" and not any(v.lower().startswith(p) for p, n in WAVEFORMS):
+            rep.warn("%s = \"%s\" is not sine, square, triangle or sawtooth; voice modulation off" % (name, v))
+        elif kind == "voicemode" and not (v.lower().startswith("ps") or v.lower() == "resample"):
+            rep.warn("%s = \"%s\" is not resample or psola; using resample" % (name, v))
+        return
+    n = dwim(v) if kind == "dwim" else v
+    if not limits[0] <= n <= limits[1]:
+        rep.warn("%s = %s out of range %s to %s" % (name, v, limits[0], limits[1]))
+
+def compile_section(rep, prefix, obj, nkeys, root):
+    # Returns (set bits, items) for one section
+    bits  = [0] * SET_WORDS
+    items = [None] * len(KEYS)
+    for key, v in obj.items():
+        name = prefix + key
+        k = KEY_INDEX.get(key)
+        if k is None or k >= nkeys:
+            if prefix == "" and key in EYE_NAMES and isinstance(v, dict):
+                continue
+            where = "in eye section" if prefix else "at top level"
+            rep.warn("unknown key %s (%s), ignored by the sketch" % (name, where))
+            continue
+        kind = KEYS[k][1]
+        r = resolve(kind, v)
+        if r is None:
+            rep.error("%s = %s has wrong type for a %s value" % (name, json.dumps(v), kind))
+            continue
+        check_range(rep, name, kind, KEYS[k][2], v)
+        if kind == "string" and root and not os.path.isfile(os.path.join(root, v)):
+            rep.warn("%s file %s not found under %s" % (name, v, root))
+        elif kind == "dir" and root and not os.path.isdir(os.path.join(root, v)):
+            rep.warn("%s directory %s not found under %s" % (name, v, root))
+        bits[k >> 5] |= 1 << (k & 31)
+        items[k] = r
+    return bits, items
+
+def compile_config(path, root):
+    rep = Report(path)
+    try:
+        doc, source_size, dups = read_json(path)
+        with open(path, "rb") as f:
+            source_hash = fnv1a(f.read())
+    except (ValueError, OSError) as e:
+        rep.error(str(e))
+        return rep, None
+    if not isinstance(doc, dict):
+        rep.error("top level is not an object")
+        return rep, None
+    for d in dups:
+        rep.warn("key %s appears more than once, last one is used" % d)
+    sections = [compile_section(rep, "", doc, len(KEYS), root)]
+    for name in EYE_NAMES:
+        sub = doc.get(name, {})
+        if not isinstance(sub, dict):
+            rep.error("%s should be an object" % name)
+            sub = {}
+        sections.append(compile_section(rep, name + ".", sub, EYE_KEYS, root))
+    if rep.errors:
+        return rep, None
+
+    # Fixed part, then strings; string items are byte offsets from start
+    # of file. Identical strings are stored once.
+    fixed   = struct.calcsize("<IHHIII") + len(sections) * (SET_WORDS + len(KEYS)) * 4
+    strings = b""
+    offsets = {}
+    body    = b""
+    for bits, items in sections:
+        body += struct.pack("<%dI" % SET_WORDS, *bits)
+        for item in items:
+            if item is None:
+                body += struct.pack("<i", 0)
+            elif item[0] == "i":
+                body += struct.pack("<i", max(min(item[1], 0x7FFFFFFF), -0x80000000))
+            elif item[0] == "f":
+                body += struct.pack("<f", item[1])
+            else:
+                s = item[1].encode("ascii", "replace")
+                if s not in offsets:
+                    offsets[s] = fixed + len(strings)
+                    strings   += s + b"\0"
+                body += struct.pack("<i", offsets[s])
+    body += strings
+    size  = struct.calcsize("<IHHIII") + len(body)
+    if size > BLOB_MAX:
+        rep.error("compiled size %d is over the sketch's %d byte limit" % (size, BLOB_MAX))
+        return rep, None
+    return rep, struct.pack("<IHHIII", BLOB_MAGIC, BLOB_VERSION, size, source_size,
+                            source_hash, fnv1a(body)) + body
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Check and compile M4 eyes config files")
+    parser.add_argument("files", nargs="+", help="config .eye files")
+    parser.add_argument("--check", action="store_true", help="check only, don't write .bin")
+    parser.add_argument("--root", help="board root for image files (default: two levels above each .eye)")
+    args = parser.parse_args()
+
+    failed = False
+    for path in args.files:
+        root = args.root if args.root else os.path.dirname(os.path.dirname(os.path.abspath(path)))
+        rep, blob = compile_config(path, root)
+        if blob is None:
+            failed = True
+            continue
+        if not args.check:
+            out = os.path.splitext(path)[0] + ".bin"
+            with open(out, "wb") as f:
+                f.write(blob)
+            sys.stdout.write("%s: %d bytes\n" % (out, len(blob)))
+    sys.exit(1 if failed else 0)
@@ -0,0 +1,87 @@
+# -*- coding: utf-8 -*-
+"""
+Print an animation log recorded by mdo_m4_eyes ("recordLog" in the config,
+see animclock.cpp), one line per frame with the inputs read during it.
+
+    python eye_log_dump.py eyelog.bin
+    python eye_log_dump.py --summary eyelog.bin
+
+The format must match AnimLog.h in mdo_m4_eyes.
+
+@author: https://github.com/Mark-MDO47
+"""
+import sys
+import struct
+import argparse
+
+LOG_VERSION = 1 # ANIM_LOG_VERSION in AnimLog.h
+# ANIM_IN_* in globals.h
+CHANNELS = ["time", "light", "boop", "buttons", "pir", "heatx", "heaty", "heatmag",
+            "user"]
+FLOAT_CHANNELS = ("heatx", "heaty", "heatmag") # Sent with animInputFloat()
+
+def read_log(data):
+    # Returns seed, eye count, list of (eye, time, [(channel, value)...]).
+    # Inputs read before the first frame are under eye None, time 0.
+    if len(data) < 10 or data[:4] != b"EYRL":
+        raise ValueError("not an animation log")
+    if data[4] != LOG_VERSION:
+        raise ValueError("log version %d, expected %d" % (data[4], LOG_VERSION))
+    eyes = data[5]
+    seed = struct.unpack_from("<I", data, 6)[0]
+    frames = [[None, 0, []]]
+    pos, t = 10, 0
+    while pos < len(data):
+        tag = data[pos]
+        pos += 1
+        v, shift = 0, 0
+        while True:
+            if pos >= len(data):
+                return seed, eyes, frames # Cut off mid-record
+            b = data[pos]
+            pos += 1
+            v |= (b & 0x7F) << shift
+            shift += 7
+            if not b & 0x80:
+                break
+        v &= 0xFFFFFFFF
+        if tag & 0xF0 == 0x10:
+            t = (t + v) & 0xFFFFFFFF
+            frames.append([tag & 0x0F, t, []])
+        elif tag & 0xF0 == 0x20:
+            ch = tag & 0x0F
+            name = CHANNELS[ch] if ch < len(CHANNELS) else "ch%d" % ch
+            v = (v >> 1) ^ -(v & 1) # Zigzag
+            if name in FLOAT_CHANNELS:
+                v = struct.unpack("<f", struct.pack("<i", v))[0]
+            frames[-1][2].append((name, v))
+        else:
+            raise ValueError("bad tag 0x%02X at byte %d" % (tag, pos - 1))
+    return seed, eyes, frames
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Print an mdo_m4_eyes animation log")
+    parser.add_argument("log", help="log file (recordLog in config)")
+    parser.add_argument("--summary", action="store_true", help="totals only")
+    args = parser.parse_args()
+    with open(args.log, "rb") as f:
+        data = f.read()
+    try:
+        seed, eyes, frames = read_log(data)
+    except ValueError as e:
+        sys.exit("%s: %s" % (args.log, e))
+    print("seed 0x%08X, %d eye(s), %d bytes" % (seed, eyes, len(data)))
+    counts = {}
+    for eye, t, inputs in frames:
+        for name, v in inputs:
+            counts[name] = counts.get(name, 0) + 1
+        if not args.summary and (eye is not None or inputs):
+            where = "setup" if eye is None else "eye %d %10.3f ms" % (eye, t / 1000.0)
+            print("%s %s" % (where, " ".join("%s=%s" % (n, v) for n, v in inputs)))
+    n = len(frames) - 1
+    if n > 1:
+        span = (frames[-1][1] - frames[1][1]) & 0xFFFFFFFF
+        print("%d frames over %.2f s%s" % (n, span / 1e6,
+            (", %.1f frames/s" % ((n - 1) * 1e6 / span)) if span else ""))
+    for name in sorted(counts):
+        print("%-8s %d readings" % (name, counts[name]))
@@ -0,0 +1,110 @@
+# -*- coding: utf-8 -*-
+"""
+Make eyelid pose images for mdo_m4_eyes from an eye's upper and lower
+eyelid images.
+
+    python eye_pose_make.py ../mdo_m4_eyes/eyes/hazel
+
+Reads upper.bmp and lower.bmp in the directory (or --upper / --lower)
+and writes poses/squint.bmp, poses/sleepy.bmp and poses/surprise.bmp.
+A pose image is 1-bit, white where the eye shows; set "eyelidPoses" in
+the config to the poses directory (e.g. "hazel/poses") and user code can
+move the lids to a pose by name (see eyelids.cpp).
+
+Each pose moves the open lid edges a fraction of the way toward where
+the closed lids meet (negative = away from it, clipped to the image).
+Edit POSES or draw your own; any 1-bit BMP in the directory is a pose.
+
+@author: https://github.com/Mark-MDO47
+"""
+import os
+import struct
+import argparse
+
+# Name, upper lid fraction, lower lid fraction
+POSES = [
+    ["squint",   0.45,  0.45],
+    ["sleepy",   0.60,  0.00],
+    ["surprise", -0.25, -0.15],
+]
+
+def read_bmp1(path):
+    # Returns width, height, rows (top-down lists of 0/1, 1 = white)
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:2] != b"BM":
+        raise ValueError("%s: not a BMP" % path)
+    offset = struct.unpack_from("<I", data, 10)[0]
+    width, height, planes, depth, compression = struct.unpack_from("<iiHHI", data, 18)
+    if depth != 1 or compression != 0:
+        raise ValueError("%s: not an uncompressed 1-bit BMP" % path)
+    hsize = struct.unpack_from("<I", data, 14)[0]
+    pal   = [struct.unpack_from("<I", data, 14 + hsize + i * 4)[0] & 0xFFFFFF for i in range(2)]
+    white = 1 if pal[1] > pal[0] else 0 # Same test as loadEyelid()
+    stride = (width + 31) // 32 * 4
+    rows = []
+    for r in range(abs(height)):
+        row = data[offset + r * stride:offset + (r + 1) * stride]
+        rows.append([1 if ((row[x >> 3] >> (7 - (x & 7))) & 1) == white else 0 for x in range(width)])
+    if height > 0:
+        rows.reverse() # Bottom-up file
+    return width, abs(height), rows
+
+def write_bmp1(path, width, rows):
+    height = len(rows)
+    stride = (width + 31) // 32 * 4
+    pixels = bytearray()
+    for row in reversed(rows): # Bottom-up
+        line = bytearray(stride)
+        for x, v in enumerate(row):
+            if v:
+                line[x >> 3] |= 0x80 >> (x & 7)
+        pixels += line
+    header = struct.pack("<2sIHHI", b"BM", 62 + len(pixels), 0, 0, 62)
+    info   = struct.pack("<IiiHHIIiiII", 40, width, height, 1, 1, 0, len(pixels), 2835, 2835, 2, 2)
+    with open(path, "wb") as f:
+        f.write(header + info + struct.pack("<II", 0, 0xFFFFFF) + pixels)
+
+def column_span(rows, x):
+    # First and last white row in column x, or None
+    ys = [y for y in range(len(rows)) if rows[y][x]]
+    return (ys[0], ys[-1]) if ys else None
+
+def make_poses(upper_path, lower_path, out_dir):
+    w, h, upper = read_bmp1(upper_path)
+    w2, h2, lower = read_bmp1(lower_path)
+    if (w, h) != (w2, h2):
+        raise ValueError("upper and lower eyelid images differ in size")
+    # Per column, top-down rows: open eye shows from top to bottom, closed
+    # lids meet at meet (no lid data = no lid in that column)
+    top, bottom, meet = [], [], []
+    for x in range(w):
+        u, l = column_span(upper, x), column_span(lower, x)
+        t = u[0] if u else 0
+        b = l[1] if l else h - 1
+        m = ((u[1] if u else h // 2) + (l[0] if l else h // 2)) / 2.0
+        top.append(t)
+        bottom.append(b)
+        meet.append(m)
+    os.makedirs(out_dir, exist_ok=True)
+    for name, uf, lf in POSES:
+        rows = [[0] * w for y in range(h)]
+        for x in range(w):
+            t = top[x] + (meet[x] - top[x]) * uf
+            b = bottom[x] - (bottom[x] - meet[x]) * lf
+            for y in range(max(0, int(round(t))), min(h - 1, int(round(b))) + 1):
+                rows[y][x] = 1
+        path = os.path.join(out_dir, name + ".bmp")
+        write_bmp1(path, w, rows)
+        print("%s" % path)
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Make eyelid pose images from eyelid images")
+    parser.add_argument("eyedir", help="eye directory with upper.bmp and lower.bmp")
+    parser.add_argument("--upper", help="upper eyelid image (default EYEDIR/upper.bmp)")
+    parser.add_argument("--lower", help="lower eyelid image (default EYEDIR/lower.bmp)")
+    parser.add_argument("--out", help="output directory (default EYEDIR/poses)")
+    args = parser.parse_args()
+    make_poses(args.upper or os.path.join(args.eyedir, "upper.bmp"),
+               args.lower or os.path.join(args.eyedir, "lower.bmp"),
+               args.out or os.path.join(args.eyedir, "poses"))
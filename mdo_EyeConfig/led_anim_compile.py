@@ -0,0 +1,117 @@
+# -*- coding: utf-8 -*-
+"""
+Check NeoPixel animation files (leds.json) and compile them to C tables
+for mdo_m4_eyes.
+
+    python led_anim_compile.py leds.json
+    python led_anim_compile.py --c leds.json > tables.txt
+
+Each top-level object is an animation: times in ms (from "0", in order)
+with [R, G, B] colors, and optionally "spread" (ms each pixel runs
+behind the one before). Reports what the sketch would ignore or cut
+(warnings) and files it can't read at all (errors), then lists the
+animations. With --c it prints them instead as const ledKey /
+ledAnim tables (LedAnim.h) for building into a user*.cpp, as
+user_touchneopixels.cpp's are. Exit status is 1 if there were errors.
+
+The limits and what's ignored must match neopixels.cpp in mdo_m4_eyes
+(pixelsHandler(), PIXELS_ANIMS, PIXELS_KEYS).
+
+@author: https://github.com/Mark-MDO47
+"""
+import sys
+import re
+import argparse
+from eye_config_compile import read_json, is_int, Report
+
+PIXELS_ANIMS = 8  # In neopixels.cpp
+PIXELS_KEYS  = 96
+NAME_MAX     = 23 # CFG_KEYLEN - 1
+
+def compile_anims(path):
+    # Returns (report, [(name, spread, [(ms, r, g, b), ...]), ...])
+    rep = Report(path)
+    try:
+        doc, source_size, dups = read_json(path)
+    except (ValueError, OSError) as e:
+        rep.error(str(e))
+        return rep, []
+    if not isinstance(doc, dict):
+        rep.error("top level is not an object")
+        return rep, []
+    for d in dups:
+        rep.warn("key %s appears more than once, last one is used" % d)
+    anims = []
+    total = 0
+    for name, obj in doc.items():
+        if not isinstance(obj, dict):
+            rep.warn("%s is not an object of keyframes, ignored" % name)
+            continue
+        if len(name) > NAME_MAX:
+            rep.warn("%s: name longer than %d characters is cut" % (name, NAME_MAX))
+        spread = 0
+        keys   = []
+        for key, v in obj.items():
+            where = "%s.%s" % (name, key)
+            if key == "spread":
+                if not is_int(v):
+                    rep.warn("%s = %s is not a whole number, ignored" % (where, v))
+                else:
+                    spread = max(0, min(v, 65535))
+                continue
+            if not re.fullmatch(r"[0-9]+", key) or int(key) > 65535:
+                rep.warn("%s: not a time (0-65535 ms), ignored" % where)
+                continue
+            ms = int(key)
+            if not (isinstance(v, list) and len(v) >= 3 and all(is_int(c) for c in v[:3])):
+                rep.warn("%s = %s is not [R, G, B], ignored" % (where, v))
+                continue
+            if (not keys and ms) or (keys and ms <= keys[-1][0]):
+                rep.warn("%s: times must start at 0 and go up, ignored" % where)
+                continue
+            if any(not 0 <= c <= 255 for c in v[:3]):
+                rep.warn("%s = %s is cut to 0-255" % (where, v))
+            if total + len(keys) >= PIXELS_KEYS:
+                rep.warn("%s: over %d keyframes in all, ignored" % (where, PIXELS_KEYS))
+                continue
+            keys.append((ms,) + tuple(max(0, min(c, 255)) for c in v[:3]))
+        if not keys:
+            rep.warn("%s has no keyframes, ignored" % name)
+            continue
+        if len(anims) >= PIXELS_ANIMS:
+            rep.warn("%s: over %d animations, ignored" % (name, PIXELS_ANIMS))
+            continue
+        total += len(keys)
+        anims.append((name[:NAME_MAX], spread, keys))
+    return rep, anims
+
+def c_name(name):
+    n = re.sub(r"[^0-9A-Za-z_]", "_", name)
+    return ("_" + n) if n[0].isdigit() else n
+
+def c_tables(path, anims):
+    out = ["// From %s by mdo_EyeConfig/led_anim_compile.py" % path]
+    for name, spread, keys in anims:
+        n = c_name(name)
+        out.append("static const ledKey %sKeys[] = {" % n)
+        for ms, r, g, b in keys:
+            out.append("  { %5d, %3d, %3d, %3d }," % (ms, r, g, b))
+        out.append("};")
+        out.append("static const ledAnim %s = { %sKeys, %d, %d };" % (n, n, len(keys), spread))
+    return "\n".join(out) + "\n"
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Check and compile NeoPixel animation files")
+    parser.add_argument("file", help="leds.json")
+    parser.add_argument("--c", action="store_true", help="print C tables")
+    args = parser.parse_args()
+
+    rep, anims = compile_anims(args.file)
+    if not rep.errors:
+        if args.c:
+            sys.stdout.write(c_tables(args.file, anims))
+        else:
+            for name, spread, keys in anims:
+                sys.stdout.write("%-24s %3d keyframes, %6d ms%s\n" % (name, len(keys), keys[-1][0],
+                    (", spread %d ms" % spread) if spread else ""))
+    sys.exit(1 if rep.errors else 0)
@@ -0,0 +1,309 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_Simul8
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+//
+// Records an animation log (mdo_m4_eyes/AnimLog, used by animclock.cpp
+// for "recordLog" and "replayLog") on a computer and reads it back with
+// the same code, checking the bytes against the format in AnimLog.h.
+//
+//   g++ -O2 -g -fsanitize=address,undefined -I../mdo_m4_eyes Simul8_animLog.cpp ../mdo_m4_eyes/AnimLog.cpp -o animLog
+//   ./animLog [--seed 47] [--sessions 200] [--write eyelog.bin] [eyelog.bin ...]
+//
+// Each session records as the board does: header, then frames for two
+// eyes about 16 ms apart (some much further, some with the clock
+// wrapping) with inputs on every channel in between, into a 16 KB
+// buffer until it's full. Input values include the extremes and float
+// bits, as animInputFloat() sends them. Then it checks:
+//   - the bytes, decoded here from AnimLog.h's description alone (as
+//     eye_log_dump.py does), are the records written;
+//   - reading back gives every record, and asking for anything other
+//     than what's next fails and reads nothing, as replay's "out of
+//     step" relies on; at the end ended() is set;
+//   - a write that doesn't fit fails and writes nothing;
+//   - a log cut short (a file copied while recording) reads the records
+//     before the cut and then stops, and a log with bytes changed reads
+//     without going outside the buffer (the sanitizers catch that).
+// --write saves the first session's log, to try with eye_log_dump.py or
+// replayLog. Log files given are read with AnimLog, written again and
+// compared with the file byte for byte.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "AnimLog.h"
+#include "XorShift.h"
+
+#define LOG_BYTES 16384 // ANIM_LOG_BYTES in animclock.cpp
+#define EYES      2
+#define CHANNELS  9     // ANIM_IN_* in globals.h
+#define HEADER    10
+
+typedef struct {
+  bool     frame;
+  uint8_t  which;  // Eye or channel
+  uint32_t value;  // Frame time or input value
+} record;
+
+// Frame and input tags and varints, read straight from the bytes
+static bool decode(const uint8_t *buf, uint32_t len, uint32_t *seed, uint8_t *eyes,
+                   std::vector<record> *out) {
+  if((len < HEADER) || memcmp(buf, "EYRL", 4) || (buf[4] != ANIM_LOG_VERSION)) return false;
+  *eyes = buf[5];
+  *seed = buf[6] | (buf[7] << 8) | (buf[8] << 16) | ((uint32_t)buf[9] << 24);
+  uint32_t pos = HEADER, t = 0;
+  while(pos < len) {
+    uint8_t  tag = buf[pos++];
+    uint32_t v = 0;
+    for(int shift=0; ; shift += 7) {
+      if((pos >= len) || (shift > 28)) return false;
+      uint8_t b = buf[pos++];
+      v |= (uint32_t)(b & 0x7F) << shift;
+      if(!(b & 0x80)) break;
+    }
+    if((tag & 0xF0) == 0x10)      out->push_back({ true, (uint8_t)(tag & 0x0F), t += v });
+    else if((tag & 0xF0) == 0x20) out->push_back({ false, (uint8_t)(tag & 0x0F), (v >> 1) ^ -(v & 1) });
+    else return false;
+  }
+  return true;
+}
+
+// Reads whatever comes next, as replay would if it knew
+static bool readNext(AnimLog *log, uint8_t eyes, record *r) {
+  for(uint8_t e=0; e<eyes; e++) {
+    if(log->readFrame(e, &r->value)) {
+      *r = { true, e, r->value };
+      return true;
+    }
+  }
+  for(uint8_t c=0; c<16; c++) {
+    int32_t v;
+    if(log->readInput(c, &v)) {
+      *r = { false, c, (uint32_t)v };
+      return true;
+    }
+  }
+  return false;
+}
+
+static int32_t inputValue(XorShift *rnd, uint8_t channel) {
+  static const int32_t extremes[] = { 0, 1, -1, 63, -64, 64, -65, 0x7FFFFFFF, (int32_t)0x80000000 };
+  if(!rnd->random(8)) return extremes[rnd->random(sizeof extremes / sizeof extremes[0])];
+  if(channel >= 5 && channel <= 7) { // Heat sensor floats
+    float   f = (rnd->random(20001) - 10000) / 100.0f;
+    int32_t i;
+    memcpy(&i, &f, sizeof i);
+    return i;
+  }
+  return rnd->random(-1024, 1024);
+}
+
+static bool same(const record &a, const record &b) {
+  return (a.frame == b.frame) && (a.which == b.which) && (a.value == b.value);
+}
+
+// One recorded session; returns the number of problems
+static int session(XorShift *rnd, uint8_t *buf, uint32_t *len, bool print) {
+  AnimLog             log;
+  std::vector<record> wrote, got;
+  uint32_t            seed = (uint32_t)rnd->random(0x7FFFFFFF) * 2 + rnd->random(2), t = rnd->random(0x7FFFFFFF);
+  int                 bad = 0;
+
+  memset(buf, 0xA5, LOG_BYTES); // Not zeros, so stale bytes would show
+  log.begin(buf, LOG_BYTES, 0);
+  if(!log.header(seed, EYES) || (log.used() != HEADER)) bad++;
+  if(log.header(seed, EYES)) bad++; // Only at the start
+  for(uint8_t i=0; i<2; i++) { // setup()'s time reads, before a frame
+    int32_t v = rnd->random(0x7FFFFFFF);
+    if(!log.input(0, v)) break;
+    wrote.push_back({ false, 0, (uint32_t)v });
+  }
+  for(bool full=false; !full; ) {
+    for(uint8_t e=0; (e<EYES) && !full; e++) {
+      switch(rnd->random(500)) {
+       case 0:  t += (uint32_t)rnd->random(0x7FFFFFFF) * 2; break; // Far ahead, may wrap
+       case 1:  break;                                    // Same time
+       default: t += 15000 + rnd->random(2000); break;    // ~60 fps
+      }
+      uint32_t before = log.used();
+      if(!log.frame(e, t)) {
+        full = true;
+        if(log.used() != before) bad++;
+        break;
+      }
+      wrote.push_back({ true, e, t });
+      for(uint8_t n=rnd->random(4); n && !full; n--) {
+        uint8_t c = rnd->random(CHANNELS);
+        int32_t v = inputValue(rnd, c);
+        before    = log.used();
+        if(!log.input(c, v)) {
+          full = true;
+          if(log.used() != before) bad++;
+        } else {
+          wrote.push_back({ false, c, (uint32_t)v });
+        }
+      }
+    }
+  }
+  *len = log.used();
+  // Nothing past the end touched, and the end within a record of full
+  for(uint32_t i=*len; i<LOG_BYTES; i++) if(buf[i] != 0xA5) { bad++; break; }
+  if(LOG_BYTES - *len >= 6) bad++;
+
+  // The bytes, by the format alone
+  uint32_t s;
+  uint8_t  eyes;
+  if(!decode(buf, *len, &s, &eyes, &got) || (s != seed) || (eyes != EYES) ||
+     (got.size() != wrote.size())) {
+    bad++;
+  } else {
+    for(size_t i=0; i<got.size(); i++) if(!same(got[i], wrote[i])) { bad++; break; }
+  }
+
+  // Read back; anything but what's next must fail and not move
+  log.begin(buf, *len, *len);
+  if(!log.readHeader(&s, &eyes) || (s != seed) || (eyes != EYES)) bad++;
+  uint32_t frames = 0, wrongAsk = 0;
+  for(const record &r : wrote) {
+    uint32_t at = log.used(), tv;
+    int32_t  iv;
+    if(r.frame ? (log.readInput(r.which, &iv) || log.readFrame(r.which ^ 1, &tv))
+               : (log.readFrame(0, &tv) || log.readInput((r.which + 1) % CHANNELS, &iv))) wrongAsk++;
+    if(log.used() != at) wrongAsk++;
+    bool ok = r.frame ? (log.readFrame(r.which, &tv) && (tv == r.value))
+                      : (log.readInput(r.which, &iv) && ((uint32_t)iv == r.value));
+    if(!ok) {
+      bad++;
+      break;
+    }
+    frames += r.frame;
+  }
+  if(!log.ended() || (log.frames() != frames) || log.readFrame(0, &s)) bad++;
+  bad += wrongAsk;
+
+  if(print) {
+    printf("seed 0x%08X: %d records, %d frames in %d bytes (%.2f bytes a frame with its inputs)\n",
+      seed, (int)wrote.size(), frames, *len, (*len - HEADER) / (double)frames);
+  }
+
+  // Cut short: the records before the cut, then nothing
+  for(int c=0; c<40; c++) {
+    uint32_t cut = (c < 24) ? c : HEADER + rnd->random(*len - HEADER);
+    log.begin(buf, cut, cut);
+    if(!log.readHeader(&s, &eyes)) {
+      if(cut >= HEADER) bad++;
+      continue;
+    }
+    size_t  n = 0;
+    record  r;
+    while(readNext(&log, EYES, &r)) {
+      if((n >= wrote.size()) || !same(r, wrote[n])) {
+        bad++;
+        break;
+      }
+      n++;
+    }
+    if(log.used() > cut) bad++;
+  }
+
+  // Bytes changed: must stay in the buffer
+  std::vector<uint8_t> copy(buf, buf + *len);
+  for(int c=0; c<40; c++) {
+    std::vector<uint8_t> hit = copy;
+    for(int n=1+rnd->random(8); n; n--) hit[rnd->random(hit.size())] ^= 1 << rnd->random(8);
+    log.begin(hit.data(), hit.size(), hit.size());
+    record r;
+    if(log.readHeader(&s, &eyes)) while(readNext(&log, 16, &r)) ;
+    if(log.used() > hit.size()) bad++;
+  }
+  return bad;
+}
+
+// A log file: read it all with AnimLog, write it again, compare
+static bool checkFile(const char *name) {
+  FILE *f = fopen(name, "rb");
+  if(!f) {
+    printf("%s: can't open\n", name);
+    return false;
+  }
+  std::vector<uint8_t> in(LOG_BYTES + 1);
+  in.resize(fread(in.data(), 1, in.size(), f));
+  fclose(f);
+  if(in.size() > LOG_BYTES) printf("%s: longer than the board reads, first %d bytes only\n", name, LOG_BYTES);
+  if(in.size() > LOG_BYTES) in.resize(LOG_BYTES);
+
+  AnimLog  log, out;
+  uint32_t seed;
+  uint8_t  eyes;
+  std::vector<uint8_t> again(LOG_BYTES);
+  log.begin(in.data(), in.size(), in.size());
+  if(!log.readHeader(&seed, &eyes)) {
+    printf("%s: not a version %d animation log\n", name, ANIM_LOG_VERSION);
+    return false;
+  }
+  out.begin(again.data(), again.size(), 0);
+  out.header(seed, eyes);
+  record   r;
+  uint32_t inputs = 0;
+  while(readNext(&log, eyes, &r)) {
+    if(r.frame) {
+      out.frame(r.which, r.value);
+    } else {
+      out.input(r.which, (int32_t)r.value);
+      inputs++;
+    }
+  }
+  bool ok = log.ended() && (out.used() == in.size()) && !memcmp(again.data(), in.data(), in.size());
+  printf("%s: seed 0x%08X, %d eye(s), %d frames, %d inputs, %d bytes\n", name, seed, eyes,
+    log.frames(), inputs, (int)in.size());
+  if(!log.ended()) printf("  stops at byte %d, tag 0x%02X isn't a frame or input\n", log.used(), in[log.used()]);
+  else if(!ok)     printf("  doesn't write back the same\n");
+  return ok;
+}
+
+int main(int argc, char *argv[]) {
+  uint32_t                  seed = 47;
+  int                       sessions = 200;
+  const char               *write = NULL;
+  std::vector<const char *> files;
+  for(int i=1; i<argc; i++) {
+    if(!strcmp(argv[i], "--seed") && (i + 1 < argc))          seed     = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "--sessions") && (i + 1 < argc)) sessions = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "--write") && (i + 1 < argc))    write    = argv[++i];
+    else                                                      files.push_back(argv[i]);
+  }
+  XorShift rnd(seed);
+  uint8_t  buf[LOG_BYTES];
+  uint32_t len;
+  int      bad = 0, failed = 0;
+
+  // A typical frame and small inputs are as short as AnimLog.h says
+  AnimLog log;
+  log.begin(buf, sizeof buf, 0);
+  log.header(0, 1);
+  log.frame(0, 16000);
+  log.input(1, -1);
+  if((log.used() != HEADER + 3 + 2) || (buf[HEADER] != 0x10) || (buf[HEADER + 3] != 0x21) ||
+     (buf[HEADER + 4] != 0x01)) {
+    printf("16 ms frame and input -1 are %d bytes, not 5\n", log.used() - HEADER);
+    bad++;
+  }
+
+  for(int n=0; n<sessions; n++) {
+    int b = session(&rnd, buf, &len, !n);
+    if(b) failed++;
+    bad += b;
+    if(!n && write) {
+      FILE *f = fopen(write, "wb");
+      if(f && (fwrite(buf, 1, len, f) == len)) printf("Wrote %s\n", write);
+      else                                     printf("Can't write %s\n", write);
+      if(f) fclose(f);
+    }
+  }
+  printf("%d sessions, %d with problems (%d problems)\n", sessions, failed, bad);
+  for(const char *name : files) if(!checkFile(name)) bad++;
+  printf("%s\n", bad ? "FAILED" : "All ok");
+  return bad ? 1 : 0;
+}
@@ -0,0 +1,164 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_Simul8
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+//
+// Times the streaming config reader (mdo_m4_eyes/configparse.cpp) on a
+// computer and throws mutated config files at it, to check a broken file
+// on the board's filesystem can only ever be reported as an error.
+//
+//   g++ -O2 -g -fsanitize=address,undefined -I../mdo_m4_eyes Simul8_configFuzz.cpp ../mdo_m4_eyes/configparse.cpp -o configFuzz
+//   ./configFuzz [--mutations 20000] [--seed 47] ../mdo_m4_eyes/eyes/*/config.eye
+//
+// For each file it first parses it as is (it must parse) and prints the
+// values found and how long a parse takes, read CFG_BUFSIZE bytes at a
+// time from memory; the board's SD reads and slower CPU add to that (and
+// the sanitizers slow it here, leave them off to time it).
+// Then --mutations copies of it, each with a few random edits: bytes
+// flipped, dropped or inserted (mostly JSON punctuation), a piece
+// repeated or the end cut off. Each must come back as parsed or as an
+// error on a line that's in the file, with every value the handler sees
+// inside its limits (key and section under CFG_KEYLEN, strings under
+// CFG_STRLEN or CFG_ITEMLEN, a known type) and without reading past the
+// end over and over. The sanitizers catch anything out of bounds.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <string>
+#include <vector>
+#include "ConfigParse.h"
+#include "XorShift.h"
+
+typedef struct {
+  const uint8_t *data;
+  uint32_t       len, pos;
+  uint32_t       endReads;  // Reads after the end
+} memFile;
+
+static int memRead(void *ctx, uint8_t *buf, int n) {
+  memFile *m = (memFile *)ctx;
+  if(m->pos >= m->len) {
+    m->endReads++;
+    return 0;
+  }
+  if((uint32_t)n > m->len - m->pos) n = m->len - m->pos;
+  memcpy(buf, m->data + m->pos, n);
+  m->pos += n;
+  return n;
+}
+
+static uint32_t values, wrong;
+
+static bool fits(const cfgScalar &s, size_t maxLen) {
+  if(s.type == CFG_STRING) return s.s && (strlen(s.s) < maxLen);
+  return (s.type >= CFG_NULL) && (s.type <= CFG_STRING);
+}
+
+static void checkValue(const char *section, const char *key, cfgValue *v) {
+  bool ok = key && (strlen(key) < CFG_KEYLEN) && (!section || (strlen(section) < CFG_KEYLEN));
+  if(v->type == CFG_ARRAY) {
+    for(uint8_t i=0; ok && (i<v->count) && (i<CFG_ITEMS); i++) ok = fits(v->item[i], CFG_ITEMLEN);
+  } else {
+    ok = ok && (v->count == 1) && (v->type == v->item[0].type) && fits(v->item[0], CFG_STRLEN);
+  }
+  if(!ok) wrong++;
+  values++;
+}
+
+static bool parse(const std::string &text, int *line, const char **error, uint32_t *endReads) {
+  memFile m = { (const uint8_t *)text.data(), (uint32_t)text.size(), 0, 0 };
+  bool    ok = cfgParse(memRead, &m, checkValue);
+  *error    = cfgError(line);
+  *endReads = m.endReads;
+  return ok;
+}
+
+static std::string mutate(const std::string &in, XorShift *rnd) {
+  static const char punct[] = "{}[]\":,/*\\\n -.0123456789eEtfn";
+  std::string s = in;
+  int edits = 1 + rnd->random(4);
+  for(int e=0; e<edits; e++) {
+    uint32_t at = s.empty() ? 0 : rnd->random(s.size());
+    switch(rnd->random(6)) {
+     case 0: if(!s.empty()) s[at] ^= 1 << rnd->random(8); break;     // Flip a bit
+     case 1: if(!s.empty()) s.erase(at, 1 + rnd->random(8)); break; // Drop bytes
+     case 2: s.insert(at, 1, punct[rnd->random(sizeof punct - 1)]); break;
+     case 3: s.insert(at, 1, (char)rnd->random(256)); break;        // Any byte
+     case 4: s.insert(at, s.substr(at, 1 + rnd->random(200))); break; // Repeat
+     case 5: s.resize(at); break;                                   // Cut off
+    }
+  }
+  return s;
+}
+
+static std::string readFile(const char *name) {
+  std::string s;
+  FILE       *f = fopen(name, "rb");
+  if(!f) return s;
+  char   buf[4096];
+  size_t n;
+  while((n = fread(buf, 1, sizeof buf, f)) > 0) s.append(buf, n);
+  fclose(f);
+  return s;
+}
+
+int main(int argc, char *argv[]) {
+  int                       mutations = 20000;
+  uint32_t                  seed = 47;
+  std::vector<const char *> files;
+  for(int i=1; i<argc; i++) {
+    if(!strcmp(argv[i], "--mutations") && (i + 1 < argc)) mutations = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "--seed") && (i + 1 < argc)) seed = atoi(argv[++i]);
+    else                                                  files.push_back(argv[i]);
+  }
+  if(files.empty()) {
+    printf("Give config files, e.g. ../mdo_m4_eyes/eyes/*/config.eye\n");
+    return 1;
+  }
+  XorShift rnd(seed);
+  bool     allOk = true;
+  for(const char *name : files) {
+    std::string text = readFile(name);
+    int         line;
+    const char *error;
+    uint32_t    endReads;
+
+    values = wrong = 0;
+    bool ok = parse(text, &line, &error, &endReads);
+    uint32_t found = values;
+    if(!ok) {
+      printf("%s: doesn't parse, line %d: %s\n", name, line, error);
+      allOk = false;
+      continue;
+    }
+    int     reps  = 2000;
+    clock_t start = clock();
+    for(int r=0; r<reps; r++) parse(text, &line, &error, &endReads);
+    double us = (clock() - start) * 1e6 / CLOCKS_PER_SEC / reps;
+
+    uint32_t errors = 0, badLine = 0, spins = 0;
+    values = wrong = 0;
+    for(int m=0; m<mutations; m++) {
+      std::string bad = mutate(text, &rnd);
+      int         badLines = 1;
+      for(char c : bad) badLines += (c == '\n');
+      if(!parse(bad, &line, &error, &endReads)) {
+        errors++;
+        if(!error || (line < 1) || (line > badLines)) badLine++;
+      }
+      if(endReads > 16) spins++; // Stuck at the end
+    }
+    bool good = !wrong && !badLine && !spins;
+    printf("%s: %d bytes, %d values, %.1f us a parse (%.1f MB/s); %d mutations, %d errors%s\n",
+      name, (int)text.size(), found, us, text.size() / us, mutations, errors, good ? "" : ":");
+    if(wrong)   printf("  %d values out of limits\n", wrong);
+    if(badLine) printf("  %d errors with no message or on a line not in the file\n", badLine);
+    if(spins)   printf("  %d kept reading past the end\n", spins);
+    if(!good) allOk = false;
+  }
+  printf("%s\n", allOk ? "All ok" : "FAILED");
+  return allOk ? 0 : 1;
+}
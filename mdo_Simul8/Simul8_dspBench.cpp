@@ -0,0 +1,95 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_Simul8
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+//
+// Checks and times the voice changer's DSP kernels (mdo_m4_eyes/VoiceDSP)
+// on a computer, with the same dspBench() the board runs at voice startup.
+//
+//   g++ -O2 -I../mdo_m4_eyes Simul8_dspBench.cpp ../mdo_m4_eyes/VoiceDSP.cpp -o dspBench
+//   ./dspBench [reps]
+//
+// Here the packed kernels run C copies of the M4's DSP instructions, so
+// they're slower than plain C; what matters is that every result's the
+// same. On the board ("Voice DSP:" lines on the serial monitor) the times
+// are CPU cycles and packed should win. Besides dspBench()'s data, every
+// kernel is checked at lengths 0-70 and odd and even starting points on
+// random data, since the packed ones handle two or four samples at a time
+// and finish off with plain C.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include "VoiceDSP.h"
+#include "XorShift.h"
+
+static uint32_t nanos(void) {
+  return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#define N 80
+
+// Scalar and packed on random data, lengths and alignments; returns
+// the number of mismatches
+static int sweep(void) {
+  XorShift rnd(47);
+  uint16_t a[N], b[N], o1[N], o2[N];
+  uint8_t  g[N];
+  int      bad = 0;
+  for(int pass=0; pass<200; pass++) {
+    for(int i=0; i<N; i++) {
+      a[i] = rnd.next();
+      b[i] = rnd.next();
+      g[i] = rnd.next();
+    }
+    for(uint16_t n=0; n<=70; n++) {
+      for(uint16_t off=0; off<4; off++) {
+        // Copy
+        memset(o1, 0, sizeof o1); memset(o2, 0, sizeof o2);
+        dspCopy12Scalar(o1 + off, a + off, n);
+        dspCopy12Packed(o2 + off, a + off, n);
+        if(memcmp(o1, o2, sizeof o1)) bad++;
+        // Cross-fade, any start weight, a and b misaligned with each other
+        uint32_t w1 = rnd.next() & 0x1FFFFFF, w2 = w1, step = rnd.next() & 0x3FFFF;
+        dspCrossfadeScalar(o1 + off, a + off, b + 1, n, &w1, step);
+        dspCrossfadePacked(o2 + off, a + off, b + 1, n, &w2, step);
+        if(memcmp(o1, o2, sizeof o1) || (w1 != w2)) bad++;
+        // Gain (on 12-bit samples)
+        for(int i=0; i<N; i++) o1[i] = o2[i] = b[i] >> 4;
+        dspGainScalar(o1 + off, g + (n & 3), n);
+        dspGainPacked(o2 + off, g + (n & 3), n);
+        if(memcmp(o1, o2, sizeof o1)) bad++;
+        // Min/max
+        uint16_t l1 = rnd.next(), h1 = rnd.next(), l2 = l1, h2 = h1;
+        dspMinMaxScalar(a + off, n, &l1, &h1);
+        dspMinMaxPacked(a + off, n, &l2, &h2);
+        if((l1 != l2) || (h1 != h2)) bad++;
+      }
+    }
+  }
+  return bad;
+}
+
+int main(int argc, char *argv[]) {
+  uint16_t reps = (argc > 1) ? atoi(argv[1]) : 1000;
+  static uint16_t scratch[DSP_BENCH_BYTES / 2];
+  dspBenchResult  r[DSP_KERNELS];
+
+#if defined(__ARM_FEATURE_DSP)
+  printf("DSP extension: packed kernels are the real instructions\n");
+#else
+  printf("No DSP extension: packed kernels are C copies of the instructions\n");
+#endif
+  dspBench(r, scratch, nanos, reps);
+  for(int k=0; k<DSP_KERNELS; k++) {
+    printf("%-9s plain %6.2f  packed %6.2f ns/sample  %s\n", r[k].name,
+      (double)r[k].scalar / reps / DSP_BENCH_SAMPLES,
+      (double)r[k].packed / reps / DSP_BENCH_SAMPLES, r[k].same ? "same" : "MISMATCH");
+  }
+  int bad = sweep();
+  printf("Lengths/alignments sweep: %d mismatches\n", bad);
+  return bad ? 1 : 0;
+}
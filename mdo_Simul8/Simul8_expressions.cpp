@@ -0,0 +1,196 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_Simul8
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+//
+// Runs mdo_m4_eyes/expressions.cpp itself on a computer against a made-up
+// clock, as loadConfig(), live reload and user code drive it, and checks
+// the values gaze.cpp and loop() would get each frame.
+//
+//   g++ -O2 -I../mdo_m4_eyes -include Simul8_sketch.h Simul8_expressions.cpp ../mdo_m4_eyes/expressions.cpp ../mdo_m4_eyes/ExpressionBlend.cpp ../mdo_m4_eyes/configparse.cpp -o expressions
+//   ./expressions [--file ../mdo_m4_eyes/eyes/hazel/expressions.eye] [--verbose]
+//
+// Reads --file (it needs "sleepy" as in hazel's) and checks, at 60 frames
+// a second: idle's values from the first frame (1.0 gaze, saccade and
+// blink, 0.5 pupil, 570 mm); a change to sleepy starts where the values
+// are, moves toward its settings and lands on them exactly at its time,
+// with the eyelid pose move to match; a reload with sleepy edited
+// carries on in sleepy with the new values at once, and a reload
+// without it goes back to idle; idle redefined in the file is used from
+// the start. A few temporary .eye files are written in the current
+// directory and removed. --verbose shows the sketch's messages.
+
+#include "ExpressionBlend.h"
+
+hostArcada arcada;
+hostSerial Serial;
+
+// STAND-INS ---------------------------------------------------------------
+
+static uint32_t now = 1000000; // The made-up clock, micros
+
+uint32_t animMicros(void) {
+  return now;
+}
+
+bool fileReady(const char *filename) {
+  return true; // Filesystem's up, arcada.open() decides
+}
+
+static int fileRead(void *ctx, uint8_t *buf, int n) {
+  return ((File *)ctx)->read(buf, n);
+}
+
+bool configParse(File *file, volatile const uint8_t *mem, uint32_t memLen,
+  cfgHandler handler) {
+  return cfgParse(fileRead, file, handler);
+}
+
+// Poses as eyelids.cpp would have them from hazel's poses directory
+static const char *poses[] = { "open", "closed", "sleepy", "squint", "surprise" };
+static int8_t      lastPose     = -1;
+static uint32_t    lastDuration = 0;
+
+int8_t lidPoseFind(const char *name) {
+  for(int8_t p=0; p<(int8_t)(sizeof poses / sizeof poses[0]); p++) {
+    if(!strcmp(name, poses[p])) return p;
+  }
+  return -1;
+}
+
+void lidPoseTo(int8_t e, uint8_t pose, uint32_t duration, uint8_t ease) {
+  lastPose     = pose;
+  lastDuration = duration;
+}
+
+// CHECKS ------------------------------------------------------------------
+
+static const char *paramName[] = { "gaze", "saccade", "blink", "pupil",
+  "pupilMix", "spin", "distance" };
+
+static bool ok = true;
+
+// Compare this frame's values with 'want' (COUNT of them, NAN = any)
+static void expect(const char *what, const float *want, float tolerance) {
+  bool good = true;
+  for(uint8_t p=0; p<ExpressionBlend::COUNT; p++) {
+    if(!isnan(want[p]) && (fabs(exprGet(p) - want[p]) > tolerance)) good = false;
+  }
+  printf("  %-34s %-10s", what, exprName());
+  for(uint8_t p=0; p<ExpressionBlend::COUNT; p++) printf(" %s %.3f", paramName[p], exprGet(p));
+  printf("%s\n", good ? "" : "  WRONG");
+  if(!good) {
+    printf("  %-34s %-10s", "", "expected");
+    for(uint8_t p=0; p<ExpressionBlend::COUNT; p++) {
+      if(isnan(want[p])) printf(" %s   any", paramName[p]);
+      else               printf(" %s %.3f", paramName[p], want[p]);
+    }
+    printf("\n");
+    ok = false;
+  }
+}
+
+static void expectTrue(const char *what, bool cond) {
+  printf("  %-34s %s\n", what, cond ? "ok" : "WRONG");
+  if(!cond) ok = false;
+}
+
+// Frames at 60/sec for 'micros'
+static void run(uint32_t micros) {
+  for(uint32_t end = now + micros; (int32_t)(end - now) > 0; ) {
+    now += 16667;
+    if((int32_t)(now - end) > 0) now = end;
+    exprFrame(now);
+  }
+}
+
+static bool writeFile(const char *name, const char *text) {
+  FILE *f = fopen(name, "w");
+  if(!f) return false;
+  fputs(text, f);
+  fclose(f);
+  return true;
+}
+
+int main(int argc, char *argv[]) {
+  const char *file = "../mdo_m4_eyes/eyes/hazel/expressions.eye";
+  for(int i=1; i<argc; i++) {
+    if(!strcmp(argv[i], "--file") && (i + 1 < argc)) file = argv[++i];
+    else if(!strcmp(argv[i], "--verbose"))            Serial.verbose = true;
+  }
+  FILE *f = fopen(file, "r");
+  if(!f) {
+    printf("Can't read %s\n", file);
+    return 1;
+  }
+  fclose(f);
+
+  const float idle[]   = { 1.0, 1.0, 1.0, 0.5, 0.0, 0.0, 570.0 },
+              sleepy[] = { 0.3, 3.0, 0.5, 0.5, 0.0, 0.0, 570.0 },
+              edited[] = { 0.6, 2.0, 0.5, 0.5, 0.0, 0.0, 570.0 },
+              middle[] = { 0.65, 2.0, 0.75, 0.5, 0.0, 0.0, 570.0 },
+              calm[]   = { 1.0, 1.0, 1.0, 0.5, 0.0, 0.0, 400.0 };
+
+  printf("Startup, %s:\n", file);
+  exprRead(file); // As loadConfig()
+  exprUse();
+  exprFrame(now);
+  expect("first frame is idle", idle, 0.0001);
+  run(1000000);
+  expect("still idle a second later", idle, 0.0001);
+
+  printf("Change to sleepy (2 sec):\n");
+  int8_t x = exprFind("sleepy");
+  expectTrue("sleepy found", x > 0);
+  if(x <= 0) {
+    printf("FAILED\n");
+    return 1;
+  }
+  expectTrue("exprSet(sleepy)", exprSet(x));
+  expectTrue("lids to sleepy pose over 2 sec",
+    (lastPose == lidPoseFind("sleepy")) && (lastDuration == 2000000));
+  exprFrame(now);
+  expect("same frame, not moved yet", idle, 0.0001);
+  run(1000000);
+  expect("halfway", middle, 0.001);
+  run(1000000);
+  expect("at 2 sec, there", sleepy, 0.0001);
+  run(500000);
+  expect("and stays", sleepy, 0.0001);
+  expectTrue("exprSet(-1) refused", !exprSet(-1));
+
+  printf("Reload, sleepy edited:\n");
+  const char *tmp1 = "Simul8_expressions_1.eye", *tmp2 = "Simul8_expressions_2.eye";
+  if(!writeFile(tmp1, "{ \"sleepy\" : { \"lids\" : \"sleepy\", \"gaze\" : 0.6, "
+                      "\"saccade\" : 2.0, \"blink\" : 0.5, \"time\" : 2.0 } }\n") ||
+     !writeFile(tmp2, "{ \"idle\" : { \"distance\" : 400 },\n"
+                      "  \"alert\" : { \"gaze\" : 1.2, \"time\" : 0.2 } }\n")) {
+    printf("Can't write temporary files\nFAILED\n");
+    return 1;
+  }
+  exprRead(tmp1); // As loadConfig() for a reload...
+  run(100000);
+  expect("read, not swapped in yet", sleepy, 0.0001);
+  exprUse();      // ...and applyReload()
+  exprFrame(now);
+  expect("swapped, new values at once", edited, 0.0001);
+
+  printf("Reload, no sleepy and idle redefined:\n");
+  exprRead(tmp2);
+  exprUse();
+  exprFrame(now);
+  expectTrue("back to idle", !strcmp(exprName(), "idle"));
+  expect("with its new distance", calm, 0.0001);
+  expectTrue("sleepy's gone", exprFind("sleepy") < 0);
+  x = exprFind("alert");
+  expectTrue("alert there, 0.2 sec", (x > 0) && exprSet(x) && (lastDuration == 200000));
+  run(200000);
+  const float alert[] = { 1.2, 1.0, 1.0, 0.5, 0.0, 0.0, 570.0 };
+  expect("alert, rest the usual defaults", alert, 0.0001);
+
+  remove(tmp1);
+  remove(tmp2);
+  printf("%s\n", ok ? "All ok" : "FAILED");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_Simul8
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+//
+// Runs the startup filesystem wait (mdo_m4_eyes/FsRetry, behind file.cpp's
+// filesysWait() and fileReady()) on a computer against a fake filesystem
+// that fails its first N opens, as the board's does for a while after
+// powering up without USB.
+//
+//   g++ -O2 -I../mdo_m4_eyes Simul8_fsRetry.cpp ../mdo_m4_eyes/FsRetry.cpp -o fsRetry
+//   ./fsRetry [--retries 8] [--ms 10] [--fails 12]
+//
+// For each N from 0 to --fails it boots as setup() does: filesysWait(),
+// then fileReady() for the config file and for one that isn't there. It
+// prints the tries and simulated ms each took, and checks them: up after
+// N + 1 tries and 10 * (2^N - 1) ms of waiting if N <= --retries, else
+// given up after all of them; once up or given up, no more waiting, so a
+// missing file costs one try. It does the same with fileReady() first
+// (a loader used before filesysWait()). --retries and --ms default to
+// FS_RETRIES and FS_RETRY_MS in file.cpp.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "FsRetry.h"
+
+static uint32_t now;      // Simulated ms
+static uint32_t failLeft; // Opens still to fail
+
+static void simPause(uint32_t ms) {
+  now += ms;
+}
+
+// Files there are "config.eye" and the root listing; nothing opens until
+// the first failLeft tries have failed
+static bool simOpen(void *ctx) {
+  if(failLeft) {
+    failLeft--;
+    return false;
+  }
+  return !ctx || !strcmp((const char *)ctx, "config.eye");
+}
+
+typedef struct {
+  bool     ok;
+  uint8_t  tries;
+  uint32_t ms;
+} result;
+
+static result probe(FsRetry *fs, bool startup, const char *filename) {
+  uint32_t start = now;
+  bool     ok    = startup ? fs->wait(simOpen, NULL) : fs->ready(simOpen, (void *)filename);
+  return { ok, fs->tries(), now - start };
+}
+
+static bool expect(const char *what, result r, bool ok, uint8_t tries, uint32_t ms) {
+  bool good = (r.ok == ok) && (r.tries == tries) && (r.ms == ms);
+  printf("  %-22s %-5s %2d tries %5d ms%s\n", what, r.ok ? "ok" : "fail", r.tries, r.ms,
+    good ? "" : "  WRONG");
+  if(!good) printf("  %-22s %-5s %2d tries %5d ms expected\n", "", ok ? "ok" : "fail", tries, ms);
+  return good;
+}
+
+int main(int argc, char *argv[]) {
+  int retries = 8, firstMs = 10, fails = 12; // As file.cpp
+  for(int i=1; i+1<argc; i+=2) {
+    if(!strcmp(argv[i], "--retries"))    retries = atoi(argv[i + 1]);
+    else if(!strcmp(argv[i], "--ms"))    firstMs = atoi(argv[i + 1]);
+    else if(!strcmp(argv[i], "--fails")) fails   = atoi(argv[i + 1]);
+  }
+  if((retries < 0) || (retries > 24) || (firstMs < 1)) {
+    printf("Need 0-24 retries and at least 1 ms\n");
+    return 1;
+  }
+  bool ok = true;
+  for(int n=0; n<=fails; n++) {
+    bool     comes  = (n <= retries);
+    uint8_t  tries  = comes ? n + 1 : retries + 1;
+    uint32_t waited = firstMs * ((1u << (tries - 1)) - 1);
+    for(int first=0; first<2; first++) {
+      FsRetry fs(simPause, retries, firstMs);
+      now      = 0;
+      failLeft = n;
+      printf("%d opens fail, %s first:\n", n, first ? "fileReady()" : "filesysWait()");
+      if(!first) {
+        ok &= expect("filesysWait()", probe(&fs, true, NULL), comes, tries, waited);
+      } else {
+        ok &= expect("fileReady(config.eye)", probe(&fs, false, "config.eye"), comes, tries, waited);
+      }
+      // Up or given up: no more waiting, one try each
+      uint32_t left = failLeft;
+      ok &= expect("fileReady(config.eye)", probe(&fs, false, "config.eye"), !left, 1, 0);
+      ok &= expect("fileReady(missing)", probe(&fs, false, "missing"), false, 1, 0);
+      ok &= (fs.up() == (comes || !left)) && (fs.down() == !comes);
+    }
+  }
+  printf("%s\n", ok ? "All ok" : "FAILED");
+  return ok ? 0 : 1;
+}
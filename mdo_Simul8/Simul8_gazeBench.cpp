@@ -0,0 +1,289 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_Simul8
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+//
+// Times eye movement the old way (M4_Eyes.ino's loop(): float easing,
+// random() targets with a sqrt(), worked out again for every eye frame)
+// against mdo_m4_eyes/gaze.cpp itself, on a computer: gazeFrame() for
+// every eye frame, as gaze.cpp was first put in loop(), and gazeTick()
+// once per tick (with vergence) then gazeLatch() per eye, as it is now.
+//
+//   g++ -O2 -I../mdo_m4_eyes -include Simul8_sketch.h Simul8_gazeBench.cpp ../mdo_m4_eyes/gaze.cpp -o gazeBench
+//   ./gazeBench [--seconds 600] [--reps 5]
+//
+// All run the same made-up frame times, two eyes about 8.5 ms apart, for
+// --seconds of animation; the best of --reps is shown as ns per eye
+// frame. These are host times, not M4 cycles: the old code is inlined
+// into the loop here as it was in loop(), gaze.cpp is a call as on the
+// board, and a PC's FPU makes float and double math about as cheap as
+// integer. The "Frame logic" line on the board's serial monitor is what
+// counts there. As a check that the behavior's the same, each should
+// make about as many moves a second as the old code and keep eye 0
+// about as far from the middle on average (within 10%).
+
+#include <chrono>
+#include "ExpressionBlend.h"
+#include "XorShift.h"
+
+hostArcada arcada;
+hostSerial Serial;
+
+// As loadConfig() leaves them with no settings in the config
+int       DISPLAY_SIZE     = 240;
+int       eyeRadius        = 125;
+int       mapRadius        = 236;
+int       mapDiameter      = 472;
+uint32_t  gazeMax          = 3000000;
+bool      moveEyesRandomly = true;
+float     eyeTargetX       = 0.0;
+float     eyeTargetY       = 0.0;
+eyeStruct eye[NUM_EYES];
+
+static bool    booped = false;
+static XorShift rng;
+
+// STAND-INS ---------------------------------------------------------------
+
+uint32_t micros(void) {
+  return 0;
+}
+
+// Idle's values (expressions.cpp)
+float exprGet(uint8_t param) {
+  return (param == ExpressionBlend::DISTANCE) ? 570.0 : 1.0;
+}
+
+int32_t animRandom(int32_t howbig) {
+  return rng.random(howbig);
+}
+
+int32_t animRandom(int32_t howsmall, int32_t howbig) {
+  return rng.random(howsmall, howbig);
+}
+
+// Arduino's random() (WMath.cpp): newlib rand() and a modulo
+static long random(long howbig) {
+  if(howbig == 0) return 0;
+  return rand() % howbig;
+}
+
+static long random(long howsmall, long howbig) {
+  if(howsmall >= howbig) return howsmall;
+  return random(howbig - howsmall) + howsmall;
+}
+
+static uint32_t nanos(void) {
+  return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// OLD ---------------------------------------------------------------------
+
+// From M4_Eyes.ino, as it was before gaze.cpp
+static bool     eyeInMotion = false;
+static float    eyeOldX, eyeOldY, eyeNewX, eyeNewY;
+static uint32_t eyeMoveStartTime = 0L;
+static int32_t  eyeMoveDuration  = 0L;
+static uint32_t lastSaccadeStop  = 0L;
+static int32_t  saccadeInterval  = 0L;
+static int      fixate           = 7;
+
+static void oldBegin(void) {
+  eyeOldX = eyeNewX = eyeOldY = eyeNewY = mapRadius;
+  eyeInMotion      = false;
+  eyeMoveStartTime = eyeMoveDuration = lastSaccadeStop = saccadeInterval = 0;
+  fixate           = 7;
+}
+
+static void oldFrame(uint8_t eyeNum, uint32_t t) {
+      // Eye movement
+      float eyeX, eyeY;
+      if(moveEyesRandomly) {
+        int32_t dt = t - eyeMoveStartTime;      // uS elapsed since last eye event
+        if(eyeInMotion) {                       // Eye currently moving?
+          if(dt >= eyeMoveDuration) {           // Time up?  Destination reached.
+            eyeInMotion = false;                // Stop moving
+            // The "move" duration temporarily becomes a hold duration...
+            // Normally this is 35 ms to 1 sec, but don't exceed gazeMax setting
+            uint32_t limit = min(1000000, gazeMax);
+            eyeMoveDuration = random(35000, limit); // Time between microsaccades
+            if(!saccadeInterval) {              // Cleared when "big" saccade finishes
+              lastSaccadeStop = t;              // Time when saccade stopped
+              saccadeInterval = random(eyeMoveDuration, gazeMax); // Next in 30ms to 3sec
+            }
+            // Similarly, the "move" start time becomes the "stop" starting time...
+            eyeMoveStartTime = t;               // Save time of event
+            eyeX = eyeOldX = eyeNewX;           // Save position
+            eyeY = eyeOldY = eyeNewY;
+          } else { // Move time's not yet fully elapsed -- interpolate position
+            float e  = (float)dt / float(eyeMoveDuration); // 0.0 to 1.0 during move
+            e = 3 * e * e - 2 * e * e * e; // Easing function: 3*e^2-2*e^3 0.0 to 1.0
+            eyeX = eyeOldX + (eyeNewX - eyeOldX) * e; // Interp X
+            eyeY = eyeOldY + (eyeNewY - eyeOldY) * e; // and Y
+          }
+        } else {                       // Eye is currently stopped
+          eyeX = eyeOldX;
+          eyeY = eyeOldY;
+          if(dt > eyeMoveDuration) {   // Time up?  Begin new move.
+            if((t - lastSaccadeStop) > saccadeInterval) { // Time for a "big" saccade
+              // r is the radius in X and Y that the eye can go, from (0,0) in the center.
+              float r = ((float)mapDiameter - (float)DISPLAY_SIZE * M_PI_2) * 0.75;
+              eyeNewX = random(-r, r);
+              float h = sqrt(r * r - eyeNewX * eyeNewX);
+              eyeNewY = random(-h, h);
+              // Set the duration for this move, and start it going.
+              eyeMoveDuration = random(83000, 166000); // ~1/12 - ~1/6 sec
+              saccadeInterval = 0; // Calc next interval when this one stops
+            } else { // Microsaccade
+              // r is possible radius of motion, ~1/10 size of full saccade.
+              // We don't bother with clipping because if it strays just a little,
+              // that's okay, it'll get put in-bounds on next full saccade.
+              float r = (float)mapDiameter - (float)DISPLAY_SIZE * M_PI_2;
+              r *= 0.07;
+              float dx = random(-r, r);
+              eyeNewX = eyeX - mapRadius + dx;
+              float h = sqrt(r * r - dx * dx);
+              eyeNewY = eyeY - mapRadius + random(-h, h);
+              eyeMoveDuration = random(7000, 25000); // 7-25 ms microsaccade
+            }
+            eyeNewX += mapRadius;    // Translate new point into map space
+            eyeNewY += mapRadius;
+            eyeMoveStartTime = t;    // Save initial time of move
+            eyeInMotion      = true; // Start move on next frame
+          }
+        }
+      } else {
+        // Allow user code to control eye position (e.g. IR sensor, joystick, etc.)
+        float r = ((float)mapDiameter - (float)DISPLAY_SIZE * M_PI_2) * 0.9;
+        eyeX = mapRadius + eyeTargetX * r;
+        eyeY = mapRadius + eyeTargetY * r;
+      }
+
+      // Eyes fixate (are slightly crossed) -- amount is filtered for boops
+      int nufix = booped ? 90 : 7;
+      fixate = ((fixate * 15) + nufix) / 16;
+      // save eye position to this eye's struct so it's same throughout render
+      if(eyeNum & 1) eyeX += fixate; // Eyes converge slightly toward center
+      else           eyeX -= fixate;
+      eye[eyeNum].eyeX = eyeX;
+      eye[eyeNum].eyeY = eyeY;
+}
+
+// NEW ---------------------------------------------------------------------
+
+// Ways to run it: the old code in every eye frame, gazeFrame() in every
+// eye frame (as gaze.cpp was first put in loop()), gazeTick() once per
+// tick with vergence and gazeLatch() per eye (as loop() is now)
+enum { RUN_OLD, RUN_FRAME, RUN_TICK };
+
+static void newFrame(uint8_t eyeNum, uint32_t t, int how) {
+  if(how == RUN_FRAME) {
+    gazeFrame(t, &eye[eyeNum].eyeX, &eye[eyeNum].eyeY);
+    eye[eyeNum].eyeX += (eyeNum & 1) ? fixate : -fixate;
+  } else {
+    if(!eyeNum) gazeTick(t, booped);
+    gazeLatch(eyeNum);
+  }
+}
+
+// RUNS --------------------------------------------------------------------
+
+typedef struct {
+  uint32_t ns;      // Best time, all frames
+  float    avgDist; // Average distance from the middle, map pixels
+  float    maxDist; // Furthest
+  uint32_t moves;   // Big saccades and microsaccades
+} result;
+
+static void start(int how) {
+  srand(47);
+  rng.seed(47);
+  if(how == RUN_OLD) oldBegin();
+  else               gazeBegin();
+}
+
+static void frame(uint32_t f, uint32_t t, int how) {
+  if(how == RUN_OLD) oldFrame(f % NUM_EYES, t);
+  else               newFrame(f % NUM_EYES, t, how);
+}
+
+static result bench(int how, const uint32_t *times, uint32_t frames, int reps) {
+  result r = {};
+  for(int rep=0; rep<reps; rep++) {
+    start(how);
+    uint32_t begin = nanos();
+    for(uint32_t f=0; f<frames; f++) frame(f, times[f], how);
+    uint32_t ns = nanos() - begin;
+    if(!rep || (ns < r.ns)) r.ns = ns;
+  }
+  // Once more, watching eye 0 (untimed): a move is any run of frames
+  // where it's not where it was
+  float  lastX = mapRadius, lastY = mapRadius;
+  bool   moving = false;
+  double sum    = 0.0;
+  start(how);
+  for(uint32_t f=0; f<frames; f++) {
+    frame(f, times[f], how);
+    if(f % NUM_EYES) continue;
+    float x = eye[0].eyeX, y = eye[0].eyeY;
+    bool  m = (x != lastX) || (y != lastY);
+    if(m && !moving) r.moves++;
+    moving = m;
+    lastX  = x;
+    lastY  = y;
+    float d = sqrt((x - mapRadius) * (x - mapRadius) + (y - mapRadius) * (y - mapRadius));
+    sum    += d;
+    if(d > r.maxDist) r.maxDist = d;
+  }
+  r.avgDist = sum / ((frames + NUM_EYES - 1) / NUM_EYES);
+  return r;
+}
+
+static bool ok = true;
+
+// Within 10% of the old code's
+static void expectNear(const char *what, float v, float old) {
+  bool good = (v > old * 0.9) && (v < old * 1.1);
+  printf("  %-44s %s\n", what, good ? "ok" : "WRONG");
+  if(!good) ok = false;
+}
+
+int main(int argc, char *argv[]) {
+  uint32_t seconds = 600;
+  int      reps    = 5;
+  for(int i=1; i<argc; i++) {
+    if(!strcmp(argv[i], "--seconds") && (i + 1 < argc))   seconds = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "--reps") && (i + 1 < argc)) reps    = atoi(argv[++i]);
+  }
+  if(reps < 1) reps = 1;
+  if(!seconds) seconds = 1;
+
+  // Eye frames 7-10 ms apart, one eye after the other
+  uint32_t  frames = seconds * 1000000 / 8500;
+  uint32_t *times  = (uint32_t *)malloc(frames * sizeof(uint32_t));
+  XorShift  clock(1);
+  uint32_t  t      = 1000000;
+  for(uint32_t f=0; f<frames; f++) times[f] = (t += clock.random(7000, 10000));
+
+  static const char *names[] = { "old loop() code", "gazeFrame() per eye", "gazeTick() + gazeLatch()" };
+  result r[3];
+  printf("%u eye frames (%u sec, %d eyes), best of %d:\n", frames, seconds, NUM_EYES, reps);
+  for(int how=RUN_OLD; how<=RUN_TICK; how++) {
+    r[how] = bench(how, times, frames, reps);
+    printf("  %-26s %6.1f ns/eye frame (%3.0f%%)  %5.2f moves/sec  from middle avg %.1f max %.1f px\n",
+      names[how], (double)r[how].ns / frames, 100.0 * r[how].ns / r[RUN_OLD].ns,
+      (float)r[how].moves / seconds, r[how].avgDist, r[how].maxDist);
+  }
+  for(int how=RUN_FRAME; how<=RUN_TICK; how++) {
+    char what[80];
+    snprintf(what, sizeof what, "%s: moves/sec as old", names[how]);
+    expectNear(what, r[how].moves, r[RUN_OLD].moves);
+    snprintf(what, sizeof what, "%s: distance from middle as old", names[how]);
+    expectNear(what, r[how].avgDist, r[RUN_OLD].avgDist);
+  }
+  free(times);
+  printf("%s\n", ok ? "All ok" : "FAILED");
+  return ok ? 0 : 1;
+}
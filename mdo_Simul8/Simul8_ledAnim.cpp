@@ -0,0 +1,128 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_Simul8
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+//
+// Plays NeoPixel animations through the keyframe engine
+// (mdo_m4_eyes/LedAnim) on a computer, as neopixels.cpp does, to see how
+// often they'd be show()n and how smooth they are.
+//
+//   g++ -O2 -I../mdo_m4_eyes Simul8_ledAnim.cpp ../mdo_m4_eyes/LedAnim.cpp -o ledAnim
+//   python ../mdo_EyeConfig/led_anim_compile.py --c ../mdo_EyeConfig/leds.json | ./ledAnim [--fps 30] [--pixels 4] [--csv leds.csv]
+//
+// Reads the C tables led_anim_compile.py --c prints, and plays each
+// animation for two of its loops (at least 5 s) with render() called
+// once an eye frame, at --fps with some jitter. For each it prints how
+// many frames were shown (show() is what costs, interrupts off while the
+// pixels are sent) and the biggest jump in any color between shows, and
+// checks that fades go one way: between two keyframes no channel turns
+// back. --csv writes every show (animation, ms, then each pixel's color).
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "LedAnim.h"
+#include "XorShift.h"
+
+typedef struct {
+  std::string         name;
+  std::vector<ledKey> keys;
+  uint16_t            spread;
+} anim;
+
+// The parts of led_anim_compile.py --c output that matter
+static std::vector<anim> readTables(FILE *in) {
+  std::vector<anim>   out;
+  std::vector<ledKey> keys;
+  char line[256], name[64];
+  int  ms, r, g, b, count, spread;
+  while(fgets(line, sizeof line, in)) {
+    if(sscanf(line, " { %d, %d, %d, %d }", &ms, &r, &g, &b) == 4) {
+      keys.push_back({ (uint16_t)ms, (uint8_t)r, (uint8_t)g, (uint8_t)b });
+    } else if(sscanf(line, "static const ledAnim %63s = { %*s %d, %d", name, &count, &spread) == 3) {
+      out.push_back({ name, keys, (uint16_t)spread });
+      keys.clear();
+    }
+  }
+  return out;
+}
+
+int main(int argc, char *argv[]) {
+  float       fps = 30;
+  int         pixels = 4;
+  const char *csv = NULL;
+  for(int i=1; i<argc; i++) {
+    if(!strcmp(argv[i], "--fps") && (i + 1 < argc))         fps = atof(argv[++i]);
+    else if(!strcmp(argv[i], "--pixels") && (i + 1 < argc)) pixels = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "--csv") && (i + 1 < argc))    csv = argv[++i];
+  }
+  if(fps < 1) fps = 1;
+  std::vector<anim> anims = readTables(stdin);
+  if(anims.empty()) {
+    printf("No tables on stdin (led_anim_compile.py --c output)\n");
+    return 1;
+  }
+  FILE *c = csv ? fopen(csv, "w") : NULL;
+  bool  ok = true;
+  for(const anim &a : anims) {
+    ledAnim  la = { a.keys.data(), (uint8_t)a.keys.size(), a.spread };
+    LedAnim  leds;
+    XorShift rnd(47);
+    uint32_t period = a.keys.back().ms,
+             length = std::max(2 * period, 5000u),
+             frames = 0, shows = 0;
+    int      jump = 0, wrong = 0;
+    uint32_t last[LED_ANIM_PIXELS] = { 0 };
+    leds.begin(pixels);
+    leds.play(&la, 0);
+    for(double ms=0; ms<length; ms+=1000.0 / fps * (0.75 + (rnd.next() % 1000) / 2000.0)) {
+      uint32_t t = (uint32_t)ms;
+      frames++;
+      if(!leds.render(t)) continue;
+      if(c) fprintf(c, "%s,%d", a.name.c_str(), t);
+      for(uint8_t p=0; p<leds.pixels(); p++) {
+        uint32_t now = leds.color(p);
+        if(c) fprintf(c, ",%06X", now);
+        if(shows) {
+          for(uint8_t s=0; s<24; s+=8) {
+            jump = std::max(jump, abs((int)((now >> s) & 255) - (int)((last[p] >> s) & 255)));
+          }
+        }
+        last[p] = now;
+      }
+      if(c) fprintf(c, "\n");
+      shows++;
+    }
+    // Fades go one way: each channel between keyframes, 1 ms apart
+    for(size_t k=0; k+1<a.keys.size(); k++) {
+      ledKey  only[2] = { a.keys[k], a.keys[k + 1] };
+      only[1].ms -= only[0].ms;
+      only[0].ms  = 0;
+      ledAnim seg = { only, 2, 0 };
+      LedAnim one;
+      one.begin(1, 0);
+      one.play(&seg, 0);
+      uint32_t prev = 0;
+      for(uint32_t t=0; t<only[1].ms; t++) {
+        one.render(t);
+        uint32_t now = one.color(0);
+        for(uint8_t s=0; t && (s<24); s+=8) {
+          int from = (&only[0].r)[2 - s / 8], to = (&only[1].r)[2 - s / 8],
+              d    = (int)((now >> s) & 255) - (int)((prev >> s) & 255);
+          if(((to > from) && (d < 0)) || ((to < from) && (d > 0)) || ((to == from) && d)) wrong++;
+        }
+        prev = now;
+      }
+    }
+    printf("%-12s %5d ms: %d frames, %d shown (%.1f/s), biggest jump %d%s\n", a.name.c_str(),
+      period, frames, shows, shows * 1000.0 / length, jump, wrong ? ", FADES TURN BACK" : "");
+    if(wrong) ok = false;
+  }
+  if(c) fclose(c);
+  printf("%s\n", ok ? "All ok" : "FAILED");
+  return ok ? 0 : 1;
+}
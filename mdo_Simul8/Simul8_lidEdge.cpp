@@ -0,0 +1,212 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_Simul8
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+//
+// Makes the 8.8 eyelid edge tables (mdo_m4_eyes/LidEdge) for eyelid
+// images on a computer, as loadEyelid() in file.cpp does, and checks them
+// against a known-good copy.
+//
+//   g++ -O2 -I../mdo_m4_eyes Simul8_lidEdge.cpp ../mdo_m4_eyes/LidEdge.cpp -o lidEdge
+//   ./lidEdge [--golden Simul8_lidEdge_hazel.txt] [--write file] [--print] image.bmp ...
+//
+// Run with no images it does hazel's lids and poses:
+//   upper.bmp lower.bmp upper-symmetrical.bmp lower-symmetrical.bmp poses/*.bmp
+// from ../mdo_m4_eyes/eyes/hazel, against Simul8_lidEdge_hazel.txt.
+// Each image gives two tables of 240 columns (the min and max edge, in
+// screen rows after loadEyelid()'s flip), compared value by value with
+// the golden file; --write writes a new one instead, --print shows them.
+// It also checks that a -symmetrical image, whose columns mirror each
+// other, gives tables that mirror exactly too (lidEdge() rounds the same
+// both ways so that they do).
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "LidEdge.h"
+
+#define DISPLAY_SIZE 240
+#define HAZEL        "../mdo_m4_eyes/eyes/hazel/"
+
+static uint32_t le32(const uint8_t *p) {
+  return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Whole-pixel extents per column, as loadEyelid() finds them (255 = none)
+static bool scanLid(const char *name, uint8_t *miny, uint8_t *maxy) {
+  FILE   *f = fopen(name, "rb");
+  uint8_t h[54], p[8];
+  if(!f || (fread(h, 1, sizeof h, f) != sizeof h) || (h[0] != 'B') || (h[1] != 'M') ||
+     ((h[28] | (h[29] << 8)) != 1) || le32(&h[30])) {
+    if(f) fclose(f);
+    return false;
+  }
+  int32_t  width = le32(&h[18]), height = le32(&h[22]), hh = abs(height);
+  uint32_t stride = (width + 31) / 32 * 4;
+  fseek(f, 14 + le32(&h[14]), SEEK_SET);
+  if(fread(p, 1, sizeof p, f) != sizeof p) {
+    fclose(f);
+    return false;
+  }
+  // Bit value for white: palette entry with the brighter RGB565
+  uint16_t pal[2];
+  for(int i=0; i<2; i++) pal[i] = ((p[i*4+2] & 0xF8) << 8) | ((p[i*4+1] & 0xFC) << 3) | (p[i*4] >> 3);
+  uint8_t white = (pal[1] > pal[0]);
+  int     sx  = (DISPLAY_SIZE - width) / 2, sy = (DISPLAY_SIZE - hh) / 2,
+          sx1 = std::max(sx, 0), sx2 = std::min(sx + width, DISPLAY_SIZE) - 1;
+  std::vector<uint8_t> row(stride);
+  memset(miny, 255, DISPLAY_SIZE);
+  fseek(f, le32(&h[10]), SEEK_SET);
+  for(int r=0; r<hh; r++) {
+    if(fread(row.data(), 1, stride, f) != stride) {
+      fclose(f);
+      return false;
+    }
+    int y = ((height > 0) ? (hh - 1 - r) : r) + sy;
+    if((y < 0) || (y >= DISPLAY_SIZE)) continue;
+    for(int x=sx1; x<=sx2; x++) {
+      int ix = x - sx;
+      if(((row[ix >> 3] >> (7 - (ix & 7))) & 1) == white) {
+        if(miny[x] == 255)   miny[x] = maxy[x] = y;
+        else if(y < miny[x]) miny[x] = y;
+        else if(y > maxy[x]) maxy[x] = y;
+      }
+    }
+  }
+  fclose(f);
+  for(int x=0; x<DISPLAY_SIZE; x++) { // Screen is rotated, flip
+    if(miny[x] != 255) {
+      uint8_t y = miny[x];
+      miny[x]   = DISPLAY_SIZE - 1 - maxy[x];
+      maxy[x]   = DISPLAY_SIZE - 1 - y;
+    }
+  }
+  return true;
+}
+
+typedef struct {
+  std::string name;   // Image path, less the hazel directory
+  uint16_t    table[2][DISPLAY_SIZE];
+} lidTables;
+
+static bool readGolden(const char *file, std::vector<lidTables> *out) {
+  FILE *f = fopen(file, "r");
+  if(!f) return false;
+  char name[256], which[8];
+  while(fscanf(f, "%255s %7s", name, which) == 2) {
+    int t = strcmp(which, "min") ? 1 : 0;
+    if(!t || out->empty() || (out->back().name != name)) {
+      out->push_back(lidTables());
+      out->back().name = name;
+    }
+    for(int x=0; x<DISPLAY_SIZE; x++) {
+      unsigned v;
+      if(fscanf(f, "%u", &v) != 1) {
+        fclose(f);
+        return false;
+      }
+      out->back().table[t][x] = v;
+    }
+  }
+  fclose(f);
+  return true;
+}
+
+static void writeTables(FILE *f, const lidTables &l) {
+  for(int t=0; t<2; t++) {
+    fprintf(f, "%s %s", l.name.c_str(), t ? "max" : "min");
+    for(int x=0; x<DISPLAY_SIZE; x++) fprintf(f, "%s%d", (x % 16) ? " " : "\n ", l.table[t][x]);
+    fprintf(f, "\n");
+  }
+}
+
+int main(int argc, char *argv[]) {
+  const char               *golden = "Simul8_lidEdge_hazel.txt", *write = NULL;
+  bool                      print = false;
+  std::vector<std::string>  images;
+  std::string               dir;
+  for(int i=1; i<argc; i++) {
+    if(!strcmp(argv[i], "--golden") && (i + 1 < argc))     golden = argv[++i];
+    else if(!strcmp(argv[i], "--write") && (i + 1 < argc)) write  = argv[++i];
+    else if(!strcmp(argv[i], "--print"))                   print  = true;
+    else                                                   images.push_back(argv[i]);
+  }
+  if(images.empty()) {
+    dir    = HAZEL;
+    images = { "upper.bmp", "lower.bmp", "upper-symmetrical.bmp", "lower-symmetrical.bmp",
+               "poses/sleepy.bmp", "poses/squint.bmp", "poses/surprise.bmp" };
+  }
+
+  std::vector<lidTables> made, good;
+  bool ok = true;
+  for(const std::string &name : images) {
+    uint8_t   miny[DISPLAY_SIZE], maxy[DISPLAY_SIZE];
+    lidTables l;
+    l.name = name;
+    if(!scanLid((dir + name).c_str(), miny, maxy)) {
+      printf("%s: can't read as a 1-bit BMP\n", name.c_str());
+      ok = false;
+      continue;
+    }
+    // Columns with no data keep loadEyelid()'s init value; it's per use
+    // on the board, 0 here
+    memset(l.table, 0, sizeof l.table);
+    lidEdge(miny, miny, l.table[0], DISPLAY_SIZE);
+    lidEdge(miny, maxy, l.table[1], DISPLAY_SIZE);
+
+    int  unmirrored = 0, columns = 0;
+    bool symmetrical = strstr(name.c_str(), "symmetrical") != NULL;
+    for(int x=0; x<DISPLAY_SIZE; x++) {
+      if(miny[x] == 255) continue;
+      columns++;
+      for(int t=0; t<2; t++) {
+        if(symmetrical && (l.table[t][x] != l.table[t][DISPLAY_SIZE - 1 - x])) unmirrored++;
+      }
+    }
+    printf("%-24s %3d columns", name.c_str(), columns);
+    if(unmirrored) printf(", %d values don't mirror", unmirrored);
+    printf("\n");
+    if(unmirrored) ok = false;
+    if(print) writeTables(stdout, l);
+    made.push_back(l);
+  }
+
+  if(write) {
+    FILE *f = fopen(write, "w");
+    if(!f) {
+      printf("Can't write %s\n", write);
+      return 1;
+    }
+    for(const lidTables &l : made) writeTables(f, l);
+    fclose(f);
+    printf("Wrote %s\n", write);
+  } else if(!readGolden(golden, &good)) {
+    printf("Can't read %s\n", golden);
+    ok = false;
+  } else {
+    for(const lidTables &l : made) {
+      auto g = std::find_if(good.begin(), good.end(), [&](const lidTables &c) { return c.name == l.name; });
+      if(g == good.end()) {
+        printf("%s: not in %s\n", l.name.c_str(), golden);
+        ok = false;
+        continue;
+      }
+      for(int t=0; t<2; t++) {
+        for(int x=0; x<DISPLAY_SIZE; x++) {
+          if(l.table[t][x] != g->table[t][x]) {
+            printf("%s %s column %d: %d, was %d\n", l.name.c_str(), t ? "max" : "min", x,
+              l.table[t][x], g->table[t][x]);
+            ok = false;
+            break;
+          }
+        }
+      }
+    }
+  }
+  printf("%s\n", ok ? "All ok" : "FAILED");
+  return ok ? 0 : 1;
+}
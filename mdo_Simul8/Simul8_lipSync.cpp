@@ -0,0 +1,190 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_Simul8
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+//
+// Plays WAV files through the WAV player (mdo_m4_eyes/WavStream) and the
+// mouth servo's lip sync (LipSync) on a computer, as user_fizzgig.cpp
+// does, and shows what the servo would be told.
+//
+//   g++ -O2 -I../mdo_m4_eyes Simul8_lipSync.cpp ../mdo_m4_eyes/LipSync.cpp ../mdo_m4_eyes/WavStream.cpp -o lipSync
+//   ./lipSync [--fps 30] [--csv servo.csv] [file.wav ...]   (default: fizzgig bark and growl)
+//
+// The sample clock runs take() a sample at a time; user_loop() (service(),
+// then LipSync::update() with each block heard) runs once a frame, at
+// --fps with some jitter.
+// For each file it prints how many servo writes there were, the pulse
+// range used, how many times the mouth opened (past half way) and how
+// much of the time it was open, plus a coarse picture of the mouth over
+// time. It also plays each file at 20 and 60 fps and shows how much the
+// servo position differs from --fps's, which should be small: how the
+// mouth moves isn't meant to depend on the frame rate, as long as the
+// frames are short enough for the WAV player to keep up (no underruns:
+// the sound itself has gaps then). --csv writes every
+// servo write (file, ms, level, microseconds).
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "LipSync.h"
+#include "WavStream.h"
+#include "XorShift.h"
+
+// As user_fizzgig.cpp
+#define SERVO_MOUTH_OPEN    750
+#define SERVO_MOUTH_CLOSED 1850
+#define MOUTH_GATE           30
+#define MOUTH_FULL          500
+#define MOUTH_ATTACK         15
+#define MOUTH_RELEASE       120
+
+typedef std::vector<uint8_t> bytes;
+typedef struct { uint32_t ms; uint16_t level, us; } servoWrite;
+
+typedef struct { const bytes *d; size_t pos; } memFile;
+
+static uint32_t memRead(void *ctx, uint8_t *buf, uint32_t n) {
+  memFile *m = (memFile *)ctx;
+  n = std::min((size_t)n, m->d->size() - m->pos);
+  memcpy(buf, m->d->data() + m->pos, n);
+  m->pos += n;
+  return n;
+}
+
+static bool memSkip(void *ctx, uint32_t n) {
+  memFile *m = (memFile *)ctx;
+  if(m->pos + n > m->d->size()) return false;
+  m->pos += n;
+  return true;
+}
+
+// Servo writes from playing 'file' with user_loop() at about 'fps', and
+// a second after (the mouth closing)
+static std::vector<servoWrite> run(const bytes &file, float fps, uint32_t *lengthMs,
+                                   uint32_t *underruns) {
+  static WavStream ws;
+  std::vector<servoWrite> out;
+  memFile   m = { &file, 0 };
+  wavFormat f;
+  LipSync   mouth;
+  XorShift  rnd(47);
+  if(!wavParse(memRead, memSkip, &m, &f)) return out;
+  ws.begin(memRead, &m, f);
+  ws.service();
+  mouth.begin(SERVO_MOUTH_CLOSED, SERVO_MOUTH_OPEN, MOUTH_GATE, MOUTH_FULL);
+  mouth.timing(MOUTH_ATTACK, MOUTH_RELEASE);
+  mouth.reset(0);
+  *lengthMs = (uint32_t)((uint64_t)f.frames * 1000 / f.rate);
+  double   frame = 1000.0 / fps, next = frame;
+  uint64_t sample = 0;
+  for(;;) {
+    uint32_t ms = (uint32_t)(sample * 1000 / ws.rate());
+    if(ms >= next) { // user_loop(), +/-25% jitter
+      ws.service();
+      uint16_t level = 0, l;
+      uint32_t heardMs;
+      bool     moved = false;
+      while(ws.heard(&l, &heardMs)) {
+        moved |= mouth.update(heardMs, l);
+        level  = std::max(level, l);
+      }
+      if(ws.done()) moved |= mouth.update(ms, 0);
+      if(moved) out.push_back({ ms, level, mouth.us() });
+      next += frame * (0.75 + (rnd.next() % 1000) / 2000.0);
+      if(ws.done() && (ms > *lengthMs + 1000)) break;
+    }
+    if(!ws.done()) ws.take();
+    sample++;
+  }
+  *underruns = ws.underruns();
+  return out;
+}
+
+// Pulse width at time 'ms' (the last write before it)
+static uint16_t at(const std::vector<servoWrite> &w, uint32_t ms) {
+  uint16_t us = SERVO_MOUTH_CLOSED;
+  for(const servoWrite &s : w) {
+    if(s.ms > ms) break;
+    us = s.us;
+  }
+  return us;
+}
+
+int main(int argc, char *argv[]) {
+  float       fps = 30;
+  const char *csv = NULL;
+  std::vector<std::string> files;
+  for(int i=1; i<argc; i++) {
+    if(!strcmp(argv[i], "--fps") && (i + 1 < argc))      fps = atof(argv[++i]);
+    else if(!strcmp(argv[i], "--csv") && (i + 1 < argc)) csv = argv[++i];
+    else files.push_back(argv[i]);
+  }
+  if(fps < 1) fps = 1;
+  if(files.empty()) {
+    for(const char *n : { "bark", "growl" }) {
+      files.push_back(std::string("../mdo_m4_eyes/eyes/fizzgig/") + n + ".wav");
+    }
+  }
+  FILE *c = csv ? fopen(csv, "w") : NULL;
+  if(c) fprintf(c, "file,ms,level,us\n");
+  const int range = SERVO_MOUTH_CLOSED - SERVO_MOUTH_OPEN;
+  for(const std::string &path : files) {
+    bytes d;
+    FILE *f = fopen(path.c_str(), "rb");
+    if(f) {
+      uint8_t buf[4096];
+      size_t  n;
+      while((n = fread(buf, 1, sizeof buf, f)) > 0) d.insert(d.end(), buf, buf + n);
+      fclose(f);
+    }
+    uint32_t len = 0, under;
+    std::vector<servoWrite> w = run(d, fps, &len, &under);
+    if(w.empty()) {
+      printf("%s: can't play\n", path.c_str());
+      continue;
+    }
+    uint16_t lo = 0xFFFF, hi = 0;
+    int      opens = 0;
+    bool     isOpen = false;
+    uint64_t openMs = 0;
+    for(size_t i=0; i<w.size(); i++) {
+      lo = std::min(lo, w[i].us);
+      hi = std::max(hi, w[i].us);
+      bool o = (SERVO_MOUTH_CLOSED - w[i].us) > range / 2;
+      if(o && !isOpen) opens++;
+      isOpen = o;
+      uint32_t until = (i + 1 < w.size()) ? w[i+1].ms : w[i].ms;
+      if(o) openMs += until - w[i].ms;
+      if(c) fprintf(c, "%s,%d,%d,%d\n", path.c_str(), w[i].ms, w[i].level, w[i].us);
+    }
+    printf("%s: %d ms, %d servo writes (%.1f/s), %d-%d us, opened %d times, open %d%% of the time, %d underruns\n",
+      path.c_str(), len, (int)w.size(), w.size() * 1000.0 / (len + 1000), lo, hi, opens,
+      (int)(openMs * 100 / std::max(len, 1u)), under);
+    // Mouth over time, 50 ms a character: ' ' shut ... '#' open
+    printf("  |");
+    for(uint32_t ms=0; ms<len + 500; ms+=50) {
+      int o = (SERVO_MOUTH_CLOSED - at(w, ms)) * 4 / (range + 1);
+      putchar(" .-=#"[std::max(0, std::min(4, o))]);
+    }
+    printf("|\n");
+    // Frame rate shouldn't matter much
+    for(float other : { 20.0f, 60.0f }) {
+      uint32_t l2, u2;
+      std::vector<servoWrite> w2 = run(d, other, &l2, &u2);
+      int worst = 0, sum = 0, n = 0;
+      for(uint32_t ms=0; ms<len + 1000; ms+=10, n++) {
+        int diff = abs((int)at(w, ms) - (int)at(w2, ms));
+        worst = std::max(worst, diff);
+        sum  += diff;
+      }
+      printf("  at %2.0f fps: different by %d us on average, %d at most (%d%% of the range), %d underruns\n",
+        other, sum / n, worst, worst * 100 / range, u2);
+    }
+  }
+  if(c) fclose(c);
+  return 0;
+}
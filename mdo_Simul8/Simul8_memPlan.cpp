@@ -0,0 +1,280 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_Simul8
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+//
+// Replays the startup memory plan (mdo_m4_eyes/memory.cpp) for eye
+// configs on a computer: the allocations the background loader makes, in
+// its order, through the same Arena code, sized from each config and its
+// BMP headers.
+//
+//   g++ -O2 -I../mdo_m4_eyes Simul8_memPlan.cpp ../mdo_m4_eyes/Arena.cpp ../mdo_m4_eyes/configparse.cpp -o memPlan
+//   ./memPlan [--eyes 2] [--ram 120000] [--root ../mdo_m4_eyes/eyes] ../mdo_m4_eyes/eyes/*/config.eye
+//
+// For each config: the image scratch block sized for the largest image
+// (as imageScratch() and lidPosesScratch()), each texture, eyelid and
+// pose image allocated from it and reset as loadTexture()/loadEyelid()
+// do; then the tables block (tablesPlan()) with its slit pupil pool, a
+// slit map per eye with a slit pupil, and the polar and displacement
+// tables built MAP_ROWS_PER_STEP rows a call as the loader steps them,
+// every row written once and inside its table. Prints what each block
+// peaked at against what was planned; anything refused, left over or
+// written twice is an error. --ram is the free RAM at load time (from
+// "Free RAM" on the serial console); scratch and tables never overlap,
+// so the larger of the two plus stackReserve must fit in it. --eyes 1 is
+// the HalloWing (one eye, per-eye sections ignored).
+//
+// The sizes and config defaults come from MemPlan.h, the same code the
+// board uses. The allocation order is as file.cpp, memory.cpp and
+// tablegen.cpp, which need the Arduino libraries to build.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <dirent.h>
+#include <strings.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "Arena.h"
+#include "ConfigParse.h"
+#include "MemPlan.h"
+
+#define DISPLAY_SIZE 240
+
+static int numEyes = 2;
+
+// CONFIG ------------------------------------------------------------------
+
+// The keys that decide memory, as loadConfig() reads them
+typedef struct {
+  int         stackReserve = 5192, eyeRadius = 0, irisRadius = 0, slitPupilRadius = 0;
+  float       coverage = 0.6;
+  std::string upperEyelid = "upper.bmp", lowerEyelid = "lower.bmp", eyelidPoses;
+  std::string iris[2], sclera[2];
+  int         eyeIris[2] = { 0, 0 }, eyeSlit[2] = { -1, -1 };
+} eyeConfig;
+
+static eyeConfig cfg;
+
+static int dwim(cfgValue *v) {
+  if(v->item[0].type == CFG_STRING) return strtol(v->item[0].s, NULL, 0);
+  if(v->item[0].type == CFG_FLOAT)  return (int)v->item[0].f;
+  return v->item[0].i;
+}
+
+static void configValue(const char *section, const char *key, cfgValue *v) {
+  int e = -1;
+  if(section) { // Per-eye sections only on two-eye boards (configEyeNames)
+    if(numEyes < 2) return;
+    if(!strcmp(section, "right"))     e = 0;
+    else if(!strcmp(section, "left")) e = 1;
+    else                              return;
+  }
+  const char *s = (v->type == CFG_STRING) ? v->item[0].s : NULL;
+  for(int i=0; i<numEyes; i++) {
+    if((e >= 0) && (e != i)) continue;
+    if(s && !strcmp(key, "irisTexture"))   cfg.iris[i]   = s;
+    if(s && !strcmp(key, "scleraTexture")) cfg.sclera[i] = s;
+    if((e >= 0) && !strcmp(key, "irisRadius"))      cfg.eyeIris[i] = dwim(v);
+    if((e >= 0) && !strcmp(key, "slitPupilRadius")) cfg.eyeSlit[i] = dwim(v);
+  }
+  if(e >= 0) return;
+  if(!strcmp(key, "stackReserve"))         cfg.stackReserve    = dwim(v);
+  else if(!strcmp(key, "eyeRadius"))       cfg.eyeRadius       = dwim(v);
+  else if(!strcmp(key, "irisRadius"))      cfg.irisRadius      = dwim(v);
+  else if(!strcmp(key, "slitPupilRadius")) cfg.slitPupilRadius = dwim(v);
+  else if(!strcmp(key, "coverage") && (v->type == CFG_FLOAT)) cfg.coverage = v->item[0].f;
+  else if(s && !strcmp(key, "upperEyelid")) cfg.upperEyelid = s;
+  else if(s && !strcmp(key, "lowerEyelid")) cfg.lowerEyelid = s;
+  else if(s && !strcmp(key, "eyelidPoses")) cfg.eyelidPoses = s;
+}
+
+static int fileRead(void *ctx, uint8_t *buf, int n) {
+  return fread(buf, 1, n, (FILE *)ctx);
+}
+
+// IMAGES ------------------------------------------------------------------
+
+typedef struct {
+  int      width, height, depth;
+  uint32_t stride;
+} bmpInfo;
+
+static uint32_t le32(const uint8_t *p) {
+  return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// As bmpOpen() in file.cpp
+static bool bmpOpen(const std::string &path, bmpInfo *bmp) {
+  uint8_t h[54];
+  FILE   *f = fopen(path.c_str(), "rb");
+  if(!f) return false;
+  bool ok = (fread(h, 1, sizeof h, f) == sizeof h) && (h[0] == 'B') && (h[1] == 'M');
+  fclose(f);
+  if(!ok) return false;
+  bmp->width  = (int32_t)le32(&h[18]);
+  bmp->height = (int32_t)le32(&h[22]);
+  bmp->depth  = h[28] | (h[29] << 8);
+  bmp->stride = (bmp->width * bmp->depth + 31) / 32 * 4;
+  return ((h[26] | (h[27] << 8)) == 1) && !le32(&h[30]) &&
+         ((bmp->depth == 24) || (bmp->depth == 1)) && (bmp->width > 0) && bmp->height;
+}
+
+// As imageScratch()
+static uint32_t imageScratch(const std::string &path) {
+  bmpInfo bmp;
+  if(!bmpOpen(path, &bmp)) return 0;
+  return planImageScratch(bmp.width, bmp.height, bmp.depth, bmp.stride, DISPLAY_SIZE);
+}
+
+// The allocations loadTexture() (24-bit) or loadEyelid() (1-bit) make,
+// then scratchReset()
+static void loadImage(Arena *scratch, const std::string &path, int depth) {
+  bmpInfo bmp;
+  if(!bmpOpen(path, &bmp) || (bmp.depth != depth)) return; // Fails before allocating
+  if(depth == 24) {
+    scratch->alloc(bmp.width * abs(bmp.height) * 2) && scratch->alloc(bmp.stride);
+  } else {
+    scratch->alloc(bmp.stride) && scratch->alloc(DISPLAY_SIZE) && scratch->alloc(DISPLAY_SIZE);
+  }
+  scratch->reset();
+}
+
+// Pose images in dir, in name order (the board goes by directory order)
+static std::vector<std::string> poseFiles(const std::string &dir) {
+  std::vector<std::string> out;
+  DIR                     *d = opendir(dir.c_str());
+  struct dirent           *entry;
+  while(d && (entry = readdir(d))) {
+    const char *dot = strrchr(entry->d_name, '.');
+    if(dot && !strcasecmp(dot, ".bmp")) out.push_back(dir + "/" + entry->d_name);
+  }
+  if(d) closedir(d);
+  std::sort(out.begin(), out.end());
+  if(out.size() > LID_POSES_MAX - 2) out.resize(LID_POSES_MAX - 2);
+  return out;
+}
+
+// TABLES ------------------------------------------------------------------
+
+// Builds 'height' rows of 'width' bytes in 'rows'-row calls the way the
+// loader steps calcMap()/calcDisplacement(): allocate on row 0, each call
+// returns the next row, done when that reaches the height. Counts rows
+// written other than once, or steps that made no progress.
+static int stepTable(Arena *tables, int width, int height, int rows) {
+  uint8_t *table = (uint8_t *)tables->alloc(width * height);
+  if(!table) return height; // calc*() give up: "no memory, nothing more to do"
+  std::vector<int> written(height, 0);
+  int y = 0, steps = 0, bad = 0;
+  while(y < height) {
+    int yEnd = std::min(y + rows, height);
+    if((yEnd <= y) || (++steps > height)) return bad + 1;
+    for(; y<yEnd; y++) {
+      memset(&table[y * width], y & 255, width);
+      written[y]++;
+    }
+  }
+  for(int r=0; r<height; r++) {
+    if(written[r] != 1) bad++;
+    for(int x=0; x<width; x++) if(table[r * width + x] != (r & 255)) { bad++; break; }
+  }
+  return bad;
+}
+
+// REPLAY ------------------------------------------------------------------
+
+int main(int argc, char *argv[]) {
+  std::string               root = "../mdo_m4_eyes/eyes";
+  uint32_t                  ram  = 0;
+  std::vector<const char *> files;
+  for(int i=1; i<argc; i++) {
+    if(!strcmp(argv[i], "--eyes") && (i + 1 < argc))      numEyes = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "--ram") && (i + 1 < argc))  ram     = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "--root") && (i + 1 < argc)) root    = argv[++i];
+    else                                                  files.push_back(argv[i]);
+  }
+  if((numEyes < 1) || (numEyes > 2) || files.empty()) {
+    printf("Give config files (and --eyes 1 or 2), see top of Simul8_memPlan.cpp\n");
+    return 1;
+  }
+  bool allOk = true;
+  for(const char *name : files) {
+    cfg = eyeConfig();
+    FILE *f = fopen(name, "rb");
+    if(!f || !cfgParse(fileRead, f, configValue)) {
+      int         line  = 0;
+      const char *error = f ? cfgError(&line) : "not found";
+      printf("%s: can't read (line %d: %s)\n", name, line, error);
+      if(f) fclose(f);
+      allOk = false;
+      continue;
+    }
+    fclose(f);
+
+    // Defaults and limits, as the end of loadConfig()
+    int eyeRadius  = planEyeRadius(cfg.eyeRadius, DISPLAY_SIZE);
+    int irisRadius = planIrisRadius(cfg.irisRadius, DISPLAY_SIZE);
+    int slit       = std::min(abs(cfg.slitPupilRadius), irisRadius), slits = 0;
+    for(int e=0; e<numEyes; e++) {
+      int ir = cfg.eyeIris[e] ? abs(cfg.eyeIris[e]) : irisRadius;
+      int sr = (cfg.eyeSlit[e] < 0) ? slit : std::min(cfg.eyeSlit[e], ir);
+      if(sr > 0) slits++;
+    }
+    float coverage  = std::max(0.0f, std::min(cfg.coverage, 1.0f));
+    int   mapRadius = planMapRadius(eyeRadius, coverage);
+
+    // RELOAD_SCRATCH: one block for the largest image
+    std::vector<std::pair<std::string, int>> images; // Path, depth
+    for(int e=0; e<numEyes; e++) {
+      if(!cfg.iris[e].empty())   images.push_back({ root + "/" + cfg.iris[e], 24 });
+      if(!cfg.sclera[e].empty()) images.push_back({ root + "/" + cfg.sclera[e], 24 });
+    }
+    images.push_back({ root + "/" + cfg.upperEyelid, 1 });
+    images.push_back({ root + "/" + cfg.lowerEyelid, 1 });
+    if(!cfg.eyelidPoses.empty()) {
+      for(const std::string &p : poseFiles(root + "/" + cfg.eyelidPoses)) images.push_back({ p, 1 });
+    }
+    uint32_t    need = 0;
+    std::string missing;
+    for(auto &img : images) {
+      uint32_t n = imageScratch(img.first);
+      if(!n) missing += " " + img.first.substr(root.size() + 1);
+      need = std::max(need, n);
+    }
+    std::vector<uint8_t> scratchMem(need + 4);
+    Arena scratch;
+    scratch.begin(need ? scratchMem.data() : NULL, need);
+    // RELOAD_TEXTURES, RELOAD_EYELIDS
+    for(auto &img : images) loadImage(&scratch, img.first, img.second);
+
+    // RELOAD_SHAPES, RELOAD_MAP, RELOAD_DISPLACE: the tables block
+    uint32_t plan = planTables(mapRadius, DISPLAY_SIZE, numEyes * 2);
+    std::vector<uint8_t> tablesMem(plan);
+    Arena tables;
+    tables.begin(tablesMem.data(), plan);
+    int slitSlots = 0;
+    for(int i=0; i<numEyes*2; i++) slitSlots += (tables.alloc(SLIT_BYTES) != NULL);
+    int badRows = stepTable(&tables, mapRadius * 2, mapRadius, MAP_ROWS_PER_STEP) +
+                  stepTable(&tables, DISPLAY_SIZE/2, DISPLAY_SIZE/2, DISPLACE_ROWS_PER_STEP);
+
+    uint32_t biggest = std::max(need, plan) + cfg.stackReserve;
+    bool     ok      = !scratch.failed() && (scratch.peak() <= need) && !tables.failed() &&
+                       (tables.used() == plan) && (slitSlots >= slits) && !badRows &&
+                       (!ram || (biggest <= ram));
+    printf("%s: mapRadius %d, %d images; scratch %d of %d; tables %d of %d, %d slit maps; "
+      "needs %d with stackReserve\n", name, mapRadius, (int)images.size(), scratch.peak(),
+      need, tables.used(), plan, slits, biggest);
+    if(!missing.empty()) printf("  not there or not a usable BMP (not loaded):%s\n", missing.c_str());
+    if(scratch.failed()) printf("  %d scratch allocations refused\n", scratch.failed());
+    if(tables.failed())  printf("  %d table allocations refused\n", tables.failed());
+    if(!tables.failed() && (tables.used() != plan)) printf("  %d table bytes unused\n", plan - tables.used());
+    if(badRows)          printf("  %d table rows written other than once\n", badRows);
+    if(ram && (biggest > ram)) printf("  doesn't fit in %d bytes\n", ram);
+    if(!ok) allOk = false;
+  }
+  printf("%s\n", allOk ? "All ok" : "FAILED");
+  return allOk ? 0 : 1;
+}
@@ -0,0 +1,476 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_Simul8
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+//
+// Runs the sketch's animation code itself (animclock.cpp, gaze.cpp,
+// expressions.cpp, eyelids.cpp) on a computer, with loop()'s once-per-
+// frame logic around it, to check that "replayLog" gives back exactly
+// the frames that were recorded.
+//
+//   g++ -O2 -I../mdo_m4_eyes -include Simul8_sketch.h Simul8_replay.cpp ../mdo_m4_eyes/animclock.cpp ../mdo_m4_eyes/gaze.cpp ../mdo_m4_eyes/expressions.cpp ../mdo_m4_eyes/eyelids.cpp ../mdo_m4_eyes/ExpressionBlend.cpp ../mdo_m4_eyes/AnimLog.cpp ../mdo_m4_eyes/configparse.cpp -o replay
+//   ./replay [--seed 47] [--frames 1200] [--light] [--boop]
+//            [--file ../mdo_m4_eyes/eyes/hazel/expressions.eye]
+//            [--poses ../mdo_m4_eyes/eyes/hazel/poses] [--log eyelog.bin] [--verbose]
+//
+// Records --frames eye frames with a made-up clock that jitters (and
+// sometimes stalls, as file access does), made-up light sensor and boop
+// readings (--light, --boop, as in the board's config) and user code
+// changing expression, queuing gaze targets, taking over the eyes and
+// setting vergence now and then. Then it replays that log twice, each
+// time with a different clock and readings, which the log has to
+// override. Every frame's state is compared across the three runs:
+// time, eye position, pupil, blink and lid factors, the expression
+// values and spin, and a hash of the lid edges lidFrame() made. A run
+// with the other clock and no log has to differ, so the check can fail.
+//
+// --log replays a log from a board twice instead and compares the two
+// replays (not against the board: its user code isn't here). Use the
+// same --light/--boop and -DNUM_EYES=1 for a HalloWing log.
+//
+// Each run is a child process, as static state in the sketch files is
+// only set up once. Pose images are listed from --poses but their edges
+// are made up here from the name (no BMP reader), as are the eyelids.
+// A temporary log is written in the current directory and removed.
+
+#include <unistd.h>
+#include <sys/wait.h>
+#include <vector>
+#include "ExpressionBlend.h"
+#include "XorShift.h"
+
+hostArcada arcada;
+hostSerial Serial;
+
+// GLOBALS -----------------------------------------------------------------
+
+// As loadConfig() leaves them with no settings in the config
+int       DISPLAY_SIZE     = 240;
+int       eyeRadius        = 125;
+int       mapRadius        = 236;
+int       mapDiameter      = 472;
+uint16_t  upperOpen[MAX_DISPLAY_SIZE];
+uint16_t  upperClosed[MAX_DISPLAY_SIZE];
+uint16_t  lowerOpen[MAX_DISPLAY_SIZE];
+uint16_t  lowerClosed[MAX_DISPLAY_SIZE];
+char     *recordLogFile    = NULL;
+char     *replayLogFile    = NULL;
+bool      tracking         = true;
+float     trackFactor      = 0.5;
+uint32_t  gazeMax          = 3000000;
+bool      moveEyesRandomly = true;
+float     eyeTargetX       = 0.0;
+float     eyeTargetY       = 0.0;
+eyeStruct eye[NUM_EYES];
+
+// From mdo_m4_eyes.ino
+static uint32_t timeOfLastBlink   = 0L,
+                timeToNextBlink   = 0L;
+static uint32_t lastLightReadTime = 0;
+static float    lastLightValue    = 0.5;
+static double   irisValue         = 0.5;
+static uint32_t boopSum           = 0,
+                boopSumFiltered   = 0,
+                boopThreshold     = 0;
+static bool     booped            = false;
+static float    irisMin           = 0.45,
+                irisRange         = 0.35;
+static uint16_t lightSensorMin    = 0,
+                lightSensorMax    = 1023;
+static float    lightSensorCurve  = 1.0;
+static int8_t   lightSensorPin    = -1;
+static int8_t   boopPin           = -1;
+#define         IRIS_LEVELS 7
+static float    iris_prev[IRIS_LEVELS] = { 0 };
+static float    iris_next[IRIS_LEVELS] = { 0 };
+static uint16_t iris_frame = 0;
+
+// STAND-INS ---------------------------------------------------------------
+
+static uint32_t now = 1000000; // The made-up clock, micros
+static XorShift live;          // Made-up clock jitter and sensor readings
+
+uint32_t micros(void) {
+  return now;
+}
+
+bool fileReady(const char *filename) {
+  return true;
+}
+
+static int fileRead(void *ctx, uint8_t *buf, int n) {
+  return ((File *)ctx)->read(buf, n);
+}
+
+bool configParse(File *file, volatile const uint8_t *mem, uint32_t memLen,
+  cfgHandler handler) {
+  return cfgParse(fileRead, file, handler);
+}
+
+uint32_t imageScratch(const char *filename) {
+  return 0;
+}
+
+// A pose's edges: open closed by 1/8 to 5/8, picked by its name
+ImageReturnCode loadEyelid(char *filename, uint16_t *minArray,
+  uint16_t *maxArray, uint8_t init) {
+  uint32_t h = 2166136261;
+  for(const char *c = filename; *c; c++) h = (h ^ (uint8_t)*c) * 16777619;
+  int f = (h % 5) + 1;
+  for(int x=0; x<DISPLAY_SIZE; x++) {
+    minArray[x] = lowerOpen[x] + (lowerClosed[x] - lowerOpen[x]) * f / 8;
+    maxArray[x] = upperOpen[x] + (upperClosed[x] - upperOpen[x]) * f / 8;
+  }
+  return IMAGE_SUCCESS;
+}
+
+// Made-up eyelid edges, 8.8: curved open, meeting mid-screen closed
+static void makeEyelids(void) {
+  for(int x=0; x<DISPLAY_SIZE; x++) {
+    int c    = x - DISPLAY_SIZE / 2,
+        bump = (DISPLAY_SIZE * DISPLAY_SIZE / 4 - c * c) / (DISPLAY_SIZE * 3);
+    upperOpen[x]   = (DISPLAY_SIZE * 3 / 4 + bump) << 8;
+    lowerOpen[x]   = (DISPLAY_SIZE / 4 - bump) << 8;
+    upperClosed[x] = lowerClosed[x] = (DISPLAY_SIZE / 2) << 8;
+  }
+}
+
+// From tablegen.cpp
+static float map2screen(int in) {
+  return sin((float)in / (float)mapRadius) * M_PI_2 * eyeRadius;
+}
+
+// LOOP --------------------------------------------------------------------
+
+// What a frame ended up as, compared between runs
+typedef struct {
+  uint32_t t;
+  uint8_t  eye;
+  float    eyeX, eyeY, pupilFactor, blinkFactor, upperLidFactor, lowerLidFactor;
+  float    expr[ExpressionBlend::COUNT];
+  int      spin;
+  uint32_t lids; // FNV-1a of lidLow/lidHigh
+} frameState;
+
+static const char *exprNames[] = { "alert", "sleepy", "angry", "hypnotized", "idle" };
+
+// Once-per-frame logic for eyeNum, as loop()
+static void eyeFrame(uint8_t eyeNum) {
+  uint32_t t = animFrame(eyeNum);
+
+  if(!eyeNum) exprFrame(t);
+
+  if(!eyeNum) gazeTick(t, booped);
+  gazeLatch(eyeNum);
+
+  float mix = exprGet(ExpressionBlend::PUPILMIX);
+  eye[eyeNum].pupilFactor = irisValue +
+    ((1.0 - exprGet(ExpressionBlend::PUPIL)) - irisValue) * mix;
+
+  if((t - timeOfLastBlink) >= timeToNextBlink) { // Start new blink?
+    timeOfLastBlink = t;
+    uint32_t blinkDuration = animRandom(36000, 72000); // ~1/28 - ~1/14 sec
+    for(uint8_t e=0; e<NUM_EYES; e++) {
+      if(eye[e].blink.state == NOBLINK) {
+        eye[e].blink.state     = ENBLINK;
+        eye[e].blink.startTime = t;
+        eye[e].blink.duration  = blinkDuration;
+      }
+    }
+    timeToNextBlink = blinkDuration * 3 +
+      animRandom(4000000) * exprGet(ExpressionBlend::BLINK);
+  }
+
+  float uq, lq;
+  if(tracking) {
+    int ix = (int)map2screen(mapRadius - eye[eyeNum].eyeX) + (DISPLAY_SIZE/2),
+        iy = (int)map2screen(mapRadius - eye[eyeNum].eyeY) + (DISPLAY_SIZE/2);
+    iy += eye[eyeNum].irisRadius * trackFactor;
+    if(eyeNum & 1) ix = DISPLAY_SIZE - 1 - ix;
+    iy <<= 8;
+    if(iy > upperOpen[ix]) {
+      uq = 1.0;
+    } else if(iy < upperClosed[ix]) {
+      uq = 0.0;
+    } else {
+      uq = (float)(iy - upperClosed[ix]) / (float)(upperOpen[ix] - upperClosed[ix]);
+    }
+    if(booped) {
+      uq = 0.9;
+      lq = 0.7;
+    } else {
+      lq = 1.0 - uq;
+    }
+  } else {
+    uq = 1.0;
+    lq = 1.0;
+  }
+  eye[eyeNum].upperLidFactor = (eye[eyeNum].upperLidFactor * 0.6) + (uq * 0.4);
+  eye[eyeNum].lowerLidFactor = (eye[eyeNum].lowerLidFactor * 0.6) + (lq * 0.4);
+
+  if(eye[eyeNum].blink.state) {
+    if((t - eye[eyeNum].blink.startTime) >= eye[eyeNum].blink.duration) {
+      if(++eye[eyeNum].blink.state > DEBLINK) {
+        eye[eyeNum].blink.state = NOBLINK;
+        eye[eyeNum].blinkFactor = 0.0;
+      } else {
+        eye[eyeNum].blink.duration *= 2;
+        eye[eyeNum].blink.startTime = t;
+        eye[eyeNum].blinkFactor = 1.0;
+      }
+    } else {
+      eye[eyeNum].blinkFactor = (float)(t - eye[eyeNum].blink.startTime) / (float)eye[eyeNum].blink.duration;
+      if(eye[eyeNum].blink.state == DEBLINK) eye[eyeNum].blinkFactor = 1.0 - eye[eyeNum].blinkFactor;
+    }
+  }
+
+  if((eyeNum == 0) && (boopPin >= 0)) {
+    boopSum         = animInput(ANIM_IN_BOOP, boopSum);
+    boopSumFiltered = ((boopSumFiltered * 3) + boopSum) / 4;
+    booped          = boopSumFiltered > boopThreshold;
+    boopSum         = 0;
+  }
+
+  lidFrame(eyeNum, t,
+    (1.0 - eye[eyeNum].blinkFactor) * eye[eyeNum].upperLidFactor,
+    (1.0 - eye[eyeNum].blinkFactor) * eye[eyeNum].lowerLidFactor);
+
+  // After the columns are drawn
+  if(eyeNum == (NUM_EYES-1)) {
+    if(lightSensorPin >= 0) {
+      #define LIGHT_INTERVAL (1000000 / 10)
+      if((t - lastLightReadTime) >= LIGHT_INTERVAL) {
+        // Mostly steady, now and then a change, sometimes an I2C error
+        uint16_t rawReading = animInput(ANIM_IN_LIGHT,
+          (live.random(20) == 0) ? 65535 : 400 + live.random(200));
+        if(rawReading <= 1023) {
+          if(rawReading < lightSensorMin)      rawReading = lightSensorMin;
+          else if(rawReading > lightSensorMax) rawReading = lightSensorMax;
+          float v = (float)(rawReading - lightSensorMin) / (float)(lightSensorMax - lightSensorMin);
+          v = pow(v, lightSensorCurve);
+          lastLightValue    = irisMin + v * irisRange;
+          lastLightReadTime = t;
+        } else {
+          lastLightReadTime = t - LIGHT_INTERVAL + 30000;
+        }
+      }
+      irisValue = (irisValue * 0.97) + (lastLightValue * 0.03);
+    } else {
+      float n, sum = 0.5;
+      for(uint16_t i=0; i<IRIS_LEVELS; i++) {
+        uint16_t iexp  = 1 << (i+1);
+        uint16_t imask = (iexp - 1);
+        uint16_t ibits = iris_frame & imask;
+        if(ibits) {
+          float weight = (float)ibits / (float)iexp;
+          n            = iris_prev[i] * (1.0 - weight) + iris_next[i] * weight;
+        } else {
+          n            = iris_next[i];
+          iris_prev[i] = iris_next[i];
+          iris_next[i] = -0.5 + ((float)animRandom(1000) / 999.0);
+        }
+        iexp = 1 << (IRIS_LEVELS - i);
+        sum += n / (float)iexp;
+      }
+      irisValue = irisMin + (sum * irisRange);
+      if((++iris_frame) >= (1 << IRIS_LEVELS)) iris_frame = 0;
+    }
+  }
+  // Boop is summed over all columns; a touch every few seconds
+  if(boopPin >= 0) boopSum += ((now / 1000000) % 4) ? live.random(40) : 400;
+}
+
+// user_loop(), once per frame of the last eye: depends only on the frame
+// count, so it's the same every run
+static void userLoop(uint32_t frame) {
+  if(!(frame % 100)) exprSet(exprFind(exprNames[(frame / 100) % 5]));
+  if(frame == 230) {
+    gazeQueue(-0.8, 0.0, 200000, 300000);
+    gazeQueue(0.8, 0.5, 100000, 200000);
+    gazeQueue(0.0, -0.8, 300000, 0);
+  }
+  if(frame == 350) moveEyesRandomly = false;
+  if(!moveEyesRandomly) {
+    eyeTargetX = sin((float)frame / 10.0);
+    eyeTargetY = cos((float)frame / 13.0);
+  }
+  if(frame == 420) moveEyesRandomly = true;
+  if(frame == 450) vergenceTarget(150.0);
+  if(frame == 500) vergenceTarget(0.0);
+}
+
+static uint32_t fnv1a(const void *data, uint32_t len, uint32_t h) {
+  for(uint32_t i=0; i<len; i++) h = (h ^ ((const uint8_t *)data)[i]) * 16777619;
+  return h;
+}
+
+// One run as the board would do it, from setup(), writing each frame's
+// state to fd
+static void session(uint32_t liveSeed, uint32_t frames, const char *exprFile,
+  const char *posesDir, int fd) {
+  live.seed(liveSeed);
+  makeEyelids();
+  animBegin(live.next()); // Before user_setup()
+  exprRead(exprFile);     // As loadConfig()
+  exprUse();
+  lidPosesLoad(posesDir); // As the background loader
+  lidPosesUse();
+  animLogBegin();
+  gazeBegin();
+  for(uint8_t e=0; e<NUM_EYES; e++) {
+    eye[e].irisRadius = planIrisRadius(0, DISPLAY_SIZE);
+    eye[e].eyeX       = mapRadius;
+    eye[e].eyeY       = mapRadius;
+  }
+  if(boopPin >= 0) boopThreshold = animInput(ANIM_IN_BOOP, 200 + live.random(20));
+  lastLightReadTime = animMicros() + 2000000;
+
+  for(uint32_t f=0; f<frames; f++) {
+    uint8_t e = f % NUM_EYES;
+    // Columns take 7-11 ms, now and then a stall for file access
+    now += (live.random(50) == 0) ? live.random(30000, 80000) : live.random(7000, 11000);
+    eyeFrame(e);
+    if(e == (NUM_EYES-1)) userLoop(f / NUM_EYES);
+
+    frameState s;
+    memset(&s, 0, sizeof s); // Padding too, it's compared as bytes
+    s.t              = animMicros();
+    s.eye            = e;
+    s.eyeX           = eye[e].eyeX;
+    s.eyeY           = eye[e].eyeY;
+    s.pupilFactor    = eye[e].pupilFactor;
+    s.blinkFactor    = eye[e].blinkFactor;
+    s.upperLidFactor = eye[e].upperLidFactor;
+    s.lowerLidFactor = eye[e].lowerLidFactor;
+    for(uint8_t p=0; p<ExpressionBlend::COUNT; p++) s.expr[p] = exprGet(p);
+    s.spin           = exprSpinAngle();
+    s.lids           = fnv1a(eye[e].lidHigh, DISPLAY_SIZE * 2,
+                       fnv1a(eye[e].lidLow, DISPLAY_SIZE * 2, 2166136261));
+    if(write(fd, &s, sizeof s) != sizeof s) _exit(1);
+  }
+  animLogEnd(); // Saves a recording
+}
+
+// Run session() in a child process, return its frames
+static std::vector<frameState> run(uint32_t liveSeed, uint32_t frames,
+  const char *exprFile, const char *posesDir) {
+  std::vector<frameState> out;
+  int                     fds[2], status;
+  fflush(stdout);
+  if(pipe(fds)) return out;
+  pid_t pid = fork();
+  if(!pid) {
+    close(fds[0]);
+    session(liveSeed, frames, exprFile, posesDir, fds[1]);
+    close(fds[1]);
+    fflush(stdout);
+    _exit(0);
+  }
+  close(fds[1]);
+  frameState s;
+  while(read(fds[0], &s, sizeof s) == sizeof s) out.push_back(s);
+  close(fds[0]);
+  waitpid(pid, &status, 0);
+  if(!WIFEXITED(status) || WEXITSTATUS(status)) out.clear();
+  return out;
+}
+
+// CHECKS ------------------------------------------------------------------
+
+static bool ok = true;
+
+static void showFrame(const char *what, const frameState *s) {
+  printf("    %-8s eye %d t %u eye %.3f,%.3f pupil %.4f blink %.3f lids %.3f,%.3f"
+    " gaze %.3f distance %.1f spin %d edges %08x\n", what, s->eye, s->t,
+    s->eyeX, s->eyeY, s->pupilFactor, s->blinkFactor, s->upperLidFactor,
+    s->lowerLidFactor, s->expr[ExpressionBlend::GAZE],
+    s->expr[ExpressionBlend::DISTANCE], s->spin, s->lids);
+}
+
+// Frame by frame; 'same' = whether they should match
+static void compare(const char *what, const char *na, std::vector<frameState> &a,
+  const char *nb, std::vector<frameState> &b, uint32_t frames, bool same) {
+  uint32_t f = 0;
+  while((f < a.size()) && (f < b.size()) && !memcmp(&a[f], &b[f], sizeof(frameState))) f++;
+  bool match = (f == frames) && (a.size() == frames) && (b.size() == frames);
+  printf("  %-40s ", what);
+  if(match) printf("%u frames the same", frames);
+  else      printf("differ from frame %u of %u", f, frames);
+  printf("%s\n", (match == same) ? "" : "  WRONG");
+  if(match != same) {
+    ok = false;
+    if((f < a.size()) && (f < b.size())) {
+      showFrame(na, &a[f]);
+      showFrame(nb, &b[f]);
+    }
+  }
+}
+
+// Eye frames in a log: count the frame records (see AnimLog.h)
+static uint32_t logFrames(const char *name) {
+  FILE    *f = fopen(name, "rb");
+  uint32_t n = 0;
+  int      c;
+  if(!f) return 0;
+  for(int i=0; i<10; i++) fgetc(f); // Header
+  while((c = fgetc(f)) != EOF) {
+    if((c & 0xF0) == 0x10) n++;
+    while(((c = fgetc(f)) != EOF) && (c & 0x80));
+  }
+  fclose(f);
+  return n;
+}
+
+int main(int argc, char *argv[]) {
+  uint32_t    seed     = 47, frames = 1200;
+  const char *exprFile = "../mdo_m4_eyes/eyes/hazel/expressions.eye",
+             *posesDir = "../mdo_m4_eyes/eyes/hazel/poses",
+             *logFile  = NULL;
+  for(int i=1; i<argc; i++) {
+    if(!strcmp(argv[i], "--seed") && (i + 1 < argc))        seed     = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "--frames") && (i + 1 < argc)) frames   = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "--file") && (i + 1 < argc))   exprFile = argv[++i];
+    else if(!strcmp(argv[i], "--poses") && (i + 1 < argc))  posesDir = argv[++i];
+    else if(!strcmp(argv[i], "--log") && (i + 1 < argc))    logFile  = argv[++i];
+    else if(!strcmp(argv[i], "--light"))                    lightSensorPin = 102;
+    else if(!strcmp(argv[i], "--boop"))                     boopPin  = 1;
+    else if(!strcmp(argv[i], "--verbose"))                  Serial.verbose = true;
+  }
+  printf("%d eyes, light sensor %s, boop %s\n", NUM_EYES,
+    (lightSensorPin >= 0) ? "on" : "off", (boopPin >= 0) ? "on" : "off");
+
+  if(logFile) {
+    frames = logFrames(logFile);
+    printf("Replaying %s (%u frames) twice:\n", logFile, frames);
+    if(!frames) {
+      printf("No frames in it\nFAILED\n");
+      return 1;
+    }
+    replayLogFile = (char *)logFile;
+    std::vector<frameState> r1 = run(seed + 1, frames, exprFile, posesDir),
+                            r2 = run(seed + 2, frames, exprFile, posesDir);
+    compare("replays match", "replay 1", r1, "replay 2", r2, frames, true);
+  } else {
+    const char *tmp = "Simul8_replay.bin";
+    printf("Record %u frames, replay twice, seed %u:\n", frames, seed);
+    remove(tmp);
+    recordLogFile = (char *)tmp;
+    std::vector<frameState> rec = run(seed, frames, exprFile, posesDir);
+    recordLogFile = NULL;
+    replayLogFile = (char *)tmp;
+    std::vector<frameState> r1  = run(seed + 1, frames, exprFile, posesDir),
+                            r2  = run(seed + 2, frames, exprFile, posesDir);
+    replayLogFile = NULL;
+    std::vector<frameState> lv  = run(seed + 1, frames, exprFile, posesDir);
+    uint32_t logged = logFrames(tmp);
+    printf("  %-40s %u frames%s\n", "log written", logged, (logged == frames) ? "" : "  WRONG");
+    if(logged != frames) ok = false;
+    compare("replay 1 matches recording", "recorded", rec, "replay 1", r1, frames, true);
+    compare("replay 2 matches replay 1", "replay 1", r1, "replay 2", r2, frames, true);
+    compare("live run with replay 1's clock differs", "recorded", rec, "live", lv, frames, false);
+    remove(tmp);
+  }
+  printf("%s\n", ok ? "All ok" : "FAILED");
+  return ok ? 0 : 1;
+}
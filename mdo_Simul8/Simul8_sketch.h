@@ -0,0 +1,228 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_Simul8
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+//
+// Stand-in for mdo_m4_eyes/globals.h and the Arduino libraries, so sketch
+// files themselves (not just the Arduino-free modules) build on a
+// computer. Force it in ahead of them with -include:
+//
+//   g++ -O2 -I../mdo_m4_eyes -include Simul8_sketch.h Simul8_expressions.cpp ../mdo_m4_eyes/expressions.cpp ...
+//
+// It defines globals.h's include guard, so their #include "globals.h"
+// gets this instead. Only what the sketch files built on a computer use
+// is here, eyeStruct cut down to the animation state. The tool defines
+// the globals it uses, Serial and arcada, micros(), and any functions
+// from sketch files it doesn't build.
+
+#ifndef __GLOBALS_H
+#define __GLOBALS_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <math.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include "ConfigParse.h"
+#include "MemPlan.h"
+
+// ARDUINO -----------------------------------------------------------------
+
+#define FILE_READ 0
+#define O_WRITE   O_WRONLY
+#define SD_MAX_FILENAME_SIZE 80
+
+// Arduino's is a macro; a function here so <chrono> etc. still build
+template<class A, class B> static inline auto min(A a, B b) -> decltype(a + b) {
+  return (a < b) ? a : b;
+}
+
+// A file on the computer, as SdFat's File
+class File {
+public:
+  File(FILE *f = NULL, const char *n = "") : fp(f) {
+    strncpy(name, n, sizeof name - 1);
+    name[sizeof name - 1] = 0;
+  }
+  operator bool() const { return fp != NULL; }
+  int      read(void *buf, int n) { return fp ? (int)fread(buf, 1, n, fp) : 0; }
+  int      write(const void *buf, int n) { return fp ? (int)fwrite(buf, 1, n, fp) : 0; }
+  uint32_t size(void) {
+    long here = ftell(fp), len;
+    fseek(fp, 0, SEEK_END);
+    len = ftell(fp);
+    fseek(fp, here, SEEK_SET);
+    return (uint32_t)len;
+  }
+  void     getName(char *buf, int n) { snprintf(buf, n, "%s", name); }
+  void     close(void) { if(fp) fclose(fp); fp = NULL; }
+  FILE    *fp;
+  char     name[SD_MAX_FILENAME_SIZE+1];
+};
+
+// Paths are as given, relative to where the tool runs
+class hostArcada {
+public:
+  File open(const char *name, int mode) {
+    return File(fopen(name, (mode == FILE_READ) ? "rb" : "wb"), name);
+  }
+  // The i'th file in 'dir' ending in '.ext', in name order (SdFat's is
+  // directory order, which is the order they were copied)
+  File openFileByIndex(const char *dir, int i, int mode, const char *ext) {
+    struct dirent **list;
+    File            file;
+    int             n = scandir(dir, &list, NULL, alphasort);
+    for(int j=0; j<n; j++) {
+      const char *dot = strrchr(list[j]->d_name, '.');
+      if(!file && dot && !strcasecmp(dot + 1, ext) && !i--) {
+        char path[512];
+        snprintf(path, sizeof path, "%s/%s", dir, list[j]->d_name);
+        file = File(fopen(path, "rb"), list[j]->d_name);
+      }
+      free(list[j]);
+    }
+    if(n >= 0) free(list);
+    return file;
+  }
+};
+
+// Messages only when 'verbose' is set, so tool output stays readable
+class hostSerial {
+public:
+  bool verbose = false;
+  void printf(const char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    if(verbose) vprintf(fmt, ap);
+    va_end(ap);
+  }
+  void println(const char *s) { if(verbose) puts(s); }
+};
+
+extern hostArcada arcada;
+extern hostSerial Serial;
+
+uint32_t micros(void);           // The tool's clock
+static inline void randomSeed(uint32_t seed) { srand(seed); }
+
+// GLOBALS.H ---------------------------------------------------------------
+
+#ifndef NUM_EYES
+#define NUM_EYES 2 // -DNUM_EYES=1 for HalloWing
+#endif
+#define MAX_DISPLAY_SIZE 240
+
+extern int       DISPLAY_SIZE;
+extern int       eyeRadius;
+extern int       mapRadius;
+extern int       mapDiameter;
+extern uint16_t  upperOpen[MAX_DISPLAY_SIZE];
+extern uint16_t  upperClosed[MAX_DISPLAY_SIZE];
+extern uint16_t  lowerOpen[MAX_DISPLAY_SIZE];
+extern uint16_t  lowerClosed[MAX_DISPLAY_SIZE];
+extern char     *recordLogFile;
+extern char     *replayLogFile;
+extern bool      tracking;
+extern float     trackFactor;
+extern uint32_t  gazeMax;
+extern bool      moveEyesRandomly;
+extern float     eyeTargetX;
+extern float     eyeTargetY;
+
+#define NOBLINK 0
+#define ENBLINK 1
+#define DEBLINK 2
+typedef struct {
+  uint8_t  state;
+  uint32_t duration;
+  uint32_t startTime;
+} eyeBlink;
+
+#define LID_POSE_OPEN   0
+#define LID_POSE_CLOSED 1
+#define LID_POSE_HERE   255
+#define LID_EASE_LINEAR 0
+#define LID_EASE_IN     1
+#define LID_EASE_OUT    2
+#define LID_EASE_INOUT  3
+typedef struct {
+  uint8_t  from, to;
+  uint8_t  ease;
+  uint32_t startTime;
+  uint32_t duration;
+  uint16_t hereLower[MAX_DISPLAY_SIZE], hereUpper[MAX_DISPLAY_SIZE];
+} lidAnim;
+
+// The animation state from globals.h's, none of the display side
+typedef struct {
+  int      irisRadius;
+  eyeBlink blink;
+  float    eyeX, eyeY;
+  float    pupilFactor;
+  float    blinkFactor;
+  float    upperLidFactor, lowerLidFactor;
+  lidAnim  lid;
+  uint16_t lidLow[MAX_DISPLAY_SIZE], lidHigh[MAX_DISPLAY_SIZE];
+} eyeStruct;
+
+extern eyeStruct eye[NUM_EYES];
+
+enum ImageReturnCode { IMAGE_SUCCESS, IMAGE_ERR_FILE_NOT_FOUND,
+  IMAGE_ERR_FORMAT, IMAGE_ERR_MALLOC };
+
+// Functions in expressions.cpp
+extern void            exprRead(const char *filename);
+extern void            exprUse(void);
+extern int8_t          exprFind(const char *name);
+extern bool            exprSet(int8_t x);
+extern const char     *exprName(void);
+extern void            exprFrame(uint32_t t);
+extern float           exprGet(uint8_t param);
+extern int             exprSpinAngle(void);
+
+// From file.cpp
+extern bool            fileReady(const char *filename);
+extern bool            configParse(File *file, volatile const uint8_t *mem, uint32_t memLen, cfgHandler handler);
+extern ImageReturnCode loadEyelid(char *filename, uint16_t *minArray, uint16_t *maxArray, uint8_t init);
+extern uint32_t        imageScratch(const char *filename);
+
+// Functions in animclock.cpp
+enum { ANIM_IN_TIME, ANIM_IN_LIGHT, ANIM_IN_BOOP, ANIM_IN_BUTTONS,
+       ANIM_IN_PIR, ANIM_IN_HEATX, ANIM_IN_HEATY, ANIM_IN_HEATMAG,
+       ANIM_IN_USER };
+extern void            animClockSource(uint32_t (*fn)(void));
+extern void            animBegin(uint32_t seed);
+extern void            animLogBegin(void);
+extern void            animLogEnd(void);
+extern uint32_t        animFrame(uint8_t e);
+extern int32_t         animInput(uint8_t channel, int32_t live);
+extern float           animInputFloat(uint8_t channel, float live);
+extern uint32_t        animMicros(void);
+extern uint32_t        animMillis(void);
+extern int32_t         animRandom(int32_t howbig);
+extern int32_t         animRandom(int32_t howsmall, int32_t howbig);
+
+// Functions in eyelids.cpp
+extern int8_t          lidPoseFind(const char *name);
+extern uint32_t        lidPosesScratch(const char *dir);
+extern void            lidPosesLoad(const char *dir);
+extern void            lidPosesUse(void);
+extern void            lidPoseTo(int8_t e, uint8_t pose, uint32_t duration, uint8_t ease);
+extern bool            lidPoseMoving(uint8_t e);
+extern void            lidFrame(uint8_t e, uint32_t t, float upperFactor, float lowerFactor);
+
+// Functions in gaze.cpp
+extern void            gazeBegin(void);
+extern bool            gazeQueue(float x, float y, uint32_t moveTime, uint32_t holdTime);
+extern void            gazeClear(void);
+extern bool            gazeScripted(void);
+extern void            gazeFrame(uint32_t t, float *x, float *y);
+extern void            vergenceTarget(float mm);
+extern void            gazeTick(uint32_t t, bool booped);
+extern void            gazeLatch(uint8_t e);
+
+#endif
@@ -0,0 +1,316 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_Simul8
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+//
+// Runs the MONSTER M4SK voice changer's DSP on a computer, on WAV files,
+// to see what a change does before it goes on the board.
+//
+//   g++ -O2 -I../mdo_m4_eyes Simul8_voiceBench.cpp ../mdo_m4_eyes/PitchDetect.cpp ../mdo_m4_eyes/PitchShift.cpp ../mdo_m4_eyes/Psola.cpp ../mdo_m4_eyes/SoundLevels.cpp ../mdo_m4_eyes/VoiceDSP.cpp -o voiceBench
+//   ./voiceBench [--pitch 1.3] [--out shifted.wav [--psola]] [--ramp] [--levels] speech.wav ...
+//
+// Each file is resampled to the mic's 46,875 Hz and played through
+// pdmvoice.cpp's recording buffer and the firmware's own PitchShift and
+// PitchDetect, once with the fixed TYP_PITCH_HZ jump and once with
+// voicePitchTrack()'s pitch-period jump, then through Psola as in
+// "voiceMode" : "psola" (double buffer, tracked period). --out writes
+// the tracked run, or with --psola the PSOLA run. Reported:
+//   pitch  - detector time per call (this computer; the M4 is roughly
+//            20-40x slower) and how many calls found a pitch
+//   fill   - fill() time per output sample, same caveat
+//   seams  - jumps (PSOLA: grains), and how rough the output is (mean
+//            absolute second difference, over the input's; 1.00 =
+//            seams don't show)
+//   shift  - output's median pitch over the input's, as heard
+// With no file it uses a made-up voice gliding 90 to 300 Hz. --ramp
+// records a slow ramp instead and counts places the output skips, which
+// there should never be (playback lapped by the recording or vice versa).
+// --levels prints what voiceLevels() would say every 100 ms instead.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include "PitchDetect.h"
+#include "PitchShift.h"
+#include "Psola.h"
+#include "SoundLevels.h"
+
+// Same as pdmvoice.cpp
+#define MIN_PITCH_HZ   65
+#define MAX_PITCH_HZ 1600
+#define TYP_PITCH_HZ  175
+#define PITCH_INTERVAL 30000 // micros
+#define VOICE_BLOCK    128
+static const float    sampleRate = 3000000.0 / 64.0;
+static const uint16_t recBufSize = (uint16_t)(sampleRate / (float)MIN_PITCH_HZ * 2.0 + 0.5);
+#define TYP_JUMP (sampleRate / (float)TYP_PITCH_HZ)
+
+typedef struct {
+  double   detectSec, detectMax, fillSec;
+  uint32_t calls, voiced, seams, fillN, skips;
+  double   rough, shift;
+} result;
+
+static bool readWav(const char *path, std::vector<float> &out, float *rate) {
+  FILE *f = fopen(path, "rb");
+  if(!f) return false;
+  std::vector<uint8_t> d;
+  uint8_t buf[4096];
+  size_t  n;
+  while((n = fread(buf, 1, sizeof buf, f)) > 0) d.insert(d.end(), buf, buf + n);
+  fclose(f);
+  if((d.size() < 12) || memcmp(&d[0], "RIFF", 4) || memcmp(&d[8], "WAVE", 4)) return false;
+  uint16_t chans = 0, bits = 0;
+  for(size_t p = 12; p + 8 <= d.size();) {
+    uint32_t len = d[p+4] | (d[p+5] << 8) | (d[p+6] << 16) | ((uint32_t)d[p+7] << 24);
+    if(!memcmp(&d[p], "fmt ", 4)) {
+      chans = d[p+10] | (d[p+11] << 8);
+      *rate = (float)(d[p+12] | (d[p+13] << 8) | (d[p+14] << 16) | ((uint32_t)d[p+15] << 24));
+      bits  = d[p+22] | (d[p+23] << 8);
+    } else if(!memcmp(&d[p], "data", 4) && chans && ((bits == 8) || (bits == 16))) {
+      size_t bytes = bits / 8, frames = std::min((size_t)len, d.size() - p - 8) / (bytes * chans);
+      for(size_t i=0; i<frames; i++) {
+        float s = 0;
+        for(uint16_t c=0; c<chans; c++) {
+          const uint8_t *q = &d[p + 8 + (i * chans + c) * bytes];
+          s += (bits == 8) ? ((float)q[0] - 128.0f) / 128.0f : (float)(int16_t)(q[0] | (q[1] << 8)) / 32768.0f;
+        }
+        out.push_back(s / chans);
+      }
+      return true;
+    }
+    p += 8 + len + (len & 1);
+  }
+  return false;
+}
+
+static void writeWav(const char *path, const std::vector<int16_t> &s, uint32_t rate) {
+  FILE *f = fopen(path, "wb");
+  if(!f) return;
+  uint32_t bytes = s.size() * 2, v;
+  fwrite("RIFF", 1, 4, f); v = 36 + bytes; fwrite(&v, 4, 1, f);
+  fwrite("WAVEfmt ", 1, 8, f); v = 16; fwrite(&v, 4, 1, f);
+  uint16_t h[2] = { 1, 1 }; fwrite(h, 2, 2, f);
+  fwrite(&rate, 4, 1, f); v = rate * 2; fwrite(&v, 4, 1, f);
+  h[0] = 2; h[1] = 16; fwrite(h, 2, 2, f);
+  fwrite("data", 1, 4, f); fwrite(&bytes, 4, 1, f);
+  fwrite(s.data(), 2, s.size(), f);
+  fclose(f);
+}
+
+// Mic-rate 16-bit unsigned samples, as recBuf holds
+static std::vector<uint16_t> toMic(const std::vector<float> &in, float rate) {
+  std::vector<uint16_t> out;
+  float peak = 1e-6;
+  for(float s : in) peak = std::max(peak, fabsf(s));
+  for(double pos = 0; pos + 1 < in.size(); pos += rate / sampleRate) {
+    size_t i = (size_t)pos;
+    float  s = in[i] + (in[i + 1] - in[i]) * (float)(pos - i);
+    out.push_back((uint16_t)(32768 + s / peak * 24000.0));
+  }
+  return out;
+}
+
+static std::vector<float> synthVoice(void) {
+  std::vector<float> v;
+  double ph = 0;
+  for(int i=0; i<(int)sampleRate * 4; i++) {
+    double f0 = 90.0 + 210.0 * (0.5 - 0.5 * cos(2 * M_PI * i / (sampleRate * 4))), s = 0;
+    for(int k=1; k*f0 < 4000; k++) s += sin(k * ph) / k * ((k == 3) ? 2 : 1);
+    ph += 2 * M_PI * f0 / sampleRate;
+    v.push_back((float)s * 0.3f);
+  }
+  return v;
+}
+
+// Mean absolute second difference
+static double roughness(const std::vector<uint16_t> &v) {
+  double sum = 0;
+  for(size_t i=2; i<v.size(); i++) sum += fabs((double)v[i] - 2.0 * v[i-1] + v[i-2]);
+  return (v.size() > 2) ? sum / (v.size() - 2) : 0;
+}
+
+// Median pitch (Hz) of 12-bit 'v' played at 'rate', 0 if none found.
+// Measured as if at the mic rate (which the detector's set up for) and
+// scaled.
+static float medianHz(const std::vector<uint16_t> &v, float rate) {
+  float scale = rate / sampleRate;
+  rate = sampleRate;
+  std::vector<uint16_t> buf(recBufSize, 32768);
+  std::vector<float>    hz;
+  PitchDetect pd;
+  pd.begin(rate, MIN_PITCH_HZ, MAX_PITCH_HZ, recBufSize);
+  uint16_t idx  = 0;
+  size_t   step = (size_t)(rate * PITCH_INTERVAL / 1e6);
+  for(size_t i=0; i<v.size(); i++) {
+    if(++idx >= recBufSize) idx = 0;
+    buf[idx] = v[i] << 4;
+    if((i > recBufSize) && !(i % step)) {
+      float period = pd.detect(buf.data(), idx);
+      if(period > 0) hz.push_back(rate / period);
+    }
+  }
+  if(hz.empty()) return 0;
+  std::sort(hz.begin(), hz.end());
+  return hz[hz.size() / 2] * scale;
+}
+
+static std::vector<float> rampInput(void) {
+  return std::vector<float>((size_t)(sampleRate * 4), 0.0f); // Only the length's used
+}
+
+// pdmvoice.cpp's recording interrupt and block playback, the recording
+// at its rate and blocks filled as soon as the DAC frees one (as loop()
+// does); 'track' = voicePitchTrack() every PITCH_INTERVAL, 'psola' =
+// VOICE_MODE_PSOLA (always tracks)
+static result run(const std::vector<uint16_t> &mic, float pitch, bool track,
+                  bool psola, std::vector<int16_t> *wav) {
+  result   r = {};
+  uint16_t size = psola ? recBufSize * 2 : recBufSize;
+  std::vector<uint16_t> recBuf(size, 32768), block(VOICE_BLOCK), out;
+  PitchDetect pd;
+  PitchShift  ps;
+  Psola       pso;
+  pd.begin(sampleRate, MIN_PITCH_HZ, MAX_PITCH_HZ, size);
+  ps.begin(size, VOICE_BLOCK);
+  ps.pitch(pitch);
+  ps.jump((int)(TYP_JUMP + 0.5));
+  pso.begin(size, VOICE_BLOCK);
+  pso.pitch(pitch);
+  pso.period(TYP_JUMP);
+  if(psola) track = true;
+  float rate = psola ? 1.0 : pitch; // DAC rate over recording rate
+  uint16_t recIndex  = 0;
+  uint32_t lastTrack = 0, filled = 2; // 2 silent blocks to start
+  for(size_t m=0; m<mic.size(); m++) {
+    if(++recIndex >= size) recIndex = 0;
+    recBuf[recIndex] = mic[m];
+    uint32_t t = (uint32_t)(m * 1e6 / sampleRate);
+    if(track && ((t - lastTrack) >= PITCH_INTERVAL)) {
+      lastTrack = t;
+      auto  a      = std::chrono::steady_clock::now();
+      float period = pd.detect(recBuf.data(), recIndex);
+      double sec   = std::chrono::duration<double>(std::chrono::steady_clock::now() - a).count();
+      r.detectSec += sec;
+      r.detectMax  = std::max(r.detectMax, sec);
+      r.calls++;
+      if((period > 0) && psola) {
+        r.voiced++;
+        pso.period(period);
+      } else if(period > 0) { // As voicePitchTrack()
+        r.voiced++;
+        int n = (int)(TYP_JUMP / period + 0.5);
+        if(n < 1) n = 1;
+        uint16_t j = (uint16_t)(period * n + 0.5);
+        while((j > ps.jumpLimit()) && (n > 1)) j = (uint16_t)(period * --n + 0.5);
+        ps.jump(j);
+      }
+    }
+    // Blocks the DAC's played by now
+    uint32_t played = (uint32_t)((m + 1) * rate / VOICE_BLOCK);
+    while(filled <= played + 1) {
+      auto a = std::chrono::steady_clock::now();
+      if(psola) pso.fill(block.data(), VOICE_BLOCK, recBuf.data(), recIndex);
+      else      ps.fill(block.data(), VOICE_BLOCK, recBuf.data(), recIndex);
+      r.fillSec += std::chrono::duration<double>(std::chrono::steady_clock::now() - a).count();
+      r.fillN   += VOICE_BLOCK;
+      filled++;
+      out.insert(out.end(), block.begin(), block.end());
+    }
+  }
+  r.seams = psola ? pso.grains() : ps.jumps();
+  r.rough = roughness(out);
+  r.shift = medianHz(out, sampleRate * rate);
+  for(size_t i=size * 4; i<out.size(); i++) { // Once buffer's full
+    int step = (int)out[i] - (int)out[i-1]; // Ramp wraps are ~4096
+    if((abs(step) > 3) && (abs(step) < 2000)) r.skips++;
+  }
+  if(wav) for(uint16_t o : out) wav->push_back((int16_t)((o - 2048) * 16));
+  return r;
+}
+
+// SoundLevels fed as voiceListen() does, a block at a time
+static void levels(const std::vector<uint16_t> &mic) {
+  SoundLevels sl;
+  soundLevels s;
+  sl.begin(sampleRate);
+  size_t every = (size_t)(sampleRate * 0.1);
+  printf("  %6s %5s %5s %5s %5s  %-23s\n", "ms", "level", "peak", "floor", "voice", "bands 250/500/1k/2k");
+  for(size_t m=0; m + VOICE_BLOCK <= mic.size(); m += VOICE_BLOCK) {
+    sl.feed(&mic[m], VOICE_BLOCK);
+    if(((m + VOICE_BLOCK) / every != m / every) && sl.get(&s)) {
+      printf("  %6d %5d %5d %5d %5s ", (int)(m * 1000 / sampleRate), s.level, s.peak,
+        s.floor, s.voice ? "yes" : "-");
+      for(uint8_t b=0; b<SOUND_BANDS; b++) printf(" %5d", s.band[b]);
+      printf("\n");
+    }
+  }
+}
+
+static void report(const char *name, const result &r, double inRough, float inHz, bool ramp) {
+  printf("  %-7s", name);
+  if(r.calls) {
+    printf(" pitch %5.1f us/call (max %5.1f), %3d%% voiced,", r.detectSec / r.calls * 1e6,
+      r.detectMax * 1e6, r.voiced * 100 / r.calls);
+  } else {
+    printf(" %45s", "");
+  }
+  printf(" fill %4.1f ns/sample, seams %5d", r.fillN ? r.fillSec / r.fillN * 1e9 : 0, r.seams);
+  if(ramp) printf(", skips %d\n", r.skips);
+  else     printf(", roughness %.2f, shift %.2f\n", inRough ? r.rough / inRough : 0,
+                  inHz ? r.shift / inHz : 0);
+}
+
+int main(int argc, char *argv[]) {
+  float       pitch = 1.3;
+  const char *out   = NULL;
+  bool        ramp  = false, psola = false, listen = false;
+  std::vector<const char *> files;
+  for(int i=1; i<argc; i++) {
+    if(!strcmp(argv[i], "--pitch") && (i + 1 < argc))    pitch = atof(argv[++i]);
+    else if(!strcmp(argv[i], "--out") && (i + 1 < argc)) out   = argv[++i];
+    else if(!strcmp(argv[i], "--ramp"))                   ramp  = true;
+    else if(!strcmp(argv[i], "--psola"))                  psola = true;
+    else if(!strcmp(argv[i], "--levels"))                 listen = true;
+    else files.push_back(argv[i]);
+  }
+  if(files.empty() || ramp) files.assign(1, NULL);
+  for(const char *path : files) {
+    std::vector<float> in;
+    float rate = sampleRate;
+    if(ramp) {
+      in = rampInput();
+    } else if(!path) {
+      in = synthVoice();
+    } else if(!readWav(path, in, &rate)) {
+      fprintf(stderr, "%s: can't read (8/16-bit PCM WAV only)\n", path);
+      continue;
+    }
+    std::vector<uint16_t> mic;
+    if(ramp) for(size_t i=0; i<in.size(); i++) mic.push_back((uint16_t)(i / 4)); // 1/64 LSB out per sample, no wrap
+    else     mic = toMic(in, rate);
+    printf("%s: %.2f s, pitch %.2f\n", ramp ? "(ramp)" : path ? path : "(made-up voice)",
+      mic.size() / sampleRate, pitch);
+    if(listen) {
+      levels(mic);
+      continue;
+    }
+    std::vector<int16_t> wav;
+    double inRough = roughness(std::vector<uint16_t>(mic.begin(), mic.end())) / 16.0; // 16->12 bit
+    std::vector<uint16_t> mic12;
+    for(uint16_t v : mic) mic12.push_back(v >> 4);
+    float inHz = ramp ? 0 : medianHz(mic12, sampleRate);
+    report("fixed", run(mic, pitch, false, false, NULL), inRough, inHz, ramp);
+    report("tracked", run(mic, pitch, true, false, (out && !psola) ? &wav : NULL), inRough, inHz, ramp);
+    if(!ramp) { // Overlapping grains of a ramp aren't a ramp
+      report("psola", run(mic, pitch, true, true, (out && psola) ? &wav : NULL), inRough, inHz, ramp);
+    }
+    if(out) writeWav(out, wav, (uint32_t)(psola ? sampleRate : sampleRate * pitch + 0.5));
+  }
+  return 0;
+}
@@ -0,0 +1,158 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_Simul8
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+//
+// Lists, checks and writes the WAV catalog (mdo_m4_eyes/WavCatalog) for a
+// directory of WAV files on a computer, with the same code the board uses.
+//
+//   g++ -O2 -I../mdo_m4_eyes Simul8_wavCatalog.cpp ../mdo_m4_eyes/WavCatalog.cpp ../mdo_m4_eyes/WavStream.cpp -o wavCatalog
+//   ./wavCatalog [--write] [--find name] [--tag tag] dir
+//
+// Prints each .wav file's tag, format, length and where its samples start,
+// and whether dir/wavindex.bin is there and up to date (the board
+// rewrites it at startup if not). --write writes it, so the board needn't
+// read every header on first boot. --find and --tag look clips up the
+// way wavFind() and wavPick() do.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <strings.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "WavCatalog.h"
+
+static uint32_t fileRead(void *ctx, uint8_t *buf, uint32_t n) {
+  return fread(buf, 1, n, (FILE *)ctx);
+}
+
+static bool fileSkip(void *ctx, uint32_t n) {
+  return !fseek((FILE *)ctx, n, SEEK_CUR);
+}
+
+static const char *formatName(const wavFormat &f) {
+  if(f.format == WAV_IMA_ADPCM) return "ADPCM";
+  if(f.format == WAV_PCM)       return (f.bits == 8) ? "8-bit" : "16-bit";
+  return "(unplayable)";
+}
+
+// Same as wavCatalog() on the board, but in name order
+static void build(const std::string &dir, WavCatalog &cat) {
+  std::vector<std::string> names;
+  DIR *d = opendir(dir.c_str());
+  if(!d) return;
+  while(struct dirent *de = readdir(d)) {
+    size_t len = strlen(de->d_name);
+    if((len > 4) && !strcasecmp(de->d_name + len - 4, ".wav") && (de->d_name[0] != '.')) {
+      names.push_back(de->d_name);
+    }
+  }
+  closedir(d);
+  std::sort(names.begin(), names.end());
+  for(const std::string &n : names) {
+    if(cat.count() >= WAV_CAT_MAX) {
+      printf("  more than %d files, rest left out\n", WAV_CAT_MAX);
+      break;
+    }
+    FILE *f = fopen((dir + "/" + n).c_str(), "rb");
+    if(!f) continue;
+    wavFormat fmt;
+    if(!wavParse(fileRead, fileSkip, f, &fmt)) memset(&fmt, 0, sizeof fmt);
+    fseek(f, 0, SEEK_END);
+    if(!cat.add(n.c_str(), ftell(f), fmt)) printf("  %s skipped, name too long\n", n.c_str());
+    fclose(f);
+  }
+}
+
+// Index file 'path' into 'cat'; false if missing or bad
+static bool load(const std::string &path, WavCatalog &cat) {
+  FILE   *f = fopen(path.c_str(), "rb");
+  uint8_t rec[WAV_CAT_RECORD];
+  int16_t c = -1;
+  if(!f) return false;
+  if(fread(rec, 1, WAV_CAT_HEAD, f) == WAV_CAT_HEAD) c = cat.unpackHeader(rec);
+  for(int16_t i=0; i<c; i++) {
+    if((fread(rec, 1, WAV_CAT_RECORD, f) != WAV_CAT_RECORD) || !cat.unpack(rec)) c = -1;
+  }
+  fclose(f);
+  return c >= 0;
+}
+
+static bool save(const std::string &path, const WavCatalog &cat) {
+  FILE   *f = fopen(path.c_str(), "wb");
+  uint8_t rec[WAV_CAT_RECORD];
+  if(!f) return false;
+  cat.packHeader(rec);
+  bool ok = fwrite(rec, 1, WAV_CAT_HEAD, f) == WAV_CAT_HEAD;
+  for(uint8_t i=0; i<cat.count(); i++) {
+    cat.pack(i, rec);
+    ok &= fwrite(rec, 1, WAV_CAT_RECORD, f) == WAV_CAT_RECORD;
+  }
+  return !fclose(f) && ok;
+}
+
+// Same files with the same sizes and headers, in any order
+static bool same(const WavCatalog &a, const WavCatalog &b) {
+  if(a.count() != b.count()) return false;
+  for(uint8_t i=0; i<a.count(); i++) {
+    const wavEntry *x = a.entry(i), *y = b.entry(b.find(x->name));
+    if(!y || (x->fileSize != y->fileSize) || memcmp(&x->fmt, &y->fmt, sizeof(wavFormat))) return false;
+  }
+  return true;
+}
+
+int main(int argc, char *argv[]) {
+  bool        write = false;
+  const char *dir = NULL, *findName = NULL, *tag = NULL;
+  for(int i=1; i<argc; i++) {
+    if(!strcmp(argv[i], "--write"))                      write    = true;
+    else if(!strcmp(argv[i], "--find") && (i + 1 < argc)) findName = argv[++i];
+    else if(!strcmp(argv[i], "--tag") && (i + 1 < argc))  tag      = argv[++i];
+    else dir = argv[i];
+  }
+  if(!dir) {
+    fprintf(stderr, "usage: %s [--write] [--find name] [--tag tag] dir\n", argv[0]);
+    return 1;
+  }
+  static WavCatalog cat, old, copy;
+  build(dir, cat);
+  printf("%s: %d files\n", dir, cat.count());
+  for(uint8_t i=0; i<cat.count(); i++) {
+    const wavEntry *w = cat.entry(i);
+    printf("  %-20s %-8s %-12s %5d Hz %dch %7d ms, samples at %d\n", w->name, w->tag,
+      formatName(w->fmt), w->fmt.rate, w->fmt.channels, w->ms, w->fmt.dataOffset);
+  }
+
+  // What the board would read back has to be the same
+  std::string path = std::string(dir) + "/" + WAV_CAT_FILE, tmp = path + ".tmp";
+  if(!save(tmp, cat) || !load(tmp, copy) || !same(cat, copy)) {
+    printf("Index file doesn't read back the same!\n");
+    remove(tmp.c_str());
+    return 1;
+  }
+  if(load(path, old) && same(cat, old)) {
+    printf("%s is up to date\n", WAV_CAT_FILE);
+    remove(tmp.c_str());
+  } else if(write) {
+    rename(tmp.c_str(), path.c_str());
+    printf("Wrote %s\n", path.c_str());
+  } else {
+    printf("%s missing or out of date (the board will rewrite it, or use --write)\n", WAV_CAT_FILE);
+    remove(tmp.c_str());
+  }
+
+  if(findName) {
+    int8_t i = cat.find(findName);
+    printf("find %s: %s\n", findName, (i >= 0) ? cat.entry(i)->name : "none");
+  }
+  if(tag) {
+    printf("tag %s (%d):", tag, cat.tagCount(tag));
+    for(int8_t i = cat.tagFirst(tag); i >= 0; i = cat.entry(i)->nextTag) printf(" %s", cat.entry(i)->name);
+    printf("\n");
+  }
+  return 0;
+}
@@ -0,0 +1,370 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_Simul8
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+//
+// Checks the WAV player's decoder (mdo_m4_eyes/WavStream) on a computer,
+// and makes IMA ADPCM files for it.
+//
+//   g++ -O2 -I../mdo_m4_eyes Simul8_wavDecode.cpp ../mdo_m4_eyes/WavStream.cpp -o wavDecode
+//   ./wavDecode [file.wav ...]               (default: the fizzgig WAVs)
+//   ./wavDecode --adpcm in.wav out.wav [blockAlign]
+//
+// Each file is made into 8-bit mono, 16-bit mono and stereo PCM, and mono
+// and stereo IMA ADPCM (some with extra chunks before the data, and cut
+// short mid-block), all in memory. Each is played through WavStream the
+// way the board does: service() now and then, take() a sample at a time
+// in between. The output has to be exactly what a separate whole-file
+// decoder here gives, and the same length; rate conversion (to 44,100 and
+// 16,000 Hz) has to be within 1 of exact linear interpolation. ADPCM's
+// error against the original is shown as a signal to noise ratio.
+// Prints a line per case and exits 1 if any fail.
+//
+// --adpcm writes in.wav (8/16-bit PCM) as mono IMA ADPCM, a quarter of the
+// 16-bit size, blockAlign bytes a block (default 512).
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include <string>
+#include "WavStream.h"
+#include "XorShift.h"
+
+typedef std::vector<uint8_t> bytes;
+
+// FILES -------------------------------------------------------------------
+
+static bool readFile(const char *path, bytes &d) {
+  FILE *f = fopen(path, "rb");
+  if(!f) return false;
+  uint8_t buf[4096];
+  size_t  n;
+  while((n = fread(buf, 1, sizeof buf, f)) > 0) d.insert(d.end(), buf, buf + n);
+  fclose(f);
+  return true;
+}
+
+static void put16(bytes &d, uint16_t v) { d.push_back(v); d.push_back(v >> 8); }
+static void put32(bytes &d, uint32_t v) { put16(d, v); put16(d, v >> 16); }
+static void putId(bytes &d, const char *id) { d.insert(d.end(), id, id + 4); }
+
+// A WAV file around 'data'. 'extra' puts a LIST chunk (odd length, so
+// padded) before fmt and data.
+static bytes wavFile(uint16_t format, uint16_t chans, uint32_t rate, uint16_t bits,
+                     uint16_t align, uint16_t blockFrames, uint32_t frames,
+                     const bytes &data, bool extra) {
+  bytes d;
+  putId(d, "RIFF"); put32(d, 0); putId(d, "WAVE");
+  if(extra) {
+    putId(d, "LIST"); put32(d, 13);
+    d.insert(d.end(), (const uint8_t *)"INFOISFT\5\0\0\0ab", (const uint8_t *)"INFOISFT\5\0\0\0ab" + 13);
+    d.push_back(0);
+  }
+  putId(d, "fmt ");
+  put32(d, (format == WAV_IMA_ADPCM) ? 20 : 16);
+  put16(d, format); put16(d, chans); put32(d, rate);
+  put32(d, (format == WAV_IMA_ADPCM) ? rate * align / blockFrames : rate * align);
+  put16(d, align); put16(d, bits);
+  if(format == WAV_IMA_ADPCM) {
+    put16(d, 2); put16(d, blockFrames);
+    putId(d, "fact"); put32(d, 4); put32(d, frames);
+  }
+  putId(d, "data"); put32(d, data.size());
+  d.insert(d.end(), data.begin(), data.end());
+  if(data.size() & 1) d.push_back(0);
+  uint32_t riff = d.size() - 8;
+  memcpy(&d[4], &riff, 4);
+  return d;
+}
+
+// Any 8/16-bit PCM file as 16-bit, mixed to mono
+static bool loadPcm(const bytes &d, std::vector<int16_t> &out, uint32_t *rate) {
+  if((d.size() < 12) || memcmp(&d[0], "RIFF", 4) || memcmp(&d[8], "WAVE", 4)) return false;
+  uint16_t chans = 0, bits = 0;
+  for(size_t p = 12; p + 8 <= d.size();) {
+    uint32_t len = d[p+4] | (d[p+5] << 8) | (d[p+6] << 16) | ((uint32_t)d[p+7] << 24);
+    if(!memcmp(&d[p], "fmt ", 4)) {
+      chans = d[p+10] | (d[p+11] << 8);
+      *rate = d[p+12] | (d[p+13] << 8) | (d[p+14] << 16) | ((uint32_t)d[p+15] << 24);
+      bits  = d[p+22] | (d[p+23] << 8);
+    } else if(!memcmp(&d[p], "data", 4) && chans && ((bits == 8) || (bits == 16))) {
+      size_t size = bits / 8, frames = std::min((size_t)len, d.size() - p - 8) / (size * chans);
+      for(size_t i=0; i<frames; i++) {
+        int32_t s = 0;
+        for(uint16_t c=0; c<chans; c++) {
+          const uint8_t *q = &d[p + 8 + (i * chans + c) * size];
+          s += (bits == 8) ? ((int32_t)q[0] - 128) << 8 : (int16_t)(q[0] | (q[1] << 8));
+        }
+        out.push_back(s / chans);
+      }
+      return true;
+    }
+    p += 8 + len + (len & 1);
+  }
+  return false;
+}
+
+// IMA ADPCM ---------------------------------------------------------------
+
+static const int stepTab[89] = {
+  7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41,
+  45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190,
+  209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724,
+  796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272,
+  2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132,
+  7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500,
+  20350, 22385, 24623, 27086, 29794, 32767 };
+static const int indexTab[16] = { -1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8 };
+
+typedef struct { int pred, index; } imaState;
+
+// One nibble's effect on the state; returns the new sample
+static int imaStep(imaState &st, int nib) {
+  int step = stepTab[st.index], diff = step >> 3;
+  if(nib & 4) diff += step;
+  if(nib & 2) diff += step >> 1;
+  if(nib & 1) diff += step >> 2;
+  st.pred  = std::max(-32768, std::min(32767, (nib & 8) ? st.pred - diff : st.pred + diff));
+  st.index = std::max(0, std::min(88, st.index + indexTab[nib]));
+  return st.pred;
+}
+
+static int imaNibble(imaState &st, int sample) {
+  int step = stepTab[st.index], delta = sample - st.pred, nib = 0;
+  if(delta < 0) { nib = 8; delta = -delta; }
+  if(delta >= step)      { nib |= 4; delta -= step; }
+  if(delta >= step >> 1) { nib |= 2; delta -= step >> 1; }
+  if(delta >= step >> 2)   nib |= 1;
+  imaStep(st, nib);
+  return nib;
+}
+
+// ch[c][i] -> blocks of 'align' bytes
+static bytes imaEncode(const std::vector<std::vector<int16_t>> &ch, uint16_t align) {
+  size_t   chans = ch.size(), frames = ch[0].size(),
+           per   = (align - 4 * chans) / (4 * chans) * 8 + 1;
+  bytes    out;
+  imaState st[2] = { { 0, 0 }, { 0, 0 } };
+  for(size_t f0=0; f0<frames; f0+=per) {
+    size_t n = std::min(per, frames - f0);
+    for(size_t c=0; c<chans; c++) {
+      st[c].pred = ch[c][f0];
+      put16(out, (uint16_t)st[c].pred);
+      out.push_back(st[c].index);
+      out.push_back(0);
+    }
+    for(size_t g=1; g<n; g+=8) { // Last group padded with silence
+      for(size_t c=0; c<chans; c++) {
+        uint8_t b[4] = { 0 };
+        for(size_t i=0; i<8; i++) {
+          int s = (g + i < n) ? ch[c][f0 + g + i] : st[c].pred;
+          b[i >> 1] |= imaNibble(st[c], s) << ((i & 1) * 4);
+        }
+        out.insert(out.end(), b, b + 4);
+      }
+    }
+  }
+  return out;
+}
+
+// Whole-file reference decode, mixed to mono as WavStream does
+static std::vector<int16_t> imaDecode(const bytes &data, uint16_t chans, uint16_t align, uint32_t frames) {
+  std::vector<int16_t> out;
+  for(size_t b=0; (b + 4 * chans <= data.size()) && (out.size() < frames); b+=align) {
+    size_t   end = std::min(data.size(), b + align);
+    imaState st[2];
+    int      sum = 0;
+    for(size_t c=0; c<chans; c++) {
+      st[c].pred  = (int16_t)(data[b + c*4] | (data[b + c*4 + 1] << 8));
+      st[c].index = std::min(88, (int)data[b + c*4 + 2]);
+      sum        += st[c].pred;
+    }
+    out.push_back(sum >> (chans - 1));
+    for(size_t p = b + 4 * chans; p + 4 * chans <= end; p += 4 * chans) {
+      int mix[8] = { 0 };
+      for(size_t c=0; c<chans; c++) {
+        for(int i=0; i<8; i++) mix[i] += imaStep(st[c], (data[p + c*4 + i/2] >> ((i & 1) * 4)) & 15);
+      }
+      for(int i=0; i<8; i++) out.push_back(mix[i] >> (chans - 1));
+    }
+  }
+  if(out.size() > frames) out.resize(frames);
+  return out;
+}
+
+// PLAYING -----------------------------------------------------------------
+
+typedef struct { const bytes *d; size_t pos; } memFile;
+
+static uint32_t memRead(void *ctx, uint8_t *buf, uint32_t n) {
+  memFile *m = (memFile *)ctx;
+  n = std::min((size_t)n, m->d->size() - m->pos);
+  memcpy(buf, m->d->data() + m->pos, n);
+  m->pos += n;
+  return n;
+}
+
+static bool memSkip(void *ctx, uint32_t n) {
+  memFile *m = (memFile *)ctx;
+  if(m->pos + n > m->d->size()) return false;
+  m->pos += n;
+  return true;
+}
+
+// Plays 'file' through WavStream at 'rate' with service() every so many
+// take()s, as loop() and the timer interrupt would
+static bool play(const bytes &file, uint32_t rate, std::vector<uint16_t> &out,
+                 wavFormat *f, uint32_t *underruns) {
+  static WavStream ws; // ~2.5 KB, as on the board
+  memFile  m = { &file, 0 };
+  XorShift rnd(file.size());
+  if(!wavParse(memRead, memSkip, &m, f) || (m.pos != f->dataOffset)) return false;
+  ws.begin(memRead, &m, *f, rate);
+  ws.service();
+  while(!ws.done()) {
+    for(uint32_t n = rnd.next() % (WAV_BLOCK * 2); n && !ws.done(); n--) out.push_back(ws.take());
+    ws.service();
+  }
+  *underruns = ws.underruns();
+  return true;
+}
+
+static int failures = 0;
+
+static void check(const char *name, const bytes &file, const std::vector<int16_t> &ref,
+                  const std::vector<int16_t> &orig, uint32_t rate) {
+  std::vector<uint16_t> out;
+  wavFormat f;
+  uint32_t  under = 0;
+  if(!play(file, rate, out, &f, &under)) {
+    printf("  %-26s FAIL (not parsed)\n", name);
+    failures++;
+    return;
+  }
+  // Expected: reference, linearly interpolated to 'rate' (stepping by
+  // the same 16.16 fixed point amount as WavStream)
+  std::vector<double> want;
+  if(!rate) rate = f.rate;
+  double step = (double)(((uint64_t)f.rate << 16) / rate) / 65536.0;
+  for(double pos = 0; pos < ref.size(); pos += step) {
+    size_t i = (size_t)pos;
+    double s = (i + 1 < ref.size()) ? ref[i] + (ref[i + 1] - ref[i]) * (pos - i) : ref[i];
+    want.push_back((s + 32768.0) / 16.0);
+  }
+  size_t bad = 0, n = std::min(want.size(), out.size());
+  double tol = (rate == f.rate) ? 0.0 : 1.0;
+  for(size_t i=0; i<n; i++) if(fabs(out[i] - floor(want[i])) > tol) bad++;
+  bool ok = !bad && !under && (want.size() == out.size()) && (f.frames == ref.size());
+  printf("  %-26s %6d Hz, %7d samples, %3d%% of 16-bit size", name, rate, (int)out.size(),
+    (int)(f.dataBytes * 100 / (f.frames * 2 * f.channels)));
+  if(bad || under) printf(", %d differ, %d underruns", (int)bad, under);
+  if(&orig != &ref) { // Lossy: how close to the original
+    double sig = 0, err = 0;
+    for(size_t i=0; i<ref.size(); i++) {
+      sig += (double)orig[i] * orig[i];
+      err += ((double)ref[i] - orig[i]) * ((double)ref[i] - orig[i]);
+    }
+    printf(", SNR %.1f dB", 10 * log10(sig / std::max(err, 1.0)));
+  }
+  printf(" %s\n", ok ? "ok" : "FAIL");
+  if(!ok) failures++;
+}
+
+static void checkFile(const char *path) {
+  bytes d;
+  std::vector<int16_t> mono;
+  uint32_t rate;
+  if(!readFile(path, d) || !loadPcm(d, mono, &rate) || (mono.size() < 2)) {
+    printf("%s: can't read (8/16-bit PCM WAV only)\n", path);
+    failures++;
+    return;
+  }
+  printf("%s: %d Hz, %.2f s\n", path, rate, mono.size() / (double)rate);
+  // 8-bit mono, as the file itself or made from it
+  bytes p8;
+  std::vector<int16_t> ref8;
+  for(int16_t s : mono) {
+    int v = std::max(0, std::min(255, (s >> 8) + 128));
+    p8.push_back(v);
+    ref8.push_back((v - 128) << 8);
+  }
+  check("8-bit mono", wavFile(WAV_PCM, 1, rate, 8, 1, 1, mono.size(), p8, false), ref8, ref8, 0);
+  // 16-bit mono and stereo (right channel quieter and inverted)
+  bytes p16, p16s;
+  std::vector<int16_t> right, refS;
+  for(int16_t s : mono) {
+    int16_t r = -s / 3;
+    right.push_back(r);
+    put16(p16, s);
+    put16(p16s, s);
+    put16(p16s, r);
+    refS.push_back((s + r) >> 1);
+  }
+  check("16-bit mono", wavFile(WAV_PCM, 1, rate, 16, 2, 1, mono.size(), p16, false), mono, mono, 0);
+  bytes stereo = wavFile(WAV_PCM, 2, rate, 16, 4, 1, mono.size(), p16s, true);
+  check("16-bit stereo", stereo, refS, refS, 0);
+  check("16-bit stereo -> 44100", stereo, refS, refS, 44100);
+  check("16-bit stereo -> 16000", stereo, refS, refS, 16000);
+  // IMA ADPCM, mono and stereo; also cut short mid-block
+  for(uint16_t align : { 256, 512, 1024 }) {
+    bytes a = imaEncode({ mono }, align);
+    uint16_t per = (align - 4) / 4 * 8 + 1;
+    std::vector<int16_t> ref = imaDecode(a, 1, align, mono.size());
+    char name[40];
+    snprintf(name, sizeof name, "ADPCM mono %d", align);
+    check(name, wavFile(WAV_IMA_ADPCM, 1, rate, 4, align, per, mono.size(), a, align == 512), ref, mono, 0);
+  }
+  bytes    a   = imaEncode({ mono, right }, 1024);
+  uint16_t per = (1024 - 8) / 8 * 8 + 1;
+  std::vector<int16_t> ref = imaDecode(a, 2, 1024, mono.size()), mix;
+  for(size_t i=0; i<mono.size(); i++) mix.push_back((mono[i] + right[i]) >> 1);
+  bytes stA = wavFile(WAV_IMA_ADPCM, 2, rate, 4, 1024, per, mono.size(), a, false);
+  check("ADPCM stereo 1024", stA, ref, mix, 0);
+  check("ADPCM stereo -> 44100", stA, ref, mix, 44100);
+  size_t cut = a.size() / 1024 / 2 * 1024 + 300; // 300 bytes into a block
+  if(cut < a.size()) {
+    bytes    shortA(a.begin(), a.begin() + cut);
+    uint32_t frames = cut / 1024 * per + (300 - 8) / 8 * 8 + 1;
+    std::vector<int16_t> refC = imaDecode(shortA, 2, 1024, frames), mixC(mix.begin(), mix.begin() + frames);
+    check("ADPCM stereo, cut short", wavFile(WAV_IMA_ADPCM, 2, rate, 4, 1024, per, frames, shortA, false),
+      refC, mixC, 0);
+  }
+}
+
+int main(int argc, char *argv[]) {
+  if((argc >= 4) && !strcmp(argv[1], "--adpcm")) {
+    bytes d;
+    std::vector<int16_t> mono;
+    uint32_t rate;
+    uint16_t align = (argc > 4) ? atoi(argv[4]) : 512;
+    if((align < 8) || (align & 3)) align = 512;
+    if(!readFile(argv[2], d) || !loadPcm(d, mono, &rate) || mono.empty()) {
+      fprintf(stderr, "%s: can't read (8/16-bit PCM WAV only)\n", argv[2]);
+      return 1;
+    }
+    bytes    a   = imaEncode({ mono }, align);
+    uint16_t per = (align - 4) / 4 * 8 + 1;
+    bytes    w   = wavFile(WAV_IMA_ADPCM, 1, rate, 4, align, per, mono.size(), a, false);
+    FILE    *f   = fopen(argv[3], "wb");
+    if(!f || (fwrite(w.data(), 1, w.size(), f) != w.size())) {
+      fprintf(stderr, "%s: can't write\n", argv[3]);
+      return 1;
+    }
+    fclose(f);
+    printf("%s: %d bytes (%d as 16-bit PCM)\n", argv[3], (int)w.size(), (int)mono.size() * 2 + 44);
+    return 0;
+  }
+  std::vector<std::string> files;
+  for(int i=1; i<argc; i++) files.push_back(argv[i]);
+  if(files.empty()) {
+    for(const char *n : { "bark", "growl", "angry" }) {
+      files.push_back(std::string("../mdo_m4_eyes/eyes/fizzgig/") + n + ".wav");
+    }
+  }
+  for(const std::string &f : files) checkFile(f.c_str());
+  printf(failures ? "%d FAILED\n" : "All ok\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,135 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_Simul8
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+//
+// Runs the playlist's boot counter log (mdo_m4_eyes/WearLog) against
+// simulated flash on a computer, to check the wear leveling and that a
+// power cut never loses more than the write it interrupted.
+//
+//   g++ -O2 -I../mdo_m4_eyes Simul8_wearLog.cpp ../mdo_m4_eyes/WearLog.cpp -o wearLog
+//   ./wearLog [--boots 100000] [--blocks 2] [--block 8192] [--cuts 100]
+//
+// The flash behaves like the SAMD51's NVM: erase sets a block to all 1
+// bits, a write can only clear bits, and each 16-byte quad-word may be
+// written once per erase (a second write is reported). It starts full
+// of random junk, as never-used flash might. Each simulated boot does
+// what playlist.cpp does: begin(), check the value is the one written
+// last boot, append() the next. --cuts of the boots lose power part way
+// through the append's erase or write; the next boot must then find the
+// value from before. At the end it prints the erases per block and
+// writes per erase; with 8K blocks that should be one erase per 512
+// boots, shared evenly across the blocks, plus up to one more for each
+// power cut (writing then moves on to the next block). --cuts 0 to see
+// the wear without them.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "WearLog.h"
+#include "XorShift.h"
+
+class SimFlash : public WearLog::Flash {
+public:
+  SimFlash(uint32_t blockBytes, uint8_t count, XorShift *r) :
+    size(blockBytes), n(count), rnd(r), mem(blockBytes * count / 4),
+    written(blockBytes * count / 16, false), erases(count, 0) {
+    for(uint32_t &w : mem) w = rnd->next(); // Never-erased flash
+  }
+  uint32_t blockSize(void) { return size; }
+  uint8_t  blocks(void)    { return n; }
+  void read(uint32_t offset, uint32_t words[4]) {
+    memcpy(words, &mem[offset / 4], 16);
+  }
+  void write(uint32_t offset, const uint32_t words[4]) {
+    if(powerLost) return;
+    uint8_t count = 4;
+    if(cutWrite) { // Power lost part way through: some words written
+      count     = rnd->next() % 4;
+      powerLost = true;
+    }
+    if(!count) return;
+    if(written[offset / 16]) rewrites++;
+    written[offset / 16] = true;
+    for(uint8_t i=0; i<count; i++) mem[offset / 4 + i] &= words[i];
+  }
+  void erase(uint8_t block) {
+    if(powerLost) return;
+    uint32_t words = size / 4, count = words;
+    if(cutErase) { // Power lost part way through: some rows erased
+      count     = rnd->next() % words;
+      powerLost = true;
+    }
+    for(uint32_t i=0; i<count; i++) mem[block * words + i] = 0xFFFFFFFF;
+    for(uint32_t i=0; i<count / 4; i++) written[block * size / 16 + i] = false;
+    erases[block]++; // Wears it either way
+  }
+
+  uint32_t              size;
+  uint8_t               n;
+  XorShift             *rnd;
+  std::vector<uint32_t> mem;
+  std::vector<bool>     written;
+  std::vector<uint32_t> erases;
+  uint32_t              rewrites  = 0;
+  bool                  cutWrite  = false, cutErase = false, powerLost = false;
+};
+
+int main(int argc, char *argv[]) {
+  uint32_t boots = 100000, blockBytes = 8192, cuts = 100;
+  int      blocks = 2; // As playlist.cpp
+  for(int i=1; i+1<argc; i+=2) {
+    if(!strcmp(argv[i], "--boots"))       boots      = atoi(argv[i + 1]);
+    else if(!strcmp(argv[i], "--blocks")) blocks     = atoi(argv[i + 1]);
+    else if(!strcmp(argv[i], "--block"))  blockBytes = atoi(argv[i + 1]);
+    else if(!strcmp(argv[i], "--cuts"))   cuts       = atoi(argv[i + 1]);
+  }
+  if((blocks < 2) || (blocks > 255) || (blockBytes < 32) || (blockBytes % 16)) {
+    printf("Need 2-255 blocks of a multiple of 16 bytes\n");
+    return 1;
+  }
+  XorShift rnd(47);
+  SimFlash flash(blockBytes, blocks, &rnd);
+  uint32_t expect = 0, wrong = 0, cutCount = 0;
+  bool     saved  = false; // Any append finished yet?
+  for(uint32_t b=0; b<boots; b++) {
+    WearLog log(&flash);
+    bool    found = log.begin();
+    if((found != saved) || (log.value() != expect)) {
+      if(wrong++ < 10) printf("Boot %d: found %d value %d, expected %d %d\n", b, found, log.value(), saved, expect);
+      saved  = found;
+      expect = log.value();
+    }
+    // Some boots lose power during this append
+    flash.cutWrite = flash.cutErase = flash.powerLost = false;
+    if(cuts && ((rnd.next() % boots) < cuts)) {
+      if(rnd.next() & 1) flash.cutWrite = true;
+      else               flash.cutErase = true;
+    }
+    log.append(log.value() + 1);
+    if(flash.powerLost) {
+      cutCount++;
+    } else {
+      saved  = true;
+      expect = log.value();
+    }
+  }
+  uint32_t total = 0, lo = 0xFFFFFFFF, hi = 0;
+  printf("%d boots, %d blocks of %d bytes, %d power cuts\n", boots, blocks, blockBytes, cutCount);
+  printf("Erases per block:");
+  for(uint32_t e : flash.erases) {
+    printf(" %d", e);
+    total += e;
+    if(e < lo) lo = e;
+    if(e > hi) hi = e;
+  }
+  printf("\n%.1f writes per erase (a block holds %d), quad-words written twice without an erase: %d\n",
+    total ? (double)boots / total : 0.0, blockBytes / 16, flash.rewrites);
+  bool ok = !wrong && !flash.rewrites && (hi - lo <= 1 + cutCount) &&
+            (total <= (boots - cutCount) / (blockBytes / 16) + cutCount + blocks);
+  if(wrong) printf("%d boots found the wrong value\n", wrong);
+  printf("%s\n", ok ? "All ok" : "FAILED");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,108 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+#include <stddef.h>
+#include <string.h>
+#include "AnimLog.h"
+
+#define TAG_FRAME 0x10
+#define TAG_INPUT 0x20
+#define HEADER    10 // Bytes
+
+AnimLog::AnimLog(void) {
+  begin(NULL, 0, 0);
+}
+
+void AnimLog::begin(uint8_t *b, uint32_t s, uint32_t used) {
+  buf      = b;
+  size     = b ? ((used && (used < s)) ? used : s) : 0;
+  pos      = 0;
+  count    = 0;
+  lastTime = 0;
+}
+
+// Tag byte then varint value
+bool AnimLog::put(uint8_t tag, uint32_t value) {
+  uint8_t  tmp[6];
+  uint32_t n = 0;
+  tmp[n++] = tag;
+  do {
+    tmp[n] = value & 0x7F;
+    if(value >>= 7) tmp[n] |= 0x80;
+    n++;
+  } while(value);
+  if((size - pos) < n) return false;
+  memcpy(&buf[pos], tmp, n);
+  pos += n;
+  return true;
+}
+
+// Value following 'tag', if that's what's next; 'next' is where after
+bool AnimLog::peek(uint8_t tag, uint32_t *value, uint32_t *next) {
+  uint32_t p = pos, v = 0;
+  if((p >= size) || (buf[p++] != tag)) return false;
+  for(uint8_t shift=0; shift<35; shift += 7) {
+    if(p >= size) return false;
+    uint8_t b = buf[p++];
+    v |= (uint32_t)(b & 0x7F) << shift;
+    if(!(b & 0x80)) {
+      *value = v;
+      *next  = p;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool AnimLog::header(uint32_t seed, uint8_t eyes) {
+  if((pos != 0) || (size < HEADER)) return false;
+  memcpy(buf, "EYRL", 4);
+  buf[4] = ANIM_LOG_VERSION;
+  buf[5] = eyes;
+  for(uint8_t i=0; i<4; i++) buf[6 + i] = seed >> (i * 8);
+  pos = HEADER;
+  return true;
+}
+
+bool AnimLog::frame(uint8_t eye, uint32_t t) {
+  if(!put(TAG_FRAME | (eye & 0x0F), t - lastTime)) return false;
+  lastTime = t;
+  count++;
+  return true;
+}
+
+bool AnimLog::input(uint8_t channel, int32_t value) {
+  // Zigzag so small negative numbers are short too
+  return put(TAG_INPUT | (channel & 0x0F),
+    ((uint32_t)value << 1) ^ (uint32_t)(value >> 31));
+}
+
+bool AnimLog::readHeader(uint32_t *seed, uint8_t *eyes) {
+  if((pos != 0) || (size < HEADER) || memcmp(buf, "EYRL", 4) ||
+     (buf[4] != ANIM_LOG_VERSION)) return false;
+  *eyes = buf[5];
+  *seed = 0;
+  for(uint8_t i=0; i<4; i++) *seed |= (uint32_t)buf[6 + i] << (i * 8);
+  pos = HEADER;
+  return true;
+}
+
+bool AnimLog::readFrame(uint8_t eye, uint32_t *t) {
+  uint32_t v, next;
+  if(!peek(TAG_FRAME | (eye & 0x0F), &v, &next)) return false;
+  pos = next;
+  *t  = lastTime += v;
+  count++;
+  return true;
+}
+
+bool AnimLog::readInput(uint8_t channel, int32_t *value) {
+  uint32_t v, next;
+  if(!peek(TAG_INPUT | (channel & 0x0F), &v, &next)) return false;
+  pos    = next;
+  *value = (int32_t)((v >> 1) ^ -(v & 1));
+  return true;
+}
@@ -0,0 +1,60 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+/* Compact binary log of what the animation saw: the random seed, then
+   for each eye frame its time, plus any outside input (light sensor,
+   boop, buttons...) in the order the code read it. Writing the same
+   values back in the same order reproduces the same frames.
+
+   Format (all little-endian):
+     header  "EYRL", version byte, eye count byte, seed (4 bytes)
+     frame   0x10 | eye,     time since last frame (micros, varint)
+     input   0x20 | channel, value (zigzag varint)
+   Varints are 7 bits a byte, low first, top bit set if more follow, so a
+   typical frame (~16 ms apart) is 3 bytes.
+
+   Works in a caller-supplied buffer; no Arduino dependencies, so the
+   same code reads logs on a host computer.
+*/
+
+#ifndef __ANIM_LOG_H
+#define __ANIM_LOG_H
+
+#include <stdint.h>
+
+#define ANIM_LOG_VERSION 1
+
+class AnimLog {
+public:
+  AnimLog(void);
+
+  // Use 'buf' of 'size' bytes; 'used' bytes of it already hold a log
+  // to read (0 to write a new one).
+  void     begin(uint8_t *buf, uint32_t size, uint32_t used);
+
+  // Writing. Each returns false, and writes nothing, if it won't fit.
+  bool     header(uint32_t seed, uint8_t eyes);
+  bool     frame(uint8_t eye, uint32_t t);
+  bool     input(uint8_t channel, int32_t value);
+
+  // Reading. Each returns false, and reads nothing, if the next thing in
+  // the log isn't what's asked for (or the log's ended).
+  bool     readHeader(uint32_t *seed, uint8_t *eyes);
+  bool     readFrame(uint8_t eye, uint32_t *t);
+  bool     readInput(uint8_t channel, int32_t *value);
+
+  uint32_t used(void) { return pos; }
+  uint32_t frames(void) { return count; }
+  bool     ended(void) { return pos >= size; }
+
+private:
+  bool     put(uint8_t tag, uint32_t value);
+  bool     peek(uint8_t tag, uint32_t *value, uint32_t *next);
+  uint8_t *buf;
+  uint32_t size, pos, count, lastTime;
+};
+
+#endif
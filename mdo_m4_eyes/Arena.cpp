@@ -0,0 +1,31 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+#include <stddef.h>
+#include "Arena.h"
+
+Arena::Arena(void) {
+  begin(NULL, 0);
+}
+
+void Arena::begin(void *mem, uint32_t size) {
+  base  = (uint8_t *)mem;
+  total = mem ? size : 0;
+  top   = 0;
+  high  = 0;
+  fails = 0;
+}
+
+void *Arena::alloc(uint32_t bytes) {
+  uint32_t start = (top + 3) & ~3; // Keep 4-byte alignment (block is too)
+  if(!base || (bytes > total) || (start > (total - bytes))) {
+    fails++;
+    return NULL;
+  }
+  top = start + bytes;
+  if(top > high) high = top;
+  return &base[start];
+}
@@ -0,0 +1,52 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+/* Bump allocator over one block of memory. Allocations are carved off the
+   bottom in order and can't be freed singly; reset() frees them all at
+   once. Nothing is ever left behind to fragment the heap: the block
+   itself comes from one malloc() (or anywhere) owned by the caller.
+
+   Tracks a high-water mark and refused allocations so a memory plan
+   (see memory.cpp) can be checked against what actually happened.
+
+   No Arduino dependencies, so the same code runs on a host computer
+   to replay allocation sequences.
+*/
+
+#ifndef __ARENA_H
+#define __ARENA_H
+
+#include <stdint.h>
+
+class Arena {
+public:
+  Arena(void);
+
+  // Manage 'size' bytes at 'mem' (forgets any previous block). NULL, 0
+  // leaves the arena empty, all allocations fail.
+  void     begin(void *mem, uint32_t size);
+
+  // 'bytes' of 4-byte-aligned memory, or NULL if it doesn't fit.
+  void    *alloc(uint32_t bytes);
+
+  // Free everything allocated since begin().
+  void     reset(void)  { top = 0; }
+
+  void    *memory(void) { return base; }
+  uint32_t size(void)   { return total; }
+  uint32_t used(void)   { return top; }
+  uint32_t peak(void)   { return high; }  // Most ever used since begin()
+  uint32_t failed(void) { return fails; } // Allocations refused
+
+private:
+  uint8_t *base;
+  uint32_t total;
+  uint32_t top;   // Offset of next free byte
+  uint32_t high;
+  uint32_t fails;
+};
+
+#endif
@@ -0,0 +1,54 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+/* Streaming JSON config reader (configparse.cpp). Calls a handler for
+   each value as it's found rather than building a document in RAM; see
+   the top of configparse.cpp for what it accepts.
+
+   Bytes come from a reader callback, so there are no Arduino
+   dependencies: on the board configParse() (file.cpp) reads a File or
+   flash, and the host tool mdo_Simul8/Simul8_configFuzz.cpp runs this
+   same code on mutated config files.
+*/
+
+#ifndef __CONFIG_PARSE_H
+#define __CONFIG_PARSE_H
+
+#include <stdint.h>
+
+// Values from the tokenizer. A scalar, or an array holding its first
+// CFG_ITEMS elements (e.g. R, G, B).
+#define CFG_KEYLEN  24  // Longest key name (incl. NUL, longer is cut)
+#define CFG_STRLEN  128 // Longest string value (incl. NUL)
+#define CFG_ITEMS   3   // Array elements kept
+#define CFG_ITEMLEN 16  // Longest string in an array (e.g. "0xFF")
+enum { CFG_NONE, CFG_NULL, CFG_BOOL, CFG_INT, CFG_FLOAT, CFG_STRING,
+       CFG_ARRAY };
+typedef struct {
+  uint8_t       type;  // CFG_NULL to CFG_STRING
+  union {
+    int32_t     i;     // CFG_BOOL (0/1), CFG_INT
+    float       f;     // CFG_FLOAT
+    const char *s;     // CFG_STRING
+  };
+} cfgScalar;
+typedef struct {
+  uint8_t       type;  // CFG_* (CFG_NONE = not in file)
+  uint8_t       count; // Number of array elements (1 if scalar)
+  cfgScalar     item[CFG_ITEMS]; // Scalar value is item[0]
+} cfgValue;
+typedef void (*cfgHandler)(const char *section, const char *key, cfgValue *v);
+
+// Fills buf with up to n bytes, returns how many (0 at the end)
+typedef int  (*cfgReader)(void *ctx, uint8_t *buf, int n);
+
+// Parse config from read(ctx), calling handler for each value. Returns
+// false on error; handler may already have been called for values
+// before that point. cfgError() then says what and on which line.
+extern bool        cfgParse(cfgReader read, void *ctx, cfgHandler handler);
+extern const char *cfgError(int *line);
+
+#endif
@@ -0,0 +1,45 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+#include "ExpressionBlend.h"
+
+ExpressionBlend::ExpressionBlend(void) {
+  int32_t zero[COUNT] = { 0 };
+  begin(zero);
+}
+
+void ExpressionBlend::begin(const int32_t *values) {
+  for(uint8_t p=0; p<COUNT; p++) from[p] = target[p] = current[p] = values[p];
+  duration = 0;
+}
+
+void ExpressionBlend::to(const int32_t *values, uint32_t dur, uint32_t now) {
+  update(now); // Current values are the new starting point
+  for(uint8_t p=0; p<COUNT; p++) {
+    from[p]   = current[p];
+    target[p] = values[p];
+  }
+  start    = now;
+  duration = dur;
+  if(!dur) update(now);
+}
+
+void ExpressionBlend::update(uint32_t now) {
+  int32_t mix = 65536; // 0.16 fixed point
+  if(duration) {
+    uint32_t dt = now - start;
+    if(dt < duration) {
+      // Ease in-out, 3x^2 - 2x^3, in 0.16 fixed point
+      int64_t x = ((int64_t)dt << 16) / duration;
+      mix = (int32_t)((x * x * (3 * 65536 - 2 * x)) >> 32);
+    } else {
+      duration = 0;
+    }
+  }
+  for(uint8_t p=0; p<COUNT; p++) {
+    current[p] = from[p] + (int32_t)(((int64_t)(target[p] - from[p]) * mix) >> 16);
+  }
+}
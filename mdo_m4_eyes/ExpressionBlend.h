@@ -0,0 +1,59 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+/* Blends a fixed set of parameters (16.16 fixed point) from where they are
+   toward a target set over a duration, with an ease-in-out curve. A new
+   target partway through starts from the current blend, so there's never
+   a jump. No allocation; one multiply per parameter per update.
+
+   Time is passed in (any microsecond clock that wraps at 32 bits) and
+   there are no Arduino dependencies, so the same code runs on a host
+   computer against a made-up clock.
+*/
+
+#ifndef __EXPRESSION_BLEND_H
+#define __EXPRESSION_BLEND_H
+
+#include <stdint.h>
+
+#define EXPR_FIXED(f) ((int32_t)((f) * 65536.0)) // float -> 16.16
+
+class ExpressionBlend {
+public:
+  // Parameters blended. Values are 16.16 fixed point.
+  enum {
+    GAZE,     // Saccade size, 1.0 = normal
+    SACCADE,  // Time between big saccades, 1.0 = normal, 2.0 = half as often
+    BLINK,    // Time between blinks, same
+    PUPIL,    // Pupil size as fraction of iris (as pupilMin/pupilMax)...
+    PUPILMIX, // ...and how much that overrides the light sensor, 0.0-1.0
+    SPIN,     // Extra iris spin, RPM
+    DISTANCE, // What the eyes converge on, mm
+    COUNT
+  };
+
+  ExpressionBlend(void);
+
+  // Jump straight to 'values' (COUNT of them).
+  void     begin(const int32_t *values);
+
+  // Start blending from current values to 'values' over 'duration'
+  // micros (0 = at once), starting at time 'now'.
+  void     to(const int32_t *values, uint32_t duration, uint32_t now);
+
+  // Update current values for time 'now'. Call once per frame.
+  void     update(uint32_t now);
+
+  int32_t  get(uint8_t p) { return current[p]; }
+  float    getFloat(uint8_t p) { return (float)current[p] / 65536.0; }
+  bool     moving(void) { return duration != 0; }
+
+private:
+  int32_t  from[COUNT], target[COUNT], current[COUNT];
+  uint32_t start, duration;
+};
+
+#endif
@@ -0,0 +1,53 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+#include "FsRetry.h"
+
+FsRetry::FsRetry(pause p, uint8_t retries, uint32_t firstMs) {
+  delayMs    = p;
+  maxRetries = retries;
+  firstWait  = firstMs;
+  isUp       = false;
+  isDown     = false;
+  lastTries  = 0;
+}
+
+bool FsRetry::wait(probe readable, void *ctx) {
+  uint32_t wait = firstWait;
+  lastTries = 0;
+  for(uint8_t i=0; !isUp; i++) {
+    lastTries++;
+    if(readable(ctx)) {
+      isUp = true;
+    } else if(i >= maxRetries) {
+      isDown = true;
+      return false;
+    } else {
+      delayMs(wait);
+      wait *= 2;
+    }
+  }
+  return true;
+}
+
+bool FsRetry::ready(probe exists, void *ctx) {
+  uint32_t wait = firstWait;
+  lastTries = 0;
+  for(uint8_t i=0; ; i++) {
+    lastTries++;
+    if(exists(ctx)) {
+      isUp = true;
+      return true;
+    }
+    if(isUp || isDown) return false;
+    if(i >= maxRetries) {
+      isDown = true;
+      return false;
+    }
+    delayMs(wait);
+    wait *= 2;
+  }
+}
@@ -0,0 +1,51 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+/* Bounded backoff while the filesystem comes up (see file.cpp's
+   filesysWait() and fileReady()). Tries a probe; if it fails and the
+   filesystem isn't known good yet, pauses firstMs, doubling each time, up
+   to 'retries' more tries. Once any probe has worked the filesystem is
+   "up" and a miss is taken at face value, no waiting; once it's given up
+   it's "down" and per-file checks don't wait again either.
+
+   The probe and the pause are callbacks, so there are no Arduino
+   dependencies; the host tool mdo_Simul8/Simul8_fsRetry.cpp runs this
+   same code against a filesystem that fails its first opens.
+*/
+
+#ifndef __FS_RETRY_H
+#define __FS_RETRY_H
+
+#include <stdint.h>
+
+class FsRetry {
+public:
+  typedef bool (*probe)(void *ctx);       // true = read OK
+  typedef void (*pause)(uint32_t ms);
+
+  FsRetry(pause p, uint8_t retries, uint32_t firstMs);
+
+  // Startup: tries 'readable' until it works or retries run out. Returns
+  // true if the filesystem is up.
+  bool    wait(probe readable, void *ctx);
+
+  // Per file: true if 'exists' works, retrying only while the filesystem
+  // is neither known good nor given up on.
+  bool    ready(probe exists, void *ctx);
+
+  bool    up(void)    { return isUp; }
+  bool    down(void)  { return isDown; }
+  uint8_t tries(void) { return lastTries; } // Probes the last call made
+
+private:
+  pause    delayMs;
+  uint8_t  maxRetries;
+  uint32_t firstWait;
+  bool     isUp, isDown;
+  uint8_t  lastTries;
+};
+
+#endif
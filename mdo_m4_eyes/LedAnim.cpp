@@ -0,0 +1,93 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+#include <string.h>
+#include "LedAnim.h"
+
+// Gamma 2.6, as Adafruit_NeoPixel::gamma8(): (i / 255) ^ 2.6 * 255
+static const uint8_t gammaTable[256] = {
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   1,   1,   1,   1,   1,   1,   1,   1,
+    1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,   2,   3,   3,   3,   3,
+    3,   3,   4,   4,   4,   4,   5,   5,   5,   5,   5,   6,   6,   6,   6,   7,
+    7,   7,   8,   8,   8,   9,   9,   9,  10,  10,  10,  11,  11,  11,  12,  12,
+   13,  13,  13,  14,  14,  15,  15,  16,  16,  17,  17,  18,  18,  19,  19,  20,
+   20,  21,  21,  22,  22,  23,  24,  24,  25,  25,  26,  27,  27,  28,  29,  29,
+   30,  31,  31,  32,  33,  34,  34,  35,  36,  37,  38,  38,  39,  40,  41,  42,
+   42,  43,  44,  45,  46,  47,  48,  49,  50,  51,  52,  53,  54,  55,  56,  57,
+   58,  59,  60,  61,  62,  63,  64,  65,  66,  68,  69,  70,  71,  72,  73,  75,
+   76,  77,  78,  80,  81,  82,  84,  85,  86,  88,  89,  90,  92,  93,  94,  96,
+   97,  99, 100, 102, 103, 105, 106, 108, 109, 111, 112, 114, 115, 117, 119, 120,
+  122, 124, 125, 127, 129, 130, 132, 134, 136, 137, 139, 141, 143, 145, 146, 148,
+  150, 152, 154, 156, 158, 160, 162, 164, 166, 168, 170, 172, 174, 176, 178, 180,
+  182, 184, 186, 188, 191, 193, 195, 197, 199, 202, 204, 206, 209, 211, 213, 215,
+  218, 220, 223, 225, 227, 230, 232, 235, 237, 240, 242, 245, 247, 250, 252, 255 };
+
+// 8.8 value through the gamma table, interpolating between entries
+static inline uint8_t gamma88(uint16_t v) {
+  uint8_t i = v >> 8, f = v & 0xFF;
+  if(i == 255) return 255;
+  return gammaTable[i] + (((gammaTable[i + 1] - gammaTable[i]) * f + 128) >> 8);
+}
+
+LedAnim::LedAnim(void) {
+  begin(0);
+}
+
+void LedAnim::begin(uint8_t pixels, uint16_t minShowMs) {
+  count    = (pixels < LED_ANIM_PIXELS) ? pixels : LED_ANIM_PIXELS;
+  minShow  = minShowMs;
+  anim     = NULL;
+  start    = lastShow = 0;
+  memset(rgb, 0, sizeof rgb);
+  dirty    = true; // Off, shown on the first render()
+}
+
+void LedAnim::play(const ledAnim *a, uint32_t ms) {
+  anim  = (a && a->count) ? a : NULL;
+  start = ms;
+}
+
+bool LedAnim::render(uint32_t ms) {
+  uint32_t period  = anim ? anim->keys[anim->count - 1].ms : 0,
+           elapsed = ms - start;
+  for(uint8_t p=0; p<count; p++) {
+    uint8_t c[3] = { 0, 0, 0 };
+    if(anim) {
+      const ledKey *k = anim->keys, *k1 = k;
+      if(period) {
+        uint32_t behind = ((uint32_t)p * anim->spread) % period,
+                 t      = (elapsed % period + period - behind) % period;
+        while((k1 < &anim->keys[anim->count - 1]) && (k1->ms <= t)) k = k1++;
+        // t is from k to k1: fraction of the way, 0 to 65535
+        uint32_t span = k1->ms - k->ms,
+                 f    = span ? (((t - k->ms) << 16) / span) : 0;
+        const uint8_t *a = &k->r, *b = &k1->r;
+        for(uint8_t i=0; i<3; i++) {
+          uint16_t v = (a[i] << 8) + (((int32_t)(b[i] - a[i]) * (int32_t)f) >> 8);
+          c[i] = gamma88(v);
+        }
+      } else { // One color
+        c[0] = gammaTable[k->r];
+        c[1] = gammaTable[k->g];
+        c[2] = gammaTable[k->b];
+      }
+    }
+    if(memcmp(rgb[p], c, 3)) {
+      memcpy(rgb[p], c, 3);
+      dirty = true;
+    }
+  }
+  if(!dirty || ((ms - lastShow) < minShow)) return false;
+  dirty    = false;
+  lastShow = ms;
+  return true;
+}
+
+uint32_t LedAnim::color(uint8_t i) const {
+  if(i >= count) return 0;
+  return ((uint32_t)rgb[i][0] << 16) | ((uint32_t)rgb[i][1] << 8) | rgb[i][2];
+}
@@ -0,0 +1,73 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+/* NeoPixel animations (neopixels.cpp) from keyframe tables instead of
+   code. An animation is a list of colors at times; in between, each
+   color channel is interpolated in fixed point (8.8) and then gamma
+   corrected through a table, so fades look even to the eye instead of
+   jumping at the dim end. It repeats after the last keyframe; each pixel
+   can run 'spread' ms behind the one before, so one table makes a chase.
+
+   render() works out the frame for a time into a pixel buffer, and says
+   whether it's time to show() it: only when something changed, and no
+   more often than every minShowMs. Pushing the pixels out (bit-banged,
+   interrupts off) then doesn't happen every eye frame for nothing.
+
+   Tables come from flash (const, see user_touchneopixels.cpp) or from a
+   JSON file at startup (pixelsLoad()); mdo_EyeConfig/led_anim_compile.py
+   checks a JSON file and turns it into const tables.
+
+   No Arduino dependencies; the host tool mdo_Simul8/Simul8_ledAnim.cpp
+   runs this same code.
+*/
+
+#ifndef __LED_ANIM_H
+#define __LED_ANIM_H
+
+#include <stdint.h>
+
+#define LED_ANIM_PIXELS 10 // Most pixels rendered
+
+typedef struct {
+  uint16_t ms;      // Time from the start of the animation
+  uint8_t  r, g, b; // As they look, 0 to 255 (gamma's applied after)
+} ledKey;
+
+typedef struct {
+  const ledKey *keys;   // In time order, the first at 0
+  uint8_t       count;
+  uint16_t      spread; // ms each pixel runs behind the one before
+} ledAnim;
+
+class LedAnim {
+public:
+  LedAnim(void);
+
+  // Number of pixels (up to LED_ANIM_PIXELS), least time between show()s
+  void     begin(uint8_t pixels, uint16_t minShowMs = 20);
+
+  // Starts 'a' at time 'ms'. NULL = all off.
+  void     play(const ledAnim *a, uint32_t ms);
+  const ledAnim *playing(void) const { return anim; }
+
+  // Renders time 'ms' into the pixel buffer. true if the pixels should be
+  // shown now (counted as shown).
+  bool     render(uint32_t ms);
+
+  // Pixel 'i' as rendered, 0x00RRGGBB, gamma corrected
+  uint32_t color(uint8_t i) const;
+  uint8_t  pixels(void) const { return count; }
+
+private:
+  const ledAnim *anim;
+  uint32_t       start, lastShow;
+  uint16_t       minShow;
+  uint8_t        count;
+  bool           dirty;
+  uint8_t        rgb[LED_ANIM_PIXELS][3];
+};
+
+#endif
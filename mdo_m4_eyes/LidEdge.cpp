@@ -0,0 +1,34 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+#include "LidEdge.h"
+
+void lidEdge(const uint8_t *has, const uint8_t *y, uint16_t *out, int columns) {
+  for(int a=0; a<columns; ) {
+    if(has[a] == 255) {
+      a++;
+      continue;
+    }
+    int b = a; // Columns a to b have data
+    while((b < (columns-1)) && (has[b+1] != 255)) b++;
+    for(int x=a; x<=b; x++) out[x] = y[x] << 8;
+    int kx = -1, ky = 0; // Last step point, x in half-columns, y 8.8
+    for(int x=a; x<b; x++) {
+      if(y[x+1] == y[x]) continue;
+      int nx = x * 2 + 1, ny = (y[x] + y[x+1]) << 7;
+      if(kx >= 0) { // Columns between this step and the last one
+        int d = nx - kx; // Rounded, same both ways so mirrored lids match
+        for(int i=(kx+1)/2; i<=x; i++) {
+          int t  = i * 2 - kx;
+          out[i] = (ky * (d - t) + ny * t + d / 2) / d;
+        }
+      }
+      kx = nx;
+      ky = ny;
+    }
+    a = b + 1;
+  }
+}
@@ -0,0 +1,27 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+/* A 1-bit eyelid image can only say which whole pixel its edge is in, so
+   a sloping edge comes out as stair steps. The true curve crosses each
+   step halfway, so lidEdge() puts a point there (between the two
+   columns, at the mean of their rows) and joins the points with straight
+   lines, giving 8.8 edge positions the renderer can anti-alias. Flat runs
+   at the ends stay as they were. Used by loadEyelid() in file.cpp.
+
+   No Arduino dependencies; the host tool mdo_Simul8/Simul8_lidEdge.cpp
+   runs it on eyelid images and checks the tables against known-good ones.
+*/
+
+#ifndef __LID_EDGE_H
+#define __LID_EDGE_H
+
+#include <stdint.h>
+
+// 'y' is whole rows per column, 'out' gets 8.8, for 'columns' columns;
+// columns where 'has' is 255 (no eyelid data) are left alone.
+void lidEdge(const uint8_t *has, const uint8_t *y, uint16_t *out, int columns);
+
+#endif
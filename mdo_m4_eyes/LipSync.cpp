@@ -0,0 +1,71 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+#include <math.h>
+#include "LipSync.h"
+
+LipSync::LipSync(void) {
+  begin(1850, 750);
+  timing(15, 120);
+}
+
+void LipSync::begin(uint16_t closedUs, uint16_t openUs, uint16_t g, uint16_t f) {
+  closed = closedUs;
+  opened = openUs;
+  gate   = g;
+  full   = (f > g) ? f : (g + 1);
+  reset(0);
+  started = false;
+}
+
+// Share of the way to go covered per tick: 1 - e^(-tick / time)
+static uint32_t perTick(uint16_t tickMs, uint16_t ms) {
+  if(!ms) return 65536;
+  return (uint32_t)((1.0 - exp(-(double)tickMs / (double)ms)) * 65536.0 + 0.5);
+}
+
+void LipSync::timing(uint16_t attackMs, uint16_t releaseMs, uint16_t tickMs, uint16_t deadbandUs) {
+  tick     = tickMs ? tickMs : 1;
+  deadband = deadbandUs;
+  attack   = perTick(tick, attackMs);
+  release  = perTick(tick, releaseMs);
+}
+
+void LipSync::reset(uint32_t ms) {
+  pos     = 0;
+  last    = ms;
+  loudest = 0;
+  pulse   = written = closed;
+  started = true;
+}
+
+bool LipSync::update(uint32_t ms, uint16_t level) {
+  if(!started) reset(ms);
+  if(level > loudest) loudest = level; // Loudest since the last step
+  if((int32_t)(ms - last) < (int32_t)tick) return false; // Not yet (or time went back)
+  uint32_t steps = (ms - last) / tick;
+  last += steps * tick;
+  if(steps > 50) steps = 50; // Long gap: settled by now anyway
+  level   = loudest;
+  loudest = 0;
+
+  uint32_t target = (level <= gate) ? 0 :
+                    (level >= full) ? 0xFFFF0000 :
+                    (uint32_t)(((uint64_t)(level - gate) << 32) / (full - gate)) & 0xFFFF0000;
+  while(steps--) {
+    if(target > pos) pos += (uint32_t)(((uint64_t)(target - pos) * attack) >> 16);
+    else             pos -= (uint32_t)(((uint64_t)(pos - target) * release) >> 16);
+  }
+  pulse = closed + (int32_t)(((int64_t)((int32_t)opened - closed) * (pos >> 16)) / 65535);
+
+  int32_t moved = (int32_t)pulse - written;
+  if((moved > deadband) || (moved < -(int32_t)deadband) ||
+     ((pulse != written) && (pos < 0x10000 || pos >= 0xFFFF0000))) { // Ends exactly
+    written = pulse;
+    return true;
+  }
+  return false;
+}
@@ -0,0 +1,68 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+/* Mouth servo following the sound (user_fizzgig.cpp): loudness in (the
+   playing WAV block's level(), see WavStream.h), servo pulse width out.
+   Quiet below 'gate' keeps the mouth shut, 'full' and above opens it all
+   the way, in between is in proportion. The mouth opens with the attack
+   time and closes with the release time (one-pole smoothing, fixed
+   point), so it snaps open on a bark and drops shut more slowly.
+
+   It steps every 'tickMs' of the time passed to update(), however often
+   that's called, on the loudest level given since the last step. Fed
+   each played block with the time it was heard (WavStream::heard()), a
+   slow frame just catches up several steps at once, so how the mouth
+   moves doesn't depend on the eyes' frame rate. update() says
+   when the pulse width has changed by more than 'deadbandUs' and is due
+   to be written, at most once a tick (servos only take 50 pulses a second
+   anyway). Fixed size, no allocation.
+
+   No Arduino dependencies; the host tool mdo_Simul8/Simul8_lipSync.cpp
+   runs this same code on WAV files.
+*/
+
+#ifndef __LIP_SYNC_H
+#define __LIP_SYNC_H
+
+#include <stdint.h>
+
+class LipSync {
+public:
+  LipSync(void);
+
+  // Pulse widths (either way round), and loudness for shut and all open
+  void     begin(uint16_t closedUs, uint16_t openUs, uint16_t gate = 30, uint16_t full = 500);
+
+  // Opening and closing times (ms to get most of the way, 63%), how
+  // often it steps, and the least change worth writing to the servo
+  void     timing(uint16_t attackMs, uint16_t releaseMs, uint16_t tickMs = 20,
+                  uint16_t deadbandUs = 4);
+
+  // Loudness (0 when nothing's playing) up to time 'ms'. true if us()
+  // should be written to the servo.
+  bool     update(uint32_t ms, uint16_t level);
+
+  // Pulse width, microseconds
+  uint16_t us(void) const { return pulse; }
+
+  // How open, 0 (shut) to 65535
+  uint16_t open(void) const { return pos >> 16; }
+
+  // Shut, now
+  void     reset(uint32_t ms);
+
+private:
+  uint16_t closed, opened, gate, full;
+  uint16_t tick, deadband;
+  uint32_t attack, release; // Per tick, of 65536
+  uint32_t pos;             // 16.16, 0 to 65535
+  uint32_t last;            // Time of the last step
+  uint16_t loudest;         // Level since then
+  bool     started;
+  uint16_t pulse, written;
+};
+
+#endif
@@ -0,0 +1,71 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+/* Sizes in the startup memory plan (see memory.cpp): image scratch per
+   BMP, the tables block, and the config defaults they're worked out
+   from. loadConfig(), imageScratch(), tablesPlan() and the loader steps
+   use these, and so does mdo_Simul8/Simul8_memPlan.cpp to replay the
+   plan on a computer, so the two can't drift apart.
+
+   No Arduino dependencies; the display size is passed in (it's only
+   known at run time on the board).
+*/
+
+#ifndef __MEM_PLAN_H
+#define __MEM_PLAN_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+
+// Slit pupil table size, per eye. Angles cover one quadrant (pupil shape
+// is symmetrical on both axes), radii cover center to edge of iris, +1
+// column so the renderer can always interpolate to the next entry.
+#define SLIT_ANGLES 16
+#define SLIT_RADII  32
+#define SLIT_BYTES  (SLIT_ANGLES * (SLIT_RADII + 1))
+
+#define LID_POSES_MAX          8 // Eyelid poses, including open & closed
+#define MAP_ROWS_PER_STEP      8 // calcMap() rows per loader step
+#define DISPLACE_ROWS_PER_STEP 8 // calcDisplacement() rows per step
+
+// Rounded up to Arena's 4-byte alignment
+static inline uint32_t planAlign(uint32_t bytes) {
+  return (bytes + 3) / 4 * 4;
+}
+
+// Config defaults, as applied at the end of loadConfig(). 0 = not set.
+static inline int planEyeRadius(int eyeRadius, int displaySize) {
+  return eyeRadius ? abs(eyeRadius) : (displaySize / 2 + 5);
+}
+
+static inline int planIrisRadius(int irisRadius, int displaySize) {
+  return irisRadius ? abs(irisRadius) : (displaySize / 4);
+}
+
+// coverage already limited to 0.0-1.0
+static inline int planMapRadius(int eyeRadius, float coverage) {
+  return (int)(eyeRadius * M_PI * coverage + 0.5);
+}
+
+// Image scratch to decode one BMP: 1-bit (eyelid) needs a row and the
+// min/max columns, 24-bit (texture) the whole image at 2 bytes/pixel and
+// a row. Each includes its share of alignment.
+static inline uint32_t planImageScratch(int32_t width, int32_t height,
+  uint16_t depth, uint32_t stride, int displaySize) {
+  if(depth == 1) return stride + displaySize * 2 + 8;
+  return width * abs(height) * 2 + stride + 4;
+}
+
+// Tables block: polarAngle/polarDist, displace and 'slitSlots' slit maps
+static inline uint32_t planTables(int mapRadius, int displaySize,
+  int slitSlots) {
+  return planAlign(mapRadius * mapRadius * 2) +
+         planAlign((displaySize / 2) * (displaySize / 2)) +
+         slitSlots * planAlign(SLIT_BYTES);
+}
+
+#endif
@@ -0,0 +1,59 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+/* Voice changer modulation (the "Dalek" effect): the gain waveform
+   dspGain() applies to the output, "modulate" Hz and "waveform" in the
+   config. One fixed MOD_TABLE-entry cycle per waveform in flash, read by
+   a 32-bit phase accumulator with the in-between entries interpolated.
+   The phase step comes from the frequency and the actual playback rate,
+   so a pitch change just changes the step (voicePitch() passes the rate
+   on) instead of working out a new buffer, any frequency can be had
+   rather than whole samples per cycle, and there's no RAM buffer.
+
+   No Arduino dependencies.
+*/
+
+#ifndef __MOD_WAVE_H
+#define __MOD_WAVE_H
+
+#include <stdint.h>
+
+#define MOD_TABLE 256 // Entries per cycle
+
+// Waveforms, as "waveform" in the config
+#define MOD_NONE     0
+#define MOD_SQUARE   1
+#define MOD_SINE     2
+#define MOD_TRIANGLE 3
+#define MOD_SAW      4
+#define MOD_WAVES    4
+
+class ModWave {
+public:
+  ModWave(void);
+
+  // Modulation frequency (Hz) and waveform (MOD_*; above MOD_WAVES is
+  // MOD_SAW). Carries on from the same point in the cycle.
+  void set(float hz, uint8_t waveform);
+
+  // Output samples per second, whenever it changes
+  void playbackRate(float rate);
+
+  bool on(void) const { return wave != MOD_NONE; }
+
+  // Next 'n' gains (0-255, as dspGain() takes) into 'gain'. Only when
+  // on().
+  void fill(uint8_t *gain, uint16_t n);
+
+private:
+  void     update(void);
+
+  uint8_t  wave;
+  float    freq, rate;
+  uint32_t phase, step; // Through the cycle, fraction of 2^32
+};
+
+#endif
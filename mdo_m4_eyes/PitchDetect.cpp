@@ -0,0 +1,98 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+#include "PitchDetect.h"
+
+PitchDetect::PitchDetect(void) {
+  size = minLag = maxLag = window = 0;
+  threshold(0.15);
+}
+
+bool PitchDetect::begin(float rate, float minHz, float maxHz, uint16_t bufSize) {
+  float r = rate / (float)PITCH_DECIMATE;
+  size    = bufSize;
+  minLag  = (uint16_t)(r / maxHz);
+  maxLag  = (uint16_t)(r / minHz + 1.0);
+  if(minLag < 2) minLag = 2;
+  // Window as long as the longest period, if the buffer allows (less a
+  // little, as the recording carries on while the block's copied out)
+  window  = maxLag;
+  uint16_t avail = (bufSize > 32) ? ((bufSize - 32) / PITCH_DECIMATE) : 0;
+  if((window + maxLag) > avail) window = (avail > maxLag) ? (avail - maxLag) : 0;
+  if((maxLag > PITCH_MAX_LAG) || (window < maxLag / 2)) {
+    maxLag = 0; // detect() will say no pitch
+    return false;
+  }
+  return true;
+}
+
+float PitchDetect::detect(const volatile uint16_t *buf, uint16_t newest) {
+  if(!maxLag) return 0.0;
+  uint16_t n = window + maxLag, i, j;
+
+  // Copy out, decimated, oldest first, removing the average
+  int32_t  sum = 0, peak = 0;
+  int      k   = (int)newest - n * PITCH_DECIMATE + 1;
+  if(k < 0) k += size;
+  for(i=0; i<n; i++) {
+    int32_t s = 0;
+    for(j=0; j<PITCH_DECIMATE; j++) {
+      s += buf[k];
+      if(++k >= size) k = 0;
+    }
+    x[i] = s = s / PITCH_DECIMATE - 32768; // 16-bit signed
+    sum += s;
+  }
+  int32_t mean = sum / n;
+  for(i=0; i<n; i++) {
+    int32_t s = x[i] - mean;
+    x[i] = s;
+    if(s < 0) s = -s;
+    if(s > peak) peak = s;
+  }
+  if(peak < 8) return 0.0; // Silence
+  // Scale to 10 bits so a squared difference summed over the window
+  // stays in 32 bits (2^22 * 256)
+  uint8_t shift = 0;
+  while((peak >> shift) > 1023) shift++;
+  if(shift) {
+    for(i=0; i<n; i++) x[i] >>= shift;
+  }
+
+  // Difference function, cumulative-mean normalized on the fly: take the
+  // first lag past minLag whose normalized value dips under the
+  // threshold, then follow it down to the bottom of the dip.
+  uint64_t cum  = 0;
+  uint16_t best = 0;
+  float    last = 0.0, t = (float)thresh / 1024.0;
+  for(uint16_t tau=1; tau<=maxLag; tau++) {
+    uint32_t acc = 0;
+    for(i=0; i<window; i++) {
+      int32_t diff = x[i] - x[i + tau];
+      acc += (uint32_t)(diff * diff);
+    }
+    d[tau]  = acc;
+    cum    += acc;
+    float n = cum ? ((float)acc * (float)tau / (float)cum) : 1.0;
+    if(best) {
+      if(n >= last) break; // Bottom of the dip was the last one
+      best = tau;
+    } else if((tau >= minLag) && (n < t)) {
+      best = tau;
+    }
+    last = n;
+  }
+  if(!best || (best >= maxLag)) return 0.0;
+
+  // Parabola through the dip for a fractional lag
+  float a = (float)d[best - 1], b = (float)d[best], c = (float)d[best + 1],
+        den = a - 2.0 * b + c, off = 0.0;
+  if(den > 0.0) {
+    off = 0.5 * (a - c) / den;
+    if(off > 0.5) off = 0.5; else if(off < -0.5) off = -0.5;
+  }
+  return ((float)best + off) * (float)PITCH_DECIMATE;
+}
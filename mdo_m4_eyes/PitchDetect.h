@@ -0,0 +1,53 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+/* Voice pitch estimate (YIN: de Cheveigne & Kawahara 2002) from the
+   latest stretch of a circular buffer of 16-bit unsigned audio, such as
+   the voice changer's recording buffer.
+
+   The block is copied out 4:1 decimated (pitch tops out well under the
+   decimated Nyquist frequency) and scaled to 10 bits, so the difference
+   function is 32-bit integer math, and stops as soon as the first clear
+   dip is found. Worst case at 46,875 Hz and a 65 Hz lowest pitch is
+   about 33,000 multiply-adds; a typical speaking voice is a third that.
+
+   No Arduino dependencies; the host tool mdo_Simul8/Simul8_voiceBench.cpp
+   runs this same code on WAV files.
+*/
+
+#ifndef __PITCH_DETECT_H
+#define __PITCH_DETECT_H
+
+#include <stdint.h>
+
+#define PITCH_DECIMATE  4   // Input samples per analysis sample
+#define PITCH_MAX_LAG 200   // Analysis samples, longest period allowed
+
+class PitchDetect {
+public:
+  PitchDetect(void);
+
+  // Input sample rate, lowest and highest pitch (Hz) to look for, and
+  // the circular buffer size (samples) that will be passed to detect().
+  // Returns false if the lowest pitch needs a longer buffer or lag.
+  bool     begin(float rate, float minHz, float maxHz, uint16_t bufSize);
+
+  // Period of the pitch in input samples (fractional), or 0 if there's
+  // no clear pitch (silence, noise, unvoiced speech). 'newest' is the
+  // index of the last sample written to 'buf'.
+  float    detect(const volatile uint16_t *buf, uint16_t newest);
+
+  // Dip threshold, 0.0-1.0: lower = fewer wrong answers, more 'no pitch'
+  void     threshold(float t) { thresh = (uint16_t)(t * 1024.0); }
+
+private:
+  uint16_t size, minLag, maxLag, window;
+  uint16_t thresh; // 0-1024
+  int16_t  x[PITCH_MAX_LAG * 2];
+  uint32_t d[PITCH_MAX_LAG + 2];
+};
+
+#endif
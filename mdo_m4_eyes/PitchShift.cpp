@@ -0,0 +1,117 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+#include <stddef.h>
+#include "PitchShift.h"
+#include "VoiceDSP.h"
+
+PitchShift::PitchShift(void) {
+  begin(0, 0);
+}
+
+void PitchShift::begin(uint16_t bufSize, uint16_t blockSize) {
+  size      = bufSize;
+  block     = blockSize;
+  jumpNext  = 1;
+  jumpTotal = 0;
+  started   = false;
+  play      = jumped = blendLeft = 0;
+  blendW    = blendStep = 0;
+  pitch(1.0);
+}
+
+void PitchShift::pitch(float p) {
+  rateInv = (uint32_t)(65536.0 / p + 0.5);
+  up      = (rateInv <= 65536);
+  // Longest jump the buffer allows. Jumping back, the faded-in point
+  // ends up j + fade (at most 2j) behind the recording, which writes up
+  // to a block more before it's read. Jumping ahead, the faded-in point
+  // must stay a block short of the newest sample, starting from as far
+  // back as the recording gains in a fade and two blocks; with the fade
+  // at most j * p / (1 - p) / 3 (see fill()) that's 4j/3 + 2 blocks/p.
+  float m = up ? (((float)size - 2 - block) / 2.0) :
+                 (((float)size - 1 - 2.0 * block / p) * 0.75);
+  jumpMax = (m > 1.0) ? (uint16_t)m : 1;
+}
+
+void PitchShift::fill(uint16_t *out, uint16_t n, const volatile uint16_t *rec, uint16_t newest) {
+  uint16_t *o = out, *end = out + n;
+  if(!size) {
+    while(o < end) *o++ = 2048;
+    return;
+  }
+  if(!started) { // Start a block behind the recording
+    play    = (newest + size - block) % size;
+    started = true;
+  }
+
+  // Same jump and fade through the block. Jumping ahead, playback has to
+  // gain on the recording in a fade; below 3/4 speed the fade's cut so
+  // each jump gains at least twice what its fade loses.
+  uint16_t j    = (jumpNext > jumpMax) ? jumpMax : (jumpNext ? jumpNext : 1),
+           fade = j;
+  uint32_t gain = 0, lead = 0; // Recording over playback - 1, 16.16; a block's recording
+  int32_t  safe;               // Distance that leaves room for a fade
+  if(up) {
+    // Recording only ever moves away, so it's enough that the faded-out
+    // point doesn't overtake it within this block
+    safe = fade + 1;
+  } else {
+    gain = rateInv - 65536;
+    lead = ((uint32_t)block * rateInv) >> 16;
+    if(j < ((3 * gain) >> 16) + 2) j = fade = ((3 * gain) >> 16) + 2; // Fade >= 1
+    uint32_t f = ((uint32_t)j << 16) / (gain * 3);
+    if(f < fade) fade = f ? f : 1;
+    // Next block, before the recording catches up: a fade, plus one more
+    // block in case this block ends in one
+    safe = (int32_t)(((uint32_t)(fade + block) * gain) >> 16) + 1;
+  }
+
+  while(o < end) {
+    if(blendLeft) {
+      // Cross-fade, ramping 'jumped' up and 'play' down, in runs that
+      // don't pass the end of the buffer
+      uint16_t pa  = (play   + 1 < size) ? (play   + 1) : 0,
+               pb  = (jumped + 1 < size) ? (jumped + 1) : 0,
+               run = blendLeft;
+      if(run > (end - o))   run = end - o;
+      if(run > (size - pa)) run = size - pa;
+      if(run > (size - pb)) run = size - pb;
+      dspCrossfade(o, (const uint16_t *)rec + pa, (const uint16_t *)rec + pb, run, &blendW, blendStep);
+      o         += run;
+      play       = pa + run - 1;
+      jumped     = pb + run - 1;
+      blendLeft -= run;
+      if(!blendLeft) play = jumped;
+      continue;
+    }
+    // Straight playback until the recording's too close
+    int32_t dist, run;
+    if(up) { // Recording ahead of playback, getting closer
+      dist = ((int32_t)newest - play + size) % size;
+      run  = dist - safe;
+    } else { // Recording behind (around the buffer), closing in between blocks
+      dist = ((int32_t)play - newest + size) % size;
+      run  = ((dist + (end - o) - (int32_t)lead) >= safe) ? (end - o) : 0;
+    }
+    if(run > (end - o)) run = end - o;
+    while(run > 0) {
+      uint16_t pa = (play + 1 < size) ? (play + 1) : 0,
+               k  = (run > (size - pa)) ? (size - pa) : run;
+      dspCopy12(o, (const uint16_t *)rec + pa, k); // 16->12 bit
+      o    += k;
+      play  = pa + k - 1;
+      run  -= k;
+    }
+    if(o >= end) break;
+    // Jump, cross-fading over its length
+    jumped    = up ? ((play + size - j) % size) : ((play + j) % size);
+    blendLeft = fade;
+    blendStep = (1UL << 24) / fade;
+    blendW    = blendStep;
+    jumpTotal++;
+  }
+}
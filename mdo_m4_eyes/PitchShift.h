@@ -0,0 +1,67 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+/* Voice changer playback: fills blocks of 12-bit output samples from a
+   circular buffer of 16-bit unsigned recording, played back at a
+   different rate than it was recorded.
+
+   Playing faster than recording, the playback point catches up with the
+   recording and has to jump back; slower, the recording catches up and
+   playback has to jump ahead. Either way the jump is cross-faded over its
+   own length, so a jump of whole pitch periods (see PitchDetect) makes no
+   seam. Jumps start only where the recording's known to stay clear of
+   both playback points until the cross-fade is over, allowing for the
+   recording carrying on while a block plays.
+
+   All in the main loop, one block at a time (see pdmvoice.cpp), rather
+   than one sample per interrupt, with the per-sample loops in VoiceDSP.
+   No Arduino dependencies; the host tool mdo_Simul8/Simul8_voiceBench.cpp
+   runs this same code on WAV files.
+*/
+
+#ifndef __PITCH_SHIFT_H
+#define __PITCH_SHIFT_H
+
+#include <stdint.h>
+
+class PitchShift {
+public:
+  PitchShift(void);
+
+  // Recording buffer size and the most samples fill() will be asked for
+  void     begin(uint16_t bufSize, uint16_t blockSize);
+
+  // Playback rate over recording rate (0.5 = octave down). Can change at
+  // any time; takes effect from the next block.
+  void     pitch(float p);
+
+  // Length of a jump, in recording samples. Clipped to jumpLimit().
+  void     jump(uint16_t samples) { jumpNext = samples; }
+
+  // Longest jump the buffer allows at the current pitch
+  uint16_t jumpLimit(void) const { return jumpMax; }
+
+  // Jumps made since begin()
+  uint32_t jumps(void) const { return jumpTotal; }
+
+  // Next 'n' output samples (12-bit, 2048 = silence) into 'out'. 'rec' is
+  // the recording buffer, 'newest' the index of its last sample written.
+  void     fill(uint16_t *out, uint16_t n, const volatile uint16_t *rec, uint16_t newest);
+
+private:
+  uint16_t       size, block;
+  uint32_t       rateInv;   // Recording rate over playback rate, 16.16
+  bool           up;        // Playing faster than recording
+  uint16_t       jumpNext, jumpMax;
+  uint32_t       jumpTotal;
+  bool           started;
+  uint16_t       play;      // Playback point
+  uint16_t       jumped;    // Where it's cross-fading to
+  uint16_t       blendLeft; // Samples left in cross-fade
+  uint32_t       blendW, blendStep; // Cross-fade weight of 'jumped', 8.24
+};
+
+#endif
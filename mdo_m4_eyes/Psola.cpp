@@ -0,0 +1,176 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+#include <string.h>
+#include "Psola.h"
+
+// Hann window, 0.5 - 0.5 * cos(2 * pi * i / 256), Q15, plus the end
+// (for interpolating)
+static const int16_t window[257] = {
+      0,     5,    20,    44,    79,   123,   177,   241,
+    315,   398,   491,   593,   705,   827,   958,  1098,
+   1247,  1406,  1573,  1749,  1935,  2128,  2331,  2542,
+   2761,  2989,  3224,  3468,  3719,  3978,  4244,  4518,
+   4799,  5086,  5381,  5682,  5990,  6304,  6624,  6950,
+   7281,  7618,  7961,  8308,  8660,  9017,  9379,  9744,
+  10114, 10487, 10864, 11244, 11628, 12014, 12403, 12794,
+  13187, 13583, 13980, 14378, 14778, 15178, 15580, 15981,
+  16383, 16786, 17187, 17589, 17989, 18389, 18787, 19184,
+  19580, 19973, 20364, 20753, 21139, 21523, 21903, 22280,
+  22653, 23023, 23388, 23750, 24107, 24459, 24806, 25149,
+  25486, 25817, 26143, 26463, 26777, 27085, 27386, 27681,
+  27968, 28249, 28523, 28789, 29048, 29299, 29543, 29778,
+  30006, 30225, 30436, 30639, 30832, 31018, 31194, 31361,
+  31520, 31669, 31809, 31940, 32062, 32174, 32276, 32369,
+  32452, 32526, 32590, 32644, 32688, 32723, 32747, 32762,
+  32767, 32762, 32747, 32723, 32688, 32644, 32590, 32526,
+  32452, 32369, 32276, 32174, 32062, 31940, 31809, 31669,
+  31520, 31361, 31194, 31018, 30832, 30639, 30436, 30225,
+  30006, 29778, 29543, 29299, 29048, 28789, 28523, 28249,
+  27968, 27681, 27386, 27085, 26777, 26463, 26143, 25817,
+  25486, 25149, 24806, 24459, 24107, 23750, 23388, 23023,
+  22653, 22280, 21903, 21523, 21139, 20753, 20364, 19973,
+  19580, 19184, 18787, 18389, 17989, 17589, 17187, 16786,
+  16384, 15981, 15580, 15178, 14778, 14378, 13980, 13583,
+  13187, 12794, 12403, 12014, 11628, 11244, 10864, 10487,
+  10114,  9744,  9379,  9017,  8660,  8308,  7961,  7618,
+   7281,  6950,  6624,  6304,  5990,  5682,  5381,  5086,
+   4799,  4518,  4244,  3978,  3719,  3468,  3224,  2989,
+   2761,  2542,  2331,  2128,  1935,  1749,  1573,  1406,
+   1247,  1098,   958,   827,   705,   593,   491,   398,
+    315,   241,   177,   123,    79,    44,    20,     5,
+      0 };
+
+Psola::Psola(void) {
+  begin(0, 0);
+}
+
+void Psola::begin(uint16_t bufSize, uint16_t blockSize) {
+  size       = bufSize;
+  block      = (blockSize > PSOLA_BLOCK_MAX) ? PSOLA_BLOCK_MAX : blockSize;
+  ratio      = 1.0;
+  periodIn   = 256.0;
+  next       = 0;
+  center     = 0;
+  started    = false;
+  grainTotal = cutTotal = 0;
+  memset(g, 0, sizeof g);
+  update();
+}
+
+void Psola::pitch(float p) {
+  if(p < PSOLA_PITCH_MIN)      p = PSOLA_PITCH_MIN;
+  else if(p > PSOLA_PITCH_MAX) p = PSOLA_PITCH_MAX;
+  ratio = p;
+  update();
+}
+
+void Psola::period(float samples) {
+  if(samples < 16.0) samples = 16.0;
+  periodIn = samples;
+  update();
+}
+
+// Grain size and spacing from pitch and period. Taking effect at the next
+// grain, grains already playing carry on as they were.
+void Psola::update(void) {
+  float h = periodIn / ratio; // Output samples between grains
+  // Half a grain is a period. Longer (to close the dips between grains
+  // below 1x) would carry the original pitch through. Windows at spacing
+  // h add up to half / h on average, corrected by norm.
+  float l = periodIn;
+  // A grain is read while the recording carries on: its start must
+  // stay ahead of it for a period (where the grain's centered), the
+  // grain's length and two blocks (filled ahead of the DAC)
+  float lMax = ((float)size - periodIn - 2.0 * block - 4.0) / 2.0;
+  if(l > lMax) l = lMax;
+  if(l < 8.0)  l = 8.0;
+  per  = (uint16_t)(periodIn + 0.5);
+  half = (uint16_t)l;
+  hop  = (uint32_t)(h * 65536.0);
+  norm = (int32_t)(256.0 * h / (float)half + 0.5);
+  if(norm > 512) norm = 512;
+}
+
+// Start a grain 'at' samples into this block, centered a whole number
+// of periods from the last one, as near as that gets to a half grain
+// behind the newest recording
+void Psola::start(uint16_t at, uint16_t newest) {
+  uint16_t target = (newest + size - half - 1) % size;
+  if(started) {
+    int32_t d = ((int32_t)target - center + size) % size;
+    if(d > size / 2) d -= size;
+    if((d > 4 * per) || (d < -4 * per)) { // Way out (period changed a lot)
+      center = target;
+    } else {
+      for(; d >= per; d -= per) center = (center + per) % size;
+      for(; d < 0;    d += per) center = (center + size - per) % size;
+    }
+  } else {
+    center  = target;
+    started = true;
+  }
+  // Use a free slot, or cut short the one closest to done
+  grain *s = &g[0];
+  for(uint8_t i=1; (i<PSOLA_GRAINS) && s->left; i++) {
+    if(g[i].left < s->left) s = &g[i];
+  }
+  if(s->left) cutTotal++;
+  s->pos   = (center + size - half) % size;
+  s->left  = half * 2;
+  s->at    = at;
+  s->phase = 0;
+  s->step  = (256UL << 16) / (half * 2);
+  grainTotal++;
+}
+
+void Psola::fill(uint16_t *out, uint16_t n, const volatile uint16_t *rec, uint16_t newest) {
+  if(n > PSOLA_BLOCK_MAX) n = PSOLA_BLOCK_MAX;
+  if(!size) {
+    for(uint16_t k=0; k<n; k++) out[k] = 2048;
+    return;
+  }
+  memset(acc, 0, n * sizeof(int32_t));
+
+  // Grains starting in this block
+  for(; next < ((uint32_t)n << 16); next += hop) start(next >> 16, newest);
+  next -= (uint32_t)n << 16;
+
+  // Each grain's part of the block, in runs that don't pass the end of
+  // the buffer
+  for(uint8_t i=0; i<PSOLA_GRAINS; i++) {
+    grain   *s = &g[i];
+    uint16_t k = s->at, cnt = n - k;
+    if(cnt > s->left) cnt = s->left;
+    s->left -= cnt;
+    s->at    = 0;
+    while(cnt) {
+      uint16_t run = (cnt > (size - s->pos)) ? (size - s->pos) : cnt;
+      const volatile uint16_t *r = &rec[s->pos];
+      uint32_t ph = s->phase, st = s->step;
+      for(uint16_t j=0; j<run; j++) {
+        // Window interpolated between table entries; grains are up to
+        // ~8x the table, and stepping through it shows as roughness
+        int32_t i = ph >> 16,
+                w = window[i] + (((window[i + 1] - window[i]) * (int32_t)((ph >> 8) & 0xFF)) >> 8);
+        acc[k++] += (((int32_t)r[j] - 32768) * w) >> 4;
+        ph       += st;
+      }
+      s->phase = ph;
+      s->pos  += run;
+      if(s->pos >= size) s->pos = 0;
+      cnt     -= run;
+    }
+  }
+
+  // Overlap gain correction, 16 -> 12 bits
+  for(uint16_t k=0; k<n; k++) {
+    int32_t v = ((acc[k] >> 11) * norm) >> 12;
+    if(v > 2047)       v = 2047;
+    else if(v < -2048) v = -2048;
+    out[k] = v + 2048;
+  }
+}
@@ -0,0 +1,86 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+/* Voice changer playback, pitch-synchronous overlap-add (PSOLA): the
+   other way of shifting pitch (see PitchShift), chosen with "voiceMode"
+   in the config. Output runs at the recording's own rate; pitch changes
+   by how often grains start, not by playing faster or slower, so the
+   voice's formants stay where they were and it sounds less like a
+   cartoon at 0.7x to 1.5x.
+
+   Each grain is two pitch periods of recording (period() from
+   PitchDetect) under a Hann window from a precomputed table, centered a
+   whole number of periods after the last grain's so they line up. Grains
+   start every period / pitch output samples and are added together. No
+   more than PSOLA_GRAINS are ever playing (the oldest is cut short to
+   start a new one), so a block costs at most PSOLA_GRAINS multiply-adds
+   per sample whatever the pitch.
+
+   No Arduino dependencies; the host tool mdo_Simul8/Simul8_voiceBench.cpp
+   runs this same code on WAV files (--psola).
+*/
+
+#ifndef __PSOLA_H
+#define __PSOLA_H
+
+#include <stdint.h>
+
+#define PSOLA_GRAINS    4   // Most grains at once: the CPU budget
+#define PSOLA_BLOCK_MAX 128 // Most samples per fill()
+#define PSOLA_PITCH_MIN 0.5
+#define PSOLA_PITCH_MAX 2.0
+
+class Psola {
+public:
+  Psola(void);
+
+  // Recording buffer size and the most samples fill() will be asked for
+  // (at most PSOLA_BLOCK_MAX). The buffer needs to hold three periods
+  // and two blocks; grains are cut shorter to fit if not.
+  void     begin(uint16_t bufSize, uint16_t blockSize);
+
+  // Output pitch over input pitch, PSOLA_PITCH_MIN to _MAX (clipped)
+  void     pitch(float p);
+
+  // Voice's pitch period, in recording samples. Keep the last one when
+  // there's no pitch (unvoiced sounds come out fine as plain grains).
+  void     period(float samples);
+
+  // Grains started and cut short since begin()
+  uint32_t grains(void) const { return grainTotal; }
+  uint32_t cuts(void) const { return cutTotal; }
+
+  // Next 'n' output samples (12-bit, 2048 = silence) into 'out'. 'rec' is
+  // the recording buffer, 'newest' the index of its last sample written.
+  void     fill(uint16_t *out, uint16_t n, const volatile uint16_t *rec, uint16_t newest);
+
+private:
+  typedef struct {
+    uint16_t pos;   // Next recording sample
+    uint16_t left;  // Samples left, 0 = not playing
+    uint16_t at;    // Where in this block it starts
+    uint32_t phase; // Through the window, 8.16 (table index . fraction)
+    uint32_t step;
+  } grain;
+
+  void     update(void);
+  void     start(uint16_t at, uint16_t newest);
+
+  uint16_t size, block;
+  float    ratio, periodIn;
+  uint16_t per;        // Period, whole samples
+  uint16_t half;       // Grain half length
+  uint32_t hop;        // Output samples between grain starts, 16.16
+  int32_t  norm;       // Overlap gain correction, 8 bits fraction
+  uint32_t next;       // Output samples to next grain start, 16.16
+  uint16_t center;     // Last grain's middle in the recording
+  bool     started;
+  grain    g[PSOLA_GRAINS];
+  int32_t  acc[PSOLA_BLOCK_MAX];
+  uint32_t grainTotal, cutTotal;
+};
+
+#endif
@@ -0,0 +1,123 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+#include <string.h>
+#include <math.h>
+#include "SoundLevels.h"
+
+static const uint16_t defaultBands[SOUND_BANDS] = { 250, 500, 1000, 2000 };
+
+SoundLevels::SoundLevels(void) {
+  begin(46875.0);
+}
+
+void SoundLevels::begin(float r, const uint16_t *bandHz) {
+  rate = r;
+  if(!bandHz) bandHz = defaultBands;
+  for(uint8_t b=0; b<SOUND_BANDS; b++) {
+    coeff[b] = 2.0 * cos(2.0 * M_PI * (float)bandHz[b] / rate);
+    s1[b]    = s2[b] = 0.0;
+  }
+  dc       = 32768;
+  dcSum    = 0;
+  sumSq    = 0;
+  peak     = fed = 0;
+  level    = floor = 0.0;
+  pitchHz  = 0;
+  count    = 0;
+  memset(snap, 0, sizeof snap);
+  snapSeq[0] = snapSeq[1] = 0;
+  snapCount  = 0;
+  voiceThreshold(3.0, 20, 250);
+}
+
+void SoundLevels::voiceThreshold(float r, uint16_t minimum, uint16_t holdMs) {
+  ratio    = r;
+  minLevel = minimum;
+  hold     = (uint16_t)((float)holdMs * 0.001 * rate / SOUND_BLOCK + 0.5);
+  holdLeft = 0;
+}
+
+void SoundLevels::feed(const uint16_t *in, uint16_t n) {
+  while(n) {
+    uint16_t k = SOUND_BLOCK - fed;
+    if(k > n) k = n;
+    n   -= k;
+    fed += k;
+    for(; k; k--) {
+      uint16_t v = *in++;
+      int32_t  x = ((int32_t)v - dc) >> 4; // 12-bit, about 0
+      uint16_t a = (x < 0) ? -x : x;
+      dcSum += v;
+      sumSq += x * x; // < 2^22 each, 2^30 a block
+      if(a > peak) peak = a;
+      for(uint8_t b=0; b<SOUND_BANDS; b++) {
+        float s0 = (float)x + coeff[b] * s1[b] - s2[b];
+        s2[b] = s1[b];
+        s1[b] = s0;
+      }
+    }
+    if(fed >= SOUND_BLOCK) finish();
+  }
+}
+
+// End of a block: work out its numbers and publish them
+void SoundLevels::finish(void) {
+  float rms = sqrtf((float)sumSq / SOUND_BLOCK);
+  dc    = dcSum / SOUND_BLOCK;
+  dcSum = sumSq = 0;
+  fed   = 0;
+
+  // Level jumps most of the way up at once, falls away over ~100 ms;
+  // the floor creeps up over seconds but drops quickly
+  if(!count)            level = floor = rms;
+  if(rms > level)       level += (rms - level) * 0.5;
+  else                  level += (rms - level) * 0.05;
+  if(rms < floor)       floor += (rms - floor) * 0.25;
+  else                  floor += (rms - floor) * 0.002;
+
+  // Voice goes by this block alone, not the slow-falling level, so it
+  // ends 'hold' after the talking does
+  if((rms >= floor * ratio) && (rms >= minLevel)) holdLeft = hold + 1;
+  if(holdLeft) holdLeft--;
+
+  // Into whichever buffer readers aren't being pointed at
+  uint8_t      i = (snapCount + 1) & 1;
+  soundLevels *s = &snap[i];
+  snapSeq[i]++;
+  __sync_synchronize();
+  s->count   = ++count;
+  s->level   = (uint16_t)(level + 0.5);
+  s->peak    = peak;
+  s->floor   = (uint16_t)(floor + 0.5);
+  s->voice   = holdLeft > 0;
+  s->pitchHz = pitchHz;
+  for(uint8_t b=0; b<SOUND_BANDS; b++) {
+    // Goertzel power -> amplitude of that frequency
+    float p = s1[b] * s1[b] + s2[b] * s2[b] - coeff[b] * s1[b] * s2[b];
+    s->band[b] = (uint16_t)(2.0 * sqrtf((p > 0.0) ? p : 0.0) / SOUND_BLOCK + 0.5);
+    s1[b] = s2[b] = 0.0;
+  }
+  peak = 0;
+  __sync_synchronize();
+  snapSeq[i]++;
+  snapCount = count;
+}
+
+bool SoundLevels::get(soundLevels *out) const {
+  for(uint8_t tries=0; tries<4; tries++) {
+    uint32_t c = snapCount;
+    if(!c) return false;
+    uint8_t  i   = c & 1;
+    uint32_t seq = snapSeq[i];
+    if(seq & 1) continue; // Being written (feed() interrupted this)
+    __sync_synchronize();
+    memcpy(out, &snap[i], sizeof(soundLevels));
+    __sync_synchronize();
+    if(snapSeq[i] == seq) return true;
+  }
+  return false;
+}
@@ -0,0 +1,88 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+/* How loud the mic is and whether someone's talking, for user code to
+   react to (pupils, blinks, expressions) without watching the recording
+   interrupt's variables. Fed the recording in any size pieces; every
+   SOUND_BLOCK samples it works out:
+     level  - RMS, smoothed: quick to rise, slow to fall
+     peak   - largest sample in the block
+     floor  - background noise, following the quietest levels
+     voice  - louder than the floor by some ratio, held on through
+              short pauses
+     band[] - how much there is near each of SOUND_BANDS frequencies
+              (Goertzel filters, one multiply-add a sample each)
+   Levels are in 12-bit sample units, 0 to 2048 (full scale).
+
+   Results go in a snapshot that get() copies out whole. It's double
+   buffered with a sequence count per buffer, so a reader never sees
+   half an update, without locks or turning interrupts off, even if
+   feed() moved to an interrupt.
+
+   No Arduino dependencies; the host tool mdo_Simul8/Simul8_voiceBench.cpp
+   runs this same code on WAV files (--levels).
+*/
+
+#ifndef __SOUND_LEVELS_H
+#define __SOUND_LEVELS_H
+
+#include <stdint.h>
+
+#define SOUND_BLOCK 256 // Samples per update, 5.5 ms at 46,875 Hz
+#define SOUND_BANDS 4
+
+typedef struct {
+  uint32_t count;             // Updates so far (changes = new numbers)
+  uint16_t level;             // Smoothed RMS
+  uint16_t peak;              // Largest sample, last block
+  uint16_t floor;             // Background noise level
+  bool     voice;             // Someone's talking
+  uint16_t band[SOUND_BANDS]; // Amplitude near each band's frequency
+  uint16_t pitchHz;           // Voice pitch if tracked (0 = none)
+} soundLevels;
+
+class SoundLevels {
+public:
+  SoundLevels(void);
+
+  // Sample rate, and band frequencies in Hz (NULL = 250, 500, 1000, 2000)
+  void begin(float rate, const uint16_t *bandHz = NULL);
+
+  // Voice is on when a block's RMS is at least 'ratio' times the floor
+  // and at least 'minLevel', and stays on for 'holdMs' after
+  void voiceThreshold(float ratio, uint16_t minLevel, uint16_t holdMs);
+
+  // More recording, 16-bit unsigned (32768 = silence)
+  void feed(const uint16_t *in, uint16_t n);
+
+  // Pitch tracker's latest result, Hz (0 = no pitch), passed through
+  void pitch(uint16_t hz) { pitchHz = hz; }
+
+  // Copies the latest numbers to *out. false if there are none yet (or,
+  // very unlikely, feed() kept interrupting the copy).
+  bool get(soundLevels *out) const;
+
+private:
+  void finish(void);
+
+  float    rate;
+  float    coeff[SOUND_BANDS], s1[SOUND_BANDS], s2[SOUND_BANDS];
+  int32_t  dc;                  // Recording's DC offset, from last block
+  int32_t  dcSum;
+  uint32_t sumSq;
+  uint16_t peak, fed;
+  float    level, floor;
+  float    ratio;
+  uint16_t minLevel, hold, holdLeft;
+  uint16_t pitchHz;
+  uint32_t count;
+  // Published results
+  soundLevels       snap[2];
+  volatile uint32_t snapSeq[2]; // Odd while snap[i]'s being written
+  volatile uint32_t snapCount;  // Latest is snap[snapCount & 1]
+};
+
+#endif
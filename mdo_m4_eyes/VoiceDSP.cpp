@@ -0,0 +1,298 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+#include <string.h>
+#include "VoiceDSP.h"
+#include "XorShift.h"
+
+// INSTRUCTIONS ------------------------------------------------------------
+
+// Two 16-bit lanes per word, low lane first (as halfword arrays load).
+// On the M4 these are the instructions themselves; elsewhere, C that does
+// the same, so the packed kernels can be checked on a computer.
+
+#if defined(__ARM_FEATURE_DSP)
+
+static inline int32_t smlad(uint32_t x, uint32_t y, int32_t acc) {
+  int32_t r;
+  __asm__("smlad %0, %1, %2, %3" : "=r"(r) : "r"(x), "r"(y), "r"(acc));
+  return r;
+}
+
+static inline int32_t smulbb(uint32_t x, uint32_t y) {
+  int32_t r;
+  __asm__("smulbb %0, %1, %2" : "=r"(r) : "r"(x), "r"(y));
+  return r;
+}
+
+static inline int32_t smultt(uint32_t x, uint32_t y) {
+  int32_t r;
+  __asm__("smultt %0, %1, %2" : "=r"(r) : "r"(x), "r"(y));
+  return r;
+}
+
+static inline uint32_t qadd16(uint32_t x, uint32_t y) {
+  uint32_t r;
+  __asm__("qadd16 %0, %1, %2" : "=r"(r) : "r"(x), "r"(y));
+  return r;
+}
+
+static inline uint32_t ssub16(uint32_t x, uint32_t y) {
+  uint32_t r;
+  __asm__("ssub16 %0, %1, %2" : "=r"(r) : "r"(x), "r"(y));
+  return r;
+}
+
+// Bytes 0 & 2 (or 1 & 3 with ror8) zero-extended to lanes
+static inline uint32_t uxtb16(uint32_t x) {
+  uint32_t r;
+  __asm__("uxtb16 %0, %1" : "=r"(r) : "r"(x));
+  return r;
+}
+
+static inline uint32_t uxtb16ror8(uint32_t x) {
+  uint32_t r;
+  __asm__("uxtb16 %0, %1, ror #8" : "=r"(r) : "r"(x));
+  return r;
+}
+
+// Unsigned lane min & max: USUB16 sets the GE flags SEL goes by, so
+// they're one asm statement (nothing can come between)
+static inline uint32_t umin16(uint32_t x, uint32_t y) {
+  uint32_t r;
+  __asm__("usub16 %0, %1, %2\n\tsel %0, %2, %1" : "=&r"(r) : "r"(x), "r"(y) : "cc");
+  return r;
+}
+
+static inline uint32_t umax16(uint32_t x, uint32_t y) {
+  uint32_t r;
+  __asm__("usub16 %0, %1, %2\n\tsel %0, %1, %2" : "=&r"(r) : "r"(x), "r"(y) : "cc");
+  return r;
+}
+
+#else // No DSP extension
+
+static inline int32_t  lo16(uint32_t x) { return (int16_t)(x & 0xFFFF); }
+static inline int32_t  hi16(uint32_t x) { return (int16_t)(x >> 16); }
+static inline uint32_t pack(int32_t l, int32_t h) {
+  return ((uint32_t)l & 0xFFFF) | ((uint32_t)h << 16);
+}
+static inline int32_t  sat16(int32_t v) {
+  return (v > 32767) ? 32767 : ((v < -32768) ? -32768 : v);
+}
+
+static inline int32_t smlad(uint32_t x, uint32_t y, int32_t acc) {
+  return (int32_t)((uint32_t)(lo16(x) * lo16(y)) + (uint32_t)(hi16(x) * hi16(y)) + (uint32_t)acc);
+}
+static inline int32_t  smulbb(uint32_t x, uint32_t y) { return lo16(x) * lo16(y); }
+static inline int32_t  smultt(uint32_t x, uint32_t y) { return hi16(x) * hi16(y); }
+static inline uint32_t qadd16(uint32_t x, uint32_t y) {
+  return pack(sat16(lo16(x) + lo16(y)), sat16(hi16(x) + hi16(y)));
+}
+static inline uint32_t ssub16(uint32_t x, uint32_t y) {
+  return pack(lo16(x) - lo16(y), hi16(x) - hi16(y));
+}
+static inline uint32_t uxtb16(uint32_t x)     { return x & 0x00FF00FF; }
+static inline uint32_t uxtb16ror8(uint32_t x) { return (x >> 8) & 0x00FF00FF; }
+static inline uint32_t umin16(uint32_t x, uint32_t y) {
+  uint32_t l = ((x & 0xFFFF) < (y & 0xFFFF)) ? x : y, h = ((x >> 16) < (y >> 16)) ? x : y;
+  return (l & 0xFFFF) | (h & 0xFFFF0000);
+}
+static inline uint32_t umax16(uint32_t x, uint32_t y) {
+  uint32_t l = ((x & 0xFFFF) > (y & 0xFFFF)) ? x : y, h = ((x >> 16) > (y >> 16)) ? x : y;
+  return (l & 0xFFFF) | (h & 0xFFFF0000);
+}
+
+#endif // __ARM_FEATURE_DSP
+
+// Two halfwords at any 2-byte alignment (the M4 allows unaligned words)
+static inline uint32_t load2(const uint16_t *p) {
+  uint32_t v;
+  memcpy(&v, p, 4);
+  return v;
+}
+
+static inline void store2(uint16_t *p, uint32_t v) {
+  memcpy(p, &v, 4);
+}
+
+// b's weight for the cross-fade, Q15 (so a's, 32767 - it, fits too)
+static inline uint32_t fadeWeight(uint32_t w) {
+  w >>= 9;
+  return (w > 32767) ? 32767 : w;
+}
+
+// PLAIN C -----------------------------------------------------------------
+
+void dspCopy12Scalar(uint16_t *out, const uint16_t *in, uint16_t n) {
+  while(n--) *out++ = *in++ >> 4;
+}
+
+void dspCrossfadeScalar(uint16_t *out, const uint16_t *a, const uint16_t *b,
+                        uint16_t n, uint32_t *w, uint32_t step) {
+  uint32_t wt = *w;
+  for(uint16_t i=0; i<n; i++) {
+    int32_t wb  = fadeWeight(wt),
+            acc = ((int32_t)a[i] - 32768) * (32767 - wb) + ((int32_t)b[i] - 32768) * wb;
+    out[i] = (acc >> 19) + 2048; // Q15 * 16 bits -> 12 bits
+    wt    += step;
+  }
+  *w = wt;
+}
+
+void dspGainScalar(uint16_t *io, const uint8_t *gain, uint16_t n) {
+  for(uint16_t i=0; i<n; i++) {
+    io[i] = ((((int32_t)io[i] - 2048) * (gain[i] + 1)) >> 8) + 2048;
+  }
+}
+
+void dspMinMaxScalar(const uint16_t *in, uint16_t n, uint16_t *lo, uint16_t *hi) {
+  uint16_t l = *lo, h = *hi;
+  while(n--) {
+    uint16_t v = *in++;
+    if(v < l) l = v;
+    if(v > h) h = v;
+  }
+  *lo = l;
+  *hi = h;
+}
+
+// PACKED ------------------------------------------------------------------
+
+void dspCopy12Packed(uint16_t *out, const uint16_t *in, uint16_t n) {
+  for(; n >= 2; n -= 2, in += 2, out += 2) {
+    store2(out, (load2(in) >> 4) & 0x0FFF0FFF);
+  }
+  if(n) *out = *in >> 4;
+}
+
+void dspCrossfadePacked(uint16_t *out, const uint16_t *a, const uint16_t *b,
+                        uint16_t n, uint32_t *w, uint32_t step) {
+  uint32_t wt = *w;
+  for(; n >= 2; n -= 2, a += 2, b += 2, out += 2) {
+    // Samples -> signed (flip top bits), paired a,b for each output
+    uint32_t av = load2(a) ^ 0x80008000, bv = load2(b) ^ 0x80008000,
+             s0 = (av & 0xFFFF) | (bv << 16),     // a0, b0
+             s1 = (av >> 16) | (bv & 0xFFFF0000), // a1, b1
+             w0 = fadeWeight(wt), w1 = fadeWeight(wt + step);
+    int32_t  o0 = smlad(s0, (32767 - w0) | (w0 << 16), 0) >> 19,
+             o1 = smlad(s1, (32767 - w1) | (w1 << 16), 0) >> 19;
+    store2(out, qadd16(((uint32_t)o0 & 0xFFFF) | ((uint32_t)o1 << 16), 0x08000800));
+    wt += step * 2;
+  }
+  *w = wt;
+  if(n) dspCrossfadeScalar(out, a, b, n, w, step);
+}
+
+void dspGainPacked(uint16_t *io, const uint8_t *gain, uint16_t n) {
+  for(; n >= 4; n -= 4, io += 4, gain += 4) {
+    uint32_t g;
+    memcpy(&g, gain, 4);
+    uint32_t g02 = uxtb16(g) + 0x00010001, g13 = uxtb16ror8(g) + 0x00010001,
+             ga  = (g02 & 0xFFFF) | (g13 << 16),      // gain 0, 1
+             gb  = (g02 >> 16) | (g13 & 0xFFFF0000),  // gain 2, 3
+             sa  = ssub16(load2(io), 0x08000800),     // Samples 0, 1 about 0
+             sb  = ssub16(load2(io + 2), 0x08000800); // 2, 3
+    store2(io,     qadd16(((uint32_t)(smulbb(sa, ga) >> 8) & 0xFFFF) |
+                          ((uint32_t)(smultt(sa, ga) >> 8) << 16), 0x08000800));
+    store2(io + 2, qadd16(((uint32_t)(smulbb(sb, gb) >> 8) & 0xFFFF) |
+                          ((uint32_t)(smultt(sb, gb) >> 8) << 16), 0x08000800));
+  }
+  if(n) dspGainScalar(io, gain, n);
+}
+
+void dspMinMaxPacked(const uint16_t *in, uint16_t n, uint16_t *lo, uint16_t *hi) {
+  uint32_t l = *lo * 0x00010001, h = *hi * 0x00010001;
+  for(; n >= 2; n -= 2, in += 2) {
+    uint32_t v = load2(in);
+    l = umin16(v, l);
+    h = umax16(v, h);
+  }
+  uint16_t l0 = l & 0xFFFF, l1 = l >> 16, h0 = h & 0xFFFF, h1 = h >> 16;
+  *lo = (l0 < l1) ? l0 : l1;
+  *hi = (h0 > h1) ? h0 : h1;
+  if(n) dspMinMaxScalar(in, n, lo, hi);
+}
+
+// WHICHEVER SUITS ---------------------------------------------------------
+
+#if defined(__ARM_FEATURE_DSP)
+ #define DSP_PICK(f) f##Packed
+#else
+ #define DSP_PICK(f) f##Scalar
+#endif
+
+void dspCopy12(uint16_t *out, const uint16_t *in, uint16_t n) {
+  DSP_PICK(dspCopy12)(out, in, n);
+}
+
+void dspCrossfade(uint16_t *out, const uint16_t *a, const uint16_t *b,
+                  uint16_t n, uint32_t *w, uint32_t step) {
+  DSP_PICK(dspCrossfade)(out, a, b, n, w, step);
+}
+
+void dspGain(uint16_t *io, const uint8_t *gain, uint16_t n) {
+  DSP_PICK(dspGain)(io, gain, n);
+}
+
+void dspMinMax(const uint16_t *in, uint16_t n, uint16_t *lo, uint16_t *hi) {
+  DSP_PICK(dspMinMax)(in, n, lo, hi);
+}
+
+// MICRO-BENCHMARK ---------------------------------------------------------
+
+void dspBench(dspBenchResult *r, void *scratch, uint32_t (*ticks)(void), uint16_t reps) {
+  const uint16_t N = DSP_BENCH_SAMPLES;
+  uint16_t *a  = (uint16_t *)scratch, *b = a + N, *o1 = b + N, *o2 = o1 + N;
+  uint8_t  *g  = (uint8_t *)(o2 + N);
+  XorShift  rnd(12345);
+  for(uint16_t i=0; i<N; i++) {
+    a[i] = rnd.next();
+    b[i] = rnd.next();
+    g[i] = rnd.next();
+  }
+  // Extremes among the random values
+  a[0] = 0;     b[0] = 65535; g[0] = 0;
+  a[1] = 65535; b[1] = 0;     g[1] = 255;
+  a[2] = 32768; b[2] = 32767; g[2] = 128;
+
+  for(uint8_t k=0; k<DSP_KERNELS; k++) {
+    uint32_t t, w1, w2, step = (1UL << 24) / (N - 3);
+    uint16_t l1 = 40000, h1 = 30000, l2 = 40000, h2 = 30000;
+    r[k].scalar = r[k].packed = 0;
+    for(uint16_t rep=0; rep<reps; rep++) {
+      // Same input each time; kernels that work in place get a fresh copy
+      switch(k) {
+       case 0:
+        r[k].name = "copy";
+        t = ticks(); dspCopy12Scalar(o1, a, N); r[k].scalar += ticks() - t;
+        t = ticks(); dspCopy12Packed(o2, a, N); r[k].packed += ticks() - t;
+        break;
+       case 1:
+        r[k].name = "crossfade";
+        w1 = w2 = 0;
+        t = ticks(); dspCrossfadeScalar(o1, a + 1, b, N - 1, &w1, step); r[k].scalar += ticks() - t;
+        t = ticks(); dspCrossfadePacked(o2, a + 1, b, N - 1, &w2, step); r[k].packed += ticks() - t;
+        o1[N - 1] = w1 >> 16; o2[N - 1] = w2 >> 16; // Final weights count too
+        break;
+       case 2:
+        r[k].name = "gain";
+        dspCopy12Scalar(o1, b, N);
+        dspCopy12Scalar(o2, b, N);
+        t = ticks(); dspGainScalar(o1, g, N - 1); r[k].scalar += ticks() - t;
+        t = ticks(); dspGainPacked(o2, g, N - 1); r[k].packed += ticks() - t;
+        break;
+       case 3:
+        r[k].name = "min/max";
+        t = ticks(); dspMinMaxScalar(a + 3, N - 4, &l1, &h1); r[k].scalar += ticks() - t;
+        t = ticks(); dspMinMaxPacked(a + 3, N - 4, &l2, &h2); r[k].packed += ticks() - t;
+        o1[0] = l1; o1[1] = h1; o2[0] = l2; o2[1] = h2;
+        break;
+      }
+    }
+    r[k].same = !memcmp(o1, o2, ((k == 3) ? 2 : N) * sizeof(uint16_t));
+  }
+}
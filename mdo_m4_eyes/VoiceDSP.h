@@ -0,0 +1,75 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+/* Inner loops of the voice changer (PitchShift, pdmvoice.cpp) on 16-bit
+   unsigned recording and 12-bit DAC samples, two samples per instruction
+   where the Cortex-M4's DSP extension allows: SMLAD for the cross-fade
+   (both weights in one multiply-add), SMULBB/SMULTT and QADD16 for the
+   modulation gain, USUB16/SEL for min/max.
+
+   Each has a plain C version that gives exactly the same results, which
+   is what's used where there's no DSP extension. The packed versions are
+   written with small instruction helpers that are inline assembly on the
+   M4 and C copies of the instructions elsewhere, so the two can be
+   checked against each other on a computer as well as on the board.
+   dspBench() does that and times both; it runs at voice startup and in
+   the host tool mdo_Simul8/Simul8_dspBench.cpp.
+
+   No Arduino dependencies.
+*/
+
+#ifndef __VOICE_DSP_H
+#define __VOICE_DSP_H
+
+#include <stdint.h>
+
+// out[i] = in[i] >> 4 (16-bit recording -> 12-bit DAC)
+void dspCopy12(uint16_t *out, const uint16_t *in, uint16_t n);
+
+// Cross-fade from 'a' to 'b' into 12-bit 'out'. *w is b's weight, 8.24
+// fixed point (0 = all a, 1<<24 = all b), used as Q15 and stepped by
+// 'step' after each sample.
+void dspCrossfade(uint16_t *out, const uint16_t *a, const uint16_t *b,
+                  uint16_t n, uint32_t *w, uint32_t step);
+
+// 12-bit samples scaled about 2048 by (gain[i] + 1) / 256
+void dspGain(uint16_t *io, const uint8_t *gain, uint16_t n);
+
+// Widens *lo and *hi to take in in[0] to in[n-1]
+void dspMinMax(const uint16_t *in, uint16_t n, uint16_t *lo, uint16_t *hi);
+
+// Plain C and packed versions of the above; the functions above are
+// whichever suits the processor.
+void dspCopy12Scalar(uint16_t *out, const uint16_t *in, uint16_t n);
+void dspCopy12Packed(uint16_t *out, const uint16_t *in, uint16_t n);
+void dspCrossfadeScalar(uint16_t *out, const uint16_t *a, const uint16_t *b,
+                        uint16_t n, uint32_t *w, uint32_t step);
+void dspCrossfadePacked(uint16_t *out, const uint16_t *a, const uint16_t *b,
+                        uint16_t n, uint32_t *w, uint32_t step);
+void dspGainScalar(uint16_t *io, const uint8_t *gain, uint16_t n);
+void dspGainPacked(uint16_t *io, const uint8_t *gain, uint16_t n);
+void dspMinMaxScalar(const uint16_t *in, uint16_t n, uint16_t *lo, uint16_t *hi);
+void dspMinMaxPacked(const uint16_t *in, uint16_t n, uint16_t *lo, uint16_t *hi);
+
+// MICRO-BENCHMARK ---------------------------------------------------------
+
+#define DSP_KERNELS       4
+#define DSP_BENCH_SAMPLES 256
+#define DSP_BENCH_BYTES   (DSP_BENCH_SAMPLES * 9) // Scratch dspBench() needs
+
+typedef struct {
+  const char *name;
+  uint32_t    scalar, packed; // ticks() per DSP_BENCH_SAMPLES * reps samples
+  bool        same;           // Packed gave the same results as scalar
+} dspBenchResult;
+
+// Runs each kernel's two versions 'reps' times on the same made-up data
+// (including extreme values), in 'scratch' (DSP_BENCH_BYTES, 2-byte
+// aligned), timed with 'ticks' (any free-running counter: CPU cycles on
+// the board, nanoseconds on a computer). Fills r[DSP_KERNELS].
+void dspBench(dspBenchResult *r, void *scratch, uint32_t (*ticks)(void), uint16_t reps);
+
+#endif
@@ -0,0 +1,166 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+#include <string.h>
+#include "WavCatalog.h"
+
+#define WAV_CAT_VERSION 1
+#define SLOTS           (WAV_CAT_MAX * 2)
+
+static inline char lower(char c) {
+  return ((c >= 'A') && (c <= 'Z')) ? (c + 'a' - 'A') : c;
+}
+
+static bool same(const char *a, const char *b) {
+  while(*a && (lower(*a) == lower(*b))) a++, b++;
+  return lower(*a) == lower(*b);
+}
+
+// FNV-1a, ignoring case
+static uint32_t hash(const char *s) {
+  uint32_t h = 2166136261u;
+  while(*s) h = (h ^ (uint8_t)lower(*s++)) * 16777619u;
+  return h;
+}
+
+static void put16(uint8_t *&p, uint16_t v) {
+  *p++ = v;
+  *p++ = v >> 8;
+}
+
+static void put32(uint8_t *&p, uint32_t v) {
+  put16(p, v);
+  put16(p, v >> 16);
+}
+
+static uint16_t get16(const uint8_t *&p) {
+  uint16_t v = p[0] | (p[1] << 8);
+  p += 2;
+  return v;
+}
+
+static uint32_t get32(const uint8_t *&p) {
+  uint32_t v = get16(p);
+  return v | ((uint32_t)get16(p) << 16);
+}
+
+WavCatalog::WavCatalog(void) {
+  clear();
+}
+
+void WavCatalog::clear(void) {
+  n = 0;
+  memset(nameSlot, -1, sizeof nameSlot);
+  memset(tagSlot, -1, sizeof tagSlot);
+}
+
+// Slot holding 'key' (name or first of tag), or the empty one it'd go in
+int8_t WavCatalog::lookup(const int8_t *slots, const char *key, bool tag) const {
+  uint8_t s = hash(key) % SLOTS;
+  while((slots[s] >= 0) && !same(tag ? e[slots[s]].tag : e[slots[s]].name, key)) {
+    if(++s >= SLOTS) s = 0; // Never full: SLOTS is twice WAV_CAT_MAX
+  }
+  return s;
+}
+
+bool WavCatalog::add(const char *name, uint32_t fileSize, const wavFormat &f) {
+  if((n >= WAV_CAT_MAX) || (strlen(name) >= WAV_CAT_NAME)) return false;
+  int8_t s = lookup(nameSlot, name, false);
+  if(nameSlot[s] >= 0) return false;
+  wavEntry *w = &e[n];
+  strncpy(w->name, name, WAV_CAT_NAME);
+  // Tag: up to the first digit, '_', '-' or '.' (or the whole name
+  // before '.' if that leaves nothing)
+  uint8_t t = 0;
+  while(name[t] && !strchr("0123456789_-.", name[t]) && (t < WAV_CAT_TAG - 1)) t++;
+  if(!t) while(name[t] && (name[t] != '.') && (t < WAV_CAT_TAG - 1)) t++;
+  memcpy(w->tag, name, t);
+  w->tag[t]   = 0;
+  w->fileSize = fileSize;
+  w->fmt      = f;
+  w->ms       = f.rate ? (uint32_t)((uint64_t)f.frames * 1000 / f.rate) : 0;
+  w->nextTag  = -1;
+  nameSlot[s] = n;
+  int8_t ts   = lookup(tagSlot, w->tag, true);
+  if(!f.format) { // Not playable (wavParse() failed): not under any tag
+    w->tag[0] = 0;
+  } else if(tagSlot[ts] < 0) {
+    tagSlot[ts] = n;
+  } else { // On the end of that tag's list, so it stays in directory order
+    int8_t i = tagSlot[ts];
+    while(e[i].nextTag >= 0) i = e[i].nextTag;
+    e[i].nextTag = n;
+  }
+  n++;
+  return true;
+}
+
+int8_t WavCatalog::find(const char *name) const {
+  return nameSlot[lookup(nameSlot, name, false)];
+}
+
+int8_t WavCatalog::tagFirst(const char *tag) const {
+  return tagSlot[lookup(tagSlot, tag, true)];
+}
+
+uint8_t WavCatalog::tagCount(const char *tag) const {
+  uint8_t c = 0;
+  for(int8_t i = tagFirst(tag); i >= 0; i = e[i].nextTag) c++;
+  return c;
+}
+
+// INDEX FILE --------------------------------------------------------------
+
+void WavCatalog::packHeader(uint8_t *out) const {
+  memcpy(out, "WCAT", 4);
+  out += 4;
+  put16(out, WAV_CAT_VERSION);
+  put16(out, n);
+}
+
+int16_t WavCatalog::unpackHeader(const uint8_t *in) const {
+  if(memcmp(in, "WCAT", 4)) return -1;
+  in += 4;
+  if(get16(in) != WAV_CAT_VERSION) return -1;
+  uint16_t c = get16(in);
+  return (c <= WAV_CAT_MAX) ? c : -1;
+}
+
+void WavCatalog::pack(uint8_t i, uint8_t *out) const {
+  const wavEntry *w = &e[i];
+  memset(out, 0, WAV_CAT_NAME);
+  strncpy((char *)out, w->name, WAV_CAT_NAME - 1);
+  out += WAV_CAT_NAME;
+  put32(out, w->fileSize);
+  put16(out, w->fmt.format);
+  put16(out, w->fmt.channels);
+  put32(out, w->fmt.rate);
+  put16(out, w->fmt.bits);
+  put16(out, w->fmt.blockAlign);
+  put16(out, w->fmt.blockFrames);
+  put32(out, w->fmt.dataOffset);
+  put32(out, w->fmt.dataBytes);
+  put32(out, w->fmt.frames);
+}
+
+bool WavCatalog::unpack(const uint8_t *in) {
+  char      name[WAV_CAT_NAME];
+  wavFormat f;
+  memcpy(name, in, WAV_CAT_NAME);
+  name[WAV_CAT_NAME - 1] = 0;
+  in += WAV_CAT_NAME;
+  uint32_t size  = get32(in);
+  f.format       = get16(in);
+  f.channels     = get16(in);
+  f.rate         = get32(in);
+  f.bits         = get16(in);
+  f.blockAlign   = get16(in);
+  f.blockFrames  = get16(in);
+  f.dataOffset   = get32(in);
+  f.dataBytes    = get32(in);
+  f.frames       = get32(in);
+  return add(name, size, f);
+}
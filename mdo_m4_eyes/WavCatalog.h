@@ -0,0 +1,78 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+/* What's in a directory of WAV files, so playing one doesn't mean
+   scanning the directory or reading the file's header again: each file's
+   name, size, format (wavParse()'s wavFormat, including where the samples
+   start) and length in ms. Kept in a small index file, WAV_CAT_FILE, in
+   the same directory: wavplay.cpp loads it at startup, checks it against
+   the directory and rewrites it if anything's changed; the host tool
+   mdo_Simul8/Simul8_wavCatalog.cpp can write it too.
+
+   Clips are found by name, or by tag: the name up to its first digit,
+   '_', '-' or '.', so "bark.wav", "bark2.wav" and "bark_loud.wav" are
+   all "bark". Both are hash lookups, case-insensitive as FAT is.
+   Fixed size, no allocation.
+
+   No Arduino dependencies.
+*/
+
+#ifndef __WAV_CATALOG_H
+#define __WAV_CATALOG_H
+
+#include <stdint.h>
+#include "WavStream.h"
+
+#define WAV_CAT_FILE    "wavindex.bin"
+#define WAV_CAT_MAX     20 // Most files
+#define WAV_CAT_NAME    24 // Longest name (bytes, incl. NUL)
+#define WAV_CAT_TAG     12 // Longest tag (bytes, incl. NUL)
+#define WAV_CAT_HEAD    8  // Index file header bytes
+#define WAV_CAT_RECORD  (WAV_CAT_NAME + 30) // Index file bytes per file
+
+typedef struct {
+  char      name[WAV_CAT_NAME];
+  char      tag[WAV_CAT_TAG];
+  uint32_t  fileSize;
+  uint32_t  ms;           // Length
+  wavFormat fmt;
+  int8_t    nextTag;      // Next entry with the same tag, -1 = none
+} wavEntry;
+
+class WavCatalog {
+public:
+  WavCatalog(void);
+
+  void            clear(void);
+
+  // Adds a file. false if it's full, the name's too long or already in.
+  bool            add(const char *name, uint32_t fileSize, const wavFormat &f);
+
+  uint8_t         count(void) const { return n; }
+  const wavEntry *entry(int8_t i) const { return ((i >= 0) && (i < n)) ? &e[i] : 0; }
+
+  // Entry with this name, -1 if none
+  int8_t          find(const char *name) const;
+
+  // First entry with this tag (-1 if none); entry(i)->nextTag is the next
+  int8_t          tagFirst(const char *tag) const;
+  uint8_t         tagCount(const char *tag) const;
+
+  // Index file: a header, then a record per entry. unpack() adds one.
+  void            packHeader(uint8_t *out) const;
+  int16_t         unpackHeader(const uint8_t *in) const; // Entries, -1 if bad
+  void            pack(uint8_t i, uint8_t *out) const;
+  bool            unpack(const uint8_t *in);
+
+private:
+  int8_t          lookup(const int8_t *slots, const char *key, bool tag) const;
+
+  wavEntry e[WAV_CAT_MAX];
+  uint8_t  n;
+  int8_t   nameSlot[WAV_CAT_MAX * 2], tagSlot[WAV_CAT_MAX * 2]; // Hash tables
+};
+
+#endif
@@ -0,0 +1,297 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+#include <string.h>
+#include "WavStream.h"
+
+// IMA ADPCM step sizes and index changes
+static const int16_t imaStep[89] = {
+      7,     8,     9,    10,    11,    12,    13,    14,    16,    17,
+     19,    21,    23,    25,    28,    31,    34,    37,    41,    45,
+     50,    55,    60,    66,    73,    80,    88,    97,   107,   118,
+    130,   143,   157,   173,   190,   209,   230,   253,   279,   307,
+    337,   371,   408,   449,   494,   544,   598,   658,   724,   796,
+    876,   963,  1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,
+   2272,  2499,  2749,  3024,  3327,  3660,  4026,  4428,  4871,  5358,
+   5894,  6484,  7132,  7845,  8630,  9493, 10442, 11487, 12635, 13899,
+  15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767 };
+static const int8_t imaIndex[8] = { -1, -1, -1, -1, 2, 4, 6, 8 };
+
+static inline uint16_t le16(const uint8_t *p) {
+  return p[0] | (p[1] << 8);
+}
+
+static inline uint32_t le32(const uint8_t *p) {
+  return p[0] | (p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// HEADER ------------------------------------------------------------------
+
+bool wavParse(wavReadFn read, wavSkipFn skip, void *ctx, wavFormat *f) {
+  uint8_t  b[40];
+  uint32_t pos = 12, factFrames = 0;
+  bool     gotFmt = false;
+  memset(f, 0, sizeof(wavFormat));
+  if((read(ctx, b, 12) != 12) || memcmp(b, "RIFF", 4) || memcmp(&b[8], "WAVE", 4)) {
+    return false;
+  }
+  for(;;) { // Chunks up to "data"
+    if(read(ctx, b, 8) != 8) return false;
+    uint32_t len = le32(&b[4]), n;
+    pos += 8;
+    if(!memcmp(b, "data", 4)) {
+      f->dataOffset = pos;
+      f->dataBytes  = len;
+      break;
+    }
+    bool fmt  = !memcmp(b, "fmt ", 4),
+         fact = !memcmp(b, "fact", 4);
+    n = (fmt || fact) ? ((len < sizeof b) ? len : sizeof b) : 0;
+    if(read(ctx, b, n) != n) return false;
+    if(fmt && (n >= 16)) {
+      f->format     = le16(b);
+      f->channels   = le16(&b[2]);
+      f->rate       = le32(&b[4]);
+      f->blockAlign = le16(&b[12]);
+      f->bits       = le16(&b[14]);
+      if((f->format == 0xFFFE) && (n >= 26)) f->format = le16(&b[24]); // Extensible
+      gotFmt = true;
+    } else if(fact && (n >= 4)) {
+      factFrames = le32(b);
+    }
+    len += len & 1; // Chunks are padded to even sizes
+    if((len > n) && !skip(ctx, len - n)) return false;
+    pos += len;
+  }
+  if(!gotFmt || !f->rate || (f->channels < 1) || (f->channels > 2)) return false;
+
+  if(f->format == WAV_PCM) {
+    if(((f->bits != 8) && (f->bits != 16)) ||
+       (f->blockAlign != f->channels * f->bits / 8)) return false;
+    f->blockFrames = 1;
+    f->frames      = f->dataBytes / f->blockAlign;
+  } else if(f->format == WAV_IMA_ADPCM) {
+    uint16_t head = 4 * f->channels; // Each channel's first sample and step
+    if((f->bits != 4) || (f->blockAlign <= head) ||
+       ((f->blockAlign - head) % head)) return false;
+    // 8 samples per channel from each 4 bytes per channel, plus the first
+    f->blockFrames = (f->blockAlign - head) / head * 8 + 1;
+    uint32_t rest  = f->dataBytes % f->blockAlign;
+    f->frames      = f->dataBytes / f->blockAlign * f->blockFrames;
+    if(rest >= head) f->frames += (rest - head) / head * 8 + 1;
+    if(factFrames && (factFrames < f->frames)) f->frames = factFrames;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// PLAYBACK ----------------------------------------------------------------
+
+WavStream::WavStream(void) {
+  filled = played = 0;
+  heardCount = heardRead = 0;
+  ended  = true;
+  underrunCount = 0;
+}
+
+void WavStream::begin(wavReadFn read, void *ctx, const wavFormat &f, uint32_t rate) {
+  ended      = true; // take() stays off the ring while it's reset
+  readFn     = read;
+  readCtx    = ctx;
+  fmt        = f;
+  outRate    = rate ? rate : f.rate;
+  inPos      = inLen = 0;
+  dataLeft   = f.dataBytes;
+  framesLeft = f.frames;
+  blockLeft  = 0;
+  groupLen   = groupPos = 0;
+  step       = (uint32_t)(((uint64_t)f.rate << 16) / outRate);
+  frac       = 0;
+  s0         = s1 = 0;
+  primed     = sourceEnd = false;
+  playPos    = 0;
+  played     = filled = 0;
+  playedSamples = 0;
+  heardCount = heardRead = 0;
+  underrunCount = 0;
+  ended      = false;
+}
+
+void WavStream::stop(void) {
+  ended  = true;
+  played = filled;
+}
+
+bool WavStream::service(void) {
+  if(ended) return false;
+  if(!primed) {
+    primed = true;
+    if(!source(&s0)) {
+      ended = true;
+      return false;
+    }
+    if(!source(&s1)) {
+      s1        = s0;
+      sourceEnd = true;
+    }
+  }
+  while((filled - played) < WAV_RING_BLOCKS) {
+    uint8_t   b = filled % WAV_RING_BLOCKS;
+    uint16_t *o = ring[b], n = 0;
+    uint32_t  sum = 0;
+    bool      last = false;
+    while(n < WAV_BLOCK) {
+      // Linear interpolation between source samples
+      int32_t s = s0 + ((((int32_t)s1 - s0) * (int32_t)(frac >> 2)) >> 14);
+      o[n]      = (uint16_t)(s + 32768) >> 4; // 16-bit signed -> 12-bit DAC
+      sum      += (o[n] >= 2048) ? (o[n] - 2048) : (2048 - o[n]);
+      n++;
+      for(frac += step; frac >= 0x10000; frac -= 0x10000) {
+        if(sourceEnd) {
+          last = true;
+          break;
+        }
+        s0 = s1;
+        if(!source(&s1)) {
+          s1        = s0;
+          sourceEnd = true;
+        }
+      }
+      if(last) break;
+    }
+    ringLen[b]   = n;
+    ringLevel[b] = sum / n;
+    __sync_synchronize(); // Block's all there before take() can see it
+    filled++;
+    if(last) {
+      ended = true;
+      return false;
+    }
+  }
+  return true;
+}
+
+uint16_t WavStream::take(void) {
+  if(played == filled) {
+    if(!ended) underrunCount++;
+    return 2048;
+  }
+  uint8_t  b = played % WAV_RING_BLOCKS;
+  uint16_t v = ring[b][playPos];
+  if(++playPos >= ringLen[b]) {
+    playedSamples += ringLen[b];
+    uint8_t h      = heardCount % WAV_HEARD;
+    heardLevel[h]  = ringLevel[b];
+    heardAt[h]     = playedSamples;
+    __sync_synchronize();
+    heardCount++;
+    playPos = 0;
+    played++;
+  }
+  return v;
+}
+
+uint16_t WavStream::level(void) const {
+  uint32_t p = played;
+  return (p == filled) ? 0 : ringLevel[p % WAV_RING_BLOCKS];
+}
+
+bool WavStream::heard(uint16_t *level, uint32_t *ms) {
+  uint32_t n = heardCount;
+  if(heardRead == n) return false;
+  if(n - heardRead > WAV_HEARD) heardRead = n - WAV_HEARD; // Lost the oldest
+  uint8_t h = heardRead % WAV_HEARD;
+  *level    = heardLevel[h];
+  *ms       = (uint32_t)((uint64_t)heardAt[h] * 1000 / outRate);
+  heardRead++;
+  return true;
+}
+
+// DECODING ----------------------------------------------------------------
+
+// 'n' bytes of sample data together in the input buffer, reading more of
+// the file when it runs out. NULL at the end of the data.
+const uint8_t *WavStream::bytes(uint16_t n) {
+  if(inLen - inPos < n) {
+    uint16_t keep = inLen - inPos;
+    memmove(in, &in[inPos], keep);
+    uint32_t want = sizeof in - keep;
+    if(want > dataLeft) want = dataLeft;
+    uint32_t got  = want ? readFn(readCtx, &in[keep], want) : 0;
+    dataLeft = (got == want) ? (dataLeft - got) : 0; // Short read = end
+    inPos    = 0;
+    inLen    = keep + got;
+    if(inLen < n) return NULL;
+  }
+  const uint8_t *p = &in[inPos];
+  inPos += n;
+  return p;
+}
+
+// Next source frame, mixed to mono. false at the end.
+bool WavStream::source(int16_t *s) {
+  if(!framesLeft) return false;
+  const uint8_t *p;
+  if(fmt.format == WAV_PCM) {
+    if(!(p = bytes(fmt.blockAlign))) return false;
+    int32_t sum = 0;
+    for(uint8_t c=0; c<fmt.channels; c++) {
+      if(fmt.bits == 8) sum += ((int32_t)*p++ - 128) << 8;
+      else {            sum += (int16_t)le16(p); p += 2; }
+    }
+    *s = (fmt.channels > 1) ? (int16_t)(sum >> 1) : (int16_t)sum;
+  } else if(groupPos < groupLen) {
+    *s = group[groupPos++];
+  } else if(!blockLeft) { // Block header: each channel's first sample
+    if(!(p = bytes(4 * fmt.channels))) return false;
+    int32_t sum = 0;
+    for(uint8_t c=0; c<fmt.channels; c++, p+=4) {
+      pred[c]  = (int16_t)le16(p);
+      index[c] = (p[2] > 88) ? 88 : p[2];
+      sum     += pred[c];
+    }
+    *s        = (fmt.channels > 1) ? (int16_t)(sum >> 1) : (int16_t)sum;
+    blockLeft = fmt.blockAlign - 4 * fmt.channels;
+  } else {
+    if(!adpcmGroup()) return false;
+    *s = group[groupPos++];
+  }
+  framesLeft--;
+  return true;
+}
+
+// Decodes the next 4 bytes per channel (8 samples each) into group[]
+bool WavStream::adpcmGroup(void) {
+  const uint8_t *p = bytes(4 * fmt.channels);
+  if(!p) return false;
+  for(uint8_t c=0; c<fmt.channels; c++) {
+    int32_t  pr = pred[c];
+    int8_t   ix = index[c];
+    for(uint8_t i=0; i<8; i++) {
+      uint8_t nib  = (p[c * 4 + (i >> 1)] >> ((i & 1) * 4)) & 15;
+      int32_t st   = imaStep[ix],
+              diff = st >> 3;
+      if(nib & 1) diff += st >> 2;
+      if(nib & 2) diff += st >> 1;
+      if(nib & 4) diff += st;
+      pr += (nib & 8) ? -diff : diff;
+      if(pr > 32767)       pr = 32767;
+      else if(pr < -32768) pr = -32768;
+      ix += imaIndex[nib & 7];
+      if(ix < 0)       ix = 0;
+      else if(ix > 88) ix = 88;
+      if(c) group[i] = (int16_t)((group[i] + pr) >> 1);
+      else  group[i] = (int16_t)pr;
+    }
+    pred[c]  = pr;
+    index[c] = ix;
+  }
+  groupLen   = 8;
+  groupPos   = 0;
+  blockLeft -= 4 * fmt.channels;
+  return true;
+}
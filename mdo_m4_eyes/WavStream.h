@@ -0,0 +1,142 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+/* WAV file playback (wavplay.cpp) without reading the file in an
+   interrupt. service(), from loop(), reads the file WAV_IN_BYTES at a
+   time, decodes it and fills a ring of WAV_RING_BLOCKS blocks of 12-bit
+   DAC samples; the output interrupt only take()s the next sample from
+   the ring. A slow read or a long frame just uses up some of the ring
+   instead of stalling the interrupt.
+
+   Reads 8- and 16-bit PCM and IMA ADPCM (4 bits a sample, a quarter of
+   16-bit's size), mono or stereo (mixed to mono), at any sample rate:
+   output can be at another rate, converted by linear interpolation
+   (fine going up or a little down; going down a lot lets some aliasing
+   through). Each block's loudness comes along with it, for lip sync
+   (LipSync.h).
+
+   The file's read through functions passed in, so it's not tied to any
+   one filesystem. No Arduino dependencies; the host tool
+   mdo_Simul8/Simul8_wavDecode.cpp runs this same code.
+*/
+
+#ifndef __WAV_STREAM_H
+#define __WAV_STREAM_H
+
+#include <stdint.h>
+
+#define WAV_BLOCK       256 // Output samples per ring block
+#define WAV_RING_BLOCKS 8   // 93 ms at 22,050 Hz
+#define WAV_IN_BYTES    512 // File read size
+#define WAV_HEARD       16  // Played blocks' loudness kept for heard()
+
+// Formats (the WAV fmt chunk's format tag)
+#define WAV_PCM       0x0001
+#define WAV_IMA_ADPCM 0x0011
+
+typedef struct {
+  uint16_t format;      // WAV_PCM or WAV_IMA_ADPCM
+  uint16_t channels;    // 1 or 2
+  uint32_t rate;        // Frames per second
+  uint16_t bits;        // 8 or 16 (PCM), 4 (ADPCM)
+  uint16_t blockAlign;  // Bytes per frame (PCM) or per block (ADPCM)
+  uint16_t blockFrames; // Frames per block (PCM 1)
+  uint32_t dataOffset;  // Where the samples start in the file
+  uint32_t dataBytes;
+  uint32_t frames;      // Length: frames / rate seconds
+} wavFormat;
+
+// Reads up to 'n' bytes at 'ctx''s current position, returns how many
+typedef uint32_t (*wavReadFn)(void *ctx, uint8_t *buf, uint32_t n);
+// Moves 'ctx''s position ahead 'n' bytes, false if it can't
+typedef bool     (*wavSkipFn)(void *ctx, uint32_t n);
+
+// Reads a WAV file's header from the start into *f, leaving the position
+// at the first sample. false if it's not a WAV or not one of the formats
+// above.
+bool wavParse(wavReadFn read, wavSkipFn skip, void *ctx, wavFormat *f);
+
+class WavStream {
+public:
+  WavStream(void);
+
+  // Starts on a file positioned at its first sample (after wavParse(),
+  // or seeking to f.dataOffset), output at 'rate' Hz (0 = the file's
+  // own). Nothing's decoded until service().
+  void     begin(wavReadFn read, void *ctx, const wavFormat &f, uint32_t rate = 0);
+
+  // Output sample rate
+  uint32_t rate(void) const { return outRate; }
+
+  // From loop(): decodes into every free block. false once the whole
+  // file's been decoded (the ring may still be playing).
+  bool     service(void);
+
+  // From the output interrupt: next 12-bit sample, 2048 (silence) when
+  // the ring's empty
+  uint16_t take(void);
+
+  // Played to the end, or stop()ped
+  bool     done(void) const { return ended && (played == filled); }
+  void     stop(void);
+
+  // Times take() found the ring empty before the end (service() not
+  // called often enough)
+  uint32_t underruns(void) const { return underrunCount; }
+
+  // Loudness of the block playing now: mean distance from 2048, 0 to
+  // 2048 (so a full-scale sine wave is about 1300). Worked out by
+  // service() as it fills each block, so it's in step with what's heard
+  // and costs one add a sample. 0 when nothing's playing.
+  uint16_t level(void) const;
+
+  // From loop(): each block that's finished playing since the last call,
+  // oldest first (up to the last WAV_HEARD): its loudness, as level(), and
+  // when it finished, ms of sound since begin(). false when there are no
+  // more. Lets lip sync follow the sound in its own time, not the frame
+  // rate's.
+  bool     heard(uint16_t *level, uint32_t *ms);
+
+private:
+  bool           source(int16_t *s);
+  bool           adpcmGroup(void);
+  const uint8_t *bytes(uint16_t n);
+
+  wavReadFn   readFn;
+  void       *readCtx;
+  wavFormat   fmt;
+  uint32_t    outRate;
+  // File input
+  uint8_t     in[WAV_IN_BYTES];
+  uint16_t    inPos, inLen;
+  uint32_t    dataLeft;   // Bytes not yet read from the file
+  uint32_t    framesLeft; // Not yet decoded
+  // IMA ADPCM state
+  int16_t     pred[2];
+  uint8_t     index[2];
+  uint16_t    blockLeft;  // Bytes left in this block
+  int16_t     group[8];   // Decoded, mixed to mono
+  uint8_t     groupLen, groupPos;
+  // Rate conversion, between source samples s0 and s1
+  uint32_t    step, frac; // 16.16
+  int16_t     s0, s1;
+  bool        primed, sourceEnd;
+  // Ring
+  uint16_t    ring[WAV_RING_BLOCKS][WAV_BLOCK];
+  uint16_t    ringLen[WAV_RING_BLOCKS];
+  uint16_t    ringLevel[WAV_RING_BLOCKS];
+  uint16_t    playPos;
+  // Played blocks' loudness, for heard()
+  uint16_t    heardLevel[WAV_HEARD];
+  uint32_t    heardAt[WAV_HEARD]; // Samples played by the block's end
+  uint32_t    playedSamples, heardRead;
+  volatile uint32_t heardCount;
+  volatile uint32_t filled, played; // Blocks, ever
+  volatile bool     ended;          // Nothing more to come into the ring
+  volatile uint32_t underrunCount;
+};
+
+#endif
@@ -0,0 +1,90 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+#include "WearLog.h"
+
+#define WEARLOG_MAGIC  0x574C4F47 // "WLOG"
+#define WEARLOG_RECORD 16         // Bytes per record (4 words)
+
+// Check word ties the other three together, so a zeroed, half-written
+// or stray quad-word isn't mistaken for a record.
+static uint32_t check(uint32_t seq, uint32_t value) {
+  uint32_t c = WEARLOG_MAGIC ^ seq ^ ((value << 13) | (value >> 19));
+  return ~c;
+}
+
+WearLog::WearLog(Flash *f) {
+  flash     = f;
+  latest    = 0;
+  seq       = 0;
+  next      = 0;
+  mustErase = true;
+}
+
+bool WearLog::begin(void) {
+  uint32_t size  = flash->blockSize() * flash->blocks();
+  uint32_t words[4];
+  bool     found = false;
+
+  // Find the newest valid record anywhere in the region
+  for(uint32_t offset=0; offset<size; offset+=WEARLOG_RECORD) {
+    flash->read(offset, words);
+    if((words[0] == WEARLOG_MAGIC) && (words[3] == check(words[1], words[2]))
+      && (!found || ((int32_t)(words[1] - seq) > 0))) {
+      found  = true;
+      seq    = words[1];
+      latest = words[2];
+      next   = offset + WEARLOG_RECORD;
+    }
+  }
+
+  if(!found) {
+    // Nothing there (new region, or never-erased flash): start over at
+    // the first block. Erase it first, it may hold anything.
+    next      = 0;
+    mustErase = true;
+  } else {
+    // Newest record should be followed by an erased slot in the same
+    // block. If that block's full, or the slot's been scribbled on
+    // (power lost mid-write?), continue at the start of the next block.
+    mustErase = false;
+    if(next % flash->blockSize()) {
+      flash->read(next, words);
+      for(uint8_t i=0; i<4; i++) {
+        if(words[i] != 0xFFFFFFFF) mustErase = true;
+      }
+    } else {
+      mustErase = true;
+    }
+    if(mustErase) {
+      next  = (next + flash->blockSize() - 1) / flash->blockSize() * flash->blockSize();
+      if(next >= size) next = 0;
+    }
+  }
+  return found;
+}
+
+void WearLog::append(uint32_t value) {
+  uint32_t words[4];
+
+  if(mustErase) {
+    flash->erase(next / flash->blockSize());
+    mustErase = false;
+  }
+  seq++;
+  words[0] = WEARLOG_MAGIC;
+  words[1] = seq;
+  words[2] = value;
+  words[3] = check(seq, value);
+  flash->write(next, words);
+  latest = value;
+
+  next += WEARLOG_RECORD;
+  if(!(next % flash->blockSize())) { // Filled this block?
+    if(next >= flash->blockSize() * flash->blocks()) next = 0;
+    mustErase = true;                // Next block has old records
+  }
+}
@@ -0,0 +1,60 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+/* Append-only log of small records, rotated across a few erase blocks of
+   flash so that a value written at every boot (e.g. a playlist position)
+   wears each cell only rarely.
+
+   Each record is one 16-byte quad-word (the SAMD51's smallest write):
+   magic, sequence number, value and check word. New records go in the
+   next erased slot; the record with the highest sequence number wins.
+   When a block fills, the NEXT block is erased and writing continues
+   there, so the latest record always survives a power loss mid-erase.
+   With 8K blocks that's one erase per 512 writes per block.
+
+   Flash access goes through the WearLog::Flash interface so the same
+   code runs against the real NVM controller (see playlist.cpp) or a
+   simulated flash array on a host computer.
+*/
+
+#ifndef __WEAR_LOG_H
+#define __WEAR_LOG_H
+
+#include <stdint.h>
+
+class WearLog {
+public:
+  // Storage behind the log. Offsets are bytes from the start of the
+  // region; erased flash reads as all 1 bits.
+  class Flash {
+  public:
+    virtual uint32_t blockSize(void) = 0;               // Erase block, bytes
+    virtual uint8_t  blocks(void) = 0;                  // Blocks in region
+    virtual void     read(uint32_t offset, uint32_t words[4]) = 0;
+    virtual void     write(uint32_t offset, const uint32_t words[4]) = 0;
+    virtual void     erase(uint8_t block) = 0;
+  };
+
+  WearLog(Flash *flash);
+
+  // Scan flash for the latest record. Returns true if one was found.
+  bool     begin(void);
+
+  // Latest value from begin() or append(), or 0 if none.
+  uint32_t value(void) { return latest; }
+
+  // Write a new value. Erases the next block first if needed.
+  void     append(uint32_t value);
+
+private:
+  Flash   *flash;
+  uint32_t latest;   // Value of newest record
+  uint32_t seq;      // Sequence number of newest record
+  uint32_t next;     // Offset of next slot to write
+  bool     mustErase; // true = 'next' is the start of a dirty block
+};
+
+#endif
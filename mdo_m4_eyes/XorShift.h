@@ -0,0 +1,50 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+/* Marsaglia xorshift32 random numbers, with the same ranges as Arduino's
+   random() so it's a drop-in replacement: a few shifts per number instead
+   of newlib's rand() and a divide, and the whole state is one word, so a
+   seed is all it takes to get the same sequence again. Not for anything
+   that needs to be unpredictable.
+*/
+
+#ifndef __XORSHIFT_H
+#define __XORSHIFT_H
+
+#include <stdint.h>
+
+class XorShift {
+public:
+  XorShift(uint32_t s = 1) { seed(s); }
+
+  // Zero would stick at zero forever, so it's swapped for another value
+  void     seed(uint32_t s) { state = s ? s : 0x9E3779B9; }
+
+  uint32_t next(void) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+  }
+
+  // 0 to howbig-1, as random(howbig); 0 if howbig <= 0
+  int32_t  random(int32_t howbig) {
+    if(howbig <= 0) return 0;
+    return (int32_t)(((uint64_t)next() * (uint32_t)howbig) >> 32);
+  }
+
+  // howsmall to howbig-1, as random(howsmall, howbig)
+  int32_t  random(int32_t howsmall, int32_t howbig) {
+    if(howsmall >= howbig) return howsmall;
+    return howsmall + (int32_t)(((uint64_t)next() *
+      (uint32_t)(howbig - howsmall)) >> 32);
+  }
+
+private:
+  uint32_t state;
+};
+
+#endif
@@ -0,0 +1,181 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+//34567890123456789012345678901234567890123456789012345678901234567890123456
+
+#include "globals.h"
+#include "AnimLog.h"
+#include "XorShift.h"
+
+// ANIMATION CLOCK ---------------------------------------------------------
+
+// Animation takes its time and random numbers from here rather than from
+// micros(), millis() and random() directly. Each eye frame gets one time,
+// from animFrame(), used for everything in that frame. Random numbers are
+// xorshift (XorShift.h), seeded by animBegin() before user_setup() and
+// again by animLogBegin() once the config's read. Outside inputs (light
+// sensor, boop, buttons, user sensors) pass through animInput().
+//
+// With all of that in one place, a run can be recorded and played back:
+// "recordLog" in the config logs the seed, every frame time and every
+// input to a RAM buffer (see AnimLog.h for the format), written to that
+// file when it fills. "replayLog" plays such a file back in place of the
+// clock, seed and inputs, so the eyes do exactly what they did when it
+// was recorded; then it's back to live, carrying on from there.
+//
+// The clock itself can be swapped out with animClockSource(), e.g. for a
+// fixed step per call when stepping the code on a host computer.
+
+#define ANIM_LOG_BYTES 16384 // About 20 sec of two eyes
+
+enum { ANIM_LIVE, ANIM_RECORD, ANIM_REPLAY };
+
+static uint32_t   liveMicros(void) { return micros(); }
+
+static uint32_t (*clockSource)(void) = liveMicros;
+static uint32_t   clockOffset = 0;     // Keeps time going on after replay
+static uint8_t    animMode    = ANIM_LIVE;
+static bool       inFrame     = false; // Set after first animFrame()
+static uint32_t   frameTime;           // This frame's time, micros
+static uint64_t   totalMicros;         // Same, not wrapping at 32 bits
+static AnimLog    animLog;
+static XorShift   rng;
+static uint8_t   *logBuf      = NULL;
+static char       logFile[SD_MAX_FILENAME_SIZE+1]; // Copy, config's is freed
+
+// Use 'fn' for the time in micros (NULL = micros()). Live mode only.
+void animClockSource(uint32_t (*fn)(void)) {
+  clockSource = fn ? fn : liveMicros;
+}
+
+// Stop recording (saving the log) or replaying; back to live time
+static void animStop(const char *why) {
+  if(animMode == ANIM_RECORD) {
+    File file = arcada.open(logFile, O_WRITE | O_CREAT | O_TRUNC);
+    if(file) {
+      file.write(logBuf, animLog.used());
+      file.close();
+      Serial.printf("Recorded %d frames to %s (%s)\n", animLog.frames(),
+        logFile, why);
+    } else {
+      Serial.printf("Can't write %s, recording lost\n", logFile);
+    }
+  } else if(animMode == ANIM_REPLAY) {
+    Serial.printf("Replayed %d frames of %s (%s)\n", animLog.frames(),
+      logFile, why);
+  }
+  animMode = ANIM_LIVE;
+  // Carry on from the last frame (before any, the clock's still right)
+  if(inFrame) clockOffset = frameTime - clockSource();
+}
+
+// Call once at the start of setup(), before user_setup(), in place of
+// randomSeed(). The clock and random numbers work from here on.
+void animBegin(uint32_t seed) {
+  rng.seed(seed);
+  randomSeed(seed); // For user code still using random()
+}
+
+// Call once in setup() after loadConfig(). Starts recording or replay if
+// the config says to. Either way random numbers start over from a new
+// seed, the one that goes in the log (or comes from it on replay), so a
+// replay matches from here whatever user_setup() drew before.
+void animLogBegin(void) {
+  File     file;
+  uint8_t  eyes;
+  uint32_t seed = rng.next();
+  if(replayLogFile && (file = arcada.open(replayLogFile, FILE_READ))) {
+    uint32_t len = file.size();
+    if(len > ANIM_LOG_BYTES) len = ANIM_LOG_BYTES;
+    if((logBuf = (uint8_t *)malloc(len))) {
+      len = file.read(logBuf, len);
+      animLog.begin(logBuf, len, len);
+      if(animLog.readHeader(&seed, &eyes) && (eyes == NUM_EYES)) {
+        animMode = ANIM_REPLAY;
+        strncpy(logFile, replayLogFile, sizeof logFile - 1);
+        Serial.printf("Replaying %s\n", logFile);
+      } else {
+        Serial.printf("%s isn't a log for this board\n", replayLogFile);
+        free(logBuf);
+        logBuf = NULL;
+      }
+    }
+    file.close();
+  } else if(recordLogFile && (logBuf = (uint8_t *)malloc(ANIM_LOG_BYTES))) {
+    animLog.begin(logBuf, ANIM_LOG_BYTES, 0);
+    animLog.header(seed, NUM_EYES);
+    animMode = ANIM_RECORD;
+    strncpy(logFile, recordLogFile, sizeof logFile - 1);
+    Serial.printf("Recording to %s\n", logFile);
+  }
+  rng.seed(seed);
+  randomSeed(seed);
+}
+
+// Stop recording (writing out what's logged so far) or replaying now,
+// e.g. from user code. Nothing if neither.
+void animLogEnd(void) {
+  if(animMode != ANIM_LIVE) animStop("stopped");
+}
+
+// Start of a frame for eye e: returns the time to use for all of it
+uint32_t animFrame(uint8_t e) {
+  uint32_t t = clockSource() + clockOffset;
+  if(animMode == ANIM_REPLAY) {
+    if(!animLog.readFrame(e, &t)) {
+      animStop(animLog.ended() ? "end" : "out of step");
+      t = frameTime;
+    }
+  } else if((animMode == ANIM_RECORD) && !animLog.frame(e, t)) {
+    animStop("full");
+  }
+  totalMicros = inFrame ? (totalMicros + (uint32_t)(t - frameTime)) : t;
+  frameTime   = t;
+  inFrame     = true;
+  return t;
+}
+
+// An outside input: 'live' is the value just read. Returns it (recording
+// it if recording) or, when replaying, the value that was recorded.
+int32_t animInput(uint8_t channel, int32_t live) {
+  if(animMode == ANIM_REPLAY) {
+    int32_t v;
+    if(animLog.readInput(channel, &v)) return v;
+    animStop(animLog.ended() ? "end" : "out of step");
+  } else if((animMode == ANIM_RECORD) && !animLog.input(channel, live)) {
+    animStop("full");
+  }
+  return live;
+}
+
+float animInputFloat(uint8_t channel, float live) {
+  int32_t i;
+  memcpy(&i, &live, sizeof i); // Exact bits, so replay is exact
+  i = animInput(channel, i);
+  memcpy(&live, &i, sizeof i);
+  return live;
+}
+
+// Current frame's time in micros. Before the first frame it's the clock
+// (as an input, so it replays too).
+uint32_t animMicros(void) {
+  return inFrame ? frameTime :
+    (uint32_t)animInput(ANIM_IN_TIME, clockSource() + clockOffset);
+}
+
+// Current frame's time in millis, as millis() (micros() wraps in 71
+// minutes, this is counted up from frame times so it doesn't)
+uint32_t animMillis(void) {
+  return inFrame ? (uint32_t)(totalMicros / 1000) : animMicros() / 1000;
+}
+
+int32_t animRandom(int32_t howbig) {
+  return rng.random(howbig);
+}
+
+int32_t animRandom(int32_t howsmall, int32_t howbig) {
+  return rng.random(howsmall, howbig);
+}
@@ -0,0 +1,269 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+//34567890123456789012345678901234567890123456789012345678901234567890123456
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ConfigParse.h"
+
+// CONFIG FILE TOKENIZER ---------------------------------------------------
+
+// Streaming (SAX-style) reader for the JSON config file. Walks the file
+// once, a small buffer at a time, and calls a handler for each value as
+// it's found rather than building a document in RAM. Accepts what the
+// ArduinoJson setup it replaces did, including // and /* */ comments.
+// Handler sees values in the top-level object (section NULL) and in
+// objects one level down (section = that object's key, e.g. "left").
+// Anything nested deeper is checked for syntax but not reported. Arrays
+// are reported as one value holding their first few scalar elements
+// (enough for RGB colors). Strings passed to the handler are only valid
+// during that call; copy them if needed.
+
+#define CFG_BUFSIZE 64 // Bytes read from file at a time
+#define CFG_DEPTH   8  // Deepest nesting accepted
+
+static struct {
+  cfgReader               read;
+  void                   *ctx;
+  uint8_t                 buf[CFG_BUFSIZE];
+  uint8_t                 len, pos;
+  int                     line;  // For error messages
+  const char             *error; // First error, NULL if none
+  cfgHandler              handler;
+  char                    section[CFG_KEYLEN]; // Key of enclosing object
+  char                    text[CFG_STRLEN];    // Current string/number
+  char                    items[CFG_ITEMS][CFG_ITEMLEN]; // Array strings
+} cfg;
+
+static int peekChar(void) {
+  if(cfg.pos >= cfg.len) {
+    int n   = cfg.read(cfg.ctx, cfg.buf, CFG_BUFSIZE);
+    cfg.pos = 0;
+    cfg.len = (n > 0) ? n : 0;
+    if(!cfg.len) return -1;
+  }
+  return cfg.buf[cfg.pos];
+}
+
+static int nextChar(void) {
+  int c = peekChar();
+  if(c >= 0) {
+    cfg.pos++;
+    if(c == '\n') cfg.line++;
+  }
+  return c;
+}
+
+static bool fail(const char *msg) {
+  if(!cfg.error) cfg.error = msg;
+  return false;
+}
+
+// Skip whitespace and comments, return next char (not consumed)
+static int skipSpace(void) {
+  int c;
+  for(;;) {
+    c = peekChar();
+    if((c == ' ') || (c == '\t') || (c == '\r') || (c == '\n')) {
+      nextChar();
+    } else if(c == '/') {
+      nextChar();
+      c = nextChar();
+      if(c == '/') {                 // Comment to end of line
+        while(((c = nextChar()) >= 0) && (c != '\n'));
+      } else if(c == '*') {          // Comment to */
+        int prev = 0;
+        while(((c = nextChar()) >= 0) && !((prev == '*') && (c == '/'))) prev = c;
+        if(c < 0) {
+          fail("unterminated comment");
+          return -1;
+        }
+      } else {
+        fail("stray '/'");
+        return -1;
+      }
+    } else {
+      return c;
+    }
+  }
+}
+
+// Read a quoted string into buf (truncating at size-1), opening quote
+// not yet consumed.
+static bool readString(char *buf, int size) {
+  int c, len = 0;
+  nextChar(); // Opening quote
+  while((c = nextChar()) != '"') {
+    if((c < 0) || (c == '\n')) return fail("unterminated string");
+    if(c == '\\') {
+      switch(c = nextChar()) {
+       case 'n': c = '\n'; break;
+       case 't': c = '\t'; break;
+       case 'r': c = '\r'; break;
+       case 'b': c = '\b'; break;
+       case 'f': c = '\f'; break;
+       case 'u': {              // Only ASCII is useful in this file
+        int u = 0;
+        for(uint8_t i=0; i<4; i++) {
+          c = nextChar();
+          if(!isxdigit(c)) return fail("bad \\u escape");
+          u = (u << 4) | (isdigit(c) ? (c - '0') : ((c | 0x20) - 'a' + 10));
+        }
+        c = (u < 0x80) ? u : '?';
+        break;
+       }
+       case '"': case '\\': case '/': break;
+       default: return fail("bad escape");
+      }
+    }
+    if(len < (size - 1)) buf[len++] = c;
+  }
+  buf[len] = 0;
+  return true;
+}
+
+// Read a number, true/false/null into s. Returns false on syntax error.
+static bool readScalar(cfgScalar *s, char *buf, int size) {
+  int c = peekChar(), len = 0;
+  if(c == '"') {
+    if(!readString(buf, size)) return false;
+    s->type = CFG_STRING;
+    s->s    = buf;
+    return true;
+  }
+  if(isalpha(c)) {               // true, false, null
+    char word[6];
+    while(isalpha(peekChar()) && (len < 5)) word[len++] = nextChar();
+    word[len] = 0;
+    if(!strcmp(word, "true") || !strcmp(word, "false")) {
+      s->type = CFG_BOOL;
+      s->i    = (word[0] == 't');
+    } else if(!strcmp(word, "null")) {
+      s->type = CFG_NULL;
+    } else {
+      return fail("unknown word");
+    }
+    return true;
+  }
+  bool isFloat = false;
+  while(isdigit(c) || (c == '-') || (c == '+') || (c == '.') || (c == 'e') || (c == 'E')) {
+    if((c == '.') || (c == 'e') || (c == 'E')) isFloat = true;
+    if(len < (size - 1)) buf[len++] = c;
+    nextChar();
+    c = peekChar();
+  }
+  buf[len] = 0;
+  if(!len) return fail("expected a value");
+  char *end;
+  if(isFloat) {
+    s->type = CFG_FLOAT;
+    s->f    = strtod(buf, &end);
+  } else {
+    s->type = CFG_INT;
+    s->i    = strtol(buf, &end, 10);
+  }
+  if(*end) return fail("bad number");
+  return true;
+}
+
+static bool parseValue(int depth, const char *key);
+
+// Object, '{' not yet consumed. depth is this object's level (1 = top).
+static bool parseObject(int depth) {
+  char key[CFG_KEYLEN];
+  int  c;
+  if(depth > CFG_DEPTH) return fail("nested too deep");
+  nextChar();
+  for(;;) {
+    if(skipSpace() == '}') {   // Empty object or trailing comma
+      nextChar();
+      return true;
+    }
+    if(skipSpace() != '"') return fail("expected a key");
+    if(!readString(key, sizeof key)) return false;
+    if(skipSpace() != ':') return fail("expected ':'");
+    nextChar();
+    if(skipSpace() == '{') {
+      if(depth == 1) strcpy(cfg.section, key); // Entering a section
+      if(!parseObject(depth + 1)) return false;
+      if(depth == 1) cfg.section[0] = 0;
+    } else if(!parseValue(depth, key)) {
+      return false;
+    }
+    if((c = skipSpace()) == ',') {
+      nextChar();
+    } else if(c != '}') {
+      return fail("expected ',' or '}'");
+    }
+  }
+}
+
+// Any value other than an object. Reported to handler if its object is
+// the top level or a section.
+static bool parseValue(int depth, const char *key) {
+  cfgValue v;
+  int      c = skipSpace();
+
+  if(depth > CFG_DEPTH) return fail("nested too deep");
+  if(c == '[') {               // Array
+    v.type  = CFG_ARRAY;
+    v.count = 0;
+    nextChar();
+    for(;;) {
+      if((c = skipSpace()) == ']') { // Empty array or trailing comma
+        nextChar();
+        break;
+      }
+      if((c == '{') || (c == '[')) { // Nested, syntax check only
+        if(v.count < CFG_ITEMS) v.item[v.count].type = CFG_NULL;
+        if(!((c == '{') ? parseObject(depth + 1) : parseValue(depth + 1, NULL))) return false;
+      } else if(v.count < CFG_ITEMS) {
+        if(!readScalar(&v.item[v.count], cfg.items[v.count], CFG_ITEMLEN)) return false;
+      } else {
+        cfgScalar s;
+        if(!readScalar(&s, cfg.text, sizeof cfg.text)) return false;
+      }
+      if(v.count < 255) v.count++;
+      if((c = skipSpace()) == ',') {
+        nextChar();
+      } else if(c != ']') {
+        return fail("expected ',' or ']'");
+      }
+    }
+  } else if(c == '{') {
+    return parseObject(depth + 1);
+  } else {
+    if(!readScalar(&v.item[0], cfg.text, sizeof cfg.text)) return false;
+    v.type  = v.item[0].type;
+    v.count = 1;
+  }
+  if(key && (depth <= 2) && cfg.handler) {
+    cfg.handler(cfg.section[0] ? cfg.section : NULL, key, &v);
+  }
+  return true;
+}
+
+bool cfgParse(cfgReader read, void *ctx, cfgHandler handler) {
+  cfg.read       = read;
+  cfg.ctx        = ctx;
+  cfg.len        = cfg.pos = 0;
+  cfg.line       = 1;
+  cfg.error      = NULL;
+  cfg.handler    = handler;
+  cfg.section[0] = 0;
+
+  if(skipSpace() != '{') fail("expected '{'");
+  else                   parseObject(1);
+  return !cfg.error;
+}
+
+// What the last cfgParse() failed on, and its line. NULL if it didn't.
+const char *cfgError(int *line) {
+  if(line) *line = cfg.line;
+  return cfg.error;
+}
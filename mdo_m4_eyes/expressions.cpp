@@ -0,0 +1,198 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+//34567890123456789012345678901234567890123456789012345678901234567890123456
+
+#include "globals.h"
+#include "ExpressionBlend.h"
+
+// EXPRESSIONS -------------------------------------------------------------
+
+// An expression is a named set of targets for how the eyes behave: lid
+// pose, saccade size and rate, blink rate, pupil size, iris spin and
+// vergence distance. They're read from the file named by "expressions" in the
+// config, same syntax as config files, one object per expression:
+//
+//   "sleepy" : { "lids" : "sleepy", "gaze" : 0.3, "saccade" : 3.0,
+//                "blink" : 0.5, "time" : 2.0 },
+//
+// lids    - eyelid pose name (see eyelids.cpp), default "open"
+// gaze    - saccade size, 1.0 = normal
+// saccade - time between big saccades, 1.0 = normal (2.0 = half as often)
+// blink   - time between blinks, same
+// pupil   - pupil size, 0.0-1.0 of iris (default: light sensor decides)
+// spin    - extra iris spin, RPM
+// distance - what the eyes converge on, mm (default 570, see gaze.cpp)
+// time    - seconds to change into this expression (default 0.5)
+//
+// Anything not given is as "idle", the sketch's usual behavior, which is
+// always expression 0 (and can be redefined in the file too). User code
+// switches with exprSet(exprFind("sleepy")). Changing over is a blend of
+// a few fixed-point numbers per frame (ExpressionBlend.h) plus a lid pose
+// move, nothing's allocated.
+
+#define EXPR_MAX  8  // Including idle
+#define EXPR_NAME 16 // Longest expression or pose name (incl. NUL)
+
+typedef struct {
+  char     name[EXPR_NAME];
+  char     lids[EXPR_NAME];              // Pose name, "" = open
+  int32_t  value[ExpressionBlend::COUNT]; // 16.16 fixed point
+  uint32_t time;                          // Change into this one, micros
+} expression;
+
+static const struct {
+  const char *key;
+  uint8_t     param;
+} exprKeys[] = {
+  { "gaze"   , ExpressionBlend::GAZE    }, { "saccade", ExpressionBlend::SACCADE },
+  { "blink"  , ExpressionBlend::BLINK   }, { "pupil"  , ExpressionBlend::PUPIL   },
+  { "spin"   , ExpressionBlend::SPIN    }, { "distance", ExpressionBlend::DISTANCE } };
+
+static expression      exprTable[EXPR_MAX];
+static uint8_t         exprCount   = 0; // 0 = not set up yet
+static expression      exprNext[EXPR_MAX]; // Read, not in use yet
+static uint8_t         exprNextCount = 0;
+static uint8_t         exprCurrent = 0;
+static ExpressionBlend exprBlend;
+static float           spinPhase   = 0.0; // Extra iris angle, 0-1024
+static uint32_t        spinTime    = 0;   // Time of last exprFrame()
+
+static void exprDefaults(expression *x, const char *name) {
+  strncpy(x->name, name, EXPR_NAME - 1);
+  x->name[EXPR_NAME - 1] = 0;
+  x->lids[0] = 0;
+  x->value[ExpressionBlend::GAZE]     = EXPR_FIXED(1.0);
+  x->value[ExpressionBlend::SACCADE]  = EXPR_FIXED(1.0);
+  x->value[ExpressionBlend::BLINK]    = EXPR_FIXED(1.0);
+  x->value[ExpressionBlend::PUPIL]    = EXPR_FIXED(0.5);
+  x->value[ExpressionBlend::PUPILMIX] = 0;
+  x->value[ExpressionBlend::SPIN]     = 0;
+  x->value[ExpressionBlend::DISTANCE] = EXPR_FIXED(570.0);
+  x->time = 500000;
+}
+
+static int8_t exprFindIn(const expression *table, uint8_t count,
+  const char *name) {
+  for(uint8_t i=0; i<count; i++) {
+    if(!strcmp(name, table[i].name)) return i;
+  }
+  return -1;
+}
+
+// Expression index by name, -1 if none
+int8_t exprFind(const char *name) {
+  return exprFindIn(exprTable, exprCount, name);
+}
+
+// configParse() handler: sections are expressions, keys their settings
+static void exprValue(const char *section, const char *key, cfgValue *v) {
+  if(!section) {
+    Serial.printf("Expressions: %s isn't in an expression, ignored\n", key);
+    return;
+  }
+  int8_t x = exprFindIn(exprNext, exprNextCount, section);
+  if(x < 0) {
+    if(exprNextCount >= EXPR_MAX) {
+      Serial.printf("Expressions: too many, %s ignored\n", section);
+      return;
+    }
+    exprDefaults(&exprNext[x = exprNextCount++], section);
+  }
+  expression *ex = &exprNext[x];
+  if(!strcmp(key, "lids")) {
+    if(v->type == CFG_STRING) {
+      strncpy(ex->lids, v->item[0].s, EXPR_NAME - 1);
+      ex->lids[EXPR_NAME - 1] = 0;
+      return;
+    }
+  } else if((v->type == CFG_INT) || (v->type == CFG_FLOAT)) {
+    float f = (v->type == CFG_INT) ? (float)v->item[0].i : v->item[0].f;
+    if(!strcmp(key, "time")) {
+      ex->time = (uint32_t)(f * 1000000.0);
+      return;
+    }
+    for(uint8_t k=0; k<(sizeof exprKeys / sizeof exprKeys[0]); k++) {
+      if(!strcmp(key, exprKeys[k].key)) {
+        ex->value[exprKeys[k].param] = EXPR_FIXED(f);
+        if(exprKeys[k].param == ExpressionBlend::PUPIL) {
+          ex->value[ExpressionBlend::PUPILMIX] = EXPR_FIXED(1.0);
+        }
+        return;
+      }
+    }
+  }
+  Serial.printf("Expressions: %s.%s unknown or wrong type, ignored\n", section, key);
+}
+
+// Read expressions from 'filename' (NULL = just idle), not used until
+// exprUse(). Called by loadConfig(); a live reload's are read with the
+// rest of the config and used when it's swapped in.
+void exprRead(const char *filename) {
+  File file;
+  exprNextCount = 0;
+  exprDefaults(&exprNext[exprNextCount++], "idle");
+  if(filename && fileReady(filename) && (file = arcada.open(filename, FILE_READ))) {
+    if(!configParse(&file, NULL, 0, exprValue)) {
+      Serial.printf("Expressions: %s has errors, some may be missing\n", filename);
+    }
+    file.close();
+    Serial.printf("Expressions: %d from %s\n", exprNextCount - 1, filename);
+  }
+}
+
+// Switch to the expressions last read. The current expression carries on
+// if it's still there, now with its new settings, else back to idle.
+// Either way its values are used at once (at startup, idle's).
+void exprUse(void) {
+  char current[EXPR_NAME];
+  if(!exprNextCount) exprRead(NULL);
+  strcpy(current, exprCount ? exprTable[exprCurrent].name : "idle");
+  memcpy(exprTable, exprNext, exprNextCount * sizeof(expression));
+  exprCount = exprNextCount;
+  int8_t x  = exprFind(current);
+  exprCurrent = (x < 0) ? 0 : x;
+  exprBlend.begin(exprTable[exprCurrent].value);
+}
+
+// Change to expression x (see exprFind()). Returns false if no such one.
+bool exprSet(int8_t x) {
+  if(!exprCount) exprUse();
+  if((x < 0) || (x >= exprCount)) return false;
+  expression *ex = &exprTable[x];
+  int8_t      lp = ex->lids[0] ? lidPoseFind(ex->lids) : LID_POSE_OPEN;
+  exprBlend.to(ex->value, ex->time, animMicros());
+  lidPoseTo(-1, (lp >= 0) ? lp : LID_POSE_OPEN, ex->time, LID_EASE_INOUT);
+  exprCurrent = x;
+  return true;
+}
+
+// Name of expression last set
+const char *exprName(void) {
+  return exprCount ? exprTable[exprCurrent].name : "idle";
+}
+
+// Called once per frame (first eye) before the values below are used
+void exprFrame(uint32_t t) {
+  if(!exprCount) exprUse();
+  if(!spinTime)   spinTime = t;
+  exprBlend.update(t);
+  // RPM clockwise, as irisSpin; angles go counterclockwise
+  spinPhase -= exprBlend.getFloat(ExpressionBlend::SPIN) * 1024.0 *
+               (float)(t - spinTime) / 60000000.0;
+  spinPhase -= floor(spinPhase / 1024.0) * 1024.0;
+  spinTime   = t;
+}
+
+// This frame's value of an ExpressionBlend parameter
+float exprGet(uint8_t param) {
+  return exprBlend.getFloat(param);
+}
+
+// Extra iris angle from expression spin, 0-1023 (1/1024ths of a turn)
+int exprSpinAngle(void) {
+  return (int)spinPhase & 1023;
+}
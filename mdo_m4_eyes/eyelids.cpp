@@ -0,0 +1,191 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+//34567890123456789012345678901234567890123456789012345678901234567890123456
+
+#include "globals.h"
+
+// EYELID POSES ------------------------------------------------------------
+
+// Pose 0 (LID_POSE_OPEN) and 1 (LID_POSE_CLOSED) are the usual eyelid
+// images' open and closed edges. More poses (squint, surprise, sleepy...)
+// come from the directory named by "eyelidPoses" in the config: each is a
+// 1-bit BMP, white where the eye shows, named for its file ("squint.bmp"
+// is "squint"). Loaded the same way as the eyelids, so their edges are
+// 8.8 fixed point too.
+//
+// Each eye's lids move from where they are to a pose over a duration with
+// an easing curve, then stay there. Blinks and lid tracking work as before
+// on top of that, closing the lids from the pose rather than from open.
+// All of it is worked out once per frame into the eye's lidLow/lidHigh,
+// so the column renderer does no more than read two numbers.
+
+#define LID_POSE_NAME 16 // Longest pose name (incl. NUL)
+
+typedef struct {
+  uint16_t lower[LID_POSES_MAX - 2][MAX_DISPLAY_SIZE],
+           upper[LID_POSES_MAX - 2][MAX_DISPLAY_SIZE];
+  char     name[LID_POSES_MAX - 2][LID_POSE_NAME];
+  uint8_t  count; // Not including open & closed
+} poseSet;
+
+// Two sets: the eyes use one while a live reload loads the other, then
+// lidPosesUse() swaps them at frame start, same as the eyelids.
+static poseSet poses[2];
+static uint8_t poseBank = 0; // The one in use
+
+// Edge tables for pose p; anything not (yet) loaded is open
+static const uint16_t *lowerOf(uint8_t p) {
+  if(p == LID_POSE_CLOSED) return lowerClosed;
+  if((p >= 2) && (p < (2 + poses[poseBank].count))) return poses[poseBank].lower[p - 2];
+  return lowerOpen;
+}
+
+static const uint16_t *upperOf(uint8_t p) {
+  if(p == LID_POSE_CLOSED) return upperClosed;
+  if((p >= 2) && (p < (2 + poses[poseBank].count))) return poses[poseBank].upper[p - 2];
+  return upperOpen;
+}
+
+// Pose index by name, -1 if there's no such pose
+int8_t lidPoseFind(const char *name) {
+  if(!strcmp(name, "open"))   return LID_POSE_OPEN;
+  if(!strcmp(name, "closed")) return LID_POSE_CLOSED;
+  for(uint8_t p=2; p<(2 + poses[poseBank].count); p++) {
+    if(!strcmp(name, poses[poseBank].name[p - 2])) return p;
+  }
+  return -1;
+}
+
+// Image scratch bytes needed to load the poses in 'dir'
+uint32_t lidPosesScratch(const char *dir) {
+  uint32_t need = 0, n;
+  char     name[SD_MAX_FILENAME_SIZE+1], path[SD_MAX_FILENAME_SIZE*2+2];
+  for(uint8_t i=0; dir && (i<(LID_POSES_MAX - 2)); i++) {
+    File entry = arcada.openFileByIndex(dir, i, FILE_READ, "bmp");
+    if(!entry) break;
+    entry.getName(name, sizeof name);
+    entry.close();
+    snprintf(path, sizeof path, "%s/%s", dir, name);
+    if((n = imageScratch(path)) > need) need = n;
+  }
+  return need;
+}
+
+// Load pose images from 'dir' (NULL = none), not used until
+// lidPosesUse(). Needs image scratch, see above.
+void lidPosesLoad(const char *dir) {
+  char     name[SD_MAX_FILENAME_SIZE+1], path[SD_MAX_FILENAME_SIZE*2+2];
+  uint8_t  n    = 0;
+  poseSet *next = &poses[!poseBank];
+  for(uint8_t i=0; dir && (i<(LID_POSES_MAX - 2)); i++) {
+    File entry = arcada.openFileByIndex(dir, i, FILE_READ, "bmp");
+    if(!entry) break;
+    entry.getName(name, sizeof name);
+    entry.close();
+    snprintf(path, sizeof path, "%s/%s", dir, name);
+    // No white in a column = lids meet there, so init is mid-screen
+    if(loadEyelid(path, next->lower[n], next->upper[n], DISPLAY_SIZE/2) != IMAGE_SUCCESS) {
+      Serial.printf("Eyelid pose %s didn't load\n", path);
+      continue;
+    }
+    char *dot = strrchr(name, '.');
+    if(dot) *dot = 0;
+    strncpy(next->name[n], name, LID_POSE_NAME - 1);
+    next->name[n][LID_POSE_NAME - 1] = 0;
+    n++;
+  }
+  next->count = n;
+  if(dir) Serial.printf("Eyelid poses: %d from %s\n", n, dir);
+}
+
+// Switch to the poses last loaded. Call at frame start (first eye), an
+// eye holding a pose that's no longer there shows open.
+void lidPosesUse(void) {
+  poseBank = !poseBank;
+}
+
+// 0.0-1.0 through a move -> 0-256 along it
+static int lidEase(uint8_t ease, float e) {
+  switch(ease) {
+   case LID_EASE_IN:    e = e * e;                         break;
+   case LID_EASE_OUT:   e = e * (2.0 - e);                 break;
+   case LID_EASE_INOUT: e = 3 * e * e - 2 * e * e * e;     break;
+  }
+  return (int)(e * 256.0 + 0.5);
+}
+
+// How far eye e is from its 'from' to its 'to' pose at time t, 0-256.
+// Finishes the move when it's time.
+static int lidMix(uint8_t e, uint32_t t) {
+  lidAnim *a = &eye[e].lid;
+  if(a->duration) {
+    uint32_t dt = t - a->startTime;
+    if(dt < a->duration) return lidEase(a->ease, (float)dt / (float)a->duration);
+    a->duration = 0;
+  }
+  a->from = a->to;
+  return 256;
+}
+
+// Start eye e's lids (-1 = all eyes) moving from wherever they are now to
+// 'pose' over 'duration' micros (0 = at once), with LID_EASE_* curve. The
+// pose holds until the next call. Moves can be changed partway through.
+void lidPoseTo(int8_t e, uint8_t pose, uint32_t duration, uint8_t ease) {
+  uint32_t t = animMicros();
+  for(uint8_t i=0; i<NUM_EYES; i++) {
+    if((e >= 0) && (e != i)) continue;
+    lidAnim *a   = &eye[i].lid;
+    int      mix = lidMix(i, t);
+    if(mix < 256) {
+      // Partway there. Freeze where the lids are now as the 'from' pose.
+      const uint16_t *fl = (a->from == LID_POSE_HERE) ? a->hereLower : lowerOf(a->from),
+                     *fu = (a->from == LID_POSE_HERE) ? a->hereUpper : upperOf(a->from),
+                     *tl = lowerOf(a->to), *tu = upperOf(a->to);
+      for(int x=0; x<DISPLAY_SIZE; x++) {
+        a->hereLower[x] = fl[x] + (((tl[x] - fl[x]) * mix) >> 8);
+        a->hereUpper[x] = fu[x] + (((tu[x] - fu[x]) * mix) >> 8);
+      }
+      a->from = LID_POSE_HERE;
+    }
+    a->to        = pose;
+    a->ease      = ease;
+    a->startTime = t;
+    a->duration  = duration;
+    if(!duration) a->from = pose;
+  }
+}
+
+// true if eye e's lids are still moving to a pose
+bool lidPoseMoving(uint8_t e) {
+  return eye[e].lid.duration != 0;
+}
+
+// Called once per frame for eye e. Works out this frame's lid edges from
+// the pose move, then closes them toward upper/lowerClosed by the blink
+// and tracking factors (1.0 = as posed, 0.0 = closed).
+void lidFrame(uint8_t e, uint32_t t, float upperFactor, float lowerFactor) {
+  lidAnim        *a   = &eye[e].lid;
+  int             mix = lidMix(e, t);
+  const uint16_t *fl  = (a->from == LID_POSE_HERE) ? a->hereLower : lowerOf(a->from),
+                 *fu  = (a->from == LID_POSE_HERE) ? a->hereUpper : upperOf(a->from),
+                 *tl  = lowerOf(a->to), *tu = upperOf(a->to);
+  int             uf  = (int)(upperFactor * 4096.0), // 4.12 fixed point
+                  lf  = (int)(lowerFactor * 4096.0);
+  for(int x=0; x<DISPLAY_SIZE; x++) {
+    int lo = fl[x] + (((tl[x] - fl[x]) * mix) >> 8),
+        hi = fu[x] + (((tu[x] - fu[x]) * mix) >> 8);
+    lo = lowerClosed[x] + (((lo - lowerClosed[x]) * lf + 2048) >> 12);
+    hi = upperClosed[x] + (((hi - upperClosed[x]) * uf + 2048) >> 12);
+    // Clip in case factors are beyond the usual 0.0 to 1.0 range
+    if(lo > ((DISPLAY_SIZE-1) << 8)) lo = (DISPLAY_SIZE-1) << 8;
+    else if(lo < 0)                  lo = 0;
+    if(hi > ((DISPLAY_SIZE-1) << 8)) hi = (DISPLAY_SIZE-1) << 8;
+    else if(hi < 0)                  hi = 0;
+    eye[e].lidLow[x]  = lo;
+    eye[e].lidHigh[x] = hi;
+  }
+}
@@ -4,14 +4,423 @@
 
 //34567890123456789012345678901234567890123456789012345678901234567890123456
 
-#define ARDUINOJSON_ENABLE_COMMENTS 1
-#include <ArduinoJson.h>          // JSON config file functions
 #include "globals.h"
+#include "FsRetry.h"
+#include "LidEdge.h"
 
 extern Adafruit_Arcada arcada;
 
+// FILESYSTEM STARTUP ------------------------------------------------------
+
+// Powering up without USB attached, the filesystem often isn't readable
+// right away (arcada.exists() etc. fail for a while). Rather than an
+// external reset to try again, wait for it here with bounded backoff:
+// FS_RETRY_MS, doubling, up to FS_RETRIES tries (~2.5 sec total). Once
+// something's been read, the filesystem is known good and later misses
+// are taken at face value (a file that's really not there), no waiting.
+// If it never comes up, the last-known-good snapshot below is used.
+
+#define FS_RETRIES  8
+#define FS_RETRY_MS 10
+
+static bool configFromSnapshot = false;
+
+// Config file in use and its size/date stamp, for live reload (see below)
+static const char *configFile  = NULL;
+static uint32_t    configStamp = 0;
+static bool        configReload = false; // loadConfig() for a live reload
+
+// Probes for FsRetry (FsRetry.h), which does the waiting
+static bool rootReadable(void *ctx) {
+  bool ok   = false;
+  File root = arcada.open("/", FILE_READ);
+  if(root) {
+    File f = root.openNextFile(); // Root listing = really readable
+    if(f) {
+      f.close();
+      ok = true;
+    }
+    root.close();
+  }
+  return ok;
+}
+
+static bool fileExists(void *ctx) {
+  return arcada.exists((const char *)ctx);
+}
+
+static void fsPause(uint32_t ms) {
+  delay(ms); // delay() calls yield(), keeps mass storage alive
+}
+
+static FsRetry filesys(fsPause, FS_RETRIES, FS_RETRY_MS);
+
+// Called once from setup(), before any file is used. Returns true if the
+// filesystem can be read. Reports how long that took.
+bool filesysWait(void) {
+  if(!filesys.wait(rootReadable, NULL)) {
+    Serial.printf("Filesystem not ready at %d ms\n", millis());
+    return false;
+  }
+  Serial.printf("Filesystem ready at %d ms, %d tries\n", millis(), filesys.tries());
+  return true;
+}
+
+// Same idea per file, for the loaders below: true if filename can be
+// opened, retrying with backoff only while filesystem isn't known good.
+bool fileReady(const char *filename) {
+  return filesys.ready(fileExists, (void *)filename);
+}
+
+// LAST-KNOWN-GOOD SNAPSHOT ------------------------------------------------
+
+// After a startup that loaded everything from files, a copy of the config
+// file and the eyelid tables is kept in internal flash (see nvm.cpp). If
+// a later startup can't read the filesystem at all, that copy is used so
+// the eyes come up as they were (textures fall back to their colors, too
+// big to keep). Only rewritten when the contents change.
+
+#define SNAPSHOT_BLOCKS 2          // 16K, config file + 4 eyelid tables
+#define SNAPSHOT_MAGIC  0x534E4150 // "SNAP"
+
+typedef struct {
+  uint32_t magic;
+  uint32_t configLen;             // Bytes of config file following header
+  uint32_t lidLen;                // Bytes of eyelid tables after config
+  uint32_t check;                 // Hash of all of the above
+} snapshotHeader;
+
+static volatile const uint8_t snapshot[SNAPSHOT_BLOCKS * NVMCTRL_BLOCK_SIZE]
+  __attribute__((aligned(NVMCTRL_BLOCK_SIZE))) = { 0xFF };
+
+static uint32_t snapshotHash(uint32_t hash, volatile const uint8_t *data,
+  uint32_t len) {
+  while(len--) {
+    hash ^= *data++; // FNV-1a
+    hash *= 16777619UL;
+  }
+  return hash;
+}
+
+// Returns header if snapshot is present and intact, else NULL
+static volatile const snapshotHeader *snapshotValid(void) {
+  volatile const snapshotHeader *h = (volatile const snapshotHeader *)snapshot;
+  if((h->magic != SNAPSHOT_MAGIC) || (h->lidLen != LID_BYTES) ||
+     ((sizeof(snapshotHeader) + h->configLen + h->lidLen) > sizeof snapshot)) {
+    return NULL;
+  }
+  uint32_t hash = snapshotHash(2166136261UL, &snapshot[sizeof(snapshotHeader)],
+    h->configLen + h->lidLen);
+  return (hash == h->check) ? h : NULL;
+}
+
+// Snapshot config file, in place in flash. Returns NULL if none.
+static volatile const uint8_t *snapshotConfig(uint32_t *len) {
+  volatile const snapshotHeader *h = snapshotValid();
+  if(!h) return NULL;
+  *len = h->configLen;
+  return &snapshot[sizeof(snapshotHeader)];
+}
+
+// Copy snapshot eyelid tables (upper open/closed, lower open/closed, as
+// in the reload code) to dst. Returns false if no snapshot.
+static bool snapshotLids(uint16_t *dst) {
+  volatile const snapshotHeader *h = snapshotValid();
+  if(!h) return false;
+  for(uint32_t i=0; i<h->lidLen; i++) {
+    ((uint8_t *)dst)[i] = snapshot[sizeof(snapshotHeader) + h->configLen + i];
+  }
+  return true;
+}
+
+// Quad-word at a time output to snapshot flash
+static struct {
+  uint32_t offset;
+  uint8_t  fill;
+  uint32_t quad[4];
+} snapOut;
+
+static void snapPut(const void *src, uint32_t len) {
+  const uint8_t *s = (const uint8_t *)src;
+  while(len--) {
+    ((uint8_t *)snapOut.quad)[snapOut.fill++] = *s++;
+    if(snapOut.fill >= sizeof snapOut.quad) {
+      nvmWrite(&snapshot[snapOut.offset], snapOut.quad, 1);
+      snapOut.offset += sizeof snapOut.quad;
+      snapOut.fill    = 0;
+    }
+  }
+}
+
+// Called once startup loading is done. Saves config file (re-read, it's
+// small) and current eyelid tables if they came from files and differ
+// from what's saved.
+static void saveSnapshot(void) {
+  File           file;
+  char          *json;
+  snapshotHeader h;
+  uint16_t      *lids[] = { upperOpen, upperClosed, lowerOpen, lowerClosed };
+
+  if(configFromSnapshot || !configFile ||
+     !(file = arcada.open(configFile, FILE_READ))) return;
+  h.configLen = file.size();
+  h.lidLen    = LID_BYTES;
+  if(((sizeof h + h.configLen + h.lidLen) > sizeof snapshot) ||
+     !(json = (char *)malloc(h.configLen))) {
+    file.close();
+    return;
+  }
+  h.configLen = file.read(json, h.configLen);
+  file.close();
+
+  h.magic = SNAPSHOT_MAGIC;
+  h.check = snapshotHash(2166136261UL, (uint8_t *)json, h.configLen);
+  for(uint8_t i=0; i<4; i++) {
+    h.check = snapshotHash(h.check, (uint8_t *)lids[i], LID_BYTES / 4);
+  }
+  volatile const snapshotHeader *old = snapshotValid();
+  if(!old || (old->check != h.check) || (old->configLen != h.configLen)) {
+    uint32_t t = millis();
+    for(uint8_t b=0; b<SNAPSHOT_BLOCKS; b++) {
+      nvmErase(&snapshot[b * NVMCTRL_BLOCK_SIZE]);
+    }
+    snapOut.offset = snapOut.fill = 0;
+    snapPut(&h, sizeof h);
+    snapPut(json, h.configLen);
+    for(uint8_t i=0; i<4; i++) snapPut(lids[i], LID_BYTES / 4);
+    if(snapOut.fill) { // Pad out last quad-word
+      memset(&((uint8_t *)snapOut.quad)[snapOut.fill], 0xFF,
+        sizeof snapOut.quad - snapOut.fill);
+      nvmWrite(&snapshot[snapOut.offset], snapOut.quad, 1);
+    }
+    Serial.printf("Saved config snapshot, %d ms\n", millis() - t);
+  }
+  free(json);
+}
+
 // CONFIGURATION FILE HANDLING ---------------------------------------------
 
+// A config can come from the .eye (JSON) file or from a precompiled .bin
+// next to it (made on a computer by mdo_EyeConfig/eye_config_compile.py,
+// which also checks the .eye for mistakes). Either way it ends up as a
+// configResolved: per key, a 'was set' bit and a value already converted
+// to what the code uses (big-endian RGB565 colors, CCW 0-1023 angles...),
+// which is then applied in a fixed order (globals, then per-eye). The
+// JSON is read by a streaming tokenizer (configparse.cpp) into a staging
+// table first, so a broken file changes nothing.
+
+// Known keys and how each is converted. Keys that can also appear in a
+// per-eye section come first. THE ORDER AND TYPES ARE PART OF THE .bin
+// FORMAT (see eye_config_compile.py): add new keys at the end of a group
+// and bump CONFIG_BLOB_VERSION.
+enum { // Value conversions
+  CT_DWIM,     // Number, hex string or RGB array, via dwim() -> int
+  CT_INT,      // Integer only
+  CT_FLOAT,    // Any number -> float
+  CT_ANGLE,    // Int 0-1023 or float 0.0-1.0 CW -> int 0-1023 CCW
+  CT_SPIN,     // Any number, CW -> float CCW 1/1024ths
+  CT_MIRROR,   // Bool or int -> 0 or 1023
+  CT_BOOL,     // true/false -> 0 or 1
+  CT_STRING,   // String -> string (in arena)
+  CT_WAVEFORM, // "square" etc. -> 0-4
+  CT_VOICEMODE, // "psola" -> 1, anything else 0 (VOICE_MODE_*)
+};
+
+typedef struct {
+  const char *name;
+  uint8_t     type; // CT_* above
+} configKey;
+
+static const configKey configKeys[] = {
+  // Global or per-eye...
+  { "pupilColor"      , CT_DWIM   }, { "backColor"       , CT_DWIM     },
+  { "irisColor"       , CT_DWIM   }, { "scleraColor"     , CT_DWIM     },
+  { "irisAngle"       , CT_ANGLE  }, { "scleraAngle"     , CT_ANGLE    },
+  { "irisSpin"        , CT_SPIN   }, { "scleraSpin"      , CT_SPIN     },
+  { "irisiSpin"       , CT_INT    }, { "scleraiSpin"     , CT_INT      },
+  { "irisMirror"      , CT_MIRROR }, { "scleraMirror"    , CT_MIRROR   },
+  { "irisTexture"     , CT_STRING }, { "scleraTexture"   , CT_STRING   },
+  { "rotate"          , CT_INT    }, { "irisRadius"      , CT_DWIM     },
+  { "slitPupilRadius" , CT_DWIM   },
+  // Global only...
+  { "stackReserve"    , CT_DWIM   }, { "eyeRadius"       , CT_DWIM     },
+  { "eyelidIndex"     , CT_DWIM   }, { "gazeMax"         , CT_DWIM     },
+  { "coverage"        , CT_FLOAT  }, { "upperEyelid"     , CT_STRING   },
+  { "lowerEyelid"     , CT_STRING }, { "lightSensorMin"  , CT_INT      },
+  { "lightSensorMax"  , CT_INT    }, { "lightSensorCurve", CT_FLOAT    },
+  { "pupilMax"        , CT_FLOAT  }, { "pupilMin"        , CT_FLOAT    },
+  { "lightSensor"     , CT_INT    }, { "boopSensor"      , CT_INT      },
+  { "tracking"        , CT_BOOL   }, { "squint"          , CT_FLOAT    },
+  { "voice"           , CT_BOOL   }, { "pitch"           , CT_FLOAT    },
+  { "gain"            , CT_FLOAT  }, { "modulate"        , CT_INT      },
+  { "waveform"        , CT_WAVEFORM }, { "eyelidPoses"     , CT_STRING   },
+  { "expressions"     , CT_STRING }, { "recordLog"       , CT_STRING   },
+  { "replayLog"       , CT_STRING }, { "voiceMode"       , CT_VOICEMODE } };
+
+enum { // Same order as above
+  CK_PUPILCOLOR, CK_BACKCOLOR, CK_IRISCOLOR, CK_SCLERACOLOR, CK_IRISANGLE,
+  CK_SCLERAANGLE, CK_IRISSPIN, CK_SCLERASPIN, CK_IRISISPIN, CK_SCLERAISPIN,
+  CK_IRISMIRROR, CK_SCLERAMIRROR, CK_IRISTEXTURE, CK_SCLERATEXTURE,
+  CK_ROTATE, CK_IRISRADIUS, CK_SLITPUPILRADIUS,
+  CK_EYE_COUNT, // Number of per-eye keys
+  CK_STACKRESERVE = CK_EYE_COUNT, CK_EYERADIUS, CK_EYELIDINDEX, CK_GAZEMAX,
+  CK_COVERAGE, CK_UPPEREYELID, CK_LOWEREYELID, CK_LIGHTSENSORMIN,
+  CK_LIGHTSENSORMAX, CK_LIGHTSENSORCURVE, CK_PUPILMAX, CK_PUPILMIN,
+  CK_LIGHTSENSOR, CK_BOOPSENSOR, CK_TRACKING, CK_SQUINT, CK_VOICE,
+  CK_PITCH, CK_GAIN, CK_MODULATE, CK_WAVEFORM, CK_EYELIDPOSES,
+  CK_EXPRESSIONS, CK_RECORDLOG, CK_REPLAYLOG, CK_VOICEMODE,
+  CK_COUNT };
+
+// Per-eye sections, by name, whatever NUM_EYES is (so one .bin suits
+// both boards). Order is part of the .bin format.
+#define CONFIG_EYES 2
+static const char * const configEyeNames[CONFIG_EYES] = { "right", "left" };
+
+typedef union {
+  int32_t     i;
+  float       f;
+  const char *s; // Offset from start of file in .bin, see loadConfigBlob()
+} configItem;
+
+typedef struct {
+  uint32_t   set[(CK_COUNT + 31) / 32]; // Bit per configKeys[] entry found
+  configItem item[CK_COUNT];            // Per-eye sections: CK_EYE_COUNT used
+} configSection;
+
+typedef struct {
+  configSection global;
+  configSection eye[CONFIG_EYES];
+} configResolved;
+
+static bool isSet(configSection *s, uint8_t k) {
+  return s->set[k >> 5] & (1UL << (k & 31));
+}
+
+static int32_t intOr(configSection *s, uint8_t k, int32_t def) {
+  return isSet(s, k) ? s->item[k].i : def;
+}
+
+static float floatOr(configSection *s, uint8_t k, float def) {
+  return isSet(s, k) ? s->item[k].f : def;
+}
+
+// Per-eye section for eye e, NULL if none
+static configSection *eyeSection(configResolved *r, uint8_t e) {
+  for(uint8_t i=0; i<CONFIG_EYES; i++) {
+    if(eye[e].name && !strcmp(eye[e].name, configEyeNames[i])) return &r->eye[i];
+  }
+  return NULL;
+}
+
+// STRING ARENA. Filenames from the config (and hex strings, until they're
+// converted) are copied here instead of strdup()'d. Only needed until the
+// images are loaded, then the whole thing is released at once with
+// configArenaRelease(). Same-named textures for both eyes share one copy.
+
+#define CONFIG_ARENA_SIZE 768
+
+static char     configArena[CONFIG_ARENA_SIZE];
+static uint16_t configArenaUsed = 0;
+
+static const char *arenaCopy(const char *str) {
+  uint16_t len = strlen(str) + 1;
+  if((configArenaUsed + len) > CONFIG_ARENA_SIZE) {
+    Serial.printf("Config strings too long, ignoring \"%s\"\n", str);
+    return NULL;
+  }
+  char *dst = &configArena[configArenaUsed];
+  memcpy(dst, str, len);
+  configArenaUsed += len;
+  return dst;
+}
+
+// Called when config strings (e.g. image filenames) are no longer needed
+static void configArenaRelease(void) {
+  for(uint8_t e=0; e<NUM_EYES; e++) {
+    eye[e].iris.filename = eye[e].sclera.filename = NULL;
+  }
+  upperEyelidFilename = lowerEyelidFilename = eyelidPosesDir = NULL;
+  recordLogFile       = replayLogFile = NULL;
+  configArenaUsed     = 0;
+}
+
+// configparse.cpp's tokenizer reads through a callback: here from a File,
+// or from memory (the last-known-good snapshot in flash).
+
+typedef struct {
+  volatile const uint8_t *mem;
+  uint32_t                len;
+} configMem;
+
+static int configFileRead(void *ctx, uint8_t *buf, int n) {
+  return ((File *)ctx)->read(buf, n);
+}
+
+static int configMemRead(void *ctx, uint8_t *buf, int n) {
+  configMem *m = (configMem *)ctx;
+  int        i;
+  for(i=0; (i < n) && m->len; i++, m->len--) buf[i] = *m->mem++;
+  return i;
+}
+
+// Parse config from file (if not NULL) or memory, calling handler for
+// each value. Returns false on error (after printing where it was);
+// handler may already have been called for values before that point.
+bool configParse(File *file, volatile const uint8_t *mem, uint32_t memLen,
+  cfgHandler handler) {
+  configMem m = { mem, memLen };
+  bool      ok = file ? cfgParse(configFileRead, file, handler) :
+                        cfgParse(configMemRead, &m, handler);
+  if(!ok) {
+    int line;
+    const char *error = cfgError(&line);
+    Serial.printf("Config file error, line %d: %s\n", line, error);
+  }
+  return ok;
+}
+
+// JSON STAGING. configParse() handler keeps values of known keys; anything
+// else is reported (a typo'd key would otherwise just quietly not work).
+
+typedef struct {
+  cfgValue global[CK_COUNT];
+  cfgValue eye[CONFIG_EYES][CK_EYE_COUNT];
+} configStage;
+
+static configStage *stage; // Only during loadConfig()
+
+static void stageValue(const char *section, const char *key, cfgValue *v) {
+  cfgValue *dst = NULL;
+  uint8_t   k, n = CK_COUNT;
+
+  if(section) {                 // Per-eye section?
+    for(uint8_t e=0; e<CONFIG_EYES; e++) {
+      if(!strcmp(section, configEyeNames[e])) {
+        dst = stage->eye[e];
+        n   = CK_EYE_COUNT;
+        break;
+      }
+    }
+  } else {
+    dst = stage->global;
+  }
+  if(dst) {
+    for(k=0; (k<n) && strcmp(key, configKeys[k].name); k++);
+  }
+  if(!dst || (k >= n)) {
+    Serial.printf("Config: unknown %s%s%s, ignored\n",
+      section ? section : "", section ? "." : "", key);
+    return;
+  }
+  dst[k] = *v;
+  for(uint8_t i=0; i<CFG_ITEMS; i++) { // Strings must outlive the parser
+    if((i < v->count) && (dst[k].item[i].type == CFG_STRING) &&
+       !(dst[k].item[i].s = arenaCopy(dst[k].item[i].s))) {
+      dst[k].item[i].type = CFG_NULL;
+    }
+  }
+}
+
 // This function decodes an integer value from the JSON config file in a
 // variety of different formats...for example, "foo" might be specified:
 // "foo" : 42                         - As a signed decimal integer
@@ -27,93 +436,461 @@ extern Adafruit_Arcada arcada;
 // not-so-well-formatted) numbers, but not every imaginable case, and makes
 // some guesses about what's an RGB color vs what isn't. Doing what I can,
 // JSON is picky and and at some point folks just gotta get it together.
-static int32_t dwim(JsonVariant v, int32_t def = 0) { // "Do What I Mean"
-  if(v.is<int>()) {                      // If integer...
-    return v;                            // ...return value directly
-  } else if(v.is<float>()) {             // If float...
-    return (int)(v.as<float>() + 0.5);   // ...return rounded integer
-  } else if(v.is<const char*>()) {             // If string...
-    if((strlen(v) == 6) && !strncasecmp(v, "0x", 2)) { // 4-digit hex?
-      uint16_t rgb = strtol(v, NULL, 0); // Probably a 16-bit RGB color,
+// eye_config_compile.py does the same, keep them in step.
+static int32_t dwim(cfgValue *v) { // "Do What I Mean"
+  if(v->type == CFG_INT) {               // If integer...
+    return v->item[0].i;                 // ...return value directly
+  } else if(v->type == CFG_FLOAT) {      // If float...
+    return (int)(v->item[0].f + 0.5);    // ...return rounded integer
+  } else if(v->type == CFG_STRING) {     // If string...
+    const char *s = v->item[0].s;
+    if((strlen(s) == 6) && !strncasecmp(s, "0x", 2)) { // 4-digit hex?
+      uint16_t rgb = strtol(s, NULL, 0); // Probably a 16-bit RGB color,
       return __builtin_bswap16(rgb);     // convert to big-endian
     } else {
-      return strtol(v, NULL, 0);         // Some other int/hex/octal
-    }
-  } else if(v.is<JsonArray>()) {         // If array...
-    if(v.size() >= 3) {                  // ...and at least 3 elements...
-      long cc[3];                        // ...parse RGB color components...
-      for(uint8_t i=0; i<3; i++) {       // Handle int/hex/octal/float...
-        if(v[i].is<int>()) {
-          cc[i] = v[i].as<int>();
-        } else if(v[i].is<float>()) {
-          cc[i] = (int)(v[i].as<float>() * 255.999);
-        } else if(v[i].is<const char*>()) {
-          cc[i] = strtol(v[i], NULL, 0);
-        }
-        if(cc[i] > 255)    cc[i] = 255;  // Clip to 8-bit range
-        else if(cc[i] < 0) cc[i] = 0;
-      }
-      uint16_t rgb = ((cc[0] & 0xF8) << 8) | // Decimate 24-bit RGB
-                     ((cc[1] & 0xFC) << 3) | // to 16-bit
-                     ( cc[2]         >> 3);
-      return __builtin_bswap16(rgb);         // and return big-endian
-    } else {                             // Some unexpected array
-      if(v[0].is<int>()) {               // Return first element
-        return v[0];                     // as a simple integer,
+      return strtol(s, NULL, 0);         // Some other int/hex/octal
+    }
+  } else if(v->count >= 3) {             // If array of 3+ elements...
+    long cc[3];                          // ...parse RGB color components...
+    for(uint8_t i=0; i<3; i++) {         // Handle int/hex/octal/float...
+      cfgScalar *s = &v->item[i];
+      if(s->type == CFG_INT) {
+        cc[i] = s->i;
+      } else if(s->type == CFG_FLOAT) {
+        cc[i] = (int)(s->f * 255.999);
+      } else if(s->type == CFG_STRING) {
+        cc[i] = strtol(s->s, NULL, 0);
       } else {
-        return strtol(v[0], NULL, 0);    // or int/hex/octal
+        cc[i] = 0;
       }
+      if(cc[i] > 255)    cc[i] = 255;    // Clip to 8-bit range
+      else if(cc[i] < 0) cc[i] = 0;
+    }
+    uint16_t rgb = ((cc[0] & 0xF8) << 8) | // Decimate 24-bit RGB
+                   ((cc[1] & 0xFC) << 3) | // to 16-bit
+                   ( cc[2]         >> 3);
+    return __builtin_bswap16(rgb);         // and return big-endian
+  } else {                               // Some unexpected array
+    cfgScalar *s = &v->item[0];          // Return first element
+    if(s->type == CFG_STRING) {
+      return strtol(s->s, NULL, 0);      // as int/hex/octal,
+    } else if(s->type == CFG_FLOAT) {
+      return (int32_t)s->f;              // or a simple integer
+    } else if(s->type == CFG_INT) {
+      return s->i;
     }
-  } else {                               // Not found in document
-    return def;                          // ...return default value
+    return 0;
   }
 }
 
-/*
-static void getFilename(JsonVariant v, char **ptr) {
-  if(*ptr) {          // If string already allocated,
-    free(*ptr);       // delete old value...
-    *ptr = NULL;
+static float asFloat(cfgValue *v) {
+  return (v->type == CFG_FLOAT) ? v->item[0].f : (float)v->item[0].i;
+}
+
+// Convert staged JSON value v to configItem per key type. Returns false
+// if it's not a usable value for that type (e.g. string for a number).
+static bool resolveValue(uint8_t type, cfgValue *v, configItem *out) {
+  bool number = (v->type == CFG_INT) || (v->type == CFG_FLOAT);
+  switch(type) {
+   case CT_DWIM:
+    if(!number && (v->type != CFG_STRING) &&
+       !((v->type == CFG_ARRAY) && v->count)) return false;
+    out->i = dwim(v);
+    return true;
+   case CT_INT:
+    if(v->type != CFG_INT) return false;
+    out->i = v->item[0].i;
+    return true;
+   case CT_FLOAT:
+    if(!number) return false;
+    out->f = asFloat(v);
+    return true;
+   case CT_ANGLE:
+    if(!number) return false;
+    if(v->type == CFG_INT) out->i = 1023 - (v->item[0].i & 1023);
+    else                   out->i = 1023 - ((int)(v->item[0].f * 1024.0) & 1023);
+    return true;
+   case CT_SPIN:
+    if(!number) return false;
+    out->f = asFloat(v) * -1024.0;
+    return true;
+   case CT_MIRROR:
+    if((v->type != CFG_BOOL) && (v->type != CFG_INT)) return false;
+    out->i = v->item[0].i ? 1023 : 0;
+    return true;
+   case CT_BOOL:
+    if(v->type != CFG_BOOL) return false;
+    out->i = v->item[0].i;
+    return true;
+   case CT_STRING:
+    if(v->type != CFG_STRING) return false;
+    out->s = v->item[0].s;       // Already in arena
+    return true;
+   case CT_WAVEFORM:
+    if(v->type != CFG_STRING) return false;
+    if(!strncasecmp(     v->item[0].s, "sq", 2)) out->i = 1;
+    else if(!strncasecmp(v->item[0].s, "si", 2)) out->i = 2;
+    else if(!strncasecmp(v->item[0].s, "t" , 1)) out->i = 3;
+    else if(!strncasecmp(v->item[0].s, "sa", 2)) out->i = 4;
+    else                                         out->i = 0;
+    return true;
+   case CT_VOICEMODE:
+    if(v->type != CFG_STRING) return false;
+    out->i = strncasecmp(v->item[0].s, "ps", 2) ? 0 : 1;
+    return true;
   }
-  if(v.is<const char*>()) {
-    *ptr = strdup(v); // Make a copy of string, save that
+  return false;
+}
+
+static void resolveSection(const char *name, cfgValue *src, uint8_t n,
+  configSection *dst) {
+  for(uint8_t k=0; k<n; k++) {
+    if(src[k].type == CFG_NONE) continue;
+    if(resolveValue(configKeys[k].type, &src[k], &dst->item[k])) {
+      dst->set[k >> 5] |= 1UL << (k & 31);
+    } else {
+      Serial.printf("Config: %s%s%s has wrong type, ignored\n",
+        name ? name : "", name ? "." : "", configKeys[k].name);
+    }
   }
 }
-*/
 
-void loadConfig(char *filename) {
-  File    file;
-  uint8_t rotation = 3;
+// BINARY CONFIG. configBlobHeader, then a configResolved (little-endian,
+// 32-bit items), then the NUL-terminated strings that CT_STRING items
+// point to. Used instead of the .eye when it's present, intact and made
+// from the .eye as it is now: the header holds a hash of the .eye's
+// contents, so a copy that changes the file's date but not its bytes
+// still uses the .bin, and an edit that keeps the size doesn't.
 
-  if(file = arcada.open(filename, FILE_READ)) {
-    StaticJsonDocument<2048> doc;
+#define CONFIG_BLOB_MAGIC   0x47464345 // "ECFG"
+#define CONFIG_BLOB_VERSION 6
+#define CONFIG_BLOB_MAX     1024       // Largest .bin accepted, bytes
+#define CONFIG_NAME_MAX     84         // Longest config path (incl. NUL)
 
+typedef struct {
+  uint32_t magic;      // CONFIG_BLOB_MAGIC
+  uint16_t version;    // CONFIG_BLOB_VERSION
+  uint16_t size;       // Whole file, bytes
+  uint32_t sourceSize; // Size of the .eye it was made from, bytes
+  uint32_t sourceHash; // FNV-1a of that .eye's contents
+  uint32_t check;      // FNV-1a of everything after header
+} configBlobHeader;
+
+// .bin name for a config file: same, with extension replaced
+static bool configBlobName(const char *filename, char *blob) {
+  const char *dot   = strrchr(filename, '.'),
+             *slash = strrchr(filename, '/');
+  int         len   = (dot && (!slash || (dot > slash))) ? (dot - filename) : strlen(filename);
+  if((len + 5) > CONFIG_NAME_MAX) return false;
+  memcpy(blob, filename, len);
+  strcpy(&blob[len], ".bin");
+  return true;
+}
+
+// Load binary config if usable. Returns false to use the .eye instead.
+static bool loadConfigBlob(const char *filename, configResolved *r) {
+  char     name[CONFIG_NAME_MAX];
+  uint8_t  buf[CONFIG_BLOB_MAX], chunk[64];
+  File     file;
+  uint32_t len, eyeSize = 0, eyeHash = 2166136261UL;
+  int      n;
+
+  if(!configBlobName(filename, name) || !arcada.exists(name) ||
+     !(file = arcada.open(name, FILE_READ))) return false;
+  len = file.read(buf, sizeof buf); // The one read
+  file.close();
+  if((file = arcada.open(filename, FILE_READ))) {
+    eyeSize = file.size();
+    while((n = file.read(chunk, sizeof chunk)) > 0) {
+      eyeHash = snapshotHash(eyeHash, chunk, n);
+    }
+    file.close();
+  }
+
+  configBlobHeader h; // Copied out, buf needn't be aligned for it
+  memcpy(&h, buf, sizeof h);
+  if((len < (sizeof(configBlobHeader) + sizeof(configResolved))) ||
+     (h.magic != CONFIG_BLOB_MAGIC) || (h.version != CONFIG_BLOB_VERSION) ||
+     (h.size != len) || (h.check != snapshotHash(2166136261UL,
+       &buf[sizeof(configBlobHeader)], len - sizeof(configBlobHeader)))) {
+    Serial.printf("%s not valid, using %s\n", name, filename);
+    return false;
+  }
+  if(eyeSize && ((eyeSize != h.sourceSize) || (eyeHash != h.sourceHash))) {
+    Serial.printf("%s wasn't made from this %s, not used\n", name, filename);
+    return false;
+  }
+
+  memcpy(r, &buf[sizeof(configBlobHeader)], sizeof(configResolved));
+  // String items hold offsets into the file, move strings to the arena
+  for(uint8_t s=0; s<=CONFIG_EYES; s++) {
+    configSection *sec = s ? &r->eye[s - 1] : &r->global;
+    for(uint8_t k=0; k<CK_COUNT; k++) {
+      if((configKeys[k].type != CT_STRING) || !isSet(sec, k)) continue;
+      uint32_t offset = sec->item[k].i;
+      if((offset >= len) || !memchr(&buf[offset], 0, len - offset) ||
+         !(sec->item[k].s = arenaCopy((char *)&buf[offset]))) {
+        sec->set[k >> 5] &= ~(1UL << (k & 31));
+      }
+    }
+  }
+  Serial.printf("Using %s\n", name);
+  return true;
+}
+
+// Read config as JSON into r. Returns false on a syntax error.
+static bool loadConfigJSON(File *file, volatile const uint8_t *mem,
+  uint32_t len, configResolved *r) {
+  static configStage staged; // ~2.2K, too big for the stack
+  memset(&staged, 0, sizeof staged); // CFG_NONE is 0, 'not in file'
+  stage = &staged;
+  bool ok = configParse(file, mem, len, stageValue);
+  stage = NULL;
+  if(ok) {
+    resolveSection(NULL, staged.global, CK_COUNT, &r->global);
+    for(uint8_t e=0; e<CONFIG_EYES; e++) {
+      resolveSection(configEyeNames[e], staged.eye[e], CK_EYE_COUNT, &r->eye[e]);
+    }
+  }
+  return ok;
+}
+
+static uint32_t fileStamp(const char *filename);
+
+// Change of either file counts as a config change (live reload)
+static uint32_t configFilesStamp(const char *filename) {
+  char     name[CONFIG_NAME_MAX];
+  uint32_t stamp = fileStamp(filename);
+  if(configBlobName(filename, name)) stamp += fileStamp(name) * 3;
+  return stamp;
+}
+
+// Everything loadConfig() sets, so a live reload can work out the new
+// settings without touching the running ones and swap them in along with
+// the new textures (see applyReload()). Global settings change with the
+// first eye, per-eye ones with their eye. A reload starts from the
+// settings as they were before the config was first read, so a key taken
+// out of the file goes back to its default rather than sticking.
+
+typedef struct {
+  uint16_t pupilColor, backColor;
+  texture  iris, sclera; // Settings only, data/width/height aren't used
+  uint8_t  rotation;
+  int      irisRadius, slitPupilRadius;
+} eyeSettings;
+
+typedef struct {
+  uint32_t    stackReserve, gazeMax;
+  int         eyeRadius, eyeDiameter, irisRadius, slitPupilRadius;
+  int         mapRadius, mapDiameter;
+  float       coverage;
+  uint8_t     eyelidIndex;
+  uint16_t    eyelidColor;
+  char       *upperEyelid, *lowerEyelid, *eyelidPoses, *recordLog, *replayLog;
+  uint16_t    lightSensorMin, lightSensorMax;
+  float       lightSensorCurve, irisMin, irisRange, trackFactor;
+  bool        tracking;
+  int8_t      lightSensorPin, boopPin;
+#if defined(ADAFRUIT_MONSTER_M4SK_EXPRESS)
+  bool        voiceOn;
+  float       currentPitch, defaultPitch, gain;
+  uint32_t    modulate;
+  uint8_t     waveform, voiceMode;
+#endif // ADAFRUIT_MONSTER_M4SK_EXPRESS
+  eyeSettings eye[NUM_EYES];
+} configSettings;
+
+static configSettings configDefaults; // As before the first loadConfig()
+static configSettings configStaged;   // Reloaded, waiting for applyReload()
+
+static void settingsSave(configSettings *s) {
+  s->stackReserve     = stackReserve;
+  s->gazeMax          = gazeMax;
+  s->eyeRadius        = eyeRadius;
+  s->eyeDiameter      = eyeDiameter;
+  s->irisRadius       = irisRadius;
+  s->slitPupilRadius  = slitPupilRadius;
+  s->mapRadius        = mapRadius;
+  s->mapDiameter      = mapDiameter;
+  s->coverage         = coverage;
+  s->eyelidIndex      = eyelidIndex;
+  s->eyelidColor      = eyelidColor;
+  s->upperEyelid      = upperEyelidFilename;
+  s->lowerEyelid      = lowerEyelidFilename;
+  s->eyelidPoses      = eyelidPosesDir;
+  s->recordLog        = recordLogFile;
+  s->replayLog        = replayLogFile;
+  s->lightSensorMin   = lightSensorMin;
+  s->lightSensorMax   = lightSensorMax;
+  s->lightSensorCurve = lightSensorCurve;
+  s->irisMin          = irisMin;
+  s->irisRange        = irisRange;
+  s->trackFactor      = trackFactor;
+  s->tracking         = tracking;
+  s->lightSensorPin   = lightSensorPin;
+  s->boopPin          = boopPin;
+#if defined(ADAFRUIT_MONSTER_M4SK_EXPRESS)
+  s->voiceOn          = voiceOn;
+  s->currentPitch     = currentPitch;
+  s->defaultPitch     = defaultPitch;
+  s->gain             = gain;
+  s->modulate         = modulate;
+  s->waveform         = waveform;
+  s->voiceMode        = voiceMode;
+#endif // ADAFRUIT_MONSTER_M4SK_EXPRESS
+  for(uint8_t e=0; e<NUM_EYES; e++) {
+    eyeSettings *p     = &s->eye[e];
+    p->pupilColor      = eye[e].pupilColor;
+    p->backColor       = eye[e].backColor;
+    p->iris            = eye[e].iris;
+    p->sclera          = eye[e].sclera;
+    p->rotation        = eye[e].rotation;
+    p->irisRadius      = eye[e].irisRadius;
+    p->slitPupilRadius = eye[e].slitPupilRadius;
+  }
+}
+
+// Texture settings from 'from', keeping what's loaded
+static void textureSettings(texture *t, const texture *from) {
+  uint16_t *data = t->data, width = t->width, height = t->height;
+  *t        = *from;
+  t->data   = data;
+  t->width  = width;
+  t->height = height;
+}
+
+static void settingsUseEye(const configSettings *s, uint8_t e) {
+  const eyeSettings *p   = &s->eye[e];
+  eye[e].pupilColor      = p->pupilColor;
+  eye[e].backColor       = p->backColor;
+  textureSettings(&eye[e].iris, &p->iris);
+  textureSettings(&eye[e].sclera, &p->sclera);
+  eye[e].rotation        = p->rotation;
+  eye[e].irisRadius      = p->irisRadius;
+  eye[e].slitPupilRadius = p->slitPupilRadius;
+}
+
+static void settingsUseGlobal(const configSettings *s) {
+  stackReserve        = s->stackReserve;
+  gazeMax             = s->gazeMax;
+  eyeRadius           = s->eyeRadius;
+  eyeDiameter         = s->eyeDiameter;
+  irisRadius          = s->irisRadius;
+  slitPupilRadius     = s->slitPupilRadius;
+  mapRadius           = s->mapRadius;
+  mapDiameter         = s->mapDiameter;
+  coverage            = s->coverage;
+  eyelidIndex         = s->eyelidIndex;
+  eyelidColor         = s->eyelidColor;
+  upperEyelidFilename = s->upperEyelid;
+  lowerEyelidFilename = s->lowerEyelid;
+  eyelidPosesDir      = s->eyelidPoses;
+  recordLogFile       = s->recordLog;
+  replayLogFile       = s->replayLog;
+  lightSensorMin      = s->lightSensorMin;
+  lightSensorMax      = s->lightSensorMax;
+  lightSensorCurve    = s->lightSensorCurve;
+  irisMin             = s->irisMin;
+  irisRange           = s->irisRange;
+  trackFactor         = s->trackFactor;
+  tracking            = s->tracking;
+  lightSensorPin      = s->lightSensorPin;
+  boopPin             = s->boopPin;
+#if defined(ADAFRUIT_MONSTER_M4SK_EXPRESS)
+  voiceOn             = s->voiceOn;
+  currentPitch        = s->currentPitch;
+  defaultPitch        = s->defaultPitch;
+  gain                = s->gain;
+  modulate            = s->modulate;
+  waveform            = s->waveform;
+  voiceMode           = s->voiceMode;
+#endif // ADAFRUIT_MONSTER_M4SK_EXPRESS
+}
+
+static void settingsUse(const configSettings *s) {
+  settingsUseGlobal(s);
+  for(uint8_t e=0; e<NUM_EYES; e++) settingsUseEye(s, e);
+}
+
+bool loadConfig(char *filename) {
+  File           file;
+  uint8_t        rotation = 3;
+  bool           status   = false, opened = false;
+  configResolved resolved;
+  uint32_t       t        = millis();
+
+  configFile  = filename;
+  configStamp = configFilesStamp(filename);
+
+  memset(&resolved, 0, sizeof resolved);
+  configArenaUsed = 0;
+
+  // Read the .bin, else the file or, if the filesystem's not working, the
+  // last-known-good snapshot (already in memory, flash really).
+  if(fileReady(filename) && loadConfigBlob(filename, &resolved)) {
+    opened = status = true;
+    configFromSnapshot = false;
+  } else if(fileReady(filename) && (file = arcada.open(filename, FILE_READ))) {
     yield();
-    DeserializationError error = deserializeJson(doc, file);
-    yield();
-    if(error) {
+    opened = true;
+    status = loadConfigJSON(&file, NULL, 0, &resolved);
+    file.close();
+    configFromSnapshot = false;
+  } else {
+    volatile const uint8_t *snap;
+    uint32_t                len;
+    if(!filesys.up() && (snap = snapshotConfig(&len))) {
+      Serial.println("Can't open config file, using last good copy");
+      opened = configFromSnapshot = true;
+      status = loadConfigJSON(NULL, snap, len, &resolved);
+    }
+  }
+  yield();
+
+  if(!status && configReload) {
+    // Bad or missing file on a live reload: the running eyes (and
+    // expression) carry on as they are, nothing here is touched
+    Serial.println("Config file error, not reloaded");
+    return false;
+  }
+  static configSettings running; // Not on the stack, resolved is big
+  if(configReload) {
+    // New settings are worked out from the defaults, then the running
+    // ones go back until applyReload()
+    settingsSave(&running);
+    settingsUse(&configDefaults);
+  } else {
+    settingsSave(&configDefaults);
+  }
+  if(opened) {
+    if(!status) {
       Serial.println("Config file error, using default settings");
-      Serial.println(error.c_str());
+      configArenaUsed = 0;
+      exprRead(NULL);
     } else {
-      uint8_t e;
+      uint8_t        e;
+      configSection *g = &resolved.global;
 
       // Values common to both eyes or global program config...
-      stackReserve    = dwim(doc["stackReserve"], stackReserve),
-      eyeRadius       = dwim(doc["eyeRadius"]);
-      eyelidIndex     = dwim(doc["eyelidIndex"]);
-      irisRadius      = dwim(doc["irisRadius"]);
-      slitPupilRadius = dwim(doc["slitPupilRadius"]);
-      gazeMax         = dwim(doc["gazeMax"], gazeMax);
-      JsonVariant v;
-      v = doc["coverage"];
-      if(v.is<int>() || v.is<float>()) coverage = v.as<float>();
-      v = doc["upperEyelid"];
-      if(v.is<const char*>())    upperEyelidFilename = strdup(v);
-      v = doc["lowerEyelid"];
-      if(v.is<const char*>())    lowerEyelidFilename = strdup(v);
-
-      lightSensorMin   = doc["lightSensorMin"] | lightSensorMin;
-      lightSensorMax   = doc["lightSensorMax"] | lightSensorMax;
+      stackReserve    = intOr(g, CK_STACKRESERVE, stackReserve);
+      eyeRadius       = intOr(g, CK_EYERADIUS, 0);
+      eyelidIndex     = intOr(g, CK_EYELIDINDEX, 0);
+      irisRadius      = intOr(g, CK_IRISRADIUS, 0);
+      slitPupilRadius = intOr(g, CK_SLITPUPILRADIUS, 0);
+      gazeMax         = intOr(g, CK_GAZEMAX, gazeMax);
+      coverage        = floatOr(g, CK_COVERAGE, coverage);
+      if(isSet(g, CK_UPPEREYELID)) upperEyelidFilename = (char *)g->item[CK_UPPEREYELID].s;
+      if(isSet(g, CK_LOWEREYELID)) lowerEyelidFilename = (char *)g->item[CK_LOWEREYELID].s;
+      if(isSet(g, CK_EYELIDPOSES)) eyelidPosesDir      = (char *)g->item[CK_EYELIDPOSES].s;
+      if(isSet(g, CK_RECORDLOG))   recordLogFile       = (char *)g->item[CK_RECORDLOG].s;
+      if(isSet(g, CK_REPLAYLOG))   replayLogFile       = (char *)g->item[CK_REPLAYLOG].s;
+      // Expressions file is read now, not kept; no file when running from
+      // the snapshot means just idle. A reload's are used at the swap.
+      exprRead((configFromSnapshot || !isSet(g, CK_EXPRESSIONS)) ? NULL :
+        g->item[CK_EXPRESSIONS].s);
+
+      lightSensorMin   = intOr(g, CK_LIGHTSENSORMIN, lightSensorMin);
+      lightSensorMax   = intOr(g, CK_LIGHTSENSORMAX, lightSensorMax);
       if(lightSensorMin > 1023)   lightSensorMin = 1023;
       else if(lightSensorMin < 0) lightSensorMin = 0;
       if(lightSensorMax > 1023)   lightSensorMax = 1023;
@@ -123,7 +900,7 @@ void loadConfig(char *filename) {
         lightSensorMin = lightSensorMax;
         lightSensorMax = temp;
       }
-      lightSensorCurve = doc["lightSensorCurve"] | lightSensorCurve;
+      lightSensorCurve = floatOr(g, CK_LIGHTSENSORCURVE, lightSensorCurve);
       if(lightSensorCurve < 0.01) lightSensorCurve = 0.01;
 
       // The pupil size is represented somewhat differently in the code
@@ -133,8 +910,8 @@ void loadConfig(char *filename) {
       // to grasp. But in the code it's actually represented as irisMin
       // (the inverse of pupilMax as described above) and irisRange
       // (an amount added to irisMin which yields the inverse of pupilMin).
-      float pMax = doc["pupilMax"] | (1.0 - irisMin),
-            pMin = doc["pupilMin"] | (1.0 - (irisMin + irisRange));
+      float pMax = floatOr(g, CK_PUPILMAX, 1.0 - irisMin),
+            pMin = floatOr(g, CK_PUPILMIN, 1.0 - (irisMin + irisRange));
       if(pMin > 1.0)      pMin = 1.0;
       else if(pMin < 0.0) pMin = 0.0;
       if(pMax > 1.0)      pMax = 1.0;
@@ -147,147 +924,100 @@ void loadConfig(char *filename) {
       irisMin   = (1.0 - pMax);
       irisRange = (pMax - pMin);
 
-      lightSensorPin = doc["lightSensor"]   | lightSensorPin;
-      boopPin        = doc["boopSensor"]    | boopPin;
+      lightSensorPin = intOr(g, CK_LIGHTSENSOR, lightSensorPin);
+      boopPin        = intOr(g, CK_BOOPSENSOR,  boopPin);
 // Computed at startup, NOT from file now
 //      boopThreshold  = doc["boopThreshold"] | boopThreshold;
 
       // Values that can be distinct per-eye but have a common default...
-      uint16_t    pupilColor   = dwim(doc["pupilColor"] , eye[0].pupilColor),
-                  backColor    = dwim(doc["backColor"]  , eye[0].backColor),
-                  irisColor    = dwim(doc["irisColor"]  , eye[0].iris.color),
-                  scleraColor  = dwim(doc["scleraColor"], eye[0].sclera.color),
-                  irisMirror   = 0,
-                  scleraMirror = 0,
-                  irisAngle    = 0,
-                  scleraAngle  = 0,
-                  irisiSpin    = 0,
-                  scleraiSpin  = 0;
-      float       irisSpin     = 0.0,
-                  scleraSpin   = 0.0;
-      JsonVariant iristv       = doc["irisTexture"],
-                  scleratv     = doc["scleraTexture"];
-
-      rotation  = doc["rotate"] | rotation; // Screen rotation (GFX lib)
+      uint16_t pupilColor   = intOr(g, CK_PUPILCOLOR , eye[0].pupilColor),
+               backColor    = intOr(g, CK_BACKCOLOR  , eye[0].backColor),
+               irisColor    = intOr(g, CK_IRISCOLOR  , eye[0].iris.color),
+               scleraColor  = intOr(g, CK_SCLERACOLOR, eye[0].sclera.color),
+               irisMirror   = intOr(g, CK_IRISMIRROR , 0),
+               scleraMirror = intOr(g, CK_SCLERAMIRROR, 0),
+               irisiSpin    = intOr(g, CK_IRISISPIN  , 0),
+               scleraiSpin  = intOr(g, CK_SCLERAISPIN, 0);
+      float    irisSpin     = floatOr(g, CK_IRISSPIN  , 0.0),
+               scleraSpin   = floatOr(g, CK_SCLERASPIN, 0.0);
+
+      rotation  = intOr(g, CK_ROTATE, rotation); // Screen rotation (GFX lib)
       rotation &= 3;
 
-      v = doc["tracking"];
-      if(v.is<bool>()) tracking = v.as<bool>();
-      v = doc["squint"];
-      if(v.is<float>()) {
-        trackFactor = 1.0 - v.as<float>();
+      if(isSet(g, CK_TRACKING)) tracking = g->item[CK_TRACKING].i;
+      if(isSet(g, CK_SQUINT)) {
+        trackFactor = 1.0 - g->item[CK_SQUINT].f;
         if(trackFactor < 0.0)      trackFactor = 0.0;
         else if(trackFactor > 1.0) trackFactor = 1.0;
       }
 
-      // Convert clockwise int (0-1023) or float (0.0-1.0) values to CCW int used internally:
-      v = doc["irisSpin"];
-      if(v.is<float>()) irisSpin   = v.as<float>() * -1024.0;
-      v = doc["scleraSpin"];
-      if(v.is<float>()) scleraSpin = v.as<float>() * -1024.0;
-      v = doc["irisiSpin"];
-      if(v.is<int>()) irisiSpin    = v.as<int>();
-      v = doc["scleraiSpin"];
-      if(v.is<int>()) scleraiSpin  = v.as<int>();
-      v = doc["irisMirror"];
-      if(v.is<bool>() || v.is<int>()) irisMirror   = v ? 1023 : 0;
-      v = doc["scleraMirror"];
-      if(v.is<bool>() || v.is<int>()) scleraMirror = v ? 1023 : 0;
       for(e=0; e<NUM_EYES; e++) {
         eye[e].pupilColor    = pupilColor;
         eye[e].backColor     = backColor;
         eye[e].iris.color    = irisColor;
         eye[e].sclera.color  = scleraColor;
-        // The globally-set irisAngle and scleraAngle are read each
-        // time through because each eye has a distinct default if
-        // not set globally. Override only if set globally at first...
-        v = doc["irisAngle"];
-        if(v.is<int>())        irisAngle   = 1023 - (v.as<int>() & 1023);
-        else if(v.is<float>()) irisAngle   = 1023 - ((int)(v.as<float>() * 1024.0) & 1023);
-        else                   irisAngle   = eye[e].iris.angle;
-        eye[e].iris.angle    = eye[e].iris.startAngle   = irisAngle;
-        v = doc["scleraAngle"];
-        if(v.is<int>())        scleraAngle = 1023 - (v.as<int>() & 1023);
-        else if(v.is<float>()) scleraAngle = 1023 - ((int)(v.as<float>() * 1024.0) & 1023);
-        else                   scleraAngle = eye[e].sclera.angle;
-        eye[e].sclera.angle  = eye[e].sclera.startAngle = scleraAngle;
+        // Each eye has a distinct default angle if not set globally.
+        // Override only if set globally at first...
+        eye[e].iris.angle    = eye[e].iris.startAngle   =
+          intOr(g, CK_IRISANGLE, eye[e].iris.angle);
+        eye[e].sclera.angle  = eye[e].sclera.startAngle =
+          intOr(g, CK_SCLERAANGLE, eye[e].sclera.angle);
         eye[e].iris.mirror   = irisMirror;
         eye[e].sclera.mirror = scleraMirror;
         eye[e].iris.spin     = irisSpin;
         eye[e].sclera.spin   = scleraSpin;
         eye[e].iris.iSpin    = irisiSpin;
         eye[e].sclera.iSpin  = scleraiSpin;
-        // iris and sclera filenames are strdup'd for each eye rather than
-        // sharing a common pointer, reason being that it gets really messy
-        // below when overriding one or the other and trying to do the right
-        // thing with free/strdup. So this does waste a tiny bit of RAM but
-        // it's only the size of the filenames and only during init. NBD.
-        if(iristv.is<const char*>())   eye[e].iris.filename   = strdup(iristv);
-        if(scleratv.is<const char*>()) eye[e].sclera.filename = strdup(scleratv);
+        // Both eyes point at the same copy of the filename in the string
+        // arena; a per-eye setting below just points one elsewhere.
+        if(isSet(g, CK_IRISTEXTURE))   eye[e].iris.filename   = (char *)g->item[CK_IRISTEXTURE].s;
+        if(isSet(g, CK_SCLERATEXTURE)) eye[e].sclera.filename = (char *)g->item[CK_SCLERATEXTURE].s;
         eye[e].rotation = rotation; // Might get override in per-eye code below
       }
 
 #if NUM_EYES > 1
       // Process any distinct per-eye settings...
       // NOT EVERYTHING IS CONFIGURABLE PER-EYE. Color and texture stuff, yes.
-      // Other things like iris size or pupil shape are not, reason being that
+      // Iris size and pupil shape too (these only need small per-eye tables,
+      // see calcDistMap()). Eye size and coverage are not, reason being that
       // there isn't enough RAM for the polar angle/dist tables for two eyes.
       for(uint8_t e=0; e<NUM_EYES; e++) {
-        eye[e].pupilColor    = dwim(doc[eye[e].name]["pupilColor"]  , eye[e].pupilColor);
-        eye[e].backColor     = dwim(doc[eye[e].name]["backColor"]   , eye[e].backColor);
-        eye[e].iris.color    = dwim(doc[eye[e].name]["irisColor"]   , eye[e].iris.color);
-        eye[e].sclera.color  = dwim(doc[eye[e].name]["scleraColor"] , eye[e].sclera.color);
-        v = doc[eye[e].name]["irisAngle"];
-        if(v.is<int>())        eye[e].iris.angle   = 1023 - (v.as<int>()   & 1023);
-        else if(v.is<float>()) eye[e].iris.angle   = 1023 - ((int)(v.as<float>()  * 1024.0) & 1023);
-        eye[e].iris.startAngle = eye[e].iris.angle;
-        v = doc[eye[e].name]["scleraAngle"];
-        if(v.is<int>())        eye[e].sclera.angle = 1023 - (v.as<int>() & 1023);
-        else if(v.is<float>()) eye[e].sclera.angle = 1023 - ((int)(v.as<float>() * 1024.0) & 1023);
-        eye[e].sclera.startAngle = eye[e].sclera.angle;
-        v = doc[eye[e].name]["irisSpin"];
-        if(v.is<float>()) eye[e].iris.spin   = v.as<float>() * -1024.0;
-        v = doc[eye[e].name]["scleraSpin"];
-        if(v.is<float>()) eye[e].sclera.spin = v.as<float>() * -1024.0;
-        v = doc[eye[e].name]["irisiSpin"];
-        if(v.is<int>()) eye[e].iris.iSpin   = v.as<int>();
-        v = doc[eye[e].name]["scleraiSpin"];
-        if(v.is<int>()) eye[e].sclera.iSpin = v.as<int>();
-        v = doc[eye[e].name]["irisMirror"];
-        if(v.is<bool>() || v.is<int>()) eye[e].iris.mirror   = v ? 1023 : 0;
-        v = doc[eye[e].name]["scleraMirror"];
-        if(v.is<bool>() || v.is<int>()) eye[e].sclera.mirror = v ? 1023 : 0;
-        v = doc[eye[e].name]["irisTexture"];
-        if(v.is<const char*>()) {                           // Per-eye iris texture specified?
-          if(eye[e].iris.filename) free(eye[e].iris.filename); // Remove old name if any
-          eye[e].iris.filename = strdup(v);                    // Save new name
-        }
-        v = doc[eye[e].name]["scleraTexture"]; // Ditto w/sclera
-        if(v.is<const char*>()) {
-          if(eye[e].sclera.filename) free(eye[e].sclera.filename);
-          eye[e].sclera.filename = strdup(v);
-        }
-        eye[e].rotation  = doc[eye[e].name]["rotate"] | rotation;
+        configSection *p = eyeSection(&resolved, e);
+        if(!p) continue;
+        eye[e].pupilColor    = intOr(p, CK_PUPILCOLOR  , eye[e].pupilColor);
+        eye[e].backColor     = intOr(p, CK_BACKCOLOR   , eye[e].backColor);
+        eye[e].iris.color    = intOr(p, CK_IRISCOLOR   , eye[e].iris.color);
+        eye[e].sclera.color  = intOr(p, CK_SCLERACOLOR , eye[e].sclera.color);
+        eye[e].iris.angle    = eye[e].iris.startAngle   =
+          intOr(p, CK_IRISANGLE, eye[e].iris.angle);
+        eye[e].sclera.angle  = eye[e].sclera.startAngle =
+          intOr(p, CK_SCLERAANGLE, eye[e].sclera.angle);
+        eye[e].iris.spin     = floatOr(p, CK_IRISSPIN  , eye[e].iris.spin);
+        eye[e].sclera.spin   = floatOr(p, CK_SCLERASPIN, eye[e].sclera.spin);
+        eye[e].iris.iSpin    = intOr(p, CK_IRISISPIN   , eye[e].iris.iSpin);
+        eye[e].sclera.iSpin  = intOr(p, CK_SCLERAISPIN , eye[e].sclera.iSpin);
+        eye[e].iris.mirror   = intOr(p, CK_IRISMIRROR  , eye[e].iris.mirror);
+        eye[e].sclera.mirror = intOr(p, CK_SCLERAMIRROR, eye[e].sclera.mirror);
+        // Per-eye iris texture specified? Ditto w/sclera
+        if(isSet(p, CK_IRISTEXTURE))   eye[e].iris.filename   = (char *)p->item[CK_IRISTEXTURE].s;
+        if(isSet(p, CK_SCLERATEXTURE)) eye[e].sclera.filename = (char *)p->item[CK_SCLERATEXTURE].s;
+        eye[e].rotation  = intOr(p, CK_ROTATE, rotation);
         eye[e].rotation &= 3;
+        eye[e].irisRadius      = intOr(p, CK_IRISRADIUS, eye[e].irisRadius);
+        eye[e].slitPupilRadius = intOr(p, CK_SLITPUPILRADIUS, eye[e].slitPupilRadius);
       }
 #endif
 #if defined(ADAFRUIT_MONSTER_M4SK_EXPRESS)
-      v = doc["voice"];
-      if(v.is<bool>()) voiceOn = v.as<bool>();
-      currentPitch = defaultPitch = doc["pitch"] | defaultPitch;
-      gain = doc["gain"] | gain;
-      modulate = doc["modulate"] | modulate;
-      v = doc["waveform"];
-      if(v.is<const char*>()) { // If string...
-        if(!strncasecmp(     v, "sq", 2)) waveform = 1;
-        else if(!strncasecmp(v, "si", 2)) waveform = 2;
-        else if(!strncasecmp(v, "t" , 1)) waveform = 3;
-        else if(!strncasecmp(v, "sa", 2)) waveform = 4;
-        else                              waveform = 0;
-      }
+      if(isSet(g, CK_VOICE)) voiceOn = g->item[CK_VOICE].i;
+      currentPitch = defaultPitch = floatOr(g, CK_PITCH, defaultPitch);
+      gain      = floatOr(g, CK_GAIN, gain);
+      modulate  = intOr(g, CK_MODULATE, modulate);
+      waveform  = intOr(g, CK_WAVEFORM, waveform);
+      voiceMode = intOr(g, CK_VOICEMODE, voiceMode); // Used at voiceSetup()
 #endif // ADAFRUIT_MONSTER_M4SK_EXPRESS
+      Serial.printf("Config read in %d ms, %d bytes of strings\n",
+        millis() - t, configArenaUsed);
     }
-    file.close();
   } else {
     Serial.println("Can't open config file, using default settings");
   }
@@ -302,164 +1032,579 @@ void loadConfig(char *filename) {
   // purpose, because displacement effect looks worst at its extremes...this
   // allows the pupil to move close to the edge of the display while keeping
   // a few pixels distance from the displacement limits.
-  if(!eyeRadius) eyeRadius = DISPLAY_SIZE/2 + 5;
-  else           eyeRadius = abs(eyeRadius);
+  eyeRadius    = planEyeRadius(eyeRadius, DISPLAY_SIZE); // MemPlan.h
   eyeDiameter  = eyeRadius * 2;
   eyelidIndex &= 0xFF;      // From table: learn.adafruit.com/assets/61921
   eyelidColor  = eyelidIndex * 0x0101; // Expand eyelidIndex to 16-bit RGB
 
-  if(!irisRadius) irisRadius = DISPLAY_SIZE/4; // Size in screen pixels
-  else            irisRadius = abs(irisRadius);
+  irisRadius      = planIrisRadius(irisRadius, DISPLAY_SIZE); // Screen pixels
   slitPupilRadius = abs(slitPupilRadius);
   if(slitPupilRadius > irisRadius) slitPupilRadius = irisRadius;
+  // Per-eye iris & pupil inherit the above unless set in eye's section
+  for(uint8_t e=0; e<NUM_EYES; e++) {
+    if(!eye[e].irisRadius) eye[e].irisRadius = irisRadius;
+    else                   eye[e].irisRadius = abs(eye[e].irisRadius);
+    if(eye[e].slitPupilRadius < 0) eye[e].slitPupilRadius = slitPupilRadius;
+    if(eye[e].slitPupilRadius > eye[e].irisRadius) {
+      eye[e].slitPupilRadius = eye[e].irisRadius;
+    }
+  }
 
   if(coverage < 0.0)      coverage = 0.0;
   else if(coverage > 1.0) coverage = 1.0;
-  mapRadius   = (int)(eyeRadius * M_PI * coverage + 0.5);
+  mapRadius   = planMapRadius(eyeRadius, coverage);
   mapDiameter = mapRadius * 2;
+
+  if(configReload) {
+    settingsSave(&configStaged);
+    settingsUse(&running);
+  } else {
+    exprUse();
+  }
+
+  return status;
 }
 
 // EYELID AND TEXTURE MAP FILE HANDLING ------------------------------------
 
-// Load one eyelid, convert bitmap to 2 arrays (min, max values per column).
-// Pass in filename, destination arrays (mins, maxes, 240 elements each).
-ImageReturnCode loadEyelid(char *filename,
-  uint8_t *minArray, uint8_t *maxArray, uint8_t init, uint32_t maxRam) {
-  Adafruit_Image  image; // Image object is on stack, pixel data is on heap
-  int32_t         w, h;
-  uint32_t        tempBytes;
-  uint8_t        *tempPtr = NULL;
-  ImageReturnCode status;
-  Adafruit_ImageReader *reader;
+// Images are read by a minimal BMP reader straight from the file, a row at
+// a time, into the image scratch arena (see memory.cpp) rather than by
+// Adafruit_ImageReader, which makes its own heap allocations per image
+// and was at the root of the old fragmentation trouble. Uncompressed
+// 24-bit (textures) and 1-bit (eyelids) only, as used in eyes/.
 
-  yield();
-  reader = arcada.getImageReader();
-  if (!reader) {
-     return IMAGE_ERR_FILE_NOT_FOUND;
-  }
+typedef struct {
+  int32_t  width, height; // height < 0 if rows are stored top-down
+  uint16_t depth;         // Bits per pixel
+  uint32_t offset;        // File position of first row
+  uint32_t stride;        // Bytes per row in file (padded to 4)
+  uint16_t palette[2];    // 1-bit images, as RGB565
+} bmpInfo;
 
-  memset(minArray, init, DISPLAY_SIZE); // Fill eyelid arrays with init value to
-  memset(maxArray, init, DISPLAY_SIZE); // mark 'no eyelid data for this column'
+static uint32_t le32(const uint8_t *p) {
+  return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
 
-  // This is the "booster seat" described in m4eyes.ino
-  yield();
-  if(reader->bmpDimensions(filename, &w, &h) == IMAGE_SUCCESS) {
-    tempBytes = ((w + 7) / 8) * h; // Bitmap size in bytes
-    if (maxRam > tempBytes) {
-      if((tempPtr = (uint8_t *)malloc(maxRam - tempBytes)) != NULL) {
-        // Make SOME tempPtr reference, or optimizer removes the alloc!
-        tempPtr[0] = 0;
+// Open BMP and read its header. On success the file is left open.
+static ImageReturnCode bmpOpen(const char *filename, File &file,
+  bmpInfo *bmp) {
+  uint8_t h[54];
+  if(!filename || !fileReady(filename) ||
+     !(file = arcada.open(filename, FILE_READ))) return IMAGE_ERR_FILE_NOT_FOUND;
+  if((file.read(h, sizeof h) == sizeof h) && (h[0] == 'B') && (h[1] == 'M')) {
+    bmp->offset = le32(&h[10]);
+    bmp->width  = le32(&h[18]);
+    bmp->height = le32(&h[22]);
+    bmp->depth  = h[28] | (h[29] << 8);
+    if(((h[26] | (h[27] << 8)) == 1) && !le32(&h[30]) && // 1 plane, no compression
+       ((bmp->depth == 24) || (bmp->depth == 1)) &&
+       (bmp->width > 0) && bmp->height) {
+      bmp->stride = (bmp->width * bmp->depth + 31) / 32 * 4;
+      if(bmp->depth == 1) {  // Palette (BGRx) follows the info header
+        uint8_t p[8];
+        file.seek(14 + le32(&h[14]));
+        file.read(p, sizeof p);
+        for(uint8_t i=0; i<2; i++) {
+          bmp->palette[i] = ((p[i*4+2] & 0xF8) << 8) | ((p[i*4+1] & 0xFC) << 3) |
+                            (p[i*4] >> 3);
+        }
       }
+      return IMAGE_SUCCESS;
     }
-    // DON'T nest the image-reading case in here. If the fragmentation
-    // culprit can be found, this block of code (and the free() block
-    // later) are easily removed.
   }
+  file.close();
+  return IMAGE_ERR_FORMAT;
+}
+
+// Image scratch bytes needed to load image (0 if it can't be read)
+uint32_t imageScratch(const char *filename) {
+  File    file;
+  bmpInfo bmp;
+  if(bmpOpen(filename, file, &bmp) != IMAGE_SUCCESS) return 0;
+  file.close();
+  return planImageScratch(bmp.width, bmp.height, bmp.depth, bmp.stride,
+    DISPLAY_SIZE);
+}
+
+// Load one eyelid, convert bitmap to 2 arrays (min, max values per column,
+// 8.8 fixed point, see LidEdge.h). Pass in filename, destination arrays (mins,
+// maxes, 240 elements each) and value (whole rows) for columns without data.
+ImageReturnCode loadEyelid(char *filename,
+  uint16_t *minArray, uint16_t *maxArray, uint8_t init) {
+  File            file;
+  bmpInfo         bmp;
+  ImageReturnCode status;
+  uint8_t        *row, *miny, *maxy;
 
   yield();
-  if((status = reader->loadBMP(filename, image)) == IMAGE_SUCCESS) {
-    if(image.getFormat() == IMAGE_1) { // MUST be 1-bit image
-      uint16_t *palette = image.getPalette();
-      uint8_t   white = (!palette || (palette[1] > palette[0]));
-      int       x, y, ix, iy, sx1, sx2, sy1, sy2;
-      // Center/clip eyelid image with respect to screen...
-      sx1 = (DISPLAY_SIZE - image.width()) / 2;  // leftmost pixel, screen space
-      sy1 = (DISPLAY_SIZE - image.height()) / 2; // topmost pixel, screen space
-      sx2 = sx1 + image.width() - 1;    // rightmost pixel, screen space
-      sy2 = sy1 + image.height() - 1;   // lowest pixel, screen space
-      ix  = -sx1;                       // leftmost pixel, image space
-      iy  = -sy1;                       // topmost pixel, image space
-      if(sx1 <   0) sx1 =   0;          // image wider than screen
-      if(sy1 <   0) sy1 =   0;          // image taller than screen
-      if(sx2 > (DISPLAY_SIZE-1)) sx2 = DISPLAY_SIZE - 1; // image wider than screen
-      if(sy2 > (DISPLAY_SIZE-1)) sy2 = DISPLAY_SIZE - 1; // image taller than screen
-      if(ix   <   0) ix   =   0;        // image narrower than screen
-      if(iy   <   0) iy   =   0;        // image shorter than screen
-
-      GFXcanvas1 *canvas = (GFXcanvas1 *)image.getCanvas();
-      uint8_t    *buffer = canvas->getBuffer();
-      int         bytesPerLine = (image.width() + 7) / 8;
-      for(x=sx1; x <= sx2; x++, ix++) { // For each column...
-        yield();
-        // Get initial pointer into image buffer
-        uint8_t *ptr  = &buffer[iy * bytesPerLine + ix / 8];
-        uint8_t  mask = 0x80 >> (ix & 7); // Column mask
-        uint8_t  wbit = white ? mask : 0; // Bit value for white pixel
-        int      miny = 255, maxy;
-        for(y=sy1; y<=sy2; y++, ptr += bytesPerLine) {
-          if((*ptr & mask) == wbit) { // Is pixel set?
-            if(miny == 255) miny = y; // If 1st set pixel, set miny
-            maxy = y;                 // If set pixel at all, set max
+  for(int x=0; x<DISPLAY_SIZE; x++) {   // Fill eyelid arrays with init value to
+    minArray[x] = maxArray[x] = init << 8; // mark 'no eyelid data for this column'
+  }
+
+  if((status = bmpOpen(filename, file, &bmp)) != IMAGE_SUCCESS) return status;
+  if(bmp.depth != 1) {                  // MUST be 1-bit image
+    status = IMAGE_ERR_FORMAT;
+  } else if(!(row  = (uint8_t *)scratchAlloc(bmp.stride)) ||
+            !(miny = (uint8_t *)scratchAlloc(DISPLAY_SIZE)) ||
+            !(maxy = (uint8_t *)scratchAlloc(DISPLAY_SIZE))) {
+    status = IMAGE_ERR_MALLOC;
+  } else {
+    int     h     = abs(bmp.height);
+    uint8_t white = (bmp.palette[1] > bmp.palette[0]); // Bit value for white
+    // Center/clip eyelid image with respect to screen. Image pixel (ix,iy)
+    // is screen pixel (ix+sx,iy+sy).
+    int     sx  = (DISPLAY_SIZE - bmp.width) / 2,
+            sy  = (DISPLAY_SIZE - h) / 2,
+            sx1 = max(sx, 0), sx2 = min(sx + (int)bmp.width, DISPLAY_SIZE) - 1;
+    memset(miny, 255, DISPLAY_SIZE);    // 255 = no set pixel in column (yet)
+    file.seek(bmp.offset);
+    for(int r=0; r<h; r++) {            // For each row, in file order...
+      yield();
+      if(file.read(row, bmp.stride) != (int)bmp.stride) {
+        status = IMAGE_ERR_FORMAT;      // Truncated file
+        break;
+      }
+      int y = ((bmp.height > 0) ? (h - 1 - r) : r) + sy; // Screen row
+      if((y < 0) || (y >= DISPLAY_SIZE)) continue;
+      for(int x=sx1; x<=sx2; x++) {
+        int ix = x - sx;
+        if(((row[ix >> 3] >> (7 - (ix & 7))) & 1) == white) { // Pixel set?
+          if(miny[x] == 255) {          // First in column
+            miny[x] = maxy[x] = y;
+          } else if(y < miny[x]) {
+            miny[x] = y;
+          } else if(y > maxy[x]) {
+            maxy[x] = y;
           }
         }
-        if(miny != 255) {
+      }
+    }
+    if(status == IMAGE_SUCCESS) {
+      for(int x=0; x<DISPLAY_SIZE; x++) {
+        if(miny[x] != 255) {
           // Because of coordinate system used later (screen rotated),
           // min/max and Y coordinates are flipped before storing...
-          maxArray[x] = DISPLAY_SIZE - 1 - miny;
-          minArray[x] = DISPLAY_SIZE - 1 - maxy;
+          uint8_t y = miny[x];
+          miny[x]   = DISPLAY_SIZE - 1 - maxy[x];
+          maxy[x]   = DISPLAY_SIZE - 1 - y;
         }
       }
-    } else {
-      status = IMAGE_ERR_FORMAT; // Don't just return, need to dealloc...
+      lidEdge(miny, miny, minArray, DISPLAY_SIZE);
+      lidEdge(miny, maxy, maxArray, DISPLAY_SIZE);
     }
   }
-
-  if(tempPtr) {
-    free(tempPtr);
-  }
-  // image destructor will handle dealloc of that object's data
-
+  file.close();
+  scratchReset();
   return status;
 }
 
 ImageReturnCode loadTexture(char *filename, uint16_t **data,
-  uint16_t *width, uint16_t *height, uint32_t maxRam) {
-  Adafruit_Image  image; // Image object is on stack, pixel data is on heap
-  int32_t         w, h;
-  uint32_t        tempBytes;
-  uint8_t        *tempPtr = NULL;
+  uint16_t *width, uint16_t *height) {
+  File            file;
+  bmpInfo         bmp;
   ImageReturnCode status;
-  Adafruit_ImageReader *reader;
+  uint16_t       *pixels;
+  uint8_t        *row;
 
   yield();
-  reader = arcada.getImageReader();
-  if (!reader) {
-     return IMAGE_ERR_FILE_NOT_FOUND;
-  }
-  
-  // This is the "booster seat" described in m4eyes.ino
-  if(reader->bmpDimensions(filename, &w, &h) == IMAGE_SUCCESS) {
-    tempBytes = w * h * 2; // Image size in bytes (converted to 16bpp)
-    if (maxRam > tempBytes) {
-      if((tempPtr = (uint8_t *)malloc(maxRam - tempBytes)) != NULL) {
-        // Make SOME tempPtr reference, or optimizer removes the alloc!
-        tempPtr[0] = 0;
+  if((status = bmpOpen(filename, file, &bmp)) != IMAGE_SUCCESS) return status;
+  int h = abs(bmp.height);
+  if(bmp.depth != 24) {                 // MUST be 24-bit image
+    status = IMAGE_ERR_FORMAT;
+  } else if(!(pixels = (uint16_t *)scratchAlloc(bmp.width * h * 2)) ||
+            !(row    = (uint8_t  *)scratchAlloc(bmp.stride))) {
+    status = IMAGE_ERR_MALLOC;
+  } else {
+    file.seek(bmp.offset);
+    for(int r=0; r<h; r++) {            // For each row, in file order...
+      yield();
+      if(file.read(row, bmp.stride) != (int)bmp.stride) {
+        status = IMAGE_ERR_FORMAT;      // Truncated file
+        break;
+      }
+      uint16_t *dst = &pixels[((bmp.height > 0) ? (h - 1 - r) : r) * bmp.width];
+      uint8_t  *src = row;              // B, G, R
+      for(int x=0; x<bmp.width; x++, src += 3) {
+        uint16_t rgb = ((src[2] & 0xF8) << 8) | ((src[1] & 0xFC) << 3) |
+                       (src[0] >> 3);
+        dst[x] = __builtin_bswap16(rgb); // Match screen endianism for direct DMA xfer
       }
     }
-    // DON'T nest the image-reading case in here. If the fragmentation
-    // culprit can be found, this block of code (and the free() block
-    // later) are easily removed.
-  }
-
-  yield();
-  if((status = reader->loadBMP(filename, image)) == IMAGE_SUCCESS) {
-    if(image.getFormat() == IMAGE_16) { // MUST be 16-bit image
+    if(status == IMAGE_SUCCESS) {
       Serial.println("Texture loaded!");
-      GFXcanvas16 *canvas = (GFXcanvas16 *)image.getCanvas();
-      canvas->byteSwap(); // Match screen endianism for direct DMA xfer
-      *width  = image.width();
-      *height = image.height();
-      *data = (uint16_t *)arcada.writeDataToFlash((uint8_t *)canvas->getBuffer(),
+      *width  = bmp.width;
+      *height = h;
+      *data = (uint16_t *)arcada.writeDataToFlash((uint8_t *)pixels,
         (int)*width * (int)*height * 2);
-    } else {
-      status = IMAGE_ERR_FORMAT; // Don't just return, need to dealloc...
     }
   }
+  file.close();
+  scratchReset(); // Image is in flash now (or failed), scratch is free again
+  return status;
+}
+
+// BACKGROUND LOADING & LIVE CONFIG RELOAD ---------------------------------
+
+// When the config file changes (e.g. edited over USB mass storage), it's
+// re-read while the eyes keep animating, and only the tables and images
+// that depend on changed settings are regenerated: an eye's iris/pupil
+// tables if its irisRadius or slitPupilRadius changed, textures and
+// eyelids if their filenames changed. New tables are built on the side
+// and swapped in at the start of each eye's next frame (see loop()).
+// Changes to eyeRadius or coverage affect the big shared polar tables,
+// there isn't RAM to build those on the side, so that case restarts.
+// The same steps do the initial load at startup (startBackgroundLoad()),
+// plus the polar and displacement tables a few rows at a time, while a
+// flat-color placeholder eye animates right away instead of a blank
+// screen. A step may still take a while (e.g. one texture image), but
+// animation carries on between steps.
+// Rows per step for the tables are in MemPlan.h.
+
+#define FS_POLL_INTERVAL 1000000 // Check config file stamp once per sec.
+
+// Cheap identity for a filename, so the names themselves can be freed
+// after loading and compared against a later config anyway.
+static uint32_t filenameHash(const char *filename) {
+  if(!filename) return 0;
+  uint32_t hash = 2166136261UL;  // FNV-1a
+  while(*filename) {
+    hash ^= (uint8_t)*filename++;
+    hash *= 16777619UL;
+  }
+  return hash ? hash : 1;        // 0 is reserved for 'no file'
+}
 
-  if(tempPtr) {
-    free(tempPtr);
+// Size and modification date/time of a file, 0 if not found
+static uint32_t fileStamp(const char *filename) {
+  File     file;
+  uint32_t stamp = 0;
+  uint16_t date = 0, time = 0;
+  if(filename && (file = arcada.open(filename, FILE_READ))) {
+    file.getModifyDateTime(&date, &time);
+    stamp = (file.size() ^ ((uint32_t)date << 16 | time)) | 1;
+    file.close();
   }
-  // image destructor will handle dealloc of that object's data
+  return stamp;
+}
 
-  return status;
+enum { RELOAD_IDLE, RELOAD_CONFIG, RELOAD_SCRATCH, RELOAD_TEXTURES,
+       RELOAD_EYELIDS, RELOAD_SHAPES, RELOAD_MAP, RELOAD_DISPLACE, RELOAD_SWAP,
+       RELOAD_WAIT };
+
+static struct {
+  uint8_t   step;              // RELOAD_* state, one step per call
+  uint8_t   item;              // Texture counter within RELOAD_TEXTURES
+  bool      boot;              // true = startup load, load everything
+  int       row;               // Table row within RELOAD_MAP/DISPLACE
+  uint32_t  lastPoll;          // micros() at last fileStamp() check
+  uint32_t  pendingStamp;      // Changed stamp, waiting to settle
+  uint32_t  irisHash[NUM_EYES], scleraHash[NUM_EYES];
+  uint32_t  upperHash, lowerHash, posesHash;
+  int       irisRadius[NUM_EYES], slitPupilRadius[NUM_EYES];
+  // Staged data, applied by applyReload() at frame start:
+  texture   iris[NUM_EYES], sclera[NUM_EYES];
+  bool      newIris[NUM_EYES], newSclera[NUM_EYES], newShape[NUM_EYES];
+  irisShape shape[NUM_EYES];
+  uint16_t *lids;              // lidStage if eyelids staged, else NULL
+  bool      poses;             // Eyelid poses loaded
+  bool      settings;          // configStaged, expressions read
+} reload;
+
+// Staged eyelids: upperOpen/Closed, lowerOpen/Closed. Static, so staging
+// doesn't put a small block in the middle of the memory plan.
+static uint16_t lidStage[MAX_DISPLAY_SIZE * 4];
+
+// Loading works from configStaged, the settings being loaded for (same as
+// running ones at startup), until they're swapped in.
+
+// Eyelid images need (re)loading?
+static bool lidsChanged(void) {
+  return reload.boot ||
+    (filenameHash(configStaged.upperEyelid) != reload.upperHash) ||
+    (filenameHash(configStaged.lowerEyelid) != reload.lowerHash) ||
+    (filenameHash(configStaged.eyelidPoses) != reload.posesHash);
+}
+
+static char *upperEyelidFile(void) {
+  return configStaged.upperEyelid ? configStaged.upperEyelid : (char *)"upper.bmp";
+}
+
+static char *lowerEyelidFile(void) {
+  return configStaged.lowerEyelid ? configStaged.lowerEyelid : (char *)"lower.bmp";
+}
+
+// Called once everything is loaded, BEFORE the filenames are freed.
+// Notes what's in use so later config changes can be compared.
+void recordLoadedAssets(void) {
+  for(uint8_t e=0; e<NUM_EYES; e++) {
+    eyeSettings *p            = &configStaged.eye[e];
+    reload.irisHash[e]        = filenameHash(p->iris.filename);
+    reload.scleraHash[e]      = filenameHash(p->sclera.filename);
+    reload.irisRadius[e]      = p->irisRadius;
+    reload.slitPupilRadius[e] = p->slitPupilRadius;
+  }
+  reload.upperHash       = filenameHash(configStaged.upperEyelid);
+  reload.lowerHash       = filenameHash(configStaged.lowerEyelid);
+  reload.posesHash       = filenameHash(configStaged.eyelidPoses);
+  reload.step            = RELOAD_IDLE;
+  filesystem_change_flag = false; // Startup load IS the 'changed' task
+}
+
+// Called once per frame in SPI quiet time. Sets filesystem_change_flag
+// when the config file stamp has changed and held steady for one poll
+// interval (so a file that's still being copied isn't read half-done).
+void checkFilesystemChange(uint32_t t) {
+  if((t - reload.lastPoll) < FS_POLL_INTERVAL) return;
+  reload.lastPoll = t;
+  uint32_t stamp  = configFilesStamp(configFile);
+  if(stamp == configStamp) {
+    reload.pendingStamp = 0;
+  } else if(stamp && (stamp == reload.pendingStamp)) {
+    filesystem_change_flag = true;
+  } else {
+    reload.pendingStamp = stamp;
+  }
+}
+
+// Load one texture for live reload. Shares image with an earlier eye's
+// staged texture if same file, same as startup does.
+static void reloadTexture(texture *staged, char *filename, uint16_t *color) {
+  if(filename) {
+    for(uint8_t e2=0; e2<NUM_EYES; e2++) {
+      texture *t = &reload.iris[e2];
+      for(uint8_t i=0; i<2; i++, t = &reload.sclera[e2]) {
+        if((t != staged) && t->filename && !strcmp(t->filename, filename)
+          && t->data) {
+          staged->data   = t->data;
+          staged->width  = t->width;
+          staged->height = t->height;
+          return;
+        }
+      }
+    }
+    yield();
+    // Image goes to not-yet-used flash (old one's still on screen). If
+    // that runs out after many reloads, or it doesn't fit in the image
+    // scratch RAM, it falls back to plain color.
+    ImageReturnCode status = loadTexture(filename, &staged->data,
+      &staged->width, &staged->height);
+    memoryPhase(filename);
+    if((status == IMAGE_SUCCESS) && staged->data) return;
+  }
+  // No file or load failed, 1px of color, same as startup
+  staged->data  = color;
+  staged->width = staged->height = 1;
+}
+
+// Called once per frame (in SPI quiet time) while filesystem_change_flag
+// is set. Does ONE step of the reload each call so animation continues.
+void handle_filesystem_change() {
+  uint8_t e;
+  switch(reload.step) {
+   case RELOAD_IDLE:
+    reload.step = RELOAD_CONFIG;
+    break;
+   case RELOAD_CONFIG: {
+    Serial.println("Config changed, reloading");
+    // New settings go to configStaged, the running ones aren't touched
+    configReload = true;
+    bool loaded  = loadConfig((char *)configFile);
+    configReload = false;
+    if(!loaded) {
+      // Probably mid-copy. Leave current eyes alone, try again later.
+      filesystem_change_flag = false;
+      reload.step            = RELOAD_IDLE;
+      return;
+    }
+    if((configStaged.eyeRadius != eyeRadius) || (configStaged.coverage != coverage)) {
+      Serial.println("Eye size changed, restarting");
+      delay(100); // Let Serial finish
+      NVIC_SystemReset();
+    }
+    for(e=0; e<NUM_EYES; e++) {
+      eyeSettings *p      = &configStaged.eye[e];
+      reload.newIris[e]   = (filenameHash(p->iris.filename)   != reload.irisHash[e]);
+      reload.newSclera[e] = (filenameHash(p->sclera.filename) != reload.scleraHash[e]);
+      reload.newShape[e]  = (p->irisRadius      != reload.irisRadius[e]) ||
+                            (p->slitPupilRadius != reload.slitPupilRadius[e]);
+      reload.iris[e].filename   = reload.newIris[e]   ? p->iris.filename   : NULL;
+      reload.sclera[e].filename = reload.newSclera[e] ? p->sclera.filename : NULL;
+      reload.iris[e].data       = reload.sclera[e].data = NULL;
+    }
+    reload.settings = true;
+    reload.item   = 0;
+    reload.step   = RELOAD_SCRATCH;
+    break;
+   }
+   case RELOAD_SCRATCH: {
+    // Set aside image scratch RAM for the largest image to be loaded
+    uint32_t need = 0, n;
+    for(e=0; e<NUM_EYES; e++) {
+      if(reload.newIris[e] && ((n = imageScratch(reload.iris[e].filename)) > need)) need = n;
+      if(reload.newSclera[e] && ((n = imageScratch(reload.sclera[e].filename)) > need)) need = n;
+    }
+    if(lidsChanged() && !configFromSnapshot) {
+      if((n = imageScratch(upperEyelidFile())) > need) need = n;
+      if((n = imageScratch(lowerEyelidFile())) > need) need = n;
+      if((n = lidPosesScratch(configStaged.eyelidPoses)) > need) need = n;
+    }
+    if(need) scratchBegin(need);
+    reload.item = 0;
+    reload.step = RELOAD_TEXTURES;
+    break;
+   }
+   case RELOAD_TEXTURES:
+    // One texture per call: iris 0, sclera 0, iris 1, sclera 1...
+    while(reload.item < NUM_EYES * 2) {
+      e = reload.item / 2;
+      bool isIris = !(reload.item++ & 1);
+      if(isIris && reload.newIris[e]) {
+        reloadTexture(&reload.iris[e], reload.iris[e].filename, &eye[e].iris.color);
+        return;
+      } else if(!isIris && reload.newSclera[e]) {
+        reloadTexture(&reload.sclera[e], reload.sclera[e].filename, &eye[e].sclera.color);
+        return;
+      }
+    }
+    reload.step = RELOAD_EYELIDS;
+    break;
+   case RELOAD_EYELIDS:
+    if(lidsChanged()) {
+      uint16_t *uo = reload.lids = lidStage, *uc = &uo[DISPLAY_SIZE],
+               *lo = &lidStage[DISPLAY_SIZE * 2], *lc = &lo[DISPLAY_SIZE];
+      // Config from snapshot means no filesystem, eyelids are there too
+      if(!configFromSnapshot || !snapshotLids(reload.lids)) {
+        loadEyelid(upperEyelidFile(), uc, uo, DISPLAY_SIZE-1);
+        loadEyelid(lowerEyelidFile(), lo, lc, 0);
+      }
+      lidPosesLoad(configFromSnapshot ? NULL : configStaged.eyelidPoses);
+      reload.poses = true;
+    }
+    scratchEnd(); // All images done, heap is back as it was
+    memoryPhase("eyelids");
+    reload.step = RELOAD_SHAPES;
+    break;
+   case RELOAD_SHAPES:
+    tablesBegin(); // First time only
+    for(e=0; e<NUM_EYES; e++) {
+      if(reload.newShape[e]) {
+        reload.shape[e].slitMap = NULL;
+        calcDistMap(&reload.shape[e], configStaged.eye[e].irisRadius,
+          configStaged.eye[e].slitPupilRadius);
+      }
+    }
+    reload.row  = 0;
+    reload.step = reload.boot ? RELOAD_MAP : RELOAD_SWAP;
+    break;
+   case RELOAD_MAP: // Startup only, shared tables are made once
+    if((reload.row = calcMap(reload.row, MAP_ROWS_PER_STEP)) >= mapRadius) {
+      memoryPhase("calcMap");
+      reload.row  = 0;
+      reload.step = RELOAD_DISPLACE;
+    }
+    break;
+   case RELOAD_DISPLACE:
+    reload.row = calcDisplacement(reload.row, DISPLACE_ROWS_PER_STEP);
+    if(reload.row >= (DISPLAY_SIZE/2)) {
+      memoryPhase("calcDisplace");
+      reload.step = RELOAD_SWAP;
+    }
+    break;
+   case RELOAD_SWAP:
+    // Everything's staged. Note new state and let loop() swap it in.
+    recordLoadedAssets();
+    filesystem_change_flag = true; // Not done until swapped
+    reload.step            = RELOAD_WAIT;
+    reloadPending          = (1 << NUM_EYES) - 1;
+    break;
+   case RELOAD_WAIT:
+    if(!reloadPending) {
+      // All eyes have switched over. Filenames no longer needed.
+      configArenaRelease();
+      if(reload.boot) {
+        Serial.printf("Full quality at %d ms\n", millis());
+        Serial.printf("Free RAM: %d\n", availableRAM());
+        memoryReport();
+        saveSnapshot();
+      } else {
+        Serial.println("Reload done");
+      }
+      reload.boot            = false;
+      reload.settings        = false;
+      reload.step            = RELOAD_IDLE;
+      filesystem_change_flag = false;
+    }
+    break;
+  }
+}
+
+// Called at the start of an eye's frame when its bit in reloadPending is
+// set, so new tables never change partway through drawing an eye.
+void applyReload(uint8_t e) {
+  if(reload.settings) {
+    if(!e) { // Global settings and expressions change with first eye
+      settingsUseGlobal(&configStaged);
+      exprUse();
+    }
+    settingsUseEye(&configStaged, e);
+  }
+  if(reload.newIris[e]) {
+    eye[e].iris.data   = reload.iris[e].data;
+    eye[e].iris.width  = reload.iris[e].width;
+    eye[e].iris.height = reload.iris[e].height;
+  }
+  if(reload.newSclera[e]) {
+    eye[e].sclera.data   = reload.sclera[e].data;
+    eye[e].sclera.width  = reload.sclera[e].width;
+    eye[e].sclera.height = reload.sclera[e].height;
+  }
+  if(reload.newShape[e]) {
+    uint8_t *oldSlit = eye[e].shape.slitMap;
+    eye[e].shape = reload.shape[e];
+    if(oldSlit) slitFree(oldSlit);
+  }
+  if(!e && reload.lids) { // Eyelids are shared, swap with first eye
+    memcpy(upperOpen  , reload.lids                   , LID_BYTES / 4);
+    memcpy(upperClosed, &reload.lids[DISPLAY_SIZE]    , LID_BYTES / 4);
+    memcpy(lowerOpen  , &reload.lids[DISPLAY_SIZE * 2], LID_BYTES / 4);
+    memcpy(lowerClosed, &reload.lids[DISPLAY_SIZE * 3], LID_BYTES / 4);
+    reload.lids = NULL;
+  }
+  if(!e && reload.poses) {
+    lidPosesUse();
+    reload.poses = false;
+  }
+  eye[e].placeholder = !(polarAngle && displace); // Tables may not fit
+  reloadPending     &= ~(1 << e);
+}
+
+// Called by setup() after loadConfig(). Eyes start out as placeholders
+// (flat colors, no tables needed) and loop() runs the loading steps
+// above in the gaps between column transfers.
+void startBackgroundLoad(void) {
+  settingsSave(&configStaged); // What's loaded for, already in use
+  for(uint8_t e=0; e<NUM_EYES; e++) {
+    eye[e].placeholder  = true;
+    eye[e].iris.data    = &eye[e].iris.color; // 1px until loaded
+    eye[e].sclera.data  = &eye[e].sclera.color;
+    eye[e].iris.width   = eye[e].iris.height   = 1;
+    eye[e].sclera.width = eye[e].sclera.height = 1;
+    reload.newIris[e]   = (eye[e].iris.filename   != NULL);
+    reload.newSclera[e] = (eye[e].sclera.filename != NULL);
+    reload.newShape[e]  = true;
+    reload.iris[e].filename   = eye[e].iris.filename;
+    reload.sclera[e].filename = eye[e].sclera.filename;
+    reload.iris[e].data       = reload.sclera[e].data = NULL;
+    reload.shape[e].slitMap   = NULL;
+  }
+  // Simple open/close lids until eyelid images are loaded
+  for(int x=0; x<DISPLAY_SIZE; x++) {
+    upperOpen[x]   = (DISPLAY_SIZE - 1) << 8;
+    upperClosed[x] = lowerClosed[x] = (DISPLAY_SIZE / 2) << 8;
+    lowerOpen[x]   = 0;
+  }
+  reload.boot            = true;
+  reload.item            = 0;
+  reload.step            = RELOAD_SCRATCH;
+  filesystem_change_flag = true;
 }
@@ -0,0 +1,251 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+//34567890123456789012345678901234567890123456789012345678901234567890123456
+
+#include "globals.h"
+#include "ExpressionBlend.h"
+
+// GAZE PLANNER ------------------------------------------------------------
+
+// Autonomous eye movement: big saccades every so often, microsaccades in
+// between, each an eased move then a hold. Same behavior as the original
+// code in loop(), made cheaper:
+//
+// - The 3e^2-2e^3 easing curve is a table, built once. Each move works
+//   out 1/duration when it starts, so a frame in motion is a multiply,
+//   a table lookup and blend, and a 64-bit multiply per axis, all
+//   integer. Positions are 16.16 fixed point in map pixels.
+// - Targets come from a table of points spread evenly over a unit disc
+//   (a sunflower spiral), so a new saccade is one random number and a
+//   scale, no sqrt() and no float random ranges.
+//
+// User code can also queue up targets with gazeQueue(): they're taken in
+// order in place of random saccades (moveEyesRandomly or not), each with
+// its own move and hold time, then random movement carries on.
+
+#define GAZE_CURVE_BITS 6                    // 64 segments
+#define GAZE_CURVE      (1 << GAZE_CURVE_BITS)
+#define GAZE_DISC       256                  // Target points
+#define GAZE_QUEUE      8                    // Scripted targets
+
+typedef struct {
+  int16_t  x, y;     // -32767 to 32767 = -1.0 to 1.0, as eyeTargetX/Y
+  uint32_t moveTime; // micros
+  uint32_t holdTime; // micros
+} gazeTarget;
+
+static uint16_t   curve[GAZE_CURVE + 1];           // 0-65535 eased
+static int8_t     discX[GAZE_DISC], discY[GAZE_DISC]; // +-127 = radius
+static bool       gazeReady = false;
+
+static int32_t    fromX, fromY, toX, toY; // 16.16 map pixels
+static uint32_t   moveStart;              // Start of move or hold
+static uint32_t   duration;               // Of move or hold, micros
+static uint32_t   recip;                  // 2^32 / move duration
+static bool       inMotion  = false;
+static uint32_t   lastSaccadeStop = 0;
+static uint32_t   saccadeInterval = 0;    // 0 = work out when move ends
+static gazeTarget queue[GAZE_QUEUE];
+static uint8_t    queueHead = 0, queueCount = 0;
+static bool       scripted  = false;      // Current move/hold is queued
+static uint32_t   scriptHold;             // Its hold time
+
+// Build tables (once) and put the eyes in the middle. Call after
+// loadConfig() so mapRadius is known.
+void gazeBegin(void) {
+  if(!gazeReady) {
+    for(int i=0; i<=GAZE_CURVE; i++) {
+      float e  = (float)i / (float)GAZE_CURVE;
+      curve[i] = (uint16_t)((3 * e * e - 2 * e * e * e) * 65535.0 + 0.5);
+    }
+    // Sunflower spiral: equal area per point, no clumps or gaps
+    for(int i=0; i<GAZE_DISC; i++) {
+      float r  = sqrt(((float)i + 0.5) / (float)GAZE_DISC) * 127.0,
+            a  = (float)i * 2.39996323; // Golden angle, radians
+      discX[i] = (int8_t)lround(r * cos(a));
+      discY[i] = (int8_t)lround(r * sin(a));
+    }
+    gazeReady = true;
+  }
+  fromX = toX = fromY = toY = mapRadius << 16;
+  inMotion   = false;
+  duration   = 0;
+  queueCount = 0;
+  scripted   = false;
+}
+
+// Queue a target for the eyes, x & y -1.0 to 1.0 (as eyeTargetX/Y), to
+// move to over moveTime micros then hold for holdTime. false if the
+// queue's full.
+bool gazeQueue(float x, float y, uint32_t moveTime, uint32_t holdTime) {
+  if(queueCount >= GAZE_QUEUE) return false;
+  if(x < -1.0) x = -1.0; else if(x > 1.0) x = 1.0;
+  if(y < -1.0) y = -1.0; else if(y > 1.0) y = 1.0;
+  gazeTarget *g = &queue[(queueHead + queueCount) % GAZE_QUEUE];
+  g->x        = (int16_t)(x * 32767.0);
+  g->y        = (int16_t)(y * 32767.0);
+  g->moveTime = moveTime ? moveTime : 1;
+  g->holdTime = holdTime;
+  queueCount++;
+  return true;
+}
+
+void gazeClear(void) {
+  queueCount = 0;
+}
+
+// true while queued targets are pending or being carried out
+bool gazeScripted(void) {
+  return queueCount || scripted;
+}
+
+// Start a move from where the eye is (fromX/Y) to toX/Y
+static void gazeMove(uint32_t t, uint32_t d) {
+  moveStart = t;
+  duration  = d;
+  recip     = 0xFFFFFFFF / d;
+  inMotion  = true;
+}
+
+// Eye position (map pixels) for time t. Called at the start of each eye's
+// frame.
+void gazeFrame(uint32_t t, float *x, float *y) {
+  uint32_t dt = t - moveStart;
+  int32_t  px, py;
+  if(inMotion) {
+    if(dt >= duration) { // Destination reached
+      inMotion = false;
+      fromX    = px = toX;
+      fromY    = py = toY;
+      if(scripted) {
+        duration = scriptHold;
+      } else {
+        // The hold between moves: 35 ms to 1 sec, but not over gazeMax
+        duration = animRandom(35000, min(1000000, gazeMax));
+        if(!saccadeInterval) { // Cleared when "big" saccade finishes
+          lastSaccadeStop = t;
+          saccadeInterval = animRandom(duration, gazeMax) * // 30ms to 3sec
+            exprGet(ExpressionBlend::SACCADE);
+        }
+      }
+      moveStart = t;
+    } else {
+      // Position along eased curve; p is 0.32 fixed point through move
+      uint32_t p    = dt * recip,
+               seg  = p >> (32 - GAZE_CURVE_BITS),
+               frac = (p >> (16 - GAZE_CURVE_BITS)) & 0xFFFF;
+      int32_t  e    = curve[seg] + (((curve[seg + 1] - curve[seg]) * frac) >> 16);
+      px = fromX + (int32_t)(((int64_t)(toX - fromX) * e) >> 16);
+      py = fromY + (int32_t)(((int64_t)(toY - fromY) * e) >> 16);
+    }
+  } else {
+    px = fromX;
+    py = fromY;
+    if(dt > duration) { // Hold's over, begin new move
+      scripted = false;
+      if(queueCount) {
+        // Same range as user-controlled eyes in loop()
+        gazeTarget *g = &queue[queueHead];
+        float       r = ((float)mapDiameter - (float)DISPLAY_SIZE * M_PI_2) * 0.9 / 32767.0;
+        toX        = (mapRadius << 16) + (int32_t)((float)g->x * r * 65536.0);
+        toY        = (mapRadius << 16) + (int32_t)((float)g->y * r * 65536.0);
+        scriptHold = g->holdTime;
+        scripted   = true;
+        queueHead  = (queueHead + 1) % GAZE_QUEUE;
+        queueCount--;
+        gazeMove(t, g->moveTime);
+      } else {
+        int i = animRandom(GAZE_DISC);
+        if((t - lastSaccadeStop) > saccadeInterval) { // Time for a "big" saccade
+          // r is the radius in X and Y that the eye can go, from the center
+          float r = ((float)mapDiameter - (float)DISPLAY_SIZE * M_PI_2) * 0.75 *
+            exprGet(ExpressionBlend::GAZE) * (65536.0 / 127.0);
+          toX = (mapRadius << 16) + (int32_t)(discX[i] * r);
+          toY = (mapRadius << 16) + (int32_t)(discY[i] * r);
+          saccadeInterval = 0; // Calc next interval when this one stops
+          gazeMove(t, animRandom(83000, 166000)); // ~1/12 - ~1/6 sec
+        } else { // Microsaccade, ~1/10 size of full saccade. Not clipped,
+          // next full saccade puts it back in bounds.
+          float r = ((float)mapDiameter - (float)DISPLAY_SIZE * M_PI_2) * 0.07 *
+            (65536.0 / 127.0);
+          toX = fromX + (int32_t)(discX[i] * r);
+          toY = fromY + (int32_t)(discY[i] * r);
+          gazeMove(t, animRandom(7000, 25000)); // 7-25 ms microsaccade
+        }
+      }
+    }
+  }
+  *x = (float)px * (1.0 / 65536.0);
+  *y = (float)py * (1.0 / 65536.0);
+}
+
+// VERGENCE ----------------------------------------------------------------
+
+// The eyes converge on something at a distance, each turned in by the
+// angle to it from that eye: atan(half eye spacing / distance). Pupil
+// offset is that angle's sine times eyeRadius (screen pixels as in the
+// old fixed 'fixate' of 7 at rest, 90 booped: about 570 mm and 30 mm
+// with eyeRadius 125). Distance is, in order: the nose when booped, the
+// user's vergenceTarget(), or the expression's (expressions.cpp).
+//
+// gazeTick() works out both eyes' positions together, once per animation
+// tick (first eye's frame), so both eyes show the same moment and the
+// filtering runs at the same rate however many eyes there are. Each eye
+// picks its position up with gazeLatch() at the start of its own frame
+// and keeps it for the whole frame.
+
+#define VERGE_HALF_SPACING 32.0 // mm, half the distance between eyes
+#define VERGE_NOSE         30.0 // mm, booped
+#define VERGE_TIME     250000.0 // micros, time constant of changes
+
+static float    userDistance = 0.0;   // 0 = not set
+static float    verge        = -1.0;  // Offset now, pixels (-1 = not yet)
+static uint32_t vergeTime;            // Time of last gazeTick()
+static float    tickX[NUM_EYES], tickY[NUM_EYES];
+
+// Distance (mm) for the eyes to converge on, from user code (e.g. a
+// distance or heat sensor). 0 to go back to the expression's.
+void vergenceTarget(float mm) {
+  userDistance = (mm > 0.0) ? mm : 0.0;
+}
+
+// Once per animation tick: both eyes' positions for time t
+void gazeTick(uint32_t t, bool booped) {
+  float x, y;
+  if(moveEyesRandomly || gazeScripted()) {
+    gazeFrame(t, &x, &y);
+  } else {
+    // Allow user code to control eye position (e.g. IR sensor, joystick, etc.)
+    float r = ((float)mapDiameter - (float)DISPLAY_SIZE * M_PI_2) * 0.9;
+    x = mapRadius + eyeTargetX * r;
+    y = mapRadius + eyeTargetY * r;
+  }
+
+  float d = booped ? VERGE_NOSE : (userDistance > 0.0) ? userDistance :
+            exprGet(ExpressionBlend::DISTANCE);
+  if(d < 1.0) d = 1.0;
+  float target = (float)eyeRadius * VERGE_HALF_SPACING /
+                 sqrt(VERGE_HALF_SPACING * VERGE_HALF_SPACING + d * d);
+  if(verge < 0.0) {
+    verge = target; // First time, start there
+  } else {
+    float k = (float)(t - vergeTime) / VERGE_TIME;
+    verge  += (target - verge) * ((k < 1.0) ? k : 1.0);
+  }
+  vergeTime = t;
+
+  for(uint8_t e=0; e<NUM_EYES; e++) {
+    tickX[e] = (e & 1) ? (x + verge) : (x - verge); // Converge toward center
+    tickY[e] = y;
+  }
+}
+
+// Start of eye e's frame: take its position from the last tick
+void gazeLatch(uint8_t e) {
+  eye[e].eyeX = tickX[e];
+  eye[e].eyeY = tickY[e];
+}
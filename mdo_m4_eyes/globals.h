@@ -4,8 +4,18 @@
 
 //34567890123456789012345678901234567890123456789012345678901234567890123456
 
+// Guarded so mdo_Simul8/Simul8_sketch.h can stand in for this file when
+// sketch code is built on a computer.
+#ifndef __GLOBALS_H
+#define __GLOBALS_H
+
 #include "Adafruit_Arcada.h"
 #include "DMAbuddy.h" // DMA-bug-workaround class
+#include "SoundLevels.h" // voiceLevels() snapshot
+#include "WavCatalog.h" // wavClip() entries
+#include "LedAnim.h" // pixelsFind() animations
+#include "ConfigParse.h" // configParse() values
+#include "MemPlan.h" // Memory plan sizes, SLIT_*
 
 #if defined(GLOBAL_VAR) // #defined in .ino file ONLY!
   #define GLOBAL_INIT(X) = (X)
@@ -31,7 +41,7 @@ GLOBAL_VAR bool      showSplashScreen    GLOBAL_INIT(true);   // Clear to suppre
 
 #define MAX_DISPLAY_SIZE 240
 GLOBAL_VAR int       DISPLAY_SIZE        GLOBAL_INIT(240);    // Start with assuming a 240x240 display
-GLOBAL_VAR uint32_t  stackReserve        GLOBAL_INIT(5192);   // See image-loading code
+GLOBAL_VAR uint32_t  stackReserve        GLOBAL_INIT(5192);   // See memory.cpp
 GLOBAL_VAR int       eyeRadius           GLOBAL_INIT(0);      // 0 = Use default in loadConfig()
 GLOBAL_VAR int       eyeDiameter;                             // Calculated from eyeRadius later
 GLOBAL_VAR int       irisRadius          GLOBAL_INIT(60);     // Approx size in screen pixels
@@ -58,13 +68,26 @@ GLOBAL_VAR int       mapRadius;          // calculated in loadConfig()
 GLOBAL_VAR int       mapDiameter;        // calculated in loadConfig()
 GLOBAL_VAR uint8_t  *displace            GLOBAL_INIT(NULL);
 GLOBAL_VAR uint8_t  *polarAngle          GLOBAL_INIT(NULL);
-GLOBAL_VAR int8_t   *polarDist           GLOBAL_INIT(NULL);
-GLOBAL_VAR uint8_t   upperOpen[MAX_DISPLAY_SIZE];
-GLOBAL_VAR uint8_t   upperClosed[MAX_DISPLAY_SIZE];
-GLOBAL_VAR uint8_t   lowerOpen[MAX_DISPLAY_SIZE];
-GLOBAL_VAR uint8_t   lowerClosed[MAX_DISPLAY_SIZE];
+// polarDist holds the distance from map center, normalized so the edge of
+// the map is POLAR_DIST_MAX (255 = outside map). It's the same for both
+// eyes; each eye's iris/sclera boundary and slit pupil are applied later
+// through that eye's irisShape tables (see tablegen.cpp).
+GLOBAL_VAR uint8_t  *polarDist           GLOBAL_INIT(NULL);
+#define POLAR_DIST_MAX 254
+// Slit pupil table size (SLIT_ANGLES, SLIT_RADII) is in MemPlan.h
+// Eyelid edge per column, 8.8 fixed point: lower lid's first row of eye,
+// upper lid's last row of eye; the fraction is partial edge pixel coverage.
+#define LID_BYTES (DISPLAY_SIZE * 4 * sizeof(uint16_t)) // All four tables
+GLOBAL_VAR uint16_t  upperOpen[MAX_DISPLAY_SIZE];
+GLOBAL_VAR uint16_t  upperClosed[MAX_DISPLAY_SIZE];
+GLOBAL_VAR uint16_t  lowerOpen[MAX_DISPLAY_SIZE];
+GLOBAL_VAR uint16_t  lowerClosed[MAX_DISPLAY_SIZE];
 GLOBAL_VAR char     *upperEyelidFilename GLOBAL_INIT(NULL);
 GLOBAL_VAR char     *lowerEyelidFilename GLOBAL_INIT(NULL);
+GLOBAL_VAR char     *eyelidPosesDir      GLOBAL_INIT(NULL);   // Directory of pose images
+GLOBAL_VAR char     *recordLogFile       GLOBAL_INIT(NULL);   // See animclock.cpp
+GLOBAL_VAR char     *replayLogFile       GLOBAL_INIT(NULL);
+GLOBAL_VAR uint8_t   reloadPending       GLOBAL_INIT(0);      // Per-eye bits, live reload ready to swap in
 GLOBAL_VAR uint16_t  lightSensorMin      GLOBAL_INIT(0);
 GLOBAL_VAR uint16_t  lightSensorMax      GLOBAL_INIT(1023);
 GLOBAL_VAR float     lightSensorCurve    GLOBAL_INIT(1.0);
@@ -98,7 +121,10 @@ GLOBAL_VAR float     defaultPitch        GLOBAL_INIT(1.0);
 GLOBAL_VAR float     gain                GLOBAL_INIT(1.0);
 GLOBAL_VAR uint8_t   waveform            GLOBAL_INIT(0);
 GLOBAL_VAR uint32_t  modulate            GLOBAL_INIT(30); // Dalek pitch
+GLOBAL_VAR uint8_t   voiceMode           GLOBAL_INIT(0);  // VOICE_MODE_*
 #endif
+#define VOICE_MODE_RESAMPLE 0 // Play faster/slower, jump at seams (PitchShift)
+#define VOICE_MODE_PSOLA    1 // Pitch-synchronous overlap-add (Psola)
 
 // EYE-RELATED STRUCTURES --------------------------------------------------
 
@@ -137,6 +163,23 @@ typedef struct {
   uint32_t startTime;   // Time (micros) of last state change
 } eyeBlink;
 
+// Eyelid poses and moves between them (see eyelids.cpp)
+// LID_POSES_MAX (including open & closed) is in MemPlan.h
+#define LID_POSE_OPEN   0
+#define LID_POSE_CLOSED 1
+#define LID_POSE_HERE   255 // Partway between poses, in hereLower/Upper
+#define LID_EASE_LINEAR 0
+#define LID_EASE_IN     1   // Starts slow
+#define LID_EASE_OUT    2   // Ends slow
+#define LID_EASE_INOUT  3   // Both
+typedef struct {
+  uint8_t  from, to;    // Pose indices
+  uint8_t  ease;        // LID_EASE_*
+  uint32_t startTime;   // micros() at start of move
+  uint32_t duration;    // Length of move (micros), 0 = holding at 'to'
+  uint16_t hereLower[MAX_DISPLAY_SIZE], hereUpper[MAX_DISPLAY_SIZE]; // 8.8
+} lidAnim;
+
 // Data for iris and sclera texture maps
 typedef struct {
   char     *filename;
@@ -151,6 +194,14 @@ typedef struct {
   uint16_t  iSpin;      // Per-frame fixed integer spin, overrides 'spin' value
 } texture;
 
+// Per-eye iris/sclera distance remap and optional slit pupil table, made
+// by calcDistMap() from the shared polarDist table (see tablegen.cpp).
+typedef struct {
+  int8_t    distMap[256]; // polarDist radius -> signed iris/sclera dist
+  uint8_t  *slitMap;      // Slit pupil table, NULL if round pupil
+  uint16_t  slitScale;    // polarDist radius -> slitMap column (8.8)
+} irisShape;
+
 // Each eye then uses the following structure. Each eye must be on its own
 // SPI bus with distinct control lines (unlike the Uncanny Eyes code where
 // they take turns on one bus). Two of the column structures as described
@@ -169,6 +220,7 @@ typedef struct {
   DMAbuddy         dma;          // DMA channel object with fix() function
   DmacDescriptor  *dptr;         // DMA channel descriptor pointer
   uint32_t         dmaStartTime; // For DMA timeout handler
+  uint32_t         frameTime;    // animFrame() time of current frame
   uint8_t          colNum;       // Column counter (0-239)
   uint8_t          colIdx;       // Alternating 0/1 index into column[] array
   bool             dma_busy;     // true = DMA transfer in progress
@@ -178,6 +230,10 @@ typedef struct {
   texture          iris;         // iris texture map
   texture          sclera;       // sclera texture map
   uint8_t          rotation;     // Screen rotation (GFX lib)
+  int              irisRadius;   // Iris size in screen pixels
+  int              slitPupilRadius; // 0 = round pupil
+  irisShape        shape;        // Tables made from above two values
+  bool             placeholder;  // true = flat-color eye while loading
 
   // Stuff carried over from Uncanny Eyes code. It now needs to be
   // independent per-eye because we interleave between drawing the
@@ -188,6 +244,8 @@ typedef struct {
   float    pupilFactor; // ditto
   float    blinkFactor;
   float    upperLidFactor, lowerLidFactor;
+  lidAnim  lid;         // Eyelid pose, then this frame's edges from it:
+  uint16_t lidLow[MAX_DISPLAY_SIZE], lidHigh[MAX_DISPLAY_SIZE]; // 8.8
 } eyeStruct;
 
 #ifdef INIT_EYESTRUCTS
@@ -205,36 +263,138 @@ typedef struct {
 
 // FUNCTION PROTOTYPES -----------------------------------------------------
 
+// Functions in expressions.cpp
+extern void            exprRead(const char *filename);
+extern void            exprUse(void);
+extern int8_t          exprFind(const char *name);
+extern bool            exprSet(int8_t x);
+extern const char     *exprName(void);
+extern void            exprFrame(uint32_t t);
+extern float           exprGet(uint8_t param);
+extern int             exprSpinAngle(void);
+
 // Functions in file.cpp
 extern int             file_setup(bool msc=true);
 extern void            handle_filesystem_change();
 // This is set true when filesystem contents have changed.
 // Set true initially so the program starts with the "changed" task.
 extern bool            filesystem_change_flag GLOBAL_INIT(true);
-extern void            loadConfig(char *filename);
-extern ImageReturnCode loadEyelid(char *filename, uint8_t *minArray, uint8_t *maxArray, uint8_t init, uint32_t maxRam);
-extern ImageReturnCode loadTexture(char *filename, uint16_t **data, uint16_t *width, uint16_t *height, uint32_t maxRam);
+extern bool            filesysWait(void);
+extern bool            fileReady(const char *filename);
+extern bool            configParse(File *file, volatile const uint8_t *mem, uint32_t memLen, cfgHandler handler);
+extern bool            loadConfig(char *filename);
+extern void            recordLoadedAssets(void);
+extern void            checkFilesystemChange(uint32_t t);
+extern void            applyReload(uint8_t e);
+extern void            startBackgroundLoad(void);
+extern ImageReturnCode loadEyelid(char *filename, uint16_t *minArray, uint16_t *maxArray, uint8_t init);
+extern ImageReturnCode loadTexture(char *filename, uint16_t **data, uint16_t *width, uint16_t *height);
+extern uint32_t        imageScratch(const char *filename);
+
+// Functions in animclock.cpp
+// Input channels for animInput(), 0-15 (log format allows no more)
+enum { ANIM_IN_TIME, ANIM_IN_LIGHT, ANIM_IN_BOOP, ANIM_IN_BUTTONS,
+       ANIM_IN_PIR, ANIM_IN_HEATX, ANIM_IN_HEATY, ANIM_IN_HEATMAG,
+       ANIM_IN_USER };
+extern void            animClockSource(uint32_t (*fn)(void));
+extern void            animBegin(uint32_t seed);
+extern void            animLogBegin(void);
+extern void            animLogEnd(void);
+extern uint32_t        animFrame(uint8_t e);
+extern int32_t         animInput(uint8_t channel, int32_t live);
+extern float           animInputFloat(uint8_t channel, float live);
+extern uint32_t        animMicros(void);
+extern uint32_t        animMillis(void);
+extern int32_t         animRandom(int32_t howbig);
+extern int32_t         animRandom(int32_t howsmall, int32_t howbig);
+
+// Functions in eyelids.cpp
+extern int8_t          lidPoseFind(const char *name);
+extern uint32_t        lidPosesScratch(const char *dir);
+extern void            lidPosesLoad(const char *dir);
+extern void            lidPosesUse(void);
+extern void            lidPoseTo(int8_t e, uint8_t pose, uint32_t duration, uint8_t ease);
+extern bool            lidPoseMoving(uint8_t e);
+extern void            lidFrame(uint8_t e, uint32_t t, float upperFactor, float lowerFactor);
+
+// Functions in gaze.cpp
+extern void            gazeBegin(void);
+extern bool            gazeQueue(float x, float y, uint32_t moveTime, uint32_t holdTime);
+extern void            gazeClear(void);
+extern bool            gazeScripted(void);
+extern void            gazeFrame(uint32_t t, float *x, float *y);
+extern void            vergenceTarget(float mm);
+extern void            gazeTick(uint32_t t, bool booped);
+extern void            gazeLatch(uint8_t e);
 
 // Functions in memory.cpp
 extern uint32_t        availableRAM(void);
 extern uint32_t        availableNVM(void);
+extern bool            scratchBegin(uint32_t bytes);
+extern void           *scratchAlloc(uint32_t bytes);
+extern void            scratchReset(void);
+extern void            scratchEnd(void);
+extern bool            tablesBegin(void);
+extern void           *tablesAlloc(uint32_t bytes);
+extern uint8_t        *slitAlloc(void);
+extern void            slitFree(uint8_t *map);
+extern void            memoryReport(void);
+extern void            stackPaint(void);
+extern uint32_t        stackPeak(void);
+extern void            heapFree(uint32_t *total, uint32_t *largest);
+extern void            memoryPhase(const char *label);
+extern void            stackWatch(uint32_t t);
 extern uint8_t        *writeDataToFlash(uint8_t *src, uint32_t len);
 
+// Functions in neopixels.cpp
+extern void            pixelsBegin(uint16_t minShowMs=20);
+extern uint8_t         pixelsLoad(const char *filename);
+extern const ledAnim  *pixelsFind(const char *name);
+extern void            pixelsPlay(const ledAnim *a);
+extern void            pixelsService(void);
+
+// Functions in nvm.cpp
+extern void            nvmErase(volatile const void *addr);
+extern void            nvmWrite(volatile const void *addr, const uint32_t *words, uint32_t quads);
+
 // Functions in pdmvoice.cpp
 #if defined(ADAFRUIT_MONSTER_M4SK_EXPRESS)
-extern bool              voiceSetup(bool modEnable);
+extern bool              voiceSetup(bool modEnable, uint8_t mode);
 extern float             voicePitch(float p);
 extern void              voiceGain(float g);
 extern void              voiceMod(uint32_t freq, uint8_t waveform);
+extern float             voicePitchTrack(uint32_t t);
+extern void              voiceFill(void);
+extern void              voiceReport(uint32_t dt);
+extern bool              voiceLevels(soundLevels *out);
 extern volatile uint16_t voiceLastReading;
 #endif // ADAFRUIT_MONSTER_M4SK_EXPRESS
 
+// Functions in playlist.cpp
+extern char           *playlistConfig(void);
+
 // Functions in tablegen.cpp
-extern void            calcDisplacement(void);
-extern void            calcMap(void);
+extern int             calcDisplacement(int y=0, int rows=MAX_DISPLAY_SIZE);
+extern int             calcMap(int y=0, int rows=0x7FFF);
+extern void            calcDistMap(irisShape *shape, int iRadius, int slitRadius);
 extern float           screen2map(int in);
 extern float           map2screen(int in);
 
+// Functions in wavplay.cpp
+extern bool            wavPlay(const char *filename, uint32_t rate=0);
+extern void            wavService(void);
+extern bool            wavPlaying(void);
+extern bool            wavHeard(uint16_t *level, uint32_t *ms);
+extern void            wavStop(void);
+extern uint8_t         wavCatalog(const char *dir);
+extern bool            wavPlayClip(int8_t i, uint32_t rate=0);
+extern int8_t          wavFind(const char *name);
+extern int8_t          wavPick(const char *tag);
+extern uint8_t         wavClips(void);
+extern const wavEntry *wavClip(int8_t i);
+
 // Functions in user.cpp
 extern void            user_setup(void);
 extern void            user_loop(void);
+
+#endif
@@ -49,14 +49,9 @@
 
 #define GLOBAL_VAR
 #include "globals.h"
+#include "ExpressionBlend.h" // Parameter names for exprGet()
 
 // Global eye state that applies to all eyes (not per-eye):
-bool     eyeInMotion = false;
-float    eyeOldX, eyeOldY, eyeNewX, eyeNewY;
-uint32_t eyeMoveStartTime = 0L;
-int32_t  eyeMoveDuration  = 0L;
-uint32_t lastSaccadeStop  = 0L;
-int32_t  saccadeInterval  = 0L;
 
 // Some sloppy eye state stuff, some carried over from old eye code...
 // kinda messy and badly named and will get cleaned up/moved/etc.
@@ -67,6 +62,9 @@ int      yPositionOverMap        = 0;
 uint8_t  eyeNum                  = 0;
 uint32_t frames                  = 0;
 uint32_t lastFrameRateReportTime = 0;
+uint32_t logicCycles             = 0, // Once-per-frame block timing,
+         logicMax                = 0, // reset each frame rate report
+         logicFrames             = 0;
 uint32_t lastLightReadTime       = 0;
 float    lastLightValue          = 0.5;
 double   irisValue               = 0.5;
@@ -74,7 +72,6 @@ int      iPupilFactor            = 42;
 uint32_t boopSum                 = 0,
          boopSumFiltered         = 0;
 bool     booped                  = false;
-int      fixate                  = 7;
 uint8_t  lightSensorFailCount    = 0;
 
 // For autonomous iris scaling
@@ -143,6 +140,18 @@ void fatal(const char *message, uint16_t blinkDelay) {
 
 #include <unistd.h> // sbrk() function
 
+// Blend big-endian RGB565 (as in renderBuf) 'a' toward 'b', 'w' = 0 (all
+// a) to 256 (all b), in 32 steps. Spreading the fields out in a 32-bit
+// word with gaps between them does all three channels in one multiply.
+static inline uint16_t mix565(uint16_t a, uint16_t b, int w) {
+  uint32_t aa = __builtin_bswap16(a), bb = __builtin_bswap16(b);
+  aa  = (aa | (aa << 16)) & 0x07E0F81F; // G bits 26-21, R 15-11, B 4-0
+  bb  = (bb | (bb << 16)) & 0x07E0F81F;
+  w >>= 3;
+  aa  = ((aa * (32 - w) + bb * w) >> 5) & 0x07E0F81F;
+  return __builtin_bswap16((uint16_t)(aa | (aa >> 16)));
+}
+
 uint32_t availableRAM(void) {
   char top;                      // Local variable pushed on stack
   return &top - (char *)sbrk(0); // Top of stack minus end of heap
@@ -151,6 +160,11 @@ uint32_t availableRAM(void) {
 // SETUP FUNCTION - CALLED ONCE AT PROGRAM START ---------------------------
 
 void setup() {
+  stackPaint(); // Before anything else, for stack high-water mark
+  // CPU cycle counter, for timing the once-per-frame animation block
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT       = 0;
+  DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
   if(!arcada.arcadaBegin())     fatal("Arcada init fail!", 100);
 #if defined(USE_TINYUSB)
   if(!arcada.filesysBeginMSD()) fatal("No filesystem found!", 250);
@@ -158,6 +172,8 @@ void setup() {
   if(!arcada.filesysBegin())    fatal("No filesystem found!", 250);
 #endif
 
+  // Clock & random numbers for animation, ready for user_setup()
+  animBegin(SysTick->VAL + analogRead(A2));
   user_setup();
 
   arcada.displayBegin();
@@ -176,6 +192,9 @@ void setup() {
   //Serial.printf("Available flash at start: %d\n", arcada.availableFlash());
   yield(); // Periodic yield() makes sure mass storage filesystem stays alive
 
+  // Wait for filesystem to be readable (can lag at power-up without USB)
+  filesysWait();
+
   // No file selector yet. In the meantime, you can override the default
   // config file by holding one of the 3 edge buttons at startup (loads
   // config1.eye, config2.eye or config3.eye instead). Keep fingers clear
@@ -199,6 +218,10 @@ void setup() {
     filename = (char *)"config3.eye";
   } else if((buttonState & ARCADA_BUTTONMASK_B) && arcada.exists("config4.eye")) {
     filename = (char *)"config3.eye";
+  } else {
+    // No button held: next config from the playlist, if any (playlist.cpp)
+    char *listed = playlistConfig();
+    if(listed && arcada.exists(listed)) filename = listed;
   }
 
   yield();
@@ -263,6 +286,9 @@ void setup() {
     eye[e].sclera.spin       = 0.0;
     eye[e].sclera.iSpin      = 0;
     eye[e].rotation          = 3;
+    eye[e].irisRadius        = 0;  // 0 = use global irisRadius
+    eye[e].slitPupilRadius   = -1; // -1 = use global slitPupilRadius
+    eye[e].shape.slitMap     = NULL;
 
     // Uncanny eyes carryover stuff for now, all messy:
     eye[e].blink.state = NOBLINK;
@@ -300,126 +326,32 @@ void setup() {
   // LOAD CONFIGURATION FILE -----------------------------------------------
 
   loadConfig(filename);
+  Serial.printf("Config loaded at %d ms\n", millis());
+  memoryPhase("config");
 
   // LOAD EYELIDS AND TEXTURE MAPS -----------------------------------------
 
-  // Experiencing a problem with MEMORY FRAGMENTATION when loading texture
-  // maps. These images only occupy RAM temporarily -- they're copied to
-  // internal flash memory and then freed. However, something is preventing
-  // the freed memory from restoring to a contiguous block. For example,
-  // if a texture image equal to about 50% of RAM is loaded/copied/freed,
-  // following this with a larger texture (or trying to allocate a larger
-  // polar lookup array) fails because RAM is fragmented into two segments.
-  // I've been through this code, Adafruit_ImageReader and Adafruit_GFX
-  // pretty carefully and they appear to be freeing RAM in the reverse order
-  // that they allocate (which should avoid fragmentation), but I'm likely
-  // overlooking something there or additional allocations are occurring
-  // in other libraries -- perhaps the filesystem and/or mass storage code.
-  // SO, here is the DIRTY WORKAROUND...
-  // Adafruit_ImageReader provides a bmpDimensions() function to determine
-  // the pixel size of an image without actually loading it. We can use this
-  // to estimate the RAM requirements for loading the image, then allocate
-  // a "booster seat" which makes the subsequent image load occur in higher
-  // memory, and the fragmenting part a bit beyond that. When the image and
-  // booster are both freed, that should restore a large contiguous chunk,
-  // leaving the fragments in high memory. Not TOO high though, we need to
-  // leave some RAM for the stack to operate over the lifetime of this
-  // program and to handle small heap allocations.
-
-  uint32_t maxRam = availableRAM() - stackReserve;
-
-  // Load texture maps for eyes
-  uint8_t e2;
-  for(e=0; e<NUM_EYES; e++) { // For each eye...
-    yield();
-    for(e2=0; e2<e; e2++) {    // Compare against each prior eye...
-      // If both eyes have the same iris filename...
-      if((eye[e].iris.filename && eye[e2].iris.filename) &&
-         (!strcmp(eye[e].iris.filename, eye[e2].iris.filename))) {
-        // Then eye 'e' can share the iris graphics from 'e2'
-        // rotate & mirror are kept distinct, just share image
-        eye[e].iris.data   = eye[e2].iris.data;
-        eye[e].iris.width  = eye[e2].iris.width;
-        eye[e].iris.height = eye[e2].iris.height;
-        break;
-      }
-    }
-    if((!e) || (e2 >= e)) { // If first eye, or no match found...
-      // If no iris filename was specified, or if file fails to load...
-      if((eye[e].iris.filename == NULL) || (loadTexture(eye[e].iris.filename,
-        &eye[e].iris.data, &eye[e].iris.width, &eye[e].iris.height,
-        maxRam) != IMAGE_SUCCESS)) {
-        // Point iris data at the color variable and set image size to 1px
-        eye[e].iris.data  = &eye[e].iris.color;
-        eye[e].iris.width = eye[e].iris.height = 1;
-      }
-      // Huh. The booster seat idea STILL doesn't always work right,
-      // something leaking in upper memory. Keep shrinking down the
-      // booster seat size a bit each time we load a texture. Feh.
-      maxRam -= 20;
-    }
-    // Repeat for sclera...
-    for(e2=0; e2<e; e2++) {    // Compare against each prior eye...
-      // If both eyes have the same sclera filename...
-      if((eye[e].sclera.filename && eye[e2].sclera.filename) &&
-         (!strcmp(eye[e].sclera.filename, eye[e2].sclera.filename))) {
-        // Then eye 'e' can share the sclera graphics from 'e2'
-        // rotate & mirror are kept distinct, just share image
-        eye[e].sclera.data   = eye[e2].sclera.data;
-        eye[e].sclera.width  = eye[e2].sclera.width;
-        eye[e].sclera.height = eye[e2].sclera.height;
-        break;
-      }
-    }
-    if((!e) || (e2 >= e)) { // If first eye, or no match found...
-      // If no sclera filename was specified, or if file fails to load...
-      if((eye[e].sclera.filename == NULL) || (loadTexture(eye[e].sclera.filename,
-        &eye[e].sclera.data, &eye[e].sclera.width, &eye[e].sclera.height,
-        maxRam) != IMAGE_SUCCESS)) {
-        // Point sclera data at the color variable and set image size to 1px
-        eye[e].sclera.data  = &eye[e].sclera.color;
-        eye[e].sclera.width = eye[e].sclera.height = 1;
-      }
-      maxRam -= 20; // See note above
-    }
-  }
-
-  // Load eyelid graphics.
-  yield();
-  ImageReturnCode status;
-
-  status = loadEyelid(upperEyelidFilename ?
-    upperEyelidFilename : (char *)"upper.bmp",
-    upperClosed, upperOpen, DISPLAY_SIZE-1, maxRam);
-
-  status = loadEyelid(lowerEyelidFilename ?
-    lowerEyelidFilename : (char *)"lower.bmp",
-    lowerOpen, lowerClosed, 0, maxRam);
-
-  // Filenames are no longer needed...
-  for(e=0; e<NUM_EYES; e++) {
-    if(eye[e].sclera.filename) free(eye[e].sclera.filename);
-    if(eye[e].iris.filename)   free(eye[e].iris.filename);
-  }
-  if(lowerEyelidFilename) free(lowerEyelidFilename);
-  if(upperEyelidFilename) free(upperEyelidFilename);
-
-  // Note that calls to availableRAM() at this point will return something
-  // close to reserveSpace, suggesting very little RAM...but that function
-  // really just returns the space between the heap and stack, and we've
-  // established above that the top of the heap is something of a mirage.
-  // Large allocations CAN still take place in the lower heap!
-
-  calcMap();
-  calcDisplacement();
-  Serial.printf("Free RAM: %d\n", availableRAM());
-
-  randomSeed(SysTick->VAL + analogRead(A2));
-  eyeOldX = eyeNewX = eyeOldY = eyeNewY = mapRadius; // Start in center
+  // Textures and eyelids used to fragment RAM on loading (image data is
+  // only in RAM until copied to flash, but the library's small allocations
+  // were left scattered through it), needing a "booster seat" workaround.
+  // Now images are decoded into one scratch block sized from their BMP
+  // headers, freed before the polar/displacement tables get their own
+  // single block -- see the MEMORY PLAN in memory.cpp.
+
+  // Textures, eyelids and the polar/displacement tables load in the
+  // background (see startBackgroundLoad() in file.cpp), a step at a time
+  // in between column transfers in loop(). Until then each eye is drawn
+  // as a flat-color placeholder, which needs none of those tables, so
+  // animation starts right away.
+  startBackgroundLoad();
+
+  // Record/replay if configured (reseeds random numbers either way)
+  animLogBegin();
+  gazeBegin(); // Start in center
   for(e=0; e<NUM_EYES; e++) { // For each eye...
     eye[e].display->setRotation(eye[e].rotation);
-    eye[e].eyeX = eyeOldX; // Set up initial position
-    eye[e].eyeY = eyeOldY;
+    eye[e].eyeX = mapRadius; // Set up initial position
+    eye[e].eyeY = mapRadius;
   }
 
   if (showSplashScreen) { // Image(s) loaded above?
@@ -441,7 +373,7 @@ void setup() {
 
 #if defined(ADAFRUIT_MONSTER_M4SK_EXPRESS)
   if(voiceOn) {
-    if(!voiceSetup((waveform > 0))) {
+    if(!voiceSetup((waveform > 0), voiceMode)) {
       Serial.println("Voice init fail, continuing without");
       voiceOn = false;
     } else {
@@ -450,6 +382,7 @@ void setup() {
       if(waveform) voiceMod(modulate, waveform);
       arcada.enableSpeaker(true);
     }
+    memoryPhase("voice");
   }
 #endif
 
@@ -462,9 +395,10 @@ void setup() {
       boopThreshold += readBoop();
     }
     boopThreshold = boopThreshold * 110 / 100; // 10% overhead
+    boopThreshold = animInput(ANIM_IN_BOOP, boopThreshold);
   }
 
-  lastLightReadTime = micros() + 2000000; // Delay initial light reading
+  lastLightReadTime = animMicros() + 2000000; // Delay initial light reading
 }
 
 
@@ -505,8 +439,13 @@ an independent frame rate depending on particular complexity at the moment).
 void loop() {
   if(++eyeNum >= NUM_EYES) eyeNum = 0; // Cycle through eyes...
 
+#if defined(ADAFRUIT_MONSTER_M4SK_EXPRESS)
+  if(voiceOn) voiceFill(); // Keep the voice changer's output blocks coming
+#endif
+  wavService(); // And any WAV file playing (wavplay.cpp)
+
   uint8_t  x = eye[eyeNum].colNum;
-  uint32_t t = micros();
+  uint32_t t; // Frame's animation time, set at first column
 
   // If next column for this eye is not yet rendered...
   if(!eye[eyeNum].column_ready) {
@@ -514,80 +453,31 @@ void loop() {
 
       // ONCE-PER-FRAME EYE ANIMATION LOGIC HAPPENS HERE -------------------
 
-      // Eye movement
-      float eyeX, eyeY;
-      if(moveEyesRandomly) {
-        int32_t dt = t - eyeMoveStartTime;      // uS elapsed since last eye event
-        if(eyeInMotion) {                       // Eye currently moving?
-          if(dt >= eyeMoveDuration) {           // Time up?  Destination reached.
-            eyeInMotion = false;                // Stop moving
-            // The "move" duration temporarily becomes a hold duration...
-            // Normally this is 35 ms to 1 sec, but don't exceed gazeMax setting
-            uint32_t limit = min(1000000, gazeMax);
-            eyeMoveDuration = random(35000, limit); // Time between microsaccades
-            if(!saccadeInterval) {              // Cleared when "big" saccade finishes
-              lastSaccadeStop = t;              // Time when saccade stopped
-              saccadeInterval = random(eyeMoveDuration, gazeMax); // Next in 30ms to 3sec
-            }
-            // Similarly, the "move" start time becomes the "stop" starting time...
-            eyeMoveStartTime = t;               // Save time of event
-            eyeX = eyeOldX = eyeNewX;           // Save position
-            eyeY = eyeOldY = eyeNewY;
-          } else { // Move time's not yet fully elapsed -- interpolate position
-            float e  = (float)dt / float(eyeMoveDuration); // 0.0 to 1.0 during move
-            e = 3 * e * e - 2 * e * e * e; // Easing function: 3*e^2-2*e^3 0.0 to 1.0
-            eyeX = eyeOldX + (eyeNewX - eyeOldX) * e; // Interp X
-            eyeY = eyeOldY + (eyeNewY - eyeOldY) * e; // and Y
-          }
-        } else {                       // Eye is currently stopped
-          eyeX = eyeOldX;
-          eyeY = eyeOldY;
-          if(dt > eyeMoveDuration) {   // Time up?  Begin new move.
-            if((t - lastSaccadeStop) > saccadeInterval) { // Time for a "big" saccade
-              // r is the radius in X and Y that the eye can go, from (0,0) in the center.
-              float r = ((float)mapDiameter - (float)DISPLAY_SIZE * M_PI_2) * 0.75;
-              eyeNewX = random(-r, r);
-              float h = sqrt(r * r - eyeNewX * eyeNewX);
-              eyeNewY = random(-h, h);
-              // Set the duration for this move, and start it going.
-              eyeMoveDuration = random(83000, 166000); // ~1/12 - ~1/6 sec
-              saccadeInterval = 0; // Calc next interval when this one stops
-            } else { // Microsaccade
-              // r is possible radius of motion, ~1/10 size of full saccade.
-              // We don't bother with clipping because if it strays just a little,
-              // that's okay, it'll get put in-bounds on next full saccade.
-              float r = (float)mapDiameter - (float)DISPLAY_SIZE * M_PI_2;
-              r *= 0.07;
-              float dx = random(-r, r);
-              eyeNewX = eyeX - mapRadius + dx;
-              float h = sqrt(r * r - dx * dx);
-              eyeNewY = eyeY - mapRadius + random(-h, h);
-              eyeMoveDuration = random(7000, 25000); // 7-25 ms microsaccade
-            }
-            eyeNewX += mapRadius;    // Translate new point into map space
-            eyeNewY += mapRadius;
-            eyeMoveStartTime = t;    // Save initial time of move
-            eyeInMotion      = true; // Start move on next frame
-          }
-        }
-      } else {
-        // Allow user code to control eye position (e.g. IR sensor, joystick, etc.)
-        float r = ((float)mapDiameter - (float)DISPLAY_SIZE * M_PI_2) * 0.9;
-        eyeX = mapRadius + eyeTargetX * r;
-        eyeY = mapRadius + eyeTargetY * r;
-      }
+      uint32_t logicStart = DWT->CYCCNT;
+
+      // One time for the whole frame, from the animation clock (which may
+      // be replaying a recording, see animclock.cpp)
+      t = eye[eyeNum].frameTime = animFrame(eyeNum);
 
-      // Eyes fixate (are slightly crossed) -- amount is filtered for boops
-      int nufix = booped ? 90 : 7;
-      fixate = ((fixate * 15) + nufix) / 16;
-      // save eye position to this eye's struct so it's same throughout render
-      if(eyeNum & 1) eyeX += fixate; // Eyes converge slightly toward center
-      else           eyeX -= fixate;
-      eye[eyeNum].eyeX = eyeX;
-      eye[eyeNum].eyeY = eyeY;
+      // Swap in new textures/tables from a live config reload, if any.
+      // Done here so an eye never changes partway through a frame.
+      if(reloadPending & (1 << eyeNum)) applyReload(eyeNum);
+
+      // Blend toward the current expression (expressions.cpp), once for
+      // all eyes; the exprGet() values below scale the usual behavior.
+      if(!eyeNum) exprFrame(t);
+
+      // Eye movement (autonomous, queued or user code's) and vergence,
+      // worked out for all eyes at once on the first eye's frame (see
+      // gaze.cpp). Each eye keeps its position the whole frame.
+      if(!eyeNum) gazeTick(t, booped);
+      gazeLatch(eyeNum);
 
       // pupilFactor? irisValue? TO DO: pick a name and stick with it
-      eye[eyeNum].pupilFactor = irisValue;
+      // Expression can set the pupil: PUPILMIX 0 = sensor, 1 = PUPIL
+      float mix = exprGet(ExpressionBlend::PUPILMIX);
+      eye[eyeNum].pupilFactor = irisValue +
+        ((1.0 - exprGet(ExpressionBlend::PUPIL)) - irisValue) * mix;
       // Also note - irisValue is calculated at the END of this function
       // for the next frame (because the sensor must be read when there's
       // no SPI traffic to the left eye)
@@ -596,7 +486,7 @@ void loop() {
       // and durations are random (within ranges).
       if((t - timeOfLastBlink) >= timeToNextBlink) { // Start new blink?
         timeOfLastBlink = t;
-        uint32_t blinkDuration = random(36000, 72000); // ~1/28 - ~1/14 sec
+        uint32_t blinkDuration = animRandom(36000, 72000); // ~1/28 - ~1/14 sec
         // Set up durations for both eyes (if not already winking)
         for(uint8_t e=0; e<NUM_EYES; e++) {
           if(eye[e].blink.state == NOBLINK) {
@@ -605,7 +495,8 @@ void loop() {
             eye[e].blink.duration  = blinkDuration;
           }
         }
-        timeToNextBlink = blinkDuration * 3 + random(4000000);
+        timeToNextBlink = blinkDuration * 3 +
+          animRandom(4000000) * exprGet(ExpressionBlend::BLINK);
       }
 
       float uq, lq; // So many sloppy temp vars in here for now, sorry
@@ -613,8 +504,9 @@ void loop() {
         // Eyelids naturally "track" the pupils (move up or down automatically)
         int ix = (int)map2screen(mapRadius - eye[eyeNum].eyeX) + (DISPLAY_SIZE/2), // Pupil position
             iy = (int)map2screen(mapRadius - eye[eyeNum].eyeY) + (DISPLAY_SIZE/2); // on screen
-        iy += irisRadius * trackFactor;
+        iy += eye[eyeNum].irisRadius * trackFactor;
         if(eyeNum & 1) ix = DISPLAY_SIZE - 1 - ix; // Flip for right eye
+        iy <<= 8; // Eyelid tables are 8.8 fixed point
         if(iy > upperOpen[ix]) {
           uq = 1.0;
         } else if(iy < upperClosed[ix]) {
@@ -660,14 +552,25 @@ void loop() {
       // Periodically report frame rate. Really this is "total number of
       // eyeballs drawn." If there are two eyes, the overall refresh rate
       // of both screens is about 1/2 this.
+      if(!frames) Serial.printf("First frame at %d ms\n", millis());
       frames++;
       if(((t - lastFrameRateReportTime) >= 1000000) && t) { // Once per sec.
         Serial.println((frames * 1000) / (t / 1000));
+        if(logicFrames) { // Average & worst time in this block, last second
+          Serial.printf("Frame logic: avg %d us, max %d us\n",
+            logicCycles / logicFrames / (F_CPU / 1000000),
+            logicMax / (F_CPU / 1000000));
+        }
+#if defined(ADAFRUIT_MONSTER_M4SK_EXPRESS)
+        if(voiceOn) voiceReport(t - lastFrameRateReportTime);
+#endif
+        logicCycles = logicMax = logicFrames = 0;
         lastFrameRateReportTime = t;
       }
 
       // Once per frame (of eye #0), reset boopSum...
       if((eyeNum == 0) && (boopPin >= 0)) {
+        boopSum         = animInput(ANIM_IN_BOOP, boopSum);
         boopSumFiltered = ((boopSumFiltered * 3) + boopSum) / 4;
         if(boopSumFiltered > boopThreshold) {
           if(!booped) {
@@ -680,20 +583,35 @@ void loop() {
         boopSum = 0;
       }
 
-      float mins = (float)millis() / 60000.0;
+      float mins = (float)animMillis() / 60000.0;
+      // Expression spin is on top of either kind (exprSpin[] is what was
+      // added last frame, so per-frame spin can take out the old one)
+      static int exprSpin[NUM_EYES];
+      int        spinNow = exprSpinAngle();
       if(eye[eyeNum].iris.iSpin) {
         // Spin works in fixed amount per frame (eyes may lose sync, but "wagon wheel" tricks work)
-        eye[eyeNum].iris.angle   += eye[eyeNum].iris.iSpin;
+        eye[eyeNum].iris.angle   += eye[eyeNum].iris.iSpin + spinNow - exprSpin[eyeNum];
       } else {
         // Keep consistent timing in spin animation (eyes stay in sync, no "wagon wheel" effects)
-        eye[eyeNum].iris.angle    = (int)((float)eye[eyeNum].iris.startAngle   + eye[eyeNum].iris.spin   * mins + 0.5);
+        eye[eyeNum].iris.angle    = (int)((float)eye[eyeNum].iris.startAngle   + eye[eyeNum].iris.spin   * mins + 0.5) + spinNow;
       }
+      exprSpin[eyeNum] = spinNow;
       if(eye[eyeNum].sclera.iSpin) {
         eye[eyeNum].sclera.angle += eye[eyeNum].sclera.iSpin;
       } else {
         eye[eyeNum].sclera.angle  = (int)((float)eye[eyeNum].sclera.startAngle + eye[eyeNum].sclera.spin * mins + 0.5);
       }
 
+      // This frame's lid edges, from pose (eyelids.cpp), blink & tracking
+      lidFrame(eyeNum, t,
+        (1.0 - eye[eyeNum].blinkFactor) * eye[eyeNum].upperLidFactor,
+        (1.0 - eye[eyeNum].blinkFactor) * eye[eyeNum].lowerLidFactor);
+
+      uint32_t logicTime = DWT->CYCCNT - logicStart;
+      logicCycles += logicTime;
+      if(logicTime > logicMax) logicMax = logicTime;
+      logicFrames++;
+
       // END ONCE-PER-FRAME EYE ANIMATION ----------------------------------
 
     } // end first-scanline check
@@ -705,17 +623,14 @@ void loop() {
     xPositionOverMap = (int)(eye[eyeNum].eyeX - (DISPLAY_SIZE/2.0));
     yPositionOverMap = (int)(eye[eyeNum].eyeY - (DISPLAY_SIZE/2.0));
 
-    // These are constant across frame and could be stored in eye struct
-    float upperLidFactor = (1.0 - eye[eyeNum].blinkFactor) * eye[eyeNum].upperLidFactor,
-          lowerLidFactor = (1.0 - eye[eyeNum].blinkFactor) * eye[eyeNum].lowerLidFactor;
     iPupilFactor = (int)((float)eye[eyeNum].iris.height * 256 * (1.0 / eye[eyeNum].pupilFactor));
 
-    int y1, y2;
+    int y1, y2, f1, f2; // Eye rows y1 to y2, fractions for edge pixels
     int lidColumn = (eyeNum & 1) ? (DISPLAY_SIZE - 1 - x) : x; // Reverse eyelid columns for left eye
 
     DmacDescriptor *d = &eye[eyeNum].column[eye[eyeNum].colIdx].descriptor[0];
 
-    if(upperOpen[lidColumn] == 255) {
+    if(upperOpen[lidColumn] == (255 << 8)) {
       // No eyelid data for this line; eyelid image is smaller than screen.
       // Great! Make a full scanline of nothing, no rendering needed:
       d->BTCTRL.bit.SRCINC = 0;
@@ -723,14 +638,18 @@ void loop() {
       d->SRCADDR.reg       = (uint32_t)&eyelidIndex;
       d->DESCADDR.reg      = 0; // No linked descriptor
     } else {
-      y1 = lowerClosed[lidColumn] + (int)(0.5 + lowerLidFactor *
-        (float)((int)lowerOpen[lidColumn] - (int)lowerClosed[lidColumn]));
-      y2 = upperClosed[lidColumn] + (int)(0.5 + upperLidFactor *
-        (float)((int)upperOpen[lidColumn] - (int)upperClosed[lidColumn]));
-      if(y1 > DISPLAY_SIZE-1)    y1 = DISPLAY_SIZE-1; // Clip results in case lidfactor
-      else if(y1 < 0) y1 = 0;   // is beyond the usual 0.0 to 1.0 range
-      if(y2 > DISPLAY_SIZE-1)    y2 = DISPLAY_SIZE-1;
-      else if(y2 < 0) y2 = 0;
+      // Lid edges in 8.8 fixed point, worked out once per frame. Rows
+      // wholly inside a lid are lid color as before; the one row each edge
+      // passes through is rendered too, then blended with eyelidColor by
+      // how much of it the lid covers.
+      y1 = eye[eyeNum].lidLow[lidColumn];
+      y2 = eye[eyeNum].lidHigh[lidColumn];
+      f1 = y1 & 255; // Lower lid's share of row y1
+      f2 = y2 & 255; // Eye's share of row y2 + 1
+      y1 >>= 8;
+      y2 >>= 8;
+      if(f2 && (y2 < (DISPLAY_SIZE-1))) y2++;
+      else f2 = 0;
       if(y1 >= y2) {
         // Eyelid is fully or partially closed, enough that there are no
         // pixels to be rendered for this line. Make "nothing," as above.
@@ -776,99 +695,139 @@ void loop() {
 #else
         y = y1;
 #endif
+        uint16_t *eyeStart = ptr; // Row y1
+
+        if(eye[eyeNum].placeholder) {
+          // Tables aren't loaded yet. Draw a flat eye: sclera disc, iris
+          // disc and pupil, positioned by the same math as lid tracking.
+          int ex = x * 2 - (DISPLAY_SIZE - 1); // Pixel pos. rel. to center,
+          int er = eyeRadius * 2;              // all in half-pixel units
+          int ix = ex - (int)(map2screen(mapRadius - eye[eyeNum].eyeX) * 2),
+              cy = (int)(map2screen(mapRadius - eye[eyeNum].eyeY) * 2),
+              ir = eye[eyeNum].irisRadius * 2,
+              pr = (int)((float)ir * (1.0 - eye[eyeNum].pupilFactor));
+          for(; y<=y2; y++) {
+            int ey = y * 2 - (DISPLAY_SIZE - 1),
+                iy = ey - cy,
+                i2 = ix * ix + iy * iy;
+            if((ex * ex + ey * ey) > (er * er)) *ptr++ = eyelidColor;
+            else if(i2 <= (pr * pr))            *ptr++ = eye[eyeNum].pupilColor;
+            else if(i2 <= (ir * ir))            *ptr++ = eye[eyeNum].iris.color;
+            else                                *ptr++ = eye[eyeNum].sclera.color;
+          }
+        } else {
+          // tablegen.cpp explains a bit of the displacement mapping trick.
+          uint8_t *displaceX, *displaceY;
+          int8_t   xmul; // Sign of X displacement: +1 or -1
+          int      doff; // Offset into displacement arrays
+          if(x < (DISPLAY_SIZE/2)) {  // Left half of screen (quadrants 2, 3)
+            displaceX = &displace[ (DISPLAY_SIZE/2 - 1) - x       ];
+            displaceY = &displace[((DISPLAY_SIZE/2 - 1) - x) * (DISPLAY_SIZE/2)];
+            xmul      = -1; // X displacement is always negative
+          } else {       // Right half of screen( quadrants 1, 4)
+            displaceX = &displace[ x - (DISPLAY_SIZE/2)       ];
+            displaceY = &displace[(x - (DISPLAY_SIZE/2)) * (DISPLAY_SIZE/2)];
+            xmul      =  1; // X displacement is always positive
+          }
 
-        // tablegen.cpp explains a bit of the displacement mapping trick.
-        uint8_t *displaceX, *displaceY;
-        int8_t   xmul; // Sign of X displacement: +1 or -1
-        int      doff; // Offset into displacement arrays
-        if(x < (DISPLAY_SIZE/2)) {  // Left half of screen (quadrants 2, 3)
-          displaceX = &displace[ (DISPLAY_SIZE/2 - 1) - x       ];
-          displaceY = &displace[((DISPLAY_SIZE/2 - 1) - x) * (DISPLAY_SIZE/2)];
-          xmul      = -1; // X displacement is always negative
-        } else {       // Right half of screen( quadrants 1, 4)
-          displaceX = &displace[ x - (DISPLAY_SIZE/2)       ];
-          displaceY = &displace[(x - (DISPLAY_SIZE/2)) * (DISPLAY_SIZE/2)];
-          xmul      =  1; // X displacement is always positive
-        }
-
-        for(; y<=y2; y++) { // For each pixel of open eye in this column...
-          int yy = yPositionOverMap + y;
-          int dx, dy;
+          for(; y<=y2; y++) { // For each pixel of open eye in this column...
+            int yy = yPositionOverMap + y;
+            int dx, dy;
 
-          if(y < (DISPLAY_SIZE/2)) { // Lower half of screen (quadrants 3, 4)
-            doff = (DISPLAY_SIZE/2 - 1) - y;
-            dy   = -displaceY[doff];
-          } else {      // Upper half of screen (quadrants 1, 2)
-            doff = y - (DISPLAY_SIZE/2);
-            dy   =  displaceY[doff];
-          }
-          dx = displaceX[doff * (DISPLAY_SIZE/2)];
-          if(dx < 255) {      // Inside eyeball area
-            dx *= xmul;       // Flip sign of x offset if in quadrants 2 or 3
-            int mx = xx + dx; // Polar angle/dist map coords
-            int my = yy + dy;
-            if((mx >= 0) && (mx < mapDiameter) && (my >= 0) && (my < mapDiameter)) {
-              // Inside polar angle/dist map
-              int angle, dist, moff;
-              if(my >= mapRadius) {
-                if(mx >= mapRadius) { // Quadrant 1
-                  // Use angle & dist directly
-                  mx   -= mapRadius;
-                  my   -= mapRadius;
-                  moff  = my * mapRadius + mx; // Offset into map arrays
-                  angle = polarAngle[moff];
-                  dist  = polarDist[moff];
-                } else {                // Quadrant 2
-                  // ROTATE angle by 90 degrees (270 degrees clockwise; 768)
-                  // MIRROR dist on X axis
-                  mx    = mapRadius - 1 - mx;
-                  my   -= mapRadius;
-                  angle = polarAngle[mx * mapRadius + my] + 768;
-                  dist  = polarDist[ my * mapRadius + mx];
-                }
-              } else {
-                if(mx < mapRadius) {  // Quadrant 3
-                  // ROTATE angle by 180 degrees
-                  // MIRROR dist on X & Y axes
-                  mx    = mapRadius - 1 - mx;
-                  my    = mapRadius - 1 - my;
-                  moff  = my * mapRadius + mx;
-                  angle = polarAngle[moff] + 512;
-                  dist  = polarDist[ moff];
-                } else {                // Quadrant 4
-                  // ROTATE angle by 270 degrees (90 degrees clockwise; 256)
-                  // MIRROR dist on Y axis
-                  mx   -= mapRadius;
-                  my    = mapRadius - 1 - my;
-                  angle = polarAngle[mx * mapRadius + my] + 256;
-                  dist  = polarDist[ my * mapRadius + mx];
+            if(y < (DISPLAY_SIZE/2)) { // Lower half of screen (quadrants 3, 4)
+              doff = (DISPLAY_SIZE/2 - 1) - y;
+              dy   = -displaceY[doff];
+            } else {      // Upper half of screen (quadrants 1, 2)
+              doff = y - (DISPLAY_SIZE/2);
+              dy   =  displaceY[doff];
+            }
+            dx = displaceX[doff * (DISPLAY_SIZE/2)];
+            if(dx < 255) {      // Inside eyeball area
+              dx *= xmul;       // Flip sign of x offset if in quadrants 2 or 3
+              int mx = xx + dx; // Polar angle/dist map coords
+              int my = yy + dy;
+              if((mx >= 0) && (mx < mapDiameter) && (my >= 0) && (my < mapDiameter)) {
+                // Inside polar angle/dist map
+                int angle, dist, rad, moff;
+                if(my >= mapRadius) {
+                  if(mx >= mapRadius) { // Quadrant 1
+                    // Use angle & dist directly
+                    mx   -= mapRadius;
+                    my   -= mapRadius;
+                    moff  = my * mapRadius + mx; // Offset into map arrays
+                    angle = polarAngle[moff];
+                    rad   = polarDist[moff];
+                  } else {                // Quadrant 2
+                    // ROTATE angle by 90 degrees (270 degrees clockwise; 768)
+                    // MIRROR dist on X axis
+                    mx    = mapRadius - 1 - mx;
+                    my   -= mapRadius;
+                    angle = polarAngle[mx * mapRadius + my] + 768;
+                    rad   = polarDist[ my * mapRadius + mx];
+                  }
+                } else {
+                  if(mx < mapRadius) {  // Quadrant 3
+                    // ROTATE angle by 180 degrees
+                    // MIRROR dist on X & Y axes
+                    mx    = mapRadius - 1 - mx;
+                    my    = mapRadius - 1 - my;
+                    moff  = my * mapRadius + mx;
+                    angle = polarAngle[moff] + 512;
+                    rad   = polarDist[ moff];
+                  } else {                // Quadrant 4
+                    // ROTATE angle by 270 degrees (90 degrees clockwise; 256)
+                    // MIRROR dist on Y axis
+                    mx   -= mapRadius;
+                    my    = mapRadius - 1 - my;
+                    angle = polarAngle[mx * mapRadius + my] + 256;
+                    rad   = polarDist[ my * mapRadius + mx];
+                  }
                 }
-              }
-              // Convert angle/dist to texture map coords
-              if(dist >= 0) { // Sclera
-                angle = ((angle + eye[eyeNum].sclera.angle) & 1023) ^ eye[eyeNum].sclera.mirror;
-                int tx = angle * eye[eyeNum].sclera.width  / 1024; // Texture map x/y
-                int ty = dist  * eye[eyeNum].sclera.height / 128;
-                *ptr++ = eye[eyeNum].sclera.data[ty * eye[eyeNum].sclera.width + tx];
-              } else if(dist > -128) { // Iris or pupil
-                int ty = dist * iPupilFactor / -32768;
-                if(ty >= eye[eyeNum].iris.height) { // Pupil
-                  *ptr++ = eye[eyeNum].pupilColor;
-                } else { // Iris
-                  angle = ((angle + eye[eyeNum].iris.angle) & 1023) ^ eye[eyeNum].iris.mirror;
-                  int tx = angle * eye[eyeNum].iris.width / 1024;
-                  *ptr++ = eye[eyeNum].iris.data[ty * eye[eyeNum].iris.width + tx];
+                // Shared radius to this eye's iris/sclera distance
+                dist = eye[eyeNum].shape.distMap[rad];
+                // Convert angle/dist to texture map coords
+                if(dist >= 0) { // Sclera
+                  angle = ((angle + eye[eyeNum].sclera.angle) & 1023) ^ eye[eyeNum].sclera.mirror;
+                  int tx = angle * eye[eyeNum].sclera.width  / 1024; // Texture map x/y
+                  int ty = dist  * eye[eyeNum].sclera.height / 128;
+                  *ptr++ = eye[eyeNum].sclera.data[ty * eye[eyeNum].sclera.width + tx];
+                } else if(dist > -128) { // Iris or pupil
+                  if(eye[eyeNum].shape.slitMap) {
+                    // Slit pupil depends on angle as well as radius. Fold
+                    // angle to one quadrant, interpolate between radii.
+                    int a = angle & 511;
+                    if(a > 255) a = 511 - a;
+                    uint8_t *slit = &eye[eyeNum].shape.slitMap[(a * SLIT_ANGLES >> 8) * (SLIT_RADII + 1)];
+                    int      r    = rad * eye[eyeNum].shape.slitScale; // 8.8 column
+                    int      c    = r >> 8;
+                    if(c >= SLIT_RADII) {
+                      dist = -1 - slit[SLIT_RADII];
+                    } else {
+                      dist = -1 - (slit[c] + (((slit[c + 1] - slit[c]) * (r & 255)) >> 8));
+                    }
+                  }
+                  int ty = dist * iPupilFactor / -32768;
+                  if(ty >= eye[eyeNum].iris.height) { // Pupil
+                    *ptr++ = eye[eyeNum].pupilColor;
+                  } else { // Iris
+                    angle = ((angle + eye[eyeNum].iris.angle) & 1023) ^ eye[eyeNum].iris.mirror;
+                    int tx = angle * eye[eyeNum].iris.width / 1024;
+                    *ptr++ = eye[eyeNum].iris.data[ty * eye[eyeNum].iris.width + tx];
+                  }
+                } else {
+                  *ptr++ = eye[eyeNum].backColor; // Back of eye
                 }
               } else {
-                *ptr++ = eye[eyeNum].backColor; // Back of eye
+                *ptr++ = eye[eyeNum].backColor; // Off map, use back-of-eye color
               }
-            } else {
-              *ptr++ = eye[eyeNum].backColor; // Off map, use back-of-eye color
+            } else { // Outside eyeball area
+              *ptr++ = eyelidColor;
             }
-          } else { // Outside eyeball area
-            *ptr++ = eyelidColor;
           }
         }
+        // Anti-alias lid edges (ptr is past row y2)
+        if(f1) *eyeStart = mix565(*eyeStart, eyelidColor, f1);
+        if(f2) ptr[-1]   = mix565(ptr[-1], eyelidColor, 256 - f2);
 
 #if NUM_DESCRIPTORS == 1
         // Render upper eyelid if needed
@@ -894,7 +853,11 @@ void loop() {
 
   // If DMA for this eye is currently busy, don't block, try next eye...
   if(eye[eyeNum].dma_busy) {
-    if((micros() - eye[eyeNum].dmaStartTime) < DMA_TIMEOUT) return;
+    if((micros() - eye[eyeNum].dmaStartTime) < DMA_TIMEOUT) {
+      // Use the wait for a step of startup loading or config reload
+      if(filesystem_change_flag) handle_filesystem_change();
+      return;
+    }
     // If we reach this point in the code, an SPI DMA transfer has taken
     // noticably longer than expected and is probably stalled (see comments
     // in the DMAbuddy.h file and above the DMA_TIMEOUT declaration earlier
@@ -911,6 +874,7 @@ void loop() {
 
   // At this point, above checks confirm that column is ready and DMA is free
   if(!x) { // If it's the first column...
+    t = eye[eyeNum].frameTime; // Same time as the frame's animation
     // End prior SPI transaction...
     digitalWrite(eye[eyeNum].cs, HIGH); // Deselect
     eye[eyeNum].spi->endTransaction();
@@ -930,7 +894,7 @@ void loop() {
           // pupils will react even if the opposite eye is stimulated.
           // Meaning we can get away with using a single light sensor for
           // both eyes. This comment has nothing to do with the code.
-          uint16_t rawReading = arcada.readLightSensor();
+          uint16_t rawReading = animInput(ANIM_IN_LIGHT, arcada.readLightSensor());
           if(rawReading <= 1023) {
             if(rawReading < lightSensorMin)      rawReading = lightSensorMin; // Clamp light sensor range
             else if(rawReading > lightSensorMax) rawReading = lightSensorMax; // to within usable range
@@ -960,7 +924,7 @@ void loop() {
           } else {
             n            = iris_next[i];
             iris_prev[i] = iris_next[i];
-            iris_next[i] = -0.5 + ((float)random(1000) / 999.0); // -0.5 to +0.5
+            iris_next[i] = -0.5 + ((float)animRandom(1000) / 999.0); // -0.5 to +0.5
           }
           iexp = 1 << (IRIS_LEVELS - i); // ...8,4,2,1
           sum += n / (float)iexp;
@@ -970,9 +934,11 @@ void loop() {
       }
 #if defined(ADAFRUIT_MONSTER_M4SK_EXPRESS)
       if(voiceOn) {
+        // Measure voice pitch for the seams in pitch-shifted playback
+        voicePitchTrack(t);
         // Read buttons, change pitch
         arcada.readButtons();
-        uint32_t buttonState = arcada.justPressedButtons();
+        uint32_t buttonState = animInput(ANIM_IN_BUTTONS, arcada.justPressedButtons());
         if(       buttonState & ARCADA_BUTTONMASK_UP) {
           currentPitch *= 1.05;
         } else if(buttonState & ARCADA_BUTTONMASK_A) {
@@ -981,14 +947,16 @@ void loop() {
           currentPitch *= 0.95;
         }
         if(buttonState & (ARCADA_BUTTONMASK_UP | ARCADA_BUTTONMASK_A | ARCADA_BUTTONMASK_DOWN)) {
-          currentPitch = voicePitch(currentPitch);
-          if(waveform) voiceMod(modulate, waveform);
+          currentPitch = voicePitch(currentPitch); // Modulation follows
           Serial.print("Voice pitch: ");
           Serial.println(currentPitch);
         }
       }
 #endif
       user_loop();
+      // Watch for config file changes (loaded below if so)
+      checkFilesystemChange(t);
+      stackWatch(t);
     }
   } // end first-column check
 
@@ -0,0 +1,198 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+//34567890123456789012345678901234567890123456789012345678901234567890123456
+
+#include "globals.h"
+#include "Arena.h"
+#include <unistd.h> // sbrk() function
+
+// MEMORY PLAN -------------------------------------------------------------
+
+// Startup memory is laid out on purpose rather than left to malloc():
+//
+// IMAGE SCRATCH - one block, sized before loading for the largest image
+//   about to be decoded (textures are 2 bytes/pixel until they're copied
+//   to flash, eyelids need only a row). Each image is decoded into it and
+//   it's reset after each one; once all images are in, the block is freed.
+//   Being the only allocation in that time, freeing it puts the heap back
+//   exactly as it was. Also used again by live reload.
+// TABLES - one block for everything kept for good: polarAngle/polarDist,
+//   displace, and a pool of slit pupil maps (two per eye, one in use plus
+//   one being built by live reload). Allocated once, after the scratch
+//   block is gone, so the two big users of RAM never overlap in time.
+//
+// The sizes come from the config (mapRadius) and image headers, not from
+// guesses; high-water marks are printed once loading's done.
+
+#define SLIT_SLOTS (NUM_EYES * 2)
+
+static Arena    scratch, tables;
+static uint32_t scratchPeak = 0, scratchMax = 0; // Over all scratch uses
+static uint8_t *slitSlot[SLIT_SLOTS];
+static uint8_t  slitInUse = 0;                    // Bit per slot
+
+// Bytes the tables block needs for current mapRadius (MemPlan.h)
+static uint32_t tablesPlan(void) {
+  return planTables(mapRadius, DISPLAY_SIZE, SLIT_SLOTS);
+}
+
+// Allocate image scratch block, up to what RAM allows after stackReserve.
+// Returns false if there's nothing at all (loads will then fail cleanly).
+bool scratchBegin(uint32_t bytes) {
+  uint32_t avail = availableRAM();
+  void    *mem   = NULL;
+  avail = (avail > stackReserve) ? ((avail - stackReserve) & ~3) : 0;
+  if(bytes > avail) {
+    Serial.printf("Image scratch: want %d bytes, %d available\n", bytes, avail);
+    bytes = avail;
+  }
+  if(bytes) mem = malloc(bytes);
+  scratch.begin(mem, bytes);
+  return mem != NULL;
+}
+
+void *scratchAlloc(uint32_t bytes) {
+  return scratch.alloc(bytes);
+}
+
+// Done with the current image
+void scratchReset(void) {
+  scratch.reset();
+}
+
+// Done with all images, give the block back
+void scratchEnd(void) {
+  if(scratch.peak() > scratchPeak) scratchPeak = scratch.peak();
+  if(scratch.size() > scratchMax)  scratchMax  = scratch.size();
+  if(scratch.failed()) {
+    Serial.printf("Image scratch: %d allocations didn't fit\n", scratch.failed());
+  }
+  free(scratch.memory());
+  scratch.begin(NULL, 0);
+}
+
+// Allocate the tables block (once per boot, mapRadius can't change
+// without a restart). Returns false if it couldn't.
+bool tablesBegin(void) {
+  if(tables.size()) return true;
+  uint32_t bytes = tablesPlan();
+  void    *mem   = malloc(bytes);
+  if(!mem) {
+    Serial.printf("Can't allocate %d bytes for tables\n", bytes);
+    return false;
+  }
+  tables.begin(mem, bytes);
+  for(uint8_t i=0; i<SLIT_SLOTS; i++) {
+    slitSlot[i] = (uint8_t *)tables.alloc(SLIT_BYTES);
+  }
+  return true;
+}
+
+void *tablesAlloc(uint32_t bytes) {
+  return tables.alloc(bytes);
+}
+
+// Slit pupil map from the pool (SLIT_BYTES), NULL if none free
+uint8_t *slitAlloc(void) {
+  for(uint8_t i=0; i<SLIT_SLOTS; i++) {
+    if(slitSlot[i] && !(slitInUse & (1 << i))) {
+      slitInUse |= 1 << i;
+      return slitSlot[i];
+    }
+  }
+  return NULL;
+}
+
+void slitFree(uint8_t *map) {
+  for(uint8_t i=0; i<SLIT_SLOTS; i++) {
+    if(map == slitSlot[i]) slitInUse &= ~(1 << i);
+  }
+}
+
+// High-water marks vs plan
+void memoryReport(void) {
+  Serial.printf("Tables: %d of %d bytes used%s\n", tables.used(),
+    tables.size(), tables.failed() ? ", SOME DIDN'T FIT" : "");
+  Serial.printf("Image scratch: peak %d of %d bytes\n", scratchPeak,
+    scratchMax);
+  Serial.printf("Stack: peak %d bytes, stackReserve %d\n", stackPeak(),
+    stackReserve);
+}
+
+// DIAGNOSTICS -------------------------------------------------------------
+
+// availableRAM() is only the gap between the top of the heap and the
+// stack pointer: it knows nothing of holes in the heap, nor how deep the
+// stack has been. These fill that in. stackPaint() fills the gap with a
+// pattern at boot; whatever the stack has since written over is how deep
+// it's gone. The heap's free list is walked for the largest block and a
+// fragmentation figure (0% = all free RAM in one piece). memoryPhase()
+// prints both after each startup step; the stack peak vs stackReserve
+// in memoryReport() is what to go by when tuning stackReserve.
+
+#define STACK_PAINT 0xC5C5C5C5
+
+// newlib-nano malloc's free list (nano-mallocr.c), in address order
+struct mallocChunk {
+  long                size; // Bytes, including this header
+  struct mallocChunk *next;
+};
+extern "C" struct mallocChunk *__malloc_free_list;
+extern "C" char                __StackTop; // From linker script
+
+static uint32_t *paintTop = NULL; // Highest painted word (exclusive)
+
+// Call first thing in setup(). Stops a little short of its own frame.
+void stackPaint(void) {
+  char      top;
+  uint32_t *p = (uint32_t *)(((uintptr_t)sbrk(0) + 3) & ~3);
+  paintTop    = (uint32_t *)(((uintptr_t)&top - 256) & ~3);
+  while(p < paintTop) *p++ = STACK_PAINT;
+}
+
+// Deepest the stack has been since stackPaint(), in bytes
+uint32_t stackPeak(void) {
+  if(!paintTop) return 0;
+  // Heap may have grown up into the paint since, start from where it is
+  uint32_t *p = (uint32_t *)(((uintptr_t)sbrk(0) + 3) & ~3);
+  while((p < paintTop) && (*p == STACK_PAINT)) p++;
+  return &__StackTop - (char *)p;
+}
+
+// Free RAM in total and largest single piece, heap holes plus the gap
+// above the heap (less stackReserve, as that's not for malloc()).
+void heapFree(uint32_t *total, uint32_t *largest) {
+  uint32_t gap = availableRAM();
+  gap      = (gap > stackReserve) ? (gap - stackReserve) : 0;
+  *total   = *largest = gap;
+  for(struct mallocChunk *c = __malloc_free_list; c; c = c->next) {
+    *total += c->size;
+    if((uint32_t)c->size > *largest) *largest = c->size;
+  }
+}
+
+// One line of memory state, after startup step 'label'
+void memoryPhase(const char *label) {
+  uint32_t total, largest;
+  heapFree(&total, &largest);
+  Serial.printf("Mem %-12s free %6d largest %6d frag %2d%% stack %d\n",
+    label, total, largest,
+    total ? (int)(100 - (uint64_t)largest * 100 / total) : 0, stackPeak());
+}
+
+// Called from loop(). Every few seconds, reports if the stack has gone
+// deeper than last time, so stackReserve can be judged after a good run.
+void stackWatch(uint32_t t) {
+  static uint32_t lastCheck = 0, lastPeak = 0;
+  if((t - lastCheck) < 5000000) return; // t is micros()
+  lastCheck = t;
+  uint32_t peak = stackPeak();
+  if(peak > lastPeak) {
+    if(lastPeak) Serial.printf("Stack: new peak %d bytes\n", peak);
+    lastPeak = peak;
+  }
+}
@@ -0,0 +1,105 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+//34567890123456789012345678901234567890123456789012345678901234567890123456
+
+#include "globals.h"
+#include "LedAnim.h"
+
+extern Adafruit_Arcada arcada;
+
+// NEOPIXEL ANIMATION ------------------------------------------------------
+
+// Keyframe animations on the board's NeoPixels (LedAnim.h), for user code
+// (user_touchneopixels.cpp). pixelsService(), from user_loop(), renders
+// the frame and only calls arcada.pixels.show() when a pixel changed and
+// at most every minShowMs, rather than every eye frame.
+
+#define PIXELS_ANIMS 8  // Most animations from a file
+#define PIXELS_KEYS  96 // Most keyframes from a file, all told
+
+static LedAnim leds;
+static ledKey  pixelsKeys[PIXELS_KEYS];
+static struct {
+  char    name[CFG_KEYLEN];
+  ledAnim anim;
+} pixelsAnims[PIXELS_ANIMS];
+static uint8_t pixelsAnimCount, pixelsKeyCount;
+
+void pixelsBegin(uint16_t minShowMs) {
+  leds.begin(arcada.pixels.numPixels(), minShowMs);
+}
+
+// configParse() handler. Each section's an animation: "spread" (ms), and
+// keys that are times in ms (in order) with [R, G, B] colors.
+static void pixelsHandler(const char *section, const char *key, cfgValue *v) {
+  if(!section) return;
+  uint8_t n = pixelsAnimCount;
+  if(!n || strcmp(pixelsAnims[n - 1].name, section)) { // New animation
+    if(n && !pixelsAnims[n - 1].anim.count) n--;     // Last had no keys
+    if(n >= PIXELS_ANIMS) return;
+    strcpy(pixelsAnims[n].name, section);
+    pixelsAnims[n].anim.keys   = &pixelsKeys[pixelsKeyCount];
+    pixelsAnims[n].anim.count  = 0;
+    pixelsAnims[n].anim.spread = 0;
+    pixelsAnimCount = ++n;
+  }
+  ledAnim *a = &pixelsAnims[n - 1].anim;
+  if(!strcmp(key, "spread")) {
+    if(v->type == CFG_INT) a->spread = constrain(v->item[0].i, 0, 65535);
+    return;
+  }
+  char *end;
+  long  ms = strtol(key, &end, 10);
+  if(*end || (ms < 0) || (ms > 65535) || (v->type != CFG_ARRAY) || (v->count < 3) ||
+     (v->item[0].type != CFG_INT) || (v->item[1].type != CFG_INT) ||
+     (v->item[2].type != CFG_INT) || (!a->count && ms) || // First at 0, then in order
+     (a->count && (ms <= a->keys[a->count - 1].ms))) {
+    Serial.printf("%s: \"%s\" ignored\n", section, key);
+    return;
+  }
+  if(pixelsKeyCount >= PIXELS_KEYS) return;
+  ledKey *k = &pixelsKeys[pixelsKeyCount++];
+  k->ms = ms;
+  k->r  = constrain(v->item[0].i, 0, 255);
+  k->g  = constrain(v->item[1].i, 0, 255);
+  k->b  = constrain(v->item[2].i, 0, 255);
+  a->count++;
+}
+
+// Loads animations from a JSON file, one object of keyframes each:
+//   "heartbeat" : { "0" : [163, 0, 0], "150" : [163, 0, 0], ... }
+// Replaces any loaded before. Returns how many there are.
+uint8_t pixelsLoad(const char *filename) {
+  pixelsAnimCount = pixelsKeyCount = 0;
+  File file = arcada.open(filename, FILE_READ);
+  if(!file) return 0;
+  if(!configParse(&file, NULL, 0, pixelsHandler)) pixelsAnimCount = 0;
+  file.close();
+  if(pixelsAnimCount && !pixelsAnims[pixelsAnimCount - 1].anim.count) pixelsAnimCount--;
+  Serial.printf("%s: %d animations\n", filename, pixelsAnimCount);
+  return pixelsAnimCount;
+}
+
+// Loaded animation named 'name', NULL if none
+const ledAnim *pixelsFind(const char *name) {
+  for(uint8_t i=0; i<pixelsAnimCount; i++) {
+    if(!strcmp(pixelsAnims[i].name, name)) return &pixelsAnims[i].anim;
+  }
+  return NULL;
+}
+
+// Starts 'a' (a loaded one or a const table) now. NULL = all off.
+void pixelsPlay(const ledAnim *a) {
+  leds.play(a, millis());
+}
+
+// Called from user_loop(): shows the frame when it's changed and due
+void pixelsService(void) {
+  if(!leds.render(millis())) return;
+  for(uint8_t i=0; i<leds.pixels(); i++) arcada.pixels.setPixelColor(i, leds.color(i));
+  arcada.pixels.show();
+}
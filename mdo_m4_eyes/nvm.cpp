@@ -0,0 +1,57 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+//34567890123456789012345678901234567890123456789012345678901234567890123456
+
+#include "globals.h"
+
+// INTERNAL FLASH WRITES ---------------------------------------------------
+
+// Small helpers for changing the SAMD51's own program flash, for the bits
+// of state that must survive a reset (playlist.cpp, config snapshot in
+// file.cpp). Regions are const arrays in the program image, aligned to
+// NVMCTRL_BLOCK_SIZE (8K), so they can't collide with Arcada's texture
+// storage that starts after the program. Writes use manual write mode one
+// 16-byte quad-word at a time, with the CPU cache off while flash changes.
+
+static void nvmCommand(uint32_t cmd) {
+  while(!NVMCTRL->STATUS.bit.READY);
+  NVMCTRL->CTRLB.reg = NVMCTRL_CTRLB_CMDEX_KEY | cmd;
+  while(!NVMCTRL->STATUS.bit.READY);
+}
+
+static void cacheOff(void) {
+  CMCC->CTRL.bit.CEN = 0;
+  while(CMCC->SR.bit.CSTS);
+}
+
+static void cacheOn(void) {
+  CMCC->MAINT0.bit.INVALL = 1; // Don't serve old contents from cache
+  CMCC->CTRL.bit.CEN = 1;
+}
+
+// Erase the 8K block starting at addr (must be block-aligned)
+void nvmErase(volatile const void *addr) {
+  cacheOff();
+  NVMCTRL->ADDR.reg = (uint32_t)addr;
+  nvmCommand(NVMCTRL_CTRLB_CMD_EB);
+  cacheOn();
+}
+
+// Write 'quads' 16-byte quad-words to addr (16-byte aligned, erased)
+void nvmWrite(volatile const void *addr, const uint32_t *words, uint32_t quads) {
+  volatile uint32_t *dst = (volatile uint32_t *)addr;
+  cacheOff();
+  NVMCTRL->CTRLA.bit.WMODE = NVMCTRL_CTRLA_WMODE_MAN;
+  while(quads--) {
+    nvmCommand(NVMCTRL_CTRLB_CMD_PBC); // Clear page buffer
+    for(uint8_t i=0; i<4; i++) dst[i] = *words++;
+    NVMCTRL->ADDR.reg = (uint32_t)dst;
+    nvmCommand(NVMCTRL_CTRLB_CMD_WQW);  // Write quad-word
+    dst += 4;
+  }
+  cacheOn();
+}
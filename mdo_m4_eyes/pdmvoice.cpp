@@ -10,12 +10,17 @@
 #include "globals.h"
 #include <SPI.h>
 #include <Adafruit_ZeroPDMSPI.h>
+#include "ModWave.h"
+#include "PitchDetect.h"
+#include "PitchShift.h"
+#include "Psola.h"
+#include "SoundLevels.h"
+#include "VoiceDSP.h"
 
 #define MIN_PITCH_HZ   65
 #define MAX_PITCH_HZ 1600
 #define TYP_PITCH_HZ  175
 
-static void  voiceOutCallback(void);
 static float actualPlaybackRate;
 
 // PDM mic allows 1.0 to 3.25 MHz max clock (2.4 typical).
@@ -37,70 +42,174 @@ Adafruit_ZeroPDMSPI pdmspi(&PDM_SPI);
 
 static float          playbackRate     = sampleRate;
 static uint16_t      *recBuf           = NULL;
-// recBuf currently gets allocated (in voiceSetup()) for two full cycles of
-// the lowest pitch we're likely to encounter. Right now it doesn't really
-// NEED to be this size, but if pitch detection is added in the future then
-// this'll become more useful.
+// recBuf gets allocated (in voiceSetup()) for two full cycles of the
+// lowest pitch we're likely to encounter, which is what pitch detection
+// (voicePitchTrack()) needs to see.
 // 46,875 sampling rate from mic, 65 Hz lowest pitch -> 2884 bytes.
-static const uint16_t recBufSize       = (uint16_t)(sampleRate / (float)MIN_PITCH_HZ * 2.0 + 0.5);
-static int16_t        recIndex         = 0;
-static int16_t        playbackIndex    = 0;
+// Twice that in PSOLA mode, where each grain is two periods centered a
+// period back, and is read from while the recording carries on.
+static uint16_t       recBufSize       = (uint16_t)(sampleRate / (float)MIN_PITCH_HZ * 2.0 + 0.5);
+static uint8_t        shiftMode        = VOICE_MODE_RESAMPLE; // voiceSetup()'s
+static float          ratio            = 1.0;   // Pitch, as voicePitch() set it
+static volatile int16_t recIndex       = 0; // Read by voiceFill() etc.
 
 volatile uint16_t     voiceLastReading = 32768;
 volatile uint16_t     voiceMin         = 32768;
 volatile uint16_t     voiceMax         = 32768;
+static int16_t        listenIndex      = 0; // Last sample voiceListen() took in
 
-#define MOD_MIN 20 // Lowest supported modulation frequency (lower = more RAM use)
-static uint8_t        modWave          = 0;     // Modulation wave type (none, sine, square, tri, saw)
-static uint8_t       *modBuf           = NULL;  // Modulation waveform buffer
-static uint32_t       modIndex         = 0;     // Current position in modBuf
-static uint32_t       modLen           = 0;     // Currently used amount of modBuf based on modFreq
+static bool           modEnabled       = false; // voiceSetup()'s
+static ModWave        modWave;                  // Modulation waveform
 
 // Just playing back directly from the recording circular buffer produces
 // audible clicks as the waveforms rarely align at the beginning and end of
 // the buffer. So what we do is advance or push back the playback index a
 // certain amount when it's likely to overtake or underflow the recording
 // index, and interpolate from the current to the jumped-forward-or-back
-// readings over a short period. In a perfect world, that "certain amount"
-// would be one wavelength of the current voice pitch...BUT...with no pitch
-// detecton currently, we instead use a fixed middle-of-the-road value:
-// TYP_PITCH_HZ, 175 by default, which is a bit below typical female spoken
-// vocal range and a bit above typical male spoken range. This all goes out
-// the window with singing, and of course young people will have a higher
-// speech range, is just a crude catch-all approximation.
-static const uint16_t jump      = (int)(sampleRate / (float)TYP_PITCH_HZ + 0.5);
-static const uint16_t interp    = jump / 4; // Interp time = 1/4 waveform
-static bool           jumping   = false;
-static uint16_t       jumpCount = 1;
-static int16_t        jumpThreshold;
-static int16_t        playbackIndexJumped;
-static uint16_t       nextOut   = 2048;
+// readings over a short period (PitchShift.cpp). In a perfect world, that
+// "certain amount" would be one wavelength of the current voice pitch.
+// voicePitchTrack() measures the pitch and sets the jump to the whole
+// number of its periods nearest TYP_PITCH_HZ's, so the seams line up.
+// Until then, or when there's no clear pitch, it stays at TYP_PITCH_HZ,
+// 175 by default, which is a bit below typical female spoken vocal range
+// and a bit above typical male spoken range.
+#define TYP_JUMP (sampleRate / (float)TYP_PITCH_HZ)
+static PitchDetect    pitchDetect;
+static PitchShift     pitchShift;
+static Psola          psola;  // Instead of pitchShift in VOICE_MODE_PSOLA
+static SoundLevels    soundLevel;
+
+// Output goes to the DAC (A0 & A1) by DMA, one block of samples at a
+// time from two buffers: while one plays, loop() fills the other (see
+// voiceFill()). A timer/counter paces the DMA at the playback rate, so
+// the only interrupt is one per block, not one per sample. This was
+// Arcada's timerCallback() timer; voice doesn't use that any more, so
+// the TC can't clash with user code that does (user_fizzgig.cpp).
+#define VOICE_BLOCK      128 // Output samples per DMA block
+#define VOICE_TC         TC2
+#define VOICE_TC_GCLK_ID TC2_GCLK_ID
+#define VOICE_TC_DMAC_ID TC2_DMAC_ID_OVF
+
+static uint16_t          outBuf[2][VOICE_BLOCK];
+static Adafruit_ZeroDMA  outDMA[2];            // A0, A1
+static volatile uint32_t blocksPlayed = 0;     // From DMA interrupt
+static uint32_t          blocksFilled = 2,     // Both start as silence
+                         fillCycles   = 0,     // voiceReport() figures
+                         underruns    = 0;
 
 float voicePitch(float p);
+static bool voiceOutBegin(void);
+static void voiceDSPCheck(void);
+static void voiceListen(void);
+static void voiceModulate(uint16_t *o);
 
 // START PITCH SHIFT (no arguments) ----------------------------------------
 
-bool voiceSetup(bool modEnable) {
+bool voiceSetup(bool modEnable, uint8_t mode) {
+
+  shiftMode = mode;
+  if(shiftMode == VOICE_MODE_PSOLA) recBufSize *= 2;
 
   // Allocate circular buffer for audio
   if(NULL == (recBuf = (uint16_t *)malloc(recBufSize * sizeof(uint16_t)))) {
     return false; // Fail
   }
 
-  // Allocate buffer for voice modulation, if enabled
-  if(modEnable) {
-    // 250 comes from min period in voicePitch()
-    modBuf = (uint8_t *)malloc((int)(48000000.0 / 250.0 / MOD_MIN + 0.5));
-    // If malloc fails, program will continue without modulation
+  // Modulation reads fixed tables (ModWave.cpp), nothing to allocate
+  modEnabled = modEnable;
+
+  voiceDSPCheck();
+
+  pitchDetect.begin(sampleRate, MIN_PITCH_HZ, MAX_PITCH_HZ, recBufSize);
+  soundLevel.begin(sampleRate);
+  if(shiftMode == VOICE_MODE_PSOLA) {
+    psola.begin(recBufSize, VOICE_BLOCK);
+    psola.period(TYP_JUMP);
+  } else {
+    pitchShift.begin(recBufSize, VOICE_BLOCK);
+    pitchShift.jump((int)(TYP_JUMP + 0.5));
   }
 
   pdmspi.begin(sampleRate);  // Set up PDM microphone
   analogWriteResolution(12); // Set up analog output
-  voicePitch(1.0);           // Set timer interval
+  analogWrite(A0, 2048);     // (turns DACs on)
+  analogWrite(A1, 2048);
+  if(!voiceOutBegin()) return false;
+  voicePitch(1.0);           // Set timer interval, starts output
 
   return true; // Success
 }
 
+static uint32_t cycles(void) {
+  return DWT->CYCCNT;
+}
+
+// Checks the packed DSP kernels give the same results as plain C and
+// prints both's cycles per sample. Uses recBuf as scratch, before there's
+// any recording in it.
+static void voiceDSPCheck(void) {
+  dspBenchResult r[DSP_KERNELS];
+  if((recBufSize * sizeof(uint16_t)) < DSP_BENCH_BYTES) return;
+  dspBench(r, recBuf, cycles, 4);
+  for(uint8_t k=0; k<DSP_KERNELS; k++) {
+    uint32_t s = r[k].scalar * 100 / (4 * DSP_BENCH_SAMPLES), // Hundredths
+             p = r[k].packed * 100 / (4 * DSP_BENCH_SAMPLES);
+    Serial.printf("Voice DSP: %-9s %d.%02d -> %d.%02d cycles/sample%s\n", r[k].name,
+      s / 100, s % 100, p / 100, p % 100, r[k].same ? "" : ", MISMATCH");
+  }
+  for(uint16_t i=0; i<recBufSize; i++) recBuf[i] = 32768; // Back to silence
+}
+
+// Block-done interrupt (DMA channel for A0; A1's runs in step with it)
+static void voiceBlockDone(Adafruit_ZeroDMA *dma) {
+  blocksPlayed++;
+}
+
+// Set up both DACs' DMA channels, each looping through the two output
+// buffers, triggered by the voice timer (not running yet)
+static bool voiceOutBegin(void) {
+  for(uint8_t b=0; b<2; b++) {
+    for(uint16_t i=0; i<VOICE_BLOCK; i++) outBuf[b][i] = 2048;
+  }
+  for(uint8_t c=0; c<2; c++) {
+    if(outDMA[c].allocate() != DMA_STATUS_OK) return false;
+    outDMA[c].setTrigger(VOICE_TC_DMAC_ID);
+    outDMA[c].setAction(DMA_TRIGGER_ACTON_BEAT);
+    for(uint8_t b=0; b<2; b++) {
+      DmacDescriptor *d = outDMA[c].addDescriptor(outBuf[b],
+        (void *)&DAC->DATA[c].reg, VOICE_BLOCK, DMA_BEAT_SIZE_HWORD, true, false);
+      if(!d) return false;
+      if(!c) d->BTCTRL.bit.BLOCKACT = DMA_BLOCK_ACTION_INT; // Block done
+    }
+    outDMA[c].loop(true);
+  }
+  outDMA[0].setCallback(voiceBlockDone);
+  outDMA[0].startJob();
+  outDMA[1].startJob();
+  return true;
+}
+
+// Start the voice timer or change its period (48 MHz clocks per sample).
+// Buffered, so the change happens at the end of a period.
+static void voiceTimer(uint32_t period) {
+  Tc *tc = VOICE_TC;
+  if(!tc->COUNT16.CTRLA.bit.ENABLE) {
+    MCLK->APBBMASK.reg |= MCLK_APBBMASK_TC2;
+    GCLK->PCHCTRL[VOICE_TC_GCLK_ID].reg = GCLK_PCHCTRL_GEN_GCLK1 | GCLK_PCHCTRL_CHEN;
+    while(!(GCLK->PCHCTRL[VOICE_TC_GCLK_ID].reg & GCLK_PCHCTRL_CHEN));
+    tc->COUNT16.CTRLA.reg = TC_CTRLA_SWRST;
+    while(tc->COUNT16.SYNCBUSY.bit.SWRST);
+    tc->COUNT16.CTRLA.reg = TC_CTRLA_MODE_COUNT16 | TC_CTRLA_PRESCALER_DIV1;
+    tc->COUNT16.WAVE.reg  = TC_WAVE_WAVEGEN_MFRQ; // Overflow at CC0 = DMA trigger
+    tc->COUNT16.CC[0].reg = period - 1;
+    while(tc->COUNT16.SYNCBUSY.bit.CC0);
+    tc->COUNT16.CTRLA.bit.ENABLE = 1;
+    while(tc->COUNT16.SYNCBUSY.bit.ENABLE);
+  } else {
+    tc->COUNT16.CCBUF[0].reg = period - 1;
+  }
+}
+
 // SET PITCH ---------------------------------------------------------------
 
 // Set pitch adjustment, higher numbers = higher pitch. 0 < pitch < inf
@@ -110,18 +219,134 @@ bool voiceSetup(bool modEnable) {
 // Available pitch adjustment range depends on various hardware factors
 // (SPI speed, timer/counter resolution, etc.), and the actual pitch
 // adjustment (after appying constraints) will be returned.
+// In PSOLA mode playback stays at the recording rate and the range is
+// PSOLA_PITCH_MIN to _MAX.
 float voicePitch(float p) {
+  if(shiftMode == VOICE_MODE_PSOLA) {
+    if(p < PSOLA_PITCH_MIN)      p = PSOLA_PITCH_MIN;
+    else if(p > PSOLA_PITCH_MAX) p = PSOLA_PITCH_MAX;
+    voiceTimer((uint32_t)(48000000.0 / sampleRate + 0.5));
+    actualPlaybackRate = playbackRate = sampleRate;
+    modWave.playbackRate(actualPlaybackRate);
+    psola.pitch(p);
+    return ratio = p;
+  }
   float   desiredPlaybackRate = sampleRate * p;
   // Clip to sensible range
   if(desiredPlaybackRate < 19200)       desiredPlaybackRate = 19200;  // ~0.41X
   else if(desiredPlaybackRate > 192000) desiredPlaybackRate = 192000; // ~4.1X
-  arcada.timerCallback(desiredPlaybackRate, voiceOutCallback);
-  // Making this assumption here knowing Arcada will use 1:1 prescale:
+  // 48 MHz timer clock, 1:1 prescale
   int32_t period = (int32_t)(48000000.0 / desiredPlaybackRate);
+  voiceTimer(period);
   actualPlaybackRate = 48000000.0 / (float)period;
   p = (actualPlaybackRate / sampleRate); // New pitch
-  jumpThreshold = (int)(jump * p + 0.5);
-  return p;
+  playbackRate = actualPlaybackRate;
+  modWave.playbackRate(actualPlaybackRate); // Same modulation Hz
+  pitchShift.pitch(p);
+  return ratio = p;
+}
+
+// TRACK VOICE PITCH -------------------------------------------------------
+
+// Called from loop() (not the interrupts; it takes a while) at time t,
+// micros. Every PITCH_INTERVAL it estimates the voice's pitch from the
+// latest audio and sets the playback seam jump to whole pitch periods
+// (PSOLA mode: the grains' period). Returns the pitch in Hz, 0 if none
+// this time.
+#define PITCH_INTERVAL 30000 // micros
+
+float voicePitchTrack(uint32_t t) {
+  static uint32_t lastTime = 0;
+  if(!recBuf || ((t - lastTime) < PITCH_INTERVAL)) return 0.0;
+  lastTime = t;
+  float period = pitchDetect.detect(recBuf, recIndex);
+  soundLevel.pitch((period > 0.0) ? (uint16_t)(sampleRate / period + 0.5) : 0);
+  if(period <= 0.0) return 0.0; // Keep last jump
+  if(shiftMode == VOICE_MODE_PSOLA) {
+    psola.period(period);
+    return sampleRate / period;
+  }
+  // Whole periods nearest the typical jump, as far as the buffer allows
+  int      n = (int)(TYP_JUMP / period + 0.5);
+  if(n < 1) n = 1;
+  uint16_t j = (uint16_t)(period * n + 0.5);
+  while((j > pitchShift.jumpLimit()) && (n > 1)) j = (uint16_t)(period * --n + 0.5);
+  pitchShift.jump(j);
+  return sampleRate / period;
+}
+
+// FILL OUTPUT BLOCKS ------------------------------------------------------
+
+// Called from loop(), as often as it comes around (every column). Fills
+// whichever output buffer the DMA's finished with. If loop() was held up
+// long enough for a buffer to play twice, that's an underrun: a block's
+// worth of sound repeats, counted for voiceReport().
+void voiceFill(void) {
+  if(!recBuf) return;
+  uint32_t played = blocksPlayed; // DMA is playing block # 'played'
+  if(blocksFilled <= played) {
+    underruns++;
+    blocksFilled = played + 1;
+  }
+  while(blocksFilled <= (played + 1)) {
+    uint16_t *o = outBuf[blocksFilled & 1];
+    uint32_t  c = DWT->CYCCNT;
+    if(shiftMode == VOICE_MODE_PSOLA) psola.fill(o, VOICE_BLOCK, recBuf, recIndex);
+    else                         pitchShift.fill(o, VOICE_BLOCK, recBuf, recIndex);
+    voiceModulate(o);
+    fillCycles += DWT->CYCCNT - c;
+    blocksFilled++;
+  }
+  voiceListen();
+}
+
+// Modulation is done on the output (rather than the input) because
+// pitch-shifting modulated input would cause weird waveform
+// discontinuities. A block of gains from the wavetable, then applied.
+static void voiceModulate(uint16_t *o) {
+  static uint8_t gain[VOICE_BLOCK];
+  if(!modWave.on()) return;
+  modWave.fill(gain, VOICE_BLOCK);
+  dspGain(o, gain, VOICE_BLOCK);
+}
+
+// Takes the samples recorded since the last call into voiceMin/voiceMax
+// and the sound levels (voiceLevels()). Done here, a run at a time,
+// rather than per sample in the interrupt.
+static void voiceListen(void) {
+  int16_t  newest = recIndex;
+  uint16_t lo = voiceMin, hi = voiceMax;
+  while(listenIndex != newest) {
+    int16_t from = (listenIndex + 1 < recBufSize) ? (listenIndex + 1) : 0,
+            to   = (newest >= from) ? newest : (recBufSize - 1); // Up to the wrap
+    dspMinMax(recBuf + from, to - from + 1, &lo, &hi);
+    soundLevel.feed(recBuf + from, to - from + 1);
+    listenIndex = to;
+  }
+  voiceMin = lo;
+  voiceMax = hi;
+}
+
+// SOUND LEVELS ------------------------------------------------------------
+
+// Copies the latest loudness, voice activity and band levels (see
+// SoundLevels.h) to *out, new every 5.5 ms. Read it once per frame rather
+// than voiceMin/voiceMax or voiceLastReading. false if there's nothing
+// yet (voice changer off or just started).
+bool voiceLevels(soundLevels *out) {
+  return recBuf && soundLevel.get(out);
+}
+
+// Prints the time spent filling output blocks, as a share of the CPU over
+// the last 'dt' micros, and underruns since the last report.
+void voiceReport(uint32_t dt) {
+  if(!recBuf || !dt) return;
+  uint32_t tenths = (uint32_t)((uint64_t)fillCycles * 1000 / ((uint64_t)dt * (F_CPU / 1000000))),
+           pitch  = (uint32_t)(ratio * 100.0 + 0.5); // Hundredths
+  Serial.printf("Voice: fill %d.%d%% CPU at pitch %d.%02d%s, %d underruns\n",
+    tenths / 10, tenths % 10, pitch / 100, pitch % 100,
+    (shiftMode == VOICE_MODE_PSOLA) ? " (PSOLA)" : "", underruns);
+  fillCycles = underruns = 0;
 }
 
 // SET GAIN ----------------------------------------------------------------
@@ -132,41 +357,11 @@ void voiceGain(float g) {
 
 // SET MODULATION ----------------------------------------------------------
 
-// This needs to be called after any call to voicePitch() -- the modulation
-// table is not currently auto-regenerated. Maybe that'll change.
-
+// Modulation frequency (Hz) and waveform (MOD_* in ModWave.h: 0 none,
+// 1 square, 2 sine, 3 triangle, 4 sawtooth). Follows voicePitch() changes
+// by itself. Ignored if voiceSetup() wasn't asked for modulation.
 void voiceMod(uint32_t freq, uint8_t waveform) {
-  if(modBuf) { // Ignore if no modulation buffer allocated
-    if(freq < MOD_MIN) freq = MOD_MIN;
-    modLen = (uint32_t)(actualPlaybackRate / freq + 0.5);
-    if(modLen   < 2) modLen   = 2;
-    if(waveform > 4) waveform = 4;
-    modWave = waveform;
-    yield();
-    switch(waveform) {
-     case 0: // None
-      break;
-     case 1: // Square
-      memset(modBuf, 255, modLen / 2);
-      memset(&modBuf[modLen / 2], 0, modLen - modLen / 2);
-      break;
-     case 2: // Sine
-      for(uint32_t i=0; i<modLen; i++) {
-        modBuf[i] = (int)((sin(M_PI * 2.0 * (float)i / (float)modLen) + 1.0) * 0.5 * 255.0 + 0.5);
-      }
-      break;
-     case 3: // Triangle
-      for(uint32_t i=0; i<modLen; i++) {
-        modBuf[i] = (int)(fabs(0.5 - (float)i / (float)modLen) * 2.0 * 255.0 + 0.5);
-      }
-      break;
-     case 4: // Sawtooth (increasing)
-      for(uint32_t i=0; i<modLen; i++) {
-        modBuf[i] = (int)((float)i / (float)(modLen - 1) * 255.0 + 0.5);
-      }
-      break;
-    }
-  }
+  if(modEnabled) modWave.set((float)freq, waveform);
 }
 
 // INTERRUPT HANDLERS ------------------------------------------------------
@@ -174,18 +369,8 @@ void voiceMod(uint32_t freq, uint8_t waveform) {
 void PDM_SERCOM_HANDLER(void) {
   uint16_t micReading = 0;
   if(pdmspi.decimateFilterWord(&micReading, true)) {
-    // So, the theory is, in the future some basic pitch detection could be
-    // added right about here, which could be used to improve the seam
-    // transitions in the playback interrupt (and possibly other things,
-    // like dynamic adjustment of the playback rate to do monotone and other
-    // effects). Actual usable pitch detection on speech turns out to be One
-    // Of Those Nearly Insurmountable Problems In Audio Processing...if
-    // you're thinking "oh just count the zero crossings" "just use an FFT"
-    // it's really not that simple, trust me, please, I've been reading
-    // everything on this, speech waveforms are jerks. Had the beginnings of
-    // some "maybe good enough approximation for a hacky microcontroller
-    // project" code here, but it's pulled out for now for the sake of
-    // getting something not-broken in folks' hands in a sensible timeframe.
+    // Pitch detection is NOT done here: it needs a block of samples and
+    // far more time than an interrupt can spare. See voicePitchTrack().
     if(++recIndex >= recBufSize) recIndex = 0;
     recBuf[recIndex] = micReading;
 
@@ -197,64 +382,11 @@ void PDM_SERCOM_HANDLER(void) {
     // but may still have some uses.
     voiceLastReading = micReading;
 
-    // Similarly, user code can extern these variables and monitor the
-    // peak-to-peak range. They are never reset in the voice code itself,
-    // it's the duty of the user code to reset both to 32768 periodically.
-    if(micReading < voiceMin)      voiceMin = micReading;
-    else if(micReading > voiceMax) voiceMax = micReading;
-  }
-}
-
-static void voiceOutCallback(void) {
-
-  // Modulation is done on the output (rather than the input) because
-  // pitch-shifting modulated input would cause weird waveform
-  // discontinuities. This does require recalculating the modulation table
-  // any time the pitch changes though.
-  if(modWave) {
-    nextOut = (((int32_t)nextOut - 2048) * (modBuf[modIndex] + 1) / 256) + 2048;
-    if(++modIndex >= modLen) modIndex = 0;
-  }
-
-  // Do analog writes pronto so output timing is consistent
-  analogWrite(A0, nextOut);
-  analogWrite(A1, nextOut);
-  // Then we can take whatever variable time for processing the next cycle...
-
-  if(++playbackIndex >= recBufSize) playbackIndex = 0;
-
-  if(jumping) {
-    // A waveform-blending transition is in-progress
-    uint32_t w1 = 65536UL * jumpCount / jump, // ramp playbackIndexJumped up (14 bits)
-             w2 = 65536UL - w1;               // ramp playbackIndex down (14 bits)
-    nextOut = (recBuf[playbackIndexJumped] * w1 + recBuf[playbackIndex] * w2) >> 20; // 28 bit result->12 bits
-    if(++jumpCount >= jump) {
-      playbackIndex = playbackIndexJumped;
-      jumpCount     = 1;
-      jumping       = false;
-    } else {
-      if(++playbackIndexJumped >= recBufSize) playbackIndexJumped = 0;
-    }
-  } else {
-    nextOut = recBuf[playbackIndex] >> 4; // 16->12 bit
-    if(playbackRate >= sampleRate) { // Sped up
-      // Playback may overtake recording, need to back off periodically
-      int16_t dist = (recIndex >= playbackIndex) ?
-        (recIndex - playbackIndex) : (recBufSize - (playbackIndex - recIndex));
-      if(dist <= jumpThreshold) {
-        playbackIndexJumped = playbackIndex - jump;
-        if(playbackIndexJumped < 0) playbackIndexJumped += recBufSize;
-        jumping             = true;
-      }
-    } else { // Slowed down
-      // Playback may underflow recording, need to advance periodically
-      int16_t dist = (playbackIndex >= recIndex) ?
-        (playbackIndex - recIndex) : (recBufSize - 1 - (recIndex - playbackIndex));
-      if(dist <= jumpThreshold) {
-        playbackIndexJumped = (playbackIndex + jump) % recBufSize;
-        jumping             = true;
-      }
-    }
+    // voiceMin and voiceMax (peak-to-peak range) are kept up from the
+    // recording buffer in voiceFill() rather than here, and voiceLevels()
+    // has more to offer. voiceMin and voiceMax are never reset in the
+    // voice code itself, it's the duty of the user code to reset both to
+    // 32768 periodically.
   }
 }
 
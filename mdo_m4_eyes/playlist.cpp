@@ -0,0 +1,109 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+//34567890123456789012345678901234567890123456789012345678901234567890123456
+
+#include "globals.h"
+#include "WearLog.h"
+
+extern Adafruit_Arcada arcada;
+
+// CONFIG PLAYLIST ---------------------------------------------------------
+
+// If PLAYLIST_FILE exists, it lists config files (one per line) and each
+// boot uses the next one in turn. Put an entry in more than once to have
+// it come up more often. Blank lines and lines starting with '#' are
+// skipped. The list itself is never rewritten; the only thing saved is a
+// boot counter, in a WearLog (see WearLog.h) in the program's own flash,
+// so each boot is one 16-byte write spread around many cells rather than
+// rewriting a file. Entry used = counter % number of entries. Editing the
+// list just continues from the same counter. Uploading a new sketch
+// erases the counter and starts back at the first entry.
+
+#define PLAYLIST_FILE    "mdo_m4_eyes.txt"
+#define PLAYLIST_MAXLINE 80 // Longest config path (bytes, incl. NUL)
+#define PLAYLIST_BLOCKS  2  // NVM erase blocks (8K each) used by log
+
+// Log region lives inside the program image (see nvm.cpp). Initialized
+// non-zero so it's kept in flash, not RAM; WearLog ignores (and erases)
+// whatever isn't a valid record. volatile because the contents change
+// underneath the compiler.
+static volatile const uint8_t playlistLog[PLAYLIST_BLOCKS * NVMCTRL_BLOCK_SIZE]
+  __attribute__((aligned(NVMCTRL_BLOCK_SIZE))) = { 0xFF };
+
+// Internal flash behind WearLog
+class NVMFlash : public WearLog::Flash {
+public:
+  uint32_t blockSize(void) { return NVMCTRL_BLOCK_SIZE; }
+  uint8_t  blocks(void)    { return PLAYLIST_BLOCKS; }
+  void read(uint32_t offset, uint32_t words[4]) {
+    volatile const uint32_t *src = (volatile const uint32_t *)&playlistLog[offset];
+    for(uint8_t i=0; i<4; i++) words[i] = src[i];
+  }
+  void write(uint32_t offset, const uint32_t words[4]) {
+    nvmWrite(&playlistLog[offset], words, 1);
+  }
+  void erase(uint8_t block) {
+    nvmErase(&playlistLog[block * NVMCTRL_BLOCK_SIZE]);
+  }
+};
+
+// Read the next line of the list into buf, without line ending. Returns
+// false at end of file.
+static bool readLine(File &file, char *buf) {
+  int c, len = 0;
+  if(!file.available()) return false;
+  while(((c = file.read()) >= 0) && (c != '\n')) {
+    if((c != '\r') && (len < (PLAYLIST_MAXLINE - 1))) buf[len++] = c;
+  }
+  buf[len] = 0;
+  return true;
+}
+
+static bool isEntry(const char *line) {
+  return line[0] && (line[0] != '#');
+}
+
+// Returns config filename for this boot from the playlist (a strdup()'d
+// string), or NULL if there's no playlist or it has no entries. Bumps
+// the boot counter either way if the list was usable.
+char *playlistConfig(void) {
+  File file;
+  char line[PLAYLIST_MAXLINE];
+  int  count = 0;
+
+  if(!fileReady(PLAYLIST_FILE) ||
+     !(file = arcada.open(PLAYLIST_FILE, FILE_READ))) return NULL;
+  while(readLine(file, line)) {
+    if(isEntry(line)) count++;
+  }
+  if(!count) {
+    file.close();
+    Serial.println(PLAYLIST_FILE " has no entries");
+    return NULL;
+  }
+
+  static NVMFlash nvm;
+  WearLog         log(&nvm);
+  log.begin();
+  uint32_t boots = log.value();
+  int      n     = boots % count;
+  char    *result = NULL;
+
+  file.seek(0);
+  while(readLine(file, line)) {
+    if(isEntry(line) && !n--) {
+      result = strdup(line);
+      break;
+    }
+  }
+  file.close();
+
+  log.append(boots + 1);
+  Serial.printf("Playlist entry %d of %d: %s\n", boots % count + 1, count,
+    result ? result : "?");
+  return result;
+}
@@ -14,21 +14,29 @@
 // This is not really an accurate representation of 3D rotation,
 // but works well enough for fooling the casual observer.
 
-void calcDisplacement() {
+// The table functions below can work a few rows at a time, so the
+// background loader (file.cpp) can build them between column transfers
+// while a placeholder eye animates. Each call does 'rows' rows starting
+// at 'y' (allocating on row 0, from memory.cpp's tables block) and
+// returns the next row to do; done when this reaches the table height.
+// Call with no arguments to do it all.
+
+int calcDisplacement(int y, int rows) {
   // To save RAM, the displacement map is calculated for ONE QUARTER of
   // the screen, then mirrored horizontally/vertically down the middle
   // when rendering. Additionally, only a single axis displacement need
   // be calculated, since eye shape is X/Y symmetrical one can just swap
   // axes to look up displacement on the opposing axis.
-  if(displace = (uint8_t *)malloc((DISPLAY_SIZE/2) * (DISPLAY_SIZE/2))) {
+  if(!y) displace = (uint8_t *)tablesAlloc((DISPLAY_SIZE/2) * (DISPLAY_SIZE/2));
+  if(displace) {
     float    eyeRadius2 = (float)(eyeRadius * eyeRadius);
-    uint8_t  x, y;
+    int      x, yEnd = min(y + rows, DISPLAY_SIZE/2);
     float    dx, dy, d2, d, h, a, pa;
-    uint8_t *ptr = displace;
+    uint8_t *ptr = &displace[y * (DISPLAY_SIZE/2)];
     // Displacement is calculated for the first quadrant in traditional
     // "+Y is up" Cartesian coordinate space; any mirroring or rotation
     // is handled in eye rendering code.
-    for(y=0; y<(DISPLAY_SIZE/2); y++) {
+    for(; y<yEnd; y++) {
       yield(); // Periodic yield() makes sure mass storage filesystem stays alive
       dy  = (float)y + 0.5;
       dy *= dy; // Now dy^2
@@ -51,28 +59,35 @@ void calcDisplacement() {
         }
       }
     }
+    return y; // Next row to do
   }
+  return DISPLAY_SIZE/2; // No memory, nothing more to do
 }
 
-void calcMap(void) {
+int calcMap(int y, int rows) {
   int pixels = mapRadius * mapRadius;
-  if(polarAngle = (uint8_t *)malloc(pixels * 2)) { // Single alloc for both tables
-    polarDist = (int8_t *)&polarAngle[pixels];     // Offset to second table
+  if(!y && (polarAngle = (uint8_t *)tablesAlloc(pixels * 2))) { // Single alloc for both tables
+    polarDist = &polarAngle[pixels];               // Offset to second table
+  }
+  if(polarAngle) {
 
     // CALCULATE POLAR ANGLE & DISTANCE
 
+    // Distance is stored as a fraction of mapRadius rather than relative
+    // to the iris edge. That way the same table serves both eyes even if
+    // they have different iris sizes or pupil shapes -- calcDistMap()
+    // makes a small per-eye table to convert this to iris/sclera distance.
     float mapRadius2  = mapRadius * mapRadius;  // Radius squared
-    float iRad        = screen2map(irisRadius); // Iris size in in polar map pixels
-    float irisRadius2 = iRad * iRad;            // Iris size squared
+    float distScale   = (float)POLAR_DIST_MAX / (float)mapRadius;
 
-    uint8_t *anglePtr = polarAngle;
-    int8_t  *distPtr  = polarDist;
+    uint8_t *anglePtr = &polarAngle[y * mapRadius];
+    uint8_t *distPtr  = &polarDist[y * mapRadius];
 
     // Like the displacement map, only the first quadrant is calculated,
     // and the other three quadrants are mirrored/rotated from this.
-    int   x, y;
-    float dx, dy, dy2, d2, d, angle, xp;
-    for(y=0; y<mapRadius; y++) {
+    int   x, yEnd = min(y + rows, mapRadius);
+    float dx, dy, dy2, d2, angle;
+    for(; y<yEnd; y++) {
       yield(); // Periodic yield() makes sure mass storage filesystem stays alive
       dy  = (float)y + 0.5;        // Y distance to map center
       dy2 = dy * dy;
@@ -81,68 +96,99 @@ void calcMap(void) {
         d2 = dx * dx + dy2;        // Distance to center of map, squared
         if(d2 > mapRadius2) {      // If it exceeds 1/2 map size, squared,
           *anglePtr++ = 0;         // then mark as out-of-eye-bounds
-          *distPtr++  = -128;
+          *distPtr++  = 255;
         } else {                   // else pixel is within eye area...
           angle  = atan2(dy, dx);  // -pi to +pi (0 to +pi/2 in 1st quadrant)
           angle  = M_PI_2 - angle; // Clockwise, 0 at top
           angle *= 512.0 / M_PI;   // 0 to <256 in 1st quadrant
           *anglePtr++ = (uint8_t)angle;
-          d = sqrt(d2);
-          if(d2 > irisRadius2) {
-            // Point is in sclera
-            d = (mapRadius - d) / (mapRadius - iRad);
-            d *= 127.0;
-            *distPtr++ = (int8_t)d; // 0 to 127
-          } else {
-            // Point is in iris (-dist to indicate such)
-            d = (iRad - d) / iRad;
-            d *= -127.0;
-            *distPtr++ = (int8_t)d - 1; // -1 to -127
-          }
+          *distPtr++  = (uint8_t)(sqrt(d2) * distScale + 0.5); // 0 to 254
         }
       }
     }
+    return y; // Next row to do
+  }
+  return mapRadius; // No memory, nothing more to do
+}
+
+// Per-eye part of the polar map. distMap[] converts the shared polarDist
+// radius to the signed distance used by the renderer: 0 to 127 in sclera
+// (127 at iris edge), -1 to -127 in iris (-127 at center), -128 off map.
+// This is what used to be baked into polarDist for a single iris size.
+void calcDistMap(irisShape *shape, int iRadius, int slitRadius) {
+  float iRad = screen2map(iRadius); // Iris size in polar map pixels
+  int   i, v;
+  float d;
 
-    // If slit pupil is enabled, override iris area of polarDist map.
-    if(slitPupilRadius > 0) {
-      // Iterate over each pixel in the iris section of the polar map...
-      for(y=0; y < mapRadius; y++) {
-        yield(); // Periodic yield() makes sure mass storage filesystem stays alive
-        dy  = y + 0.5;            // Distance to center, Y component
-        dy2 = dy * dy;
-        for(x=0; x < mapRadius; x++) {
-          dx = x + 0.5;           // Distance to center point, X component
-          d2 = dx * dx + dy2;     // Distance to center, squared
-          if(d2 <= irisRadius2) { // If inside iris...
-            yield();
-            xp = x + 0.5;
-            // This is a bit ugly in that it iteratively calculates the
-            // polarDist value...trial and error. It should be possible to
-            // algebraically simplify this and find the single polarDist
-            // point for a given pixel, but I've not worked that out yet.
-            // This is only needed once at startup, not a complete disaster.
-            for(int i=126; i>=0; i--) {
-              float ratio = i / 128.0; // 0.0 (open) to just-under-1.0 (slit) (>= 1.0 will cause trouble)
-              // Interpolate a point between top of iris and top of slit pupil, based on ratio
-              float y1 = iRad - (iRad - slitPupilRadius) * ratio;
-              // (x1 is 0 and thus dropped from equation below)
-              // And another point between right of iris and center of eye, inverse ratio
-              float x2 = iRad * (1.0 - ratio);
-              // (y2 is also zero, same deal)
-              // Find X coordinate of center of circle that crosses above two points
-              // and has Y at 0.0
-              float xc = (x2 * x2 - y1 * y1) / (2 * x2);
-              dx = x2 - xc;       // Distance from center of circle to right edge
-              float r2 = dx * dx; // center-to-right distance squared
-              dx = xp - xc;       // X component of...
-              d2 = dx * dx + dy2; // Distance from pixel to left 'xc' point
-              if(d2 <= r2) {      // If point is within circle...
-                polarDist[y * mapRadius + x] = (int8_t)(-1 - i); // Set to distance 'i'
-                break;
-              }
-            }
+  for(i=0; i<=POLAR_DIST_MAX; i++) {
+    d = (float)i * (float)mapRadius / (float)POLAR_DIST_MAX; // Map pixels
+    if(d > iRad) {
+      // Point is in sclera
+      v = (int)((mapRadius - d) / (mapRadius - iRad) * 127.0); // 0 to 127
+    } else {
+      // Point is in iris (-dist to indicate such)
+      v = (int)((iRad - d) / iRad * -127.0) - 1; // -1 to -127
+      if(v < -127) v = -127; // Dead center would otherwise be 'off map'
+    }
+    shape->distMap[i] = v;
+  }
+  shape->distMap[255] = -128; // Off map
+
+  if(shape->slitMap) {
+    slitFree(shape->slitMap);
+    shape->slitMap = NULL;
+  }
+  // If slit pupil is enabled, make a small table (angle & radius) that
+  // overrides the iris area of distMap. A slit isn't radially symmetric
+  // so it can't be a simple 1D remap, but it IS symmetric on both axes,
+  // so one quadrant at fairly coarse resolution is plenty once the
+  // renderer interpolates between radii.
+  if((slitRadius > 0) &&
+     (shape->slitMap = slitAlloc())) {
+    // Scale polarDist radius to table column, 8.8 fixed point. A tiny
+    // iris would overflow 16 bits; anything past SLIT_RADII columns per
+    // polarDist step already puts every radius off the table's far end.
+    float scale = 256.0 * SLIT_RADII * mapRadius / (iRad * POLAR_DIST_MAX) + 0.5;
+    shape->slitScale = ((iRad > 0.0) && (scale < (float)(SLIT_RADII * 256))) ?
+                       (uint16_t)scale : (SLIT_RADII * 256);
+    uint8_t *ptr = shape->slitMap;
+    for(int a=0; a<SLIT_ANGLES; a++) {
+      yield(); // Periodic yield() makes sure mass storage filesystem stays alive
+      // Angle is clockwise from top (slit axis), same as polarAngle
+      float pa = ((float)a + 0.5) * M_PI_2 / (float)SLIT_ANGLES;
+      for(int r=0; r<=SLIT_RADII; r++) {
+        float pd  = (float)r * iRad / (float)SLIT_RADII;
+        float xp  = pd * sin(pa); // Sample point, X & Y distance to center
+        float dy  = pd * cos(pa);
+        float dy2 = dy * dy;
+        float dx, d2;
+        *ptr = 0;                 // Iris edge if not matched below
+        // This is a bit ugly in that it iteratively calculates the
+        // polarDist value...trial and error. It should be possible to
+        // algebraically simplify this and find the single polarDist
+        // point for a given pixel, but I've not worked that out yet.
+        // This is only needed once at startup, not a complete disaster.
+        for(int i=126; i>=0; i--) {
+          float ratio = i / 128.0; // 0.0 (open) to just-under-1.0 (slit) (>= 1.0 will cause trouble)
+          // Interpolate a point between top of iris and top of slit pupil, based on ratio
+          float y1 = iRad - (iRad - slitRadius) * ratio;
+          // (x1 is 0 and thus dropped from equation below)
+          // And another point between right of iris and center of eye, inverse ratio
+          float x2 = iRad * (1.0 - ratio);
+          // (y2 is also zero, same deal)
+          // Find X coordinate of center of circle that crosses above two points
+          // and has Y at 0.0
+          float xc = (x2 * x2 - y1 * y1) / (2 * x2);
+          dx = x2 - xc;       // Distance from center of circle to right edge
+          float r2 = dx * dx; // center-to-right distance squared
+          dx = xp - xc;       // X component of...
+          d2 = dx * dx + dy2; // Distance from pixel to left 'xc' point
+          if(d2 <= r2) {      // If point is within circle...
+            *ptr = i;         // Set to distance 'i'
+            break;
           }
         }
+        ptr++;
       }
     }
   }
@@ -17,7 +17,7 @@ extern volatile uint16_t voiceLastReading, voiceMin, voiceMax; // In pdmvoice.cp
 // even if not using sound output...we're using it to steal
 // access to the mic here.
 #define SOUND_KEYCODE_TO_SEND        HID_KEY_SPACE
-#define SOUND_THRESHOLD              10000
+#define SOUND_THRESHOLD              300 // voiceLevels() level, 0-2048
 
 // HID report descriptor using TinyUSB's template
 // Single Report (no ID) descriptor
@@ -71,14 +71,13 @@ void user_loop(void) {
     keycode[3] = SHAKE_KEYCODE_TO_SEND;
   }
 
-  uint16_t p2p = voiceMax - voiceMin; // Max peak-to-peak since last reading
-  if(p2p) { // usu. non-zero if voice changer enabled
-    if(p2p > SOUND_THRESHOLD) {
+  soundLevels sound;
+  if(voiceLevels(&sound)) { // Only if voice changer enabled
+    if(sound.level > SOUND_THRESHOLD) {
       Serial.println("Sound");
       keycode[4] = SOUND_KEYCODE_TO_SEND;
     }
   }
-  voiceMin = voiceMax = 32768; // Reset p2p range for next pass
 
   bool anypressed = false;
   for (int k=0; k<sizeof(keycode); k++) {
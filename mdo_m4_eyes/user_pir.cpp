@@ -10,52 +10,28 @@
 
 #define PIR_PIN 3  // PIR sensor on D3 connector (between MIC & BAT)
 
-static uint8_t priorState;
+static uint8_t priorState = 0xFF; // Not read yet
 
 void user_setup(void) {
   pinMode(PIR_PIN, INPUT);
-  priorState = digitalRead(PIR_PIN);
-  for(uint8_t e=0; e<NUM_EYES; e++) {
-    // Init to DEBLINK with an impossibly large duration to hold eyes shut.
-    eye[e].blink.state     = DEBLINK;
-    eye[e].blink.duration  = 0x7FFFFFFF;
-    eye[e].blink.startTime = micros();
-  }
+  // Start with eyes shut. The closed pose holds until changed; blinks
+  // still happen but can't open the lids past the pose.
+  lidPoseTo(-1, LID_POSE_CLOSED, 0, LID_EASE_LINEAR);
 }
 
 void user_loop(void) {
-  uint8_t e, newState = digitalRead(PIR_PIN);
+  // Read in the loop, even the first time, so recordings replay it
+  uint8_t newState = animInput(ANIM_IN_PIR, digitalRead(PIR_PIN));
+  if(priorState == 0xFF) priorState = newState;
   if(newState != priorState) {
     if(newState) {
-      // Initial motion sensed
-      for(e=0; e<NUM_EYES; e++) {          // For each eye...
-        eye[e].blink.state     = DEBLINK;  // Opening...
-        eye[e].blink.duration  = 500000;   // Slowly, about 1/2 sec
-        eye[e].blink.startTime = micros(); // Starting now
-      }
+      // Initial motion sensed. Open slowly, about 1/2 sec
+      lidPoseTo(-1, LID_POSE_OPEN, 500000, LID_EASE_OUT);
     } else {
-      // PIR timeout; "end" of motion
-      for(e=0; e<NUM_EYES; e++) {            // For each eye...
-        if(eye[e].blink.state != ENBLINK) {  // If not already blinking...
-          eye[e].blink.state     = ENBLINK;  // Start closing...
-          eye[e].blink.duration  = 1500000;  // Even slower, about 1.5 sec
-          eye[e].blink.startTime = micros(); // Starting now
-        }
-      }
+      // PIR timeout; "end" of motion. Close even slower, about 1.5 sec
+      lidPoseTo(-1, LID_POSE_CLOSED, 1500000, LID_EASE_INOUT);
     }
     priorState = newState;
-  } else if(!newState) {
-    // No change in state. If currently no motion active,
-    // force eyes into closed position at every opportunity.
-    for(e=0; e<NUM_EYES; e++) {           // For each eye...
-      if(eye[e].blink.state != ENBLINK) { // If not currently blinking...
-        // Set to DEBLINK with an impossibly large duration -- eyes will
-        // hold shut until motion event above resets start & duration.
-        eye[e].blink.state     = DEBLINK;
-        eye[e].blink.duration  = 0x7FFFFFFF;
-        eye[e].blink.startTime = micros();
-      }
-    }
   }
 }
 
@@ -6,246 +6,94 @@
 
 #include "globals.h"
 
+// NeoPixel behaviors, chosen with the buttons and changing every 50 s on
+// their own. Each is a keyframe animation (LedAnim.h) played by
+// neopixels.cpp: faded in fixed point, gamma corrected, and only shown
+// when the pixels change. Built in below; a leds.json on the board with
+// animations of the same names replaces them (mdo_EyeConfig/leds.json,
+// which these tables are made from by led_anim_compile.py --c).
+
 static uint32_t lastTouchSample;
 static uint32_t lastBehaviorChange;
-static uint32_t lastWave;
 
 static int currentBehavior = 0;
 
-static int colorIndex  = 0;
-
 const uint32_t SAMPLE_TIME = 50000;
 const uint32_t TOUCH_SAMPLE_TIME = SAMPLE_TIME * 15;
-static uint8_t currentStep = 100;
-static int direction = -3;
-static uint32_t lastColorShift;
-const int N_HEARTBEAT_FRAMES = 20;
-static uint8_t currentHeartBeatStep = 0;
-static uint8_t heartbeat[] = { 80, 80, 80, 80, 20,
-                              20, 120, 255, 255, 120,
-                              80, 40, 20, 0, 0,
-                              0, 0, 0, 0, 0 };
-
-const int N_BREATH_IN_FRAMES = 45;
-static uint8_t currentBreathStep = 0;
-static uint16_t breathIn[] = { 7, 14, 21, 28, 35,
-                            42, 49, 56, 63, 70,
-                            77, 84, 91, 98, 105,
-                            112, 119, 126, 133, 140,
-                            147, 154, 161, 168, 175,
-                            182, 189, 196, 203, 210,
-                            217, 224, 231, 238, 255,
-                            255, 255, 255, 255, 255,
-                            255, 255, 255, 255, 255};
-
-const int N_BREATH_OUT_FRAMES = 45;
-static uint16_t breathOut[] = { 255, 255, 255, 255, 255, 255, 255, 255, 255, 
-                                255, 255, 238, 231, 224, 217, 210, 203, 196, 
-                                189, 182, 175, 168, 161, 154, 147, 140, 133, 
-                                126, 119, 112, 105, 98, 91, 84, 77, 70, 63, 
-                                56, 49, 42, 35, 28, 21, 14, 7};
-
-static int breathFrames = N_BREATH_IN_FRAMES;
-static uint16_t *breath = breathIn;
-
-void setGradientPixelColor(uint16_t ledPosition, uint16_t step, float redRatio, float greenRatio, float blueRatio)
-{
-    float green = step * greenRatio;
-    float red = step * redRatio;
-    float blue = step * blueRatio;
-    arcada.pixels.setPixelColor(ledPosition, red, green, blue);
-}
- 
-void stepGreenBlackGradient(uint16_t ledPosition, uint16_t step) {
-    setGradientPixelColor(ledPosition, step, 0, 1, 0);
-}
- 
-void stepOrangeBlackGradient(uint16_t ledPosition, uint16_t step) {
-    setGradientPixelColor(ledPosition, step, 1, 0.64453125, 0);
-}
- 
-void stepPurpleBlackGradient(uint16_t ledPosition, uint16_t step) {
-    setGradientPixelColor(ledPosition, step, 0.8815, 0.4028, 1);
-}
- 
-void stepRedBlackGradient(uint16_t ledPosition, uint16_t step) {
-    setGradientPixelColor(ledPosition, step, 1, 0, 0);
-}
- 
-void stepYellowBlackGradient(uint16_t ledPosition, uint16_t step) {
-    setGradientPixelColor(ledPosition, step, 1, 1, 0);
-}
- 
-void stepWhiteBlackGradient(uint16_t ledPosition, uint16_t step) {
-    setGradientPixelColor(ledPosition, step, 1, 1, 1);
-}
- 
-void stepRedOrangeGradient(uint16_t ledPosition, uint16_t step) {
-    int red = 255;
-    float green = step * .647;
-    int blue = 0;
-    arcada.pixels.setPixelColor(ledPosition, red, green, blue);
-}
- 
-void stepOrangeYellowGradient(uint16_t ledPosition, uint16_t step) {
-    int red = 255;
-    float green = 165 + (step % 90);
-    int blue = 0;
-    arcada.pixels.setPixelColor(ledPosition, red, green, blue);
-}
- 
-void stepYellowGreenGradient(uint16_t ledPosition, uint16_t step) {
-    int red = 255 - step * 2;
-    float green = 255 - (step * 1.5);
-    int blue = 0;
-    arcada.pixels.setPixelColor(ledPosition, red, green, blue);
-}
- 
-void stepGreenBlueGradient(uint16_t ledPosition, uint16_t step) {
-    int red = 0;
-    float green = 128 - step;
-    int blue = step;
-    arcada.pixels.setPixelColor(ledPosition, red, green, blue);
-}
- 
-void stepBlueIndigoGradient(uint16_t ledPosition, uint16_t step) {
-    int red = step;
-    float green = 0;
-    int blue = 255 - step;
-    arcada.pixels.setPixelColor(ledPosition, red, green, blue);
-}
- 
-void stepIndigoVioletGradient(uint16_t ledPosition, uint16_t step) {
-    int red = 75+step;
-    float green = step;
-    int blue = 130+step;
-    arcada.pixels.setPixelColor(ledPosition, red, green, blue);
-}
- 
-void stepVioletRedGradient(uint16_t ledPosition, uint16_t step) {
-    int red = 238+(step*.17);
-    float green = 130 - step;
-    int blue = 238 - (step * 2);
-    arcada.pixels.setPixelColor(ledPosition, red, green, blue);
-}
-
-typedef void (*StepColorGradient)(uint16_t, uint16_t);
-
-static uint16_t rainbowWalkLEDSteps[] = {5, 6, 1, 4};
-const int N_RAINBOW_GRADIENTS = 7;
-// ROY G BIV
-static StepColorGradient rainbowWalkGradients[] = {  &stepRedOrangeGradient,
-                                                     &stepOrangeYellowGradient,
-                                                     &stepYellowGreenGradient,
-                                                     &stepGreenBlueGradient,
-                                                     &stepBlueIndigoGradient,
-                                                     &stepIndigoVioletGradient,
-                                                     &stepVioletRedGradient,
-                                                  };
-static uint32_t lastRainbowColorShift;
 
-void advanceRainbowWalk(void) {
-    uint16_t i;
-    for(i = 0; i < arcada.pixels.numPixels(); i++) {
-        rainbowWalkGradients[rainbowWalkLEDSteps[i]](i, currentStep);
-    }
-    currentStep = currentStep + 25;
-    if(currentStep > 100) {
-      currentStep = 0;
-      for(i = 0; i < arcada.pixels.numPixels(); i++) {
-        rainbowWalkLEDSteps[i] = rainbowWalkLEDSteps[i] + 1;
-        if(rainbowWalkLEDSteps[i] >= N_RAINBOW_GRADIENTS) {
-          rainbowWalkLEDSteps[i] = 0;
-        }
-      }
-    }
-    arcada.pixels.show();
-}
-
-static StepColorGradient breathGradient = &stepRedBlackGradient;
-
-void advanceBreath(void)
-{  
-    uint16_t i;
-    for(i = 0; i < arcada.pixels.numPixels(); i++) {
-        breathGradient(i, breath[currentBreathStep]);
-    }
-    arcada.pixels.show();
-    
-    if(currentBreathStep == breathFrames - 1) {
-        currentBreathStep = 0;
-        if(breath == breathIn) {
-          breath = breathOut;
-          breathFrames = N_BREATH_OUT_FRAMES;
-          breathGradient = &stepRedBlackGradient;
-        }
-        else {          
-          breath = breathIn;
-          breathFrames = N_BREATH_IN_FRAMES;
-          breathGradient = &stepRedBlackGradient;
-        }
-    }
-    else {
-        currentBreathStep = currentBreathStep + 1;
-    }
-}
- 
-void advanceHalloweenGradients(void) {
-    for(int i = 0; i < arcada.pixels.numPixels(); i++) {
-        switch (colorIndex) {
-            case 0:
-                stepOrangeBlackGradient(i, currentStep);
-                break;
-            case 1:
-                stepRedBlackGradient(i, currentStep);
-                break;
-            case 2:
-                stepYellowBlackGradient(i, currentStep);
-                break;
-            default:
-                stepWhiteBlackGradient(i, currentStep);
-                break;
-        }
-    }
-    arcada.pixels.show();
-
-    if(currentStep <= 0) {
-        direction = 3;
-        // shift to next color
-        colorIndex = colorIndex + 1;
-        if(colorIndex >= arcada.pixels.numPixels()) {
-            colorIndex = 0;
-        }
-    }
-    else if(currentStep >= 100) {
-        direction = -3;
-    }
-    currentStep = currentStep + direction;
-}
- 
-void advanceHeartBeat(void) {
-    int i;
-    for(i = 0; i < arcada.pixels.numPixels(); i++) {
-        stepRedBlackGradient(i, heartbeat[currentHeartBeatStep]);
-    }
-    arcada.pixels.show();
-    
-    if(currentHeartBeatStep == N_HEARTBEAT_FRAMES - 1) {
-        currentHeartBeatStep = 0;
-    } else {
-        currentHeartBeatStep = currentHeartBeatStep + 1;
-    }
-}
-
-void changeBehavior(int newBehavior, uint32_t timeOfChange) {  
-    currentBehavior = newBehavior;
-    lastBehaviorChange = timeOfChange;
+// From leds.json by mdo_EyeConfig/led_anim_compile.py
+static const ledKey halloweenKeys[] = {
+  {     0,   0,   0,   0 },
+  {  1700, 178, 150,   0 },
+  {  3400,   0,   0,   0 },
+  {  5100, 178,   0,   0 },
+  {  6800,   0,   0,   0 },
+  {  8500, 178, 178,   0 },
+  { 10200,   0,   0,   0 },
+  { 11900, 178, 178, 178 },
+  { 13600,   0,   0,   0 },
+};
+static const ledAnim halloween = { halloweenKeys, 9, 0 };
+static const ledKey heartbeatKeys[] = {
+  {     0, 163,   0,   0 },
+  {   150, 163,   0,   0 },
+  {   200,  95,   0,   0 },
+  {   250,  95,   0,   0 },
+  {   300, 191,   0,   0 },
+  {   350, 255,   0,   0 },
+  {   400, 255,   0,   0 },
+  {   450, 191,   0,   0 },
+  {   500, 163,   0,   0 },
+  {   550, 125,   0,   0 },
+  {   600,  95,   0,   0 },
+  {   650,   0,   0,   0 },
+  {   950,   0,   0,   0 },
+  {  1000, 163,   0,   0 },
+};
+static const ledAnim heartbeat = { heartbeatKeys, 14, 0 };
+static const ledKey breathKeys[] = {
+  {     0,  63,   0,   0 },
+  {  1700, 255,   0,   0 },
+  {  2800, 255,   0,   0 },
+  {  4500,  63,   0,   0 },
+};
+static const ledAnim breath = { breathKeys, 4, 0 };
+static const ledKey rainbowKeys[] = {
+  {     0, 255,   0,   0 },
+  {   250, 255, 215,   0 },
+  {   500, 255, 255,   0 },
+  {   750,   0, 195,   0 },
+  {  1000,   0,   0, 255 },
+  {  1250, 159,   0, 197 },
+  {  1500, 248, 197, 248 },
+  {  1750, 255,   0,   0 },
+};
+static const ledAnim rainbow = { rainbowKeys, 8, 500 };
+
+// Up, down, left, right buttons
+static const struct {
+  const char    *name;    // In leds.json
+  const ledAnim *builtIn;
+} behaviors[] = {
+  { "halloween", &halloween },
+  { "heartbeat", &heartbeat },
+  { "breath",    &breath    },
+  { "rainbow",   &rainbow   },
+};
+const int N_BEHAVIORS = sizeof behaviors / sizeof behaviors[0];
+
+void changeBehavior(int newBehavior, uint32_t timeOfChange) {
+  currentBehavior = newBehavior;
+  lastBehaviorChange = timeOfChange;
+  const ledAnim *a = pixelsFind(behaviors[newBehavior].name);
+  pixelsPlay(a ? a : behaviors[newBehavior].builtIn);
 }
 
 void user_setup(void) {
-  lastBehaviorChange, lastWave, lastColorShift, lastRainbowColorShift, lastTouchSample = micros();
+  lastTouchSample = micros();
   arcada.pixels.setBrightness(255);
-  advanceHalloweenGradients();
+  pixelsBegin();
+  pixelsLoad("leds.json");
   changeBehavior(0, micros());
 }
 
@@ -253,9 +101,9 @@ void user_loop(void) {
   uint32_t elapsedSince = micros();
   if(elapsedSince - lastTouchSample > TOUCH_SAMPLE_TIME) {
     lastTouchSample = elapsedSince;
-    uint8_t pressed_buttons = arcada.readButtons();
+    arcada.readButtons();
     uint8_t justpressed_buttons = arcada.justPressedButtons();
-    
+
     if (justpressed_buttons & ARCADA_BUTTONMASK_UP){
       changeBehavior(0, elapsedSince);
     }
@@ -269,34 +117,12 @@ void user_loop(void) {
       changeBehavior(3, elapsedSince);
     }
   }
-    
-  if (elapsedSince - lastWave > SAMPLE_TIME) {
-    lastWave = elapsedSince;
-    switch (currentBehavior) {
-      case 0:
-        advanceHalloweenGradients();
-        break;
-      case 1:
-        advanceHeartBeat();
-        break;
-      case 2:
-        advanceBreath();
-        break;
-      case 3:
-        advanceRainbowWalk();
-        break;
-      default:        
-        arcada.pixels.fill(0, 0, 0);
-        arcada.pixels.show();
-        break;
-    }
 
-    if ((elapsedSince - lastBehaviorChange) > (SAMPLE_TIME * 1000)) {
-      lastBehaviorChange = elapsedSince;
-      currentBehavior++;
-      currentBehavior %= 4;
-    }
+  if ((elapsedSince - lastBehaviorChange) > (SAMPLE_TIME * 1000)) {
+    changeBehavior((currentBehavior + 1) % N_BEHAVIORS, elapsedSince);
   }
+
+  pixelsService(); // Renders every frame, shows only when changed
 }
 
 #endif
@@ -39,8 +39,15 @@ void user_loop(void) {
   heatSensor.find_focus();
 
   // Set values for the new X and Y.
-  eyeTargetX = heatSensor.x;
-  eyeTargetY = -heatSensor.y;
+  // (through animInput() so recordings replay it, see animclock.cpp)
+  eyeTargetX = animInputFloat(ANIM_IN_HEATX, heatSensor.x);
+  eyeTargetY = -animInputFloat(ANIM_IN_HEATY, heatSensor.y);
+
+  // Warmer = closer, roughly: a face ~33 C at arm's length, reading
+  // cooler as it gets further away and fills less of a sensor pixel.
+  float heat = animInputFloat(ANIM_IN_HEATMAG, heatSensor.magnitude);
+  vergenceTarget((heat >= 33.0) ? 300.0 : (heat <= 26.0) ? 2000.0 :
+    2000.0 - (heat - 26.0) * (1700.0 / 7.0));
 }
 
 #endif // 0
@@ -0,0 +1,234 @@
+// This code -     https://github.com/Mark-MDO47/mdo_m4_eyes.git
+//                   directory mdo_m4_eyes
+// Author:  https://github.com/Mark-MDO47
+// Date:    2026-10-19
+// License: MIT
+
+//34567890123456789012345678901234567890123456789012345678901234567890123456
+
+#include "globals.h"
+#include "WavStream.h"
+#include "WavCatalog.h"
+
+extern Adafruit_Arcada arcada;
+
+// WAV PLAYER --------------------------------------------------------------
+
+// Plays a WAV file out the speaker (A0 & A1) while the eyes carry on, for
+// user code (user_fizzgig.cpp). The file is read and decoded in loop()
+// (wavService(), every column like voiceFill()) into WavStream's ring;
+// the timer interrupt only takes the next sample out of it, so it never
+// waits on the filesystem. One file at a time; not while the voice
+// changer has the speaker. wavCatalog() indexes a directory once so
+// clips can be played by name or tag without scanning or parsing again.
+
+static WavStream wav;
+static File      wavFile;
+static bool      wavOn = false; // Timer running
+
+static uint32_t wavFileRead(void *ctx, uint8_t *buf, uint32_t n) {
+  int got = ((File *)ctx)->read(buf, n);
+  return (got > 0) ? got : 0;
+}
+
+static bool wavFileSkip(void *ctx, uint32_t n) {
+  return ((File *)ctx)->seekCur(n);
+}
+
+static void wavOutCallback(void) {
+  uint16_t n = wav.take();
+  analogWrite(A0, n);
+  analogWrite(A1, n);
+}
+
+// Output from a file positioned at its first sample
+static bool wavStart(const wavFormat &f, uint32_t rate, const char *name) {
+  wav.begin(wavFileRead, &wavFile, f, rate);
+  wav.service(); // Ring full before the timer starts on it
+  analogWriteResolution(12);
+  analogWrite(A0, 2048);
+  analogWrite(A1, 2048);
+  arcada.enableSpeaker(true);
+  arcada.timerCallback(wav.rate(), wavOutCallback);
+  wavOn = true;
+  Serial.printf("WAV: %s, %d Hz %s, %d.%02d s\n", name, f.rate,
+    (f.format == WAV_IMA_ADPCM) ? "ADPCM" : (f.bits == 8) ? "8-bit" : "16-bit",
+    f.frames / f.rate, f.frames % f.rate * 100 / f.rate);
+  return true;
+}
+
+// False (with a message) if the voice changer's using the speaker
+static bool wavSpeakerFree(void) {
+#if defined(ADAFRUIT_MONSTER_M4SK_EXPRESS)
+  if(voiceOn) {
+    Serial.println("WAV: voice changer has the speaker");
+    return false;
+  }
+#endif
+  return true;
+}
+
+// Starts playing 'filename' (8/16-bit PCM or IMA ADPCM, mono or stereo),
+// at 'rate' Hz output (0 = the file's own rate, else converted to it).
+// Stops anything already playing.
+bool wavPlay(const char *filename, uint32_t rate) {
+  wavStop();
+  if(!wavSpeakerFree()) return false;
+  if(!(wavFile = arcada.open(filename))) {
+    Serial.println("Failed to open WAV file");
+    return false;
+  }
+  wavFormat f;
+  if(!wavParse(wavFileRead, wavFileSkip, &wavFile, &f)) {
+    Serial.println("WAV isn't 8/16-bit PCM or IMA ADPCM, mono or stereo");
+    wavFile.close();
+    return false;
+  }
+  return wavStart(f, rate, filename);
+}
+
+// Called from loop(): reads and decodes ahead, stops at the end
+void wavService(void) {
+  if(!wavOn) return;
+  wav.service();
+  if(wav.done()) wavStop();
+}
+
+bool wavPlaying(void) {
+  return wavOn;
+}
+
+// For lip sync: each block heard since the last call, oldest first, with
+// its loudness and when it finished (ms since the clip started). false
+// when there are no more. See WavStream::heard() and LipSync.h.
+bool wavHeard(uint16_t *level, uint32_t *ms) {
+  return wav.heard(level, ms);
+}
+
+void wavStop(void) {
+  if(!wavOn) return;
+  arcada.timerStop();
+  arcada.enableSpeaker(false);
+  wav.stop();
+  wavFile.close();
+  wavOn = false;
+  if(wav.underruns()) Serial.printf("WAV: %d underruns\n", wav.underruns());
+}
+
+// WAV CATALOG -------------------------------------------------------------
+
+static WavCatalog wavCat;
+static char       wavDir[SD_MAX_FILENAME_SIZE+1];
+
+// Catalogs the WAV files in 'dir' for wavPlayClip(), wavFind() and
+// wavPick(). Loads dir/WAV_CAT_FILE if it matches the directory (same
+// names and sizes, so only directory entries are read); otherwise reads
+// each file's header and rewrites it. Call again after changing files.
+// Files that aren't playable are listed but won't play. Returns the
+// number of files.
+uint8_t wavCatalog(const char *dir) {
+  char    name[SD_MAX_FILENAME_SIZE+1], path[SD_MAX_FILENAME_SIZE*2+2];
+  uint8_t rec[WAV_CAT_RECORD], found = 0;
+  bool    stale = true;
+  wavCat.clear();
+  strncpy(wavDir, dir, sizeof wavDir - 1);
+  wavDir[sizeof wavDir - 1] = 0;
+  snprintf(path, sizeof path, "%s/%s", dir, WAV_CAT_FILE);
+
+  File file = arcada.open(path, FILE_READ);
+  if(file) {
+    int16_t c = -1;
+    if(file.read(rec, WAV_CAT_HEAD) == WAV_CAT_HEAD) c = wavCat.unpackHeader(rec);
+    for(int16_t i=0; i<c; i++) {
+      if((file.read(rec, WAV_CAT_RECORD) != WAV_CAT_RECORD) || !wavCat.unpack(rec)) c = -1;
+    }
+    file.close();
+    stale = (c < 0);
+  }
+  // Same files as the directory has now?
+  for(uint8_t i=0; !stale && (found < WAV_CAT_MAX); i++) {
+    File entry = arcada.openFileByIndex(dir, i, FILE_READ, "wav");
+    if(!entry) break;
+    entry.getName(name, sizeof name);
+    if(strlen(name) < WAV_CAT_NAME) { // Longer ones never go in
+      int8_t x = wavCat.find(name);
+      if((x < 0) || (wavCat.entry(x)->fileSize != entry.size())) stale = true;
+      found++;
+    }
+    entry.close();
+  }
+  if(!stale && (found == wavCat.count())) return found;
+
+  wavCat.clear();
+  for(uint8_t i=0; wavCat.count() < WAV_CAT_MAX; i++) {
+    File entry = arcada.openFileByIndex(dir, i, FILE_READ, "wav");
+    if(!entry) break;
+    entry.getName(name, sizeof name);
+    wavFormat f;
+    if(!wavParse(wavFileRead, wavFileSkip, &entry, &f)) {
+      memset(&f, 0, sizeof f); // Listed, won't play
+      Serial.printf("WAV catalog: %s isn't playable\n", name);
+    }
+    if(!wavCat.add(name, entry.size(), f)) {
+      Serial.printf("WAV catalog: %s skipped, name too long\n", name);
+    }
+    entry.close();
+  }
+  if((file = arcada.open(path, O_WRITE | O_CREAT | O_TRUNC))) {
+    wavCat.packHeader(rec);
+    file.write(rec, WAV_CAT_HEAD);
+    for(uint8_t i=0; i<wavCat.count(); i++) {
+      wavCat.pack(i, rec);
+      file.write(rec, WAV_CAT_RECORD);
+    }
+    file.close();
+  } else {
+    Serial.printf("Can't write %s\n", path);
+  }
+  Serial.printf("WAV catalog: %d files in %s\n", wavCat.count(), dir);
+  return wavCat.count();
+}
+
+// Plays catalog entry 'i' (see wavCatalog()), going straight to its
+// samples. Same as wavPlay() otherwise.
+bool wavPlayClip(int8_t i, uint32_t rate) {
+  const wavEntry *w = wavCat.entry(i);
+  char            path[SD_MAX_FILENAME_SIZE*2+2];
+  wavStop();
+  if(!w || !w->fmt.format || !wavSpeakerFree()) return false;
+  snprintf(path, sizeof path, "%s/%s", wavDir, w->name);
+  if(!(wavFile = arcada.open(path))) {
+    Serial.printf("Failed to open %s\n", path);
+    return false;
+  }
+  if((wavFile.size() != w->fileSize) || !wavFile.seek(w->fmt.dataOffset)) {
+    Serial.printf("%s changed since wavCatalog()\n", path);
+    wavFile.close();
+    return false;
+  }
+  return wavStart(w->fmt, rate, w->name);
+}
+
+// Catalog entry named 'name' ("bark.wav"), -1 if none
+int8_t wavFind(const char *name) {
+  return wavCat.find(name);
+}
+
+// A random catalog entry tagged 'tag' (its name up to the first digit,
+// '_', '-' or '.': "bark" picks from bark.wav, bark2.wav...), -1 if none
+int8_t wavPick(const char *tag) {
+  uint8_t n = wavCat.tagCount(tag);
+  if(!n) return -1;
+  int8_t i = wavCat.tagFirst(tag);
+  for(n = animRandom(n); n; n--) i = wavCat.entry(i)->nextTag;
+  return i;
+}
+
+uint8_t wavClips(void) {
+  return wavCat.count();
+}
+
+// Name, tag, format and length (ms) of entry 'i', NULL if none
+const wavEntry *wavClip(int8_t i) {
+  return wavCat.entry(i);
+}